@@ -24,12 +24,14 @@
 namespace tpne {
 
 class Net;
+class CompiledNet;
 class MaxPlus;
 template<typename T> class SparseMatrix; // FIXME add (max,+) struct
 
 //--------------------------------------------------------------------------
 //! \brief Chech if the Petri net is a graph event meaning that each places
-//! have exactly one input arc and one output arc.
+//! have exactly one input arc and one output arc, all arcs having a weight
+//! of 1.
 //! \param[inout] error human readable error message.
 //! \param[inout] erroneous_arcs store detected erroneous arcs.
 //!
@@ -49,6 +51,11 @@ bool isEventGraph(Net const& net, std::string& error, std::vector<Arc*>& erroneo
 //--------------------------------------------------------------------------
 bool isEventGraph(Net const& net);
 
+//--------------------------------------------------------------------------
+//! \brief Same than isEventGraph(Net const&) but on a compiled net.
+//--------------------------------------------------------------------------
+bool isEventGraph(CompiledNet const& net);
+
 //--------------------------------------------------------------------------
 //! \brief Return the event graph as implicit dynamic linear (max, +) system.
 //! X(n) = D X(n) ⨁ A X(n-1) ⨁ B U(n)
@@ -90,6 +97,13 @@ void toCanonicalForm(Net const& net, Net& canonic);
 bool toAdjacencyMatrices(Net const& net, SparseMatrix<MaxPlus>& tokens,
     SparseMatrix<MaxPlus>& durations);
 
+//--------------------------------------------------------------------------
+//! \brief Same than toAdjacencyMatrices(Net const&, ...) but on a compiled
+//! net.
+//--------------------------------------------------------------------------
+bool toAdjacencyMatrices(CompiledNet const& net, SparseMatrix<MaxPlus>& tokens,
+    SparseMatrix<MaxPlus>& durations);
+
 //--------------------------------------------------------------------------
 //! \brief Returned by findCriticalCycle()
 //--------------------------------------------------------------------------
@@ -0,0 +1,504 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef COMPILED_PETRI_NET_HPP
+#  define COMPILED_PETRI_NET_HPP
+
+#  include "TimedPetriNetEditor/PetriNet.hpp"
+#  include <cstdint>
+#  include <limits>
+
+namespace tpne {
+
+// *****************************************************************************
+//! \brief Frozen snapshot of a Net in struct-of-arrays form, used by the
+//! simulation and the algorithms. While the Net class is made for being edited
+//! (nodes in std::deque, arcs referring nodes), this class stores the marking
+//! in a contiguous vector and the pre/post incidence of transitions and places
+//! in compressed sparse row (CSR) order: for the transition t, its upstream
+//! places are preplaces[preoffsets[t]] to preplaces[preoffsets[t + 1] - 1].
+//!
+//! Places and transitions are referred by their unique identifier which are
+//! also their position in the containers of the Net. Arcs are referred by their
+//! position in the container of the Net.
+//!
+//! \note The structure of the net is frozen when compile() is called: adding or
+//! removing nodes or arcs to the Net needs to compile it again. The marking and
+//! receptivities can be exchanged with the Net by readMarking() and
+//! writeMarking().
+//!
+//! \note When the project is built with TPNE_COMPACT_INDEX defined, indices
+//! and token counters are stored on 32 bits instead of size_t, halving the
+//! memory of CSR arrays and of the marking. Limits are given by maxIndex() and
+//! maxCount(): compile() refuses nets exceeding them and token counters
+//! saturate at maxCount(). Tokens lost by a saturation are counted by
+//! overflows().
+// *****************************************************************************
+class CompiledNet
+{
+public:
+
+    //--------------------------------------------------------------------------
+    //! \brief Precomputed kind of transitions (see Transition::isInput(),
+    //! Transition::isOutput() and Transition::isState()).
+    //--------------------------------------------------------------------------
+    enum class Kind : uint8_t { Isolated, Input, Output, State };
+
+#  if defined(TPNE_COMPACT_INDEX)
+    //! \brief Type of identifiers of nodes, positions of arcs and offsets.
+    using Index = uint32_t;
+    //! \brief Type of the number of tokens and of the weight of arcs.
+    using Count = uint32_t;
+#  else
+    using Index = size_t;
+    using Count = size_t;
+#  endif
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the maximum number of places, transitions or arcs that
+    //! can be compiled.
+    //--------------------------------------------------------------------------
+    static constexpr size_t maxIndex()
+    {
+        return std::numeric_limits<Index>::max();
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the maximum number of tokens in a place and the maximum
+    //! weight of arcs.
+    //--------------------------------------------------------------------------
+    static constexpr size_t maxCount()
+    {
+        return std::numeric_limits<Count>::max();
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Read-only view on a chunk of a CSR array.
+    //--------------------------------------------------------------------------
+    template<class T>
+    struct Range
+    {
+        T const* first;
+        T const* last;
+
+        inline T const* begin() const { return first; }
+        inline T const* end() const { return last; }
+        inline size_t size() const { return size_t(last - first); }
+        inline T const& operator[](size_t const i) const { return first[i]; }
+    };
+
+    //--------------------------------------------------------------------------
+    //! \brief Empty net. Call compile() to fill it.
+    //--------------------------------------------------------------------------
+    CompiledNet() = default;
+
+    //--------------------------------------------------------------------------
+    //! \brief Compile the given net. Call error() to know if the compilation
+    //! has failed.
+    //--------------------------------------------------------------------------
+    explicit CompiledNet(Net const& net);
+
+    //--------------------------------------------------------------------------
+    //! \brief Freeze the structure, the marking and the receptivities of the
+    //! given net. Complexity is O(n) where n is the number of nodes and arcs.
+    //! \return false if the net exceeds maxIndex() or maxCount(). In this case
+    //! the compiled net is left empty and error() holds the reason.
+    //--------------------------------------------------------------------------
+    bool compile(Net const& net);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the reason of the latest failure of compile() or an empty
+    //! string.
+    //--------------------------------------------------------------------------
+    inline std::string const& error() const { return m_error; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of times a token counter has been saturated at
+    //! maxCount() since the latest compile(), losing tokens. Saturations at
+    //! NetSettings::maxTokens (i.e. GRAFCET) are the expected behavior and are
+    //! not counted.
+    //--------------------------------------------------------------------------
+    inline size_t overflows() const { return m_overflows; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return true if tokens have been lost by a saturation at
+    //! maxCount() since the latest compile().
+    //--------------------------------------------------------------------------
+    inline bool overflowed() const { return m_overflows != 0u; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return tokens + count * weight saturated at the maximum number
+    //! of tokens of a place, for counting tokens outside places (i.e. carried
+    //! by arcs). Saturations at maxCount() are counted by overflows().
+    //--------------------------------------------------------------------------
+    size_t addTokens(size_t const tokens, size_t const count, size_t const weight);
+
+    //--------------------------------------------------------------------------
+    //! \brief Refresh the marking and the receptivities from the net compiled
+    //! by compile(). The structure of the net shall not have been modified.
+    //! \return false if a place holds more than maxCount() tokens. Its number
+    //! of tokens is then saturated.
+    //--------------------------------------------------------------------------
+    bool readMarking(Net const& net);
+
+    //--------------------------------------------------------------------------
+    //! \brief Write back to the net compiled by compile() the places and the
+    //! receptivities modified since the last call of compile(), readMarking()
+    //! or writeMarking().
+    //--------------------------------------------------------------------------
+    void writeMarking(Net& net);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the settings of the net when compiled.
+    //--------------------------------------------------------------------------
+    inline NetSettings const& settings() const { return m_settings; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of places.
+    //--------------------------------------------------------------------------
+    inline size_t places() const { return m_tokens.size(); }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of transitions.
+    //--------------------------------------------------------------------------
+    inline size_t transitions() const { return m_kinds.size(); }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of arcs.
+    //--------------------------------------------------------------------------
+    inline size_t arcs() const { return m_arcs; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Const getter of the marking (number of tokens for each place).
+    //--------------------------------------------------------------------------
+    inline std::vector<Count> const& tokens() const { return m_tokens; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of tokens of the given place.
+    //--------------------------------------------------------------------------
+    inline size_t tokens(size_t const place) const { return m_tokens[place]; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Set the number of tokens of the given place, constrained by the
+    //! type of net and by maxCount() (see overflows()).
+    //--------------------------------------------------------------------------
+    void tokens(size_t const place, size_t const count);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the receptivity of the given transition.
+    //--------------------------------------------------------------------------
+    inline bool receptivity(size_t const transition) const
+    {
+        return m_receptivities[transition] != 0u;
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Set the receptivity of the given transition.
+    //--------------------------------------------------------------------------
+    void receptivity(size_t const transition, bool const value);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the precomputed kind of the given transition.
+    //--------------------------------------------------------------------------
+    inline Kind kind(size_t const transition) const { return m_kinds[transition]; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the structural conflict cluster of the given transition.
+    //! Two transitions sharing an upstream place are in the same cluster:
+    //! transitions of different clusters never compete for tokens. Clusters
+    //! are numbered from 0 to clusters() - 1.
+    //--------------------------------------------------------------------------
+    inline size_t cluster(size_t const transition) const
+    {
+        return m_clusters[transition];
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of conflict clusters.
+    //--------------------------------------------------------------------------
+    inline size_t clusters() const { return m_nclusters; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the upstream places of the given transition.
+    //--------------------------------------------------------------------------
+    inline Range<Index> prePlaces(size_t const transition) const
+    {
+        return range(m_pre_places, m_pre_offsets, transition);
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the position in the Net of the arcs Place -> Transition
+    //! (same order than prePlaces()).
+    //--------------------------------------------------------------------------
+    inline Range<Index> preArcs(size_t const transition) const
+    {
+        return range(m_pre_arcs, m_pre_offsets, transition);
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the weights of the arcs Place -> Transition (same order
+    //! than prePlaces()).
+    //--------------------------------------------------------------------------
+    inline Range<Count> preWeights(size_t const transition) const
+    {
+        return range(m_pre_weights, m_pre_offsets, transition);
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the downstream places of the given transition.
+    //--------------------------------------------------------------------------
+    inline Range<Index> postPlaces(size_t const transition) const
+    {
+        return range(m_post_places, m_post_offsets, transition);
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the position in the Net of the arcs Transition -> Place
+    //! (same order than postPlaces()).
+    //--------------------------------------------------------------------------
+    inline Range<Index> postArcs(size_t const transition) const
+    {
+        return range(m_post_arcs, m_post_offsets, transition);
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the durations of the arcs Transition -> Place (same order
+    //! than postPlaces()).
+    //--------------------------------------------------------------------------
+    inline Range<float> postDurations(size_t const transition) const
+    {
+        return range(m_post_durations, m_post_offsets, transition);
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the weights of the arcs Transition -> Place (same order
+    //! than postPlaces()).
+    //--------------------------------------------------------------------------
+    inline Range<Count> postWeights(size_t const transition) const
+    {
+        return range(m_post_weights, m_post_offsets, transition);
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the weight of the arc Transition -> Place given its
+    //! offset inside the CSR arrays.
+    //--------------------------------------------------------------------------
+    inline size_t postWeight(size_t const offset) const { return m_post_weights[offset]; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the offset of the first arc Transition -> Place of the
+    //! given transition inside the CSR arrays. Offsets of the net are in the
+    //! range [0 .. postSize()[ and can be used to index user data per arc.
+    //--------------------------------------------------------------------------
+    inline size_t postOffset(size_t const transition) const
+    {
+        return m_post_offsets[transition];
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of arcs Transition -> Place.
+    //--------------------------------------------------------------------------
+    inline size_t postSize() const { return m_post_places.size(); }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the position in the Net of the arc Transition -> Place
+    //! given its offset inside the CSR arrays.
+    //--------------------------------------------------------------------------
+    inline size_t postArc(size_t const offset) const { return m_post_arcs[offset]; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the downstream place of the arc Transition -> Place given
+    //! its offset inside the CSR arrays.
+    //--------------------------------------------------------------------------
+    inline size_t postPlace(size_t const offset) const { return m_post_places[offset]; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the upstream transitions of the given place.
+    //--------------------------------------------------------------------------
+    inline Range<Index> inputTransitions(size_t const place) const
+    {
+        return range(m_place_in_transitions, m_place_in_offsets, place);
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the durations of the arcs Transition -> Place incoming to
+    //! the given place (same order than inputTransitions()).
+    //--------------------------------------------------------------------------
+    inline Range<float> inputDurations(size_t const place) const
+    {
+        return range(m_place_in_durations, m_place_in_offsets, place);
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the downstream transitions of the given place.
+    //--------------------------------------------------------------------------
+    inline Range<Index> outputTransitions(size_t const place) const
+    {
+        return range(m_place_out_transitions, m_place_out_offsets, place);
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Same than Transition::isValidated(): check if all upstream places
+    //! have at least as many tokens as the weight of their arc.
+    //--------------------------------------------------------------------------
+    bool isValidated(size_t const transition) const;
+
+    //--------------------------------------------------------------------------
+    //! \brief Same than Transition::isFireable(): the receptivity is true and
+    //! all upstream places have at least as many tokens as the weight of their
+    //! arc (see isValidated()).
+    //--------------------------------------------------------------------------
+    inline bool isFireable(size_t const transition) const
+    {
+        return receptivity(transition) && isValidated(transition);
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Same than Transition::countBurnableTokens(): return the maximum
+    //! number of times the transition can be fired.
+    //--------------------------------------------------------------------------
+    size_t countBurnableTokens(size_t const transition) const;
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of times the transition can be fired with the
+    //! tokens of its upstream places, whatever its receptivity and the firing
+    //! policy. Transitions without upstream place return 1.
+    //--------------------------------------------------------------------------
+    size_t enablingDegree(size_t const transition) const;
+
+    //--------------------------------------------------------------------------
+    //! \brief Fire the transition the given number of times: burn this number
+    //! multiplied by the weight of the arc in each upstream place. The caller
+    //! shall check the transition can be fired.
+    //--------------------------------------------------------------------------
+    void consume(size_t const transition, size_t const count);
+
+    //--------------------------------------------------------------------------
+    //! \brief Deposit the given number multiplied by the weight of the arc in
+    //! each downstream place of the transition, constrained by the type of
+    //! net and by maxCount() (see overflows()).
+    //--------------------------------------------------------------------------
+    void produce(size_t const transition, size_t const count);
+
+    //--------------------------------------------------------------------------
+    //! \brief Deposit the given number of tokens in the given place,
+    //! constrained by the type of net and by maxCount() (see overflows()).
+    //--------------------------------------------------------------------------
+    void deposit(size_t const place, size_t const count);
+
+    //--------------------------------------------------------------------------
+    //! \brief Fire the transition: consume() then produce() tokens.
+    //--------------------------------------------------------------------------
+    void fire(size_t const transition, size_t const count = 1u);
+
+    //--------------------------------------------------------------------------
+    //! \brief Move into the given vector the transitions which may have become
+    //! fireable since the latest call (all transitions after compile()), that
+    //! is downstream transitions of places which have gained tokens and
+    //! transitions whose receptivity has become true. Other transitions have
+    //! not changed of fireability. The cost is O(degree) per modified place.
+    //--------------------------------------------------------------------------
+    void takeCandidates(std::vector<size_t>& candidates);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the transitions which may have become fireable since the
+    //! latest call of takeCandidates(), in the order they have been marked.
+    //--------------------------------------------------------------------------
+    inline std::vector<Index> const& candidates() const { return m_candidates; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Restore a marking, receptivities and candidates saved from
+    //! tokens(), receptivity() and candidates(). All places and transitions
+    //! are written back by the next writeMarking().
+    //--------------------------------------------------------------------------
+    void restore(std::vector<Count> const& tokens,
+                 std::vector<uint8_t> const& receptivities,
+                 std::vector<Index> const& candidates);
+
+private:
+
+    template<class T>
+    static inline Range<T> range(std::vector<T> const& values,
+                                 std::vector<Index> const& offsets,
+                                 size_t const i)
+    {
+        return { values.data() + offsets[i], values.data() + offsets[i + 1u] };
+    }
+
+    void touchPlace(size_t const place);
+    void touchCandidate(size_t const transition);
+    void gainedTokens(size_t const place);
+    bool fail(std::string const& error);
+
+private:
+
+    //! \brief Settings of the net when compiled.
+    NetSettings m_settings;
+    //! \brief Maximum number of tokens in a place: the smallest of the
+    //! settings and of maxCount().
+    size_t m_max_tokens = 0u;
+    //! \brief Reason of the latest failure of compile().
+    std::string m_error;
+    //! \brief Number of saturations at maxCount() since compile().
+    size_t m_overflows = 0u;
+    //! \brief Number of arcs.
+    size_t m_arcs = 0u;
+    //! \brief Marking: number of tokens for each place.
+    std::vector<Count> m_tokens;
+    //! \brief Receptivities for each transition (0 or 1).
+    std::vector<uint8_t> m_receptivities;
+    //! \brief Precomputed kinds of transitions.
+    std::vector<Kind> m_kinds;
+    //! \brief Conflict cluster of each transition.
+    std::vector<Index> m_clusters;
+    size_t m_nclusters = 0u;
+    //! \brief Arcs Place -> Transition in CSR order (indexed by transitions).
+    std::vector<Index> m_pre_offsets;
+    std::vector<Index> m_pre_places;
+    std::vector<Index> m_pre_arcs;
+    std::vector<Count> m_pre_weights;
+    //! \brief Arcs Transition -> Place in CSR order (indexed by transitions).
+    std::vector<Index> m_post_offsets;
+    std::vector<Index> m_post_places;
+    std::vector<Index> m_post_arcs;
+    std::vector<float> m_post_durations;
+    std::vector<Count> m_post_weights;
+    //! \brief Arcs Transition -> Place in CSR order (indexed by places).
+    std::vector<Index> m_place_in_offsets;
+    std::vector<Index> m_place_in_transitions;
+    std::vector<float> m_place_in_durations;
+    //! \brief Arcs Place -> Transition in CSR order (indexed by places).
+    std::vector<Index> m_place_out_offsets;
+    std::vector<Index> m_place_out_transitions;
+    //! \brief Places and transitions modified since the latest exchange with
+    //! the Net.
+    std::vector<uint8_t> m_dirty_places;
+    std::vector<Index> m_modified_places;
+    std::vector<uint8_t> m_dirty_transitions;
+    std::vector<Index> m_modified_transitions;
+    //! \brief Transitions which may have become fireable since the latest
+    //! call of takeCandidates().
+    std::vector<uint8_t> m_candidate_transitions;
+    std::vector<Index> m_candidates;
+};
+
+} // namespace tpne
+
+#endif
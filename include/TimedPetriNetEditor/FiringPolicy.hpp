@@ -0,0 +1,239 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef FIRING_POLICY_HPP
+#  define FIRING_POLICY_HPP
+
+#  include "TimedPetriNetEditor/IndexedHeap.hpp"
+#  include <vector>
+#  include <memory>
+#  include <cstdint>
+#  include <cstddef>
+
+namespace tpne {
+
+// *****************************************************************************
+//! \brief Conflict resolution of the TimedSimulator: choose in which order the
+//! fireable transitions of a conflict cluster (transitions sharing upstream
+//! places) are fired. The simulator pushes the candidates of the cluster, then
+//! pops them one by one and fires those which are still fireable:
+//!   - per round policies (rounds() returning true) get the transitions fired
+//!     during a round pushed again for the next round, so each transition
+//!     fires at most once per round;
+//!   - other policies get a fired transition pushed again immediately, so it
+//!     may be chosen again before the others.
+//!
+//! Transitions are referred by their identifier. Policies are cloned when the
+//! simulator is copied and their persistent state is stored in checkpoints.
+// *****************************************************************************
+class FiringPolicy
+{
+public:
+
+    // *************************************************************************
+    //! \brief SplitMix64 random generator: its state is a single integer,
+    //! cheap to store in checkpoints.
+    // *************************************************************************
+    struct Random
+    {
+        using result_type = uint32_t;
+        static constexpr result_type min() { return 0u; }
+        static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+        inline result_type operator()()
+        {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return result_type((z ^ (z >> 31)) >> 32);
+        }
+
+        uint64_t state = 0u;
+    };
+
+    virtual ~FiringPolicy() = default;
+
+    //--------------------------------------------------------------------------
+    //! \brief Return a copy of the policy with its configuration and state.
+    //--------------------------------------------------------------------------
+    virtual std::unique_ptr<FiringPolicy> clone() const = 0;
+
+    //--------------------------------------------------------------------------
+    //! \brief Called when the simulator compiles a net. Pushed transitions are
+    //! forgotten; the configuration of existing transitions is kept.
+    //--------------------------------------------------------------------------
+    virtual void reset(size_t const transitions) = 0;
+
+    //--------------------------------------------------------------------------
+    //! \brief Do transitions fire at most once per round ? If so, the
+    //! simulator may fire rounds in bulk when tokens are enough for all the
+    //! candidates.
+    //--------------------------------------------------------------------------
+    virtual bool rounds() const = 0;
+
+    //--------------------------------------------------------------------------
+    //! \brief Add a candidate transition. It shall not be already pushed.
+    //--------------------------------------------------------------------------
+    virtual void push(size_t const transition) = 0;
+
+    //--------------------------------------------------------------------------
+    //! \brief Are all pushed transitions popped ?
+    //--------------------------------------------------------------------------
+    virtual bool empty() const = 0;
+
+    //--------------------------------------------------------------------------
+    //! \brief Remove and return the transition to try next. The policy shall
+    //! not be empty.
+    //--------------------------------------------------------------------------
+    virtual size_t pop(Random& random) = 0;
+
+    //--------------------------------------------------------------------------
+    //! \brief Notify that the transition has been fired, in conflict or not.
+    //--------------------------------------------------------------------------
+    virtual void fired(size_t const /*transition*/) {}
+
+    //--------------------------------------------------------------------------
+    //! \brief Save and restore the state changing along the simulation, not
+    //! the configuration.
+    //--------------------------------------------------------------------------
+    virtual void save(std::vector<uint64_t>& state) const { state.clear(); }
+    virtual void restore(std::vector<uint64_t> const& /*state*/) {}
+};
+
+// *****************************************************************************
+//! \brief Default policy: each round, transitions are tried in a uniformly
+//! random order.
+// *****************************************************************************
+class RandomPolicy: public FiringPolicy
+{
+public:
+
+    std::unique_ptr<FiringPolicy> clone() const override;
+    void reset(size_t const transitions) override;
+    bool rounds() const override { return true; }
+    void push(size_t const transition) override;
+    bool empty() const override { return m_next == m_pending.size(); }
+    size_t pop(Random& random) override;
+
+private:
+
+    //! \brief Transitions of the round, shuffled on the first pop.
+    std::vector<size_t> m_pending;
+    size_t m_next = 0u;
+    bool m_shuffled = false;
+};
+
+// *****************************************************************************
+//! \brief The fireable transition with the highest priority is fired, again and
+//! again, before transitions of lower priorities get the tokens. Transitions
+//! of the same priority are tried by increasing identifiers. Priorities are 0
+//! by default.
+// *****************************************************************************
+class PriorityPolicy: public FiringPolicy
+{
+public:
+
+    //--------------------------------------------------------------------------
+    //! \brief Set the priority of the transition: higher wins.
+    //--------------------------------------------------------------------------
+    void priority(size_t const transition, int const value);
+    int priority(size_t const transition) const;
+
+    std::unique_ptr<FiringPolicy> clone() const override;
+    void reset(size_t const transitions) override;
+    bool rounds() const override { return false; }
+    void push(size_t const transition) override;
+    bool empty() const override { return m_heap.empty(); }
+    size_t pop(Random& random) override;
+
+private:
+
+    std::vector<int> m_priorities;
+    IndexedHeap<int64_t> m_heap;
+};
+
+// *****************************************************************************
+//! \brief Fairness: each round, the transition which has waited the longest
+//! since its latest firing is tried first. Never fired transitions are tried
+//! first, by increasing identifiers.
+// *****************************************************************************
+class FifoPolicy: public FiringPolicy
+{
+public:
+
+    std::unique_ptr<FiringPolicy> clone() const override;
+    void reset(size_t const transitions) override;
+    bool rounds() const override { return true; }
+    void push(size_t const transition) override;
+    bool empty() const override { return m_heap.empty(); }
+    size_t pop(Random& random) override;
+    void fired(size_t const transition) override;
+    void save(std::vector<uint64_t>& state) const override;
+    void restore(std::vector<uint64_t> const& state) override;
+
+private:
+
+    //! \brief Order of the latest firing of transitions (0: never fired).
+    std::vector<uint64_t> m_stamps;
+    //! \brief Number of firings since the reset.
+    uint64_t m_counter = 0u;
+    IndexedHeap<int64_t> m_heap;
+};
+
+// *****************************************************************************
+//! \brief Each firing is given to one of the candidates with a probability
+//! proportional to its weight. Weights are 1 by default. Sampling and removal
+//! are made in O(log n) with a Fenwick tree of weights.
+// *****************************************************************************
+class WeightedRandomPolicy: public FiringPolicy
+{
+public:
+
+    //--------------------------------------------------------------------------
+    //! \brief Set the weight of the transition. Weights lower than 1 are set
+    //! to 1.
+    //--------------------------------------------------------------------------
+    void weight(size_t const transition, uint32_t const value);
+    uint32_t weight(size_t const transition) const;
+
+    std::unique_ptr<FiringPolicy> clone() const override;
+    void reset(size_t const transitions) override;
+    bool rounds() const override { return false; }
+    void push(size_t const transition) override;
+    bool empty() const override { return m_count == 0u; }
+    size_t pop(Random& random) override;
+
+private:
+
+    void add(size_t const transition, int64_t const delta);
+
+private:
+
+    std::vector<uint32_t> m_weights;
+    //! \brief Fenwick tree of the weights of pushed transitions (1-based,
+    //! power of two size).
+    std::vector<uint64_t> m_tree;
+    //! \brief Number of pushed transitions.
+    size_t m_count = 0u;
+};
+
+} // namespace tpne
+
+#endif
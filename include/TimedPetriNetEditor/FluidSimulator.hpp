@@ -0,0 +1,209 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef FLUID_SIMULATOR_HPP
+#  define FLUID_SIMULATOR_HPP
+
+#  include "TimedPetriNetEditor/CompiledNet.hpp"
+
+namespace tpne {
+
+// *****************************************************************************
+//! \brief Headless continuous (fluid) approximation of a timed net carrying a
+//! huge number of tokens. Markings are real numbers and transitions fire
+//! continuously at a flow (firings per unit of time) instead of burning tokens
+//! one by one: the marking evolves as dm/dt = C.f(m) where C is the incidence
+//! matrix of the net. The cost of a simulation depends on the structure of the
+//! net, not on its number of tokens.
+//!
+//! The rate of a transition is the inverse of the mean of its delay (see
+//! Transition::delay) and can be overridden by rate(). The semantics is given
+//! by the settings of the net (see NetSettings::server):
+//!   - Server::Infinite: the flow of t is rate(t) * min(m(p) / w(p, t)) over
+//!     its upstream places p. The dynamics is linear between changes of the
+//!     place reaching the minimum: it is integrated with Runge-Kutta 4 steps
+//!     no longer than step().
+//!   - Server::Finite: the flow of t is rate(t) while all its upstream places
+//!     are marked. An empty upstream place limits it to the share of the flow
+//!     it receives, shared by its downstream transitions proportionally to
+//!     their rate. Flows are constant until a place becomes empty: the
+//!     simulation jumps from one such event to the next one and is exact.
+//!
+//! Transitions without upstream places fire at their rate. Receptivities of the
+//! compiled net are honored; durations of arcs are not used.
+// *****************************************************************************
+class FluidSimulator
+{
+public:
+
+    //--------------------------------------------------------------------------
+    //! \brief Empty simulator. Call reset() to simulate a net.
+    //--------------------------------------------------------------------------
+    FluidSimulator() = default;
+
+    //--------------------------------------------------------------------------
+    //! \brief Compile the net and reset the simulation. Call error() to know if
+    //! the reset has failed.
+    //--------------------------------------------------------------------------
+    explicit FluidSimulator(Net const& net);
+
+    //--------------------------------------------------------------------------
+    //! \brief Compile the net, take its marking as the initial continuous
+    //! marking and the rates of its transitions, and set the simulated time
+    //! to 0.
+    //! \return false if the net cannot be compiled or if a transition has no
+    //! delay (immediate transitions have no fluid approximation).
+    //--------------------------------------------------------------------------
+    bool reset(Net const& net);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the reason of the latest failure of reset().
+    //--------------------------------------------------------------------------
+    inline std::string const& error() const
+    {
+        return m_error.empty() ? m_compiled.error() : m_error;
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the semantics of transitions.
+    //--------------------------------------------------------------------------
+    inline NetSettings::Server server() const { return m_server; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Change the semantics of transitions. Valid until the next
+    //! reset().
+    //--------------------------------------------------------------------------
+    inline void server(NetSettings::Server const semantics)
+    {
+        m_server = semantics;
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Override the rate of the transition. Valid until the next reset().
+    //--------------------------------------------------------------------------
+    inline void rate(size_t const transition, double const value)
+    {
+        m_rates[transition] = value;
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the rate of the transition.
+    //--------------------------------------------------------------------------
+    inline double rate(size_t const transition) const { return m_rates[transition]; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Change the maximal integration step of the infinite server
+    //! semantics.
+    //--------------------------------------------------------------------------
+    inline void step(double const value) { m_step = value; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the maximal integration step.
+    //--------------------------------------------------------------------------
+    inline double step() const { return m_step; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Simulate until the given time.
+    //--------------------------------------------------------------------------
+    void runUntil(double const time);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the current simulated time.
+    //--------------------------------------------------------------------------
+    inline double time() const { return m_time; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the continuous marking.
+    //--------------------------------------------------------------------------
+    inline std::vector<double> const& marking() const { return m_marking; }
+    inline double marking(size_t const place) const { return m_marking[place]; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the current flows of transitions.
+    //--------------------------------------------------------------------------
+    std::vector<double> const& flows();
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the cumulated flow of the transition since the reset():
+    //! its number of firings in the continuous approximation.
+    //--------------------------------------------------------------------------
+    inline double firings(size_t const transition) const { return m_firings[transition]; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the mean flow of the transition since the reset().
+    //--------------------------------------------------------------------------
+    double throughput(size_t const transition) const;
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of events (places becoming empty) of the finite
+    //! server semantics or the number of integration steps of the infinite
+    //! server semantics since the reset().
+    //--------------------------------------------------------------------------
+    inline size_t events() const { return m_events; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the compiled net holding the structure.
+    //--------------------------------------------------------------------------
+    inline CompiledNet const& compiled() const { return m_compiled; }
+
+private:
+
+    //! \brief Compute the flows of transitions for the given marking.
+    void compute(std::vector<double> const& marking, std::vector<double>& flows);
+    void infiniteFlows(std::vector<double> const& marking, std::vector<double>& flows) const;
+    void finiteFlows(std::vector<double> const& marking, std::vector<double>& flows);
+    //! \brief Add C.firings to the marking.
+    void apply(std::vector<double> const& firings, double const factor,
+               std::vector<double>& marking) const;
+    void advanceInfinite(double const time);
+    void advanceFinite(double const time);
+
+private:
+
+    //! \brief Structure of the simulated net.
+    CompiledNet m_compiled;
+    std::string m_error;
+    NetSettings::Server m_server = NetSettings::Server::Infinite;
+    //! \brief Continuous marking of places.
+    std::vector<double> m_marking;
+    //! \brief Rate of transitions.
+    std::vector<double> m_rates;
+    //! \brief Cumulated flow of transitions.
+    std::vector<double> m_firings;
+    //! \brief Downstream transitions of places with the weight of their arc,
+    //! in CSR form like CompiledNet::outputTransitions().
+    std::vector<CompiledNet::Index> m_consumer_offsets;
+    std::vector<CompiledNet::Index> m_consumers;
+    std::vector<double> m_consumer_weights;
+    double m_time = 0.0;
+    double m_step = 0.01;
+    size_t m_events = 0u;
+    //! \brief Scratch buffers reused by integration steps.
+    std::vector<double> m_flows;
+    std::vector<double> m_stages[4];
+    std::vector<double> m_inflows;
+    std::vector<double> m_demands;
+    std::vector<double> m_derivatives;
+    std::vector<double> m_temporary;
+};
+
+} // namespace tpne
+
+#endif
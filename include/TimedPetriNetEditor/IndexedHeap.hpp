@@ -0,0 +1,184 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef INDEXED_HEAP_HPP
+#  define INDEXED_HEAP_HPP
+
+#  include <vector>
+#  include <cstddef>
+#  include <cassert>
+
+namespace tpne {
+
+// *****************************************************************************
+//! \brief Min-heap of transitions on (key, identifier) where the position of
+//! each transition is indexed: push, pop, update of a key and removal of any
+//! transition are made in O(log n).
+// *****************************************************************************
+template<class Key>
+class IndexedHeap
+{
+public:
+
+    //--------------------------------------------------------------------------
+    //! \brief Remove all transitions and accept identifiers lower than the
+    //! given number.
+    //--------------------------------------------------------------------------
+    void reset(size_t const transitions)
+    {
+        m_heap.clear();
+        m_positions.assign(transitions, NONE);
+        m_keys.assign(transitions, Key());
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Insert the transition, or update its key if already present.
+    //--------------------------------------------------------------------------
+    void push(size_t const transition, Key const key)
+    {
+        if (transition >= m_positions.size())
+        {
+            m_positions.resize(transition + 1u, NONE);
+            m_keys.resize(transition + 1u, Key());
+        }
+
+        if (m_positions[transition] != NONE)
+        {
+            Key const previous = m_keys[transition];
+            m_keys[transition] = key;
+            if (key < previous)
+                up(m_positions[transition]);
+            else
+                down(m_positions[transition]);
+            return ;
+        }
+
+        m_keys[transition] = key;
+        m_heap.push_back(transition);
+        up(m_heap.size() - 1u);
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Remove and return the transition with the lowest key.
+    //--------------------------------------------------------------------------
+    size_t pop()
+    {
+        assert(!m_heap.empty());
+        size_t const transition = m_heap.front();
+        remove(transition);
+        return transition;
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Remove the transition if present.
+    //--------------------------------------------------------------------------
+    void remove(size_t const transition)
+    {
+        if (!contains(transition))
+            return ;
+
+        size_t const position = m_positions[transition];
+        size_t const last = m_heap.back();
+        m_heap.pop_back();
+        m_positions[transition] = NONE;
+        if (last == transition)
+            return ;
+
+        // Move the last transition into the hole, then restore the heap order.
+        place(position, last);
+        if ((position > 0u) && before(last, m_heap[(position - 1u) / 2u]))
+            up(position);
+        else
+            down(position);
+    }
+
+    inline bool contains(size_t const transition) const
+    {
+        return (transition < m_positions.size()) && (m_positions[transition] != NONE);
+    }
+    inline bool empty() const { return m_heap.empty(); }
+    inline size_t size() const { return m_heap.size(); }
+    inline size_t top() const { return m_heap.front(); }
+    inline Key const& key(size_t const transition) const { return m_keys[transition]; }
+
+private:
+
+    bool before(size_t const a, size_t const b) const
+    {
+        return (m_keys[a] < m_keys[b]) || ((!(m_keys[b] < m_keys[a])) && (a < b));
+    }
+
+    void place(size_t const position, size_t const transition)
+    {
+        m_heap[position] = transition;
+        m_positions[transition] = position;
+    }
+
+    void up(size_t position)
+    {
+        size_t const transition = m_heap[position];
+        while (position > 0u)
+        {
+            size_t const parent = (position - 1u) / 2u;
+            if (!before(transition, m_heap[parent]))
+                break;
+            place(position, m_heap[parent]);
+            position = parent;
+        }
+        place(position, transition);
+    }
+
+    void down(size_t position)
+    {
+        size_t const transition = m_heap[position];
+        size_t const size = m_heap.size();
+        while (true)
+        {
+            size_t child = 2u * position + 1u;
+            if (child >= size)
+                break;
+            if ((child + 1u < size) && before(m_heap[child + 1u], m_heap[child]))
+                ++child;
+            if (!before(m_heap[child], transition))
+                break;
+            place(position, m_heap[child]);
+            position = child;
+        }
+        place(position, transition);
+    }
+
+private:
+
+    static constexpr size_t NONE = static_cast<size_t>(-1);
+
+    //! \brief Transitions in heap order.
+    std::vector<size_t> m_heap;
+    //! \brief Position of transitions in m_heap, or NONE.
+    std::vector<size_t> m_positions;
+    //! \brief Key of transitions (indexed by identifiers).
+    std::vector<Key> m_keys;
+};
+
+template<class Key>
+constexpr size_t IndexedHeap<Key>::NONE;
+
+} // namespace tpne
+
+#endif
@@ -0,0 +1,73 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef MONTE_CARLO_HPP
+#  define MONTE_CARLO_HPP
+
+#  include "TimedPetriNetEditor/TimedSimulator.hpp"
+
+namespace tpne {
+
+//--------------------------------------------------------------------------
+//! \brief Returned by runMonteCarlo(): statistics of the replications.
+//--------------------------------------------------------------------------
+struct MonteCarloResult
+{
+    //! \brief Has the net been compiled ? In case of failure, holds the
+    //! reason in message.
+    bool success = false;
+    std::string message;
+    //! \brief Number of replications which have been simulated.
+    size_t replications = 0u;
+    //! \brief For each transition, mean number of firings per unit of time.
+    std::vector<double> throughputs;
+    //! \brief For each place, mean number of tokens over the simulated time.
+    std::vector<double> markings;
+    //! \brief Number of replications ending in a deadlock before the end of
+    //! the simulated time (no fireable transition and no pending token).
+    size_t deadlocks = 0u;
+    //! \brief Ratio of replications ending in a deadlock.
+    double deadlock_frequency = 0.0;
+};
+
+//--------------------------------------------------------------------------
+//! \brief Simulate the given net many times, each replication with its own
+//! random order of firing, and aggregate statistics. The net is compiled once
+//! and copied into each worker thread; replications are distributed over the
+//! threads with work stealing.
+//!
+//! Each replication is seeded from the master seed and from its index, and
+//! statistics are aggregated in the order of replications: results depend
+//! on the master seed only, not on the number of threads.
+//!
+//! \param[in] net the net to simulate with its current marking and
+//!   receptivities (see Net::resetReceptivies()).
+//! \param[in] replications the number of simulations.
+//! \param[in] duration the simulated time of each replication.
+//! \param[in] seed the master seed.
+//! \param[in] threads the number of threads. 0 for the number of cores.
+//--------------------------------------------------------------------------
+MonteCarloResult runMonteCarlo(Net const& net, size_t const replications,
+                               double const duration, uint64_t const seed,
+                               size_t const threads = 0u);
+
+} // namespace tpne
+
+#endif
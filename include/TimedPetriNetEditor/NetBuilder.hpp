@@ -0,0 +1,160 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef PETRI_NET_BUILDER_HPP
+#  define PETRI_NET_BUILDER_HPP
+
+#  include "TimedPetriNetEditor/PetriNet.hpp"
+
+namespace tpne {
+
+// *****************************************************************************
+//! \brief Fill a Net with many places, transitions and arcs at once, typically
+//! when importing a file or generating a large model. Elements are queued by
+//! the add methods and inserted in the net by finalize(), which makes the
+//! sanity checks once (duplicated identifiers, unknown nodes, duplicated arcs,
+//! negative durations, null weights) and reserves containers up front.
+//!
+//! Places are inserted first, then transitions, then arcs in the order they
+//! were queued. As with Net::addArc(Node&, Node&, float), an arc linking two
+//! nodes of the same type creates an intermediate node of the opposite type.
+//! Therefore the resulting net is the same than calling the methods of Net
+//! one by one.
+// *****************************************************************************
+class NetBuilder
+{
+public:
+
+    //--------------------------------------------------------------------------
+    //! \brief Reason of the failure of finalize().
+    //--------------------------------------------------------------------------
+    enum class Failure { None, DuplicatedNode, UnknownNode, NegativeDuration,
+                         NullWeight, DuplicatedArc };
+
+    //--------------------------------------------------------------------------
+    //! \brief Fill the given net. The net is not cleared: its nodes can be
+    //! referred by the queued arcs.
+    //--------------------------------------------------------------------------
+    explicit NetBuilder(Net& net);
+
+    //--------------------------------------------------------------------------
+    //! \brief Reserve memory for the given number of places, transitions and
+    //! arcs to queue.
+    //--------------------------------------------------------------------------
+    void reserve(size_t const places, size_t const transitions, size_t const arcs);
+
+    //--------------------------------------------------------------------------
+    //! \brief Queue a place. Same parameters than Net::addPlace().
+    //--------------------------------------------------------------------------
+    void addPlace(size_t const id, std::string const& caption, float const x,
+                  float const y, size_t const tokens);
+
+    //--------------------------------------------------------------------------
+    //! \brief Queue a transition. Same parameters than Net::addTransition().
+    //--------------------------------------------------------------------------
+    void addTransition(size_t const id, std::string const& caption,
+                       float const x, float const y, int const angle);
+
+    //--------------------------------------------------------------------------
+    //! \brief Queue an arc between two nodes given by their key (i.e. "P0" or
+    //! "T1") with the given duration and weight (see Arc). Nodes are looked
+    //! for in finalize(): they can be queued after the arc.
+    //--------------------------------------------------------------------------
+    void addArc(std::string const& from, std::string const& to,
+                float const duration = 0.0f, size_t const weight = 1u);
+
+    //--------------------------------------------------------------------------
+    //! \brief Queue arcs Transition -> Place -> Transition where the place is
+    //! created with the given number of tokens. Same behavior than
+    //! Net::addArc(Transition&, Transition&, size_t, float).
+    //--------------------------------------------------------------------------
+    void addArc(size_t const from, size_t const to, size_t const tokens,
+                float const duration);
+
+    //--------------------------------------------------------------------------
+    //! \brief Check queued elements and insert them in the net. Complexity is
+    //! O(n) where n is the number of nodes and arcs. Queues are emptied.
+    //! \return false in case of failure: the insertion stopped at the first
+    //! faulty element, the net is left partially filled and shall be reset.
+    //! Call failure(), failedArc() and error() to know the reason.
+    //--------------------------------------------------------------------------
+    bool finalize();
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the reason of the latest failure of finalize().
+    //--------------------------------------------------------------------------
+    inline Failure failure() const { return m_failure; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the position, in the order of the calls to addArc(), of
+    //! the arc that made finalize() fail.
+    //--------------------------------------------------------------------------
+    inline size_t failedArc() const { return m_failed_arc; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the message of the latest failure of finalize() (i.e.
+    //! "Arc P0 -> T0 has negative duration").
+    //--------------------------------------------------------------------------
+    inline std::string const& error() const { return m_error; }
+
+private:
+
+    bool fail(Failure const failure, std::string const& error, size_t const arc = 0u);
+
+private:
+
+    //! \brief Queued node.
+    struct PendingNode
+    {
+        size_t id;
+        std::string caption;
+        float x;
+        float y;
+        size_t tokens;
+        int angle;
+    };
+
+    //! \brief Queued arc. If \c tokens is set, \c from and \c to are two
+    //! transitions to be linked through a new place.
+    struct PendingArc
+    {
+        std::string from;
+        std::string to;
+        float duration;
+        size_t weight;
+        size_t tokens;
+        bool through_place;
+    };
+
+    //! \brief The net to fill.
+    Net& m_net;
+    //! \brief Queued elements.
+    std::vector<PendingNode> m_places;
+    std::vector<PendingNode> m_transitions;
+    std::vector<PendingArc> m_arcs;
+    //! \brief Reason of the latest failure.
+    Failure m_failure = Failure::None;
+    size_t m_failed_arc = 0u;
+    std::string m_error;
+};
+
+} // namespace tpne
+
+#endif
@@ -0,0 +1,193 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef PARALLEL_SIMULATOR_HPP
+#  define PARALLEL_SIMULATOR_HPP
+
+#  include "TimedPetriNetEditor/TimedSimulator.hpp"
+
+namespace tpne {
+
+// *****************************************************************************
+//! \brief Headless timed simulation of a net split into partitions, each one
+//! simulated by its own TimedSimulator on its own thread.
+//!
+//! The net is partitioned so that partitions only exchange tokens along arcs
+//! Transition -> Place with a strictly positive delay: a place belongs to the
+//! partition of its downstream transitions (conflicts are resolved inside a
+//! partition), source transitions belong to the partition of their downstream
+//! places, and arcs without delay do not cross partitions. Groups of nodes
+//! bound this way are then ordered by a breadth-first traversal of the net and
+//! cut into partitions of balanced number of nodes and arcs, keeping
+//! neighbouring groups together.
+//!
+//! Tokens departing towards another partition are sent through lock-free
+//! queues. Partitions are synchronized by the conservative Chandy-Misra-Bryant
+//! protocol: each message carries a promise, the earliest time of the tokens
+//! the sender may still send. It is the earliest time the sender may fire
+//! again plus the lookahead of the channel, the smallest delay of arcs from the
+//! sender to the receiver. A partition only simulates instants earlier than
+//! the promises of all its senders; when it has no tokens to send, it sends
+//! promises alone (null messages) so that cycles of partitions cannot
+//! deadlock.
+//!
+//! Instants are processed as in TimedSimulator: results (firings, marking)
+//! are the ones of a sequential simulation of the whole net, random firing
+//! policies included: a conflict cluster lies in a single partition and draws
+//! from its own random generator, the same as in TimedSimulator. Observers are
+//! not supported.
+//!
+//! \note Each partition compiles the whole net but only owns its places and
+//! transitions: others stay empty and disabled in it.
+// *****************************************************************************
+class ParallelSimulator
+{
+public:
+
+    //--------------------------------------------------------------------------
+    //! \brief Empty simulator. Call reset() to simulate a net.
+    //--------------------------------------------------------------------------
+    ParallelSimulator();
+
+    //--------------------------------------------------------------------------
+    //! \brief Partition the net and reset the simulation. Call error() to know
+    //! if the reset has failed.
+    //--------------------------------------------------------------------------
+    ParallelSimulator(Net const& net, size_t const partitions);
+
+    ~ParallelSimulator();
+
+    //--------------------------------------------------------------------------
+    //! \brief Compile and partition the net with its current marking and
+    //! receptivities, and set the simulated time to 0. Fewer partitions than
+    //! requested are made when the net cannot be cut further.
+    //! \return false if the net cannot be compiled (see error()).
+    //--------------------------------------------------------------------------
+    bool reset(Net const& net, size_t const partitions);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the reason of the latest failure of reset().
+    //--------------------------------------------------------------------------
+    inline std::string const& error() const { return m_compiled.error(); }
+
+    //--------------------------------------------------------------------------
+    //! \brief Seed the random generator of each partition (see
+    //! TimedSimulator::seed()).
+    //--------------------------------------------------------------------------
+    void seed(uint32_t const value);
+
+    //--------------------------------------------------------------------------
+    //! \brief Set the firing policy of each partition, as a copy of the given
+    //! one (see TimedSimulator::policy()).
+    //--------------------------------------------------------------------------
+    void policy(FiringPolicy const& policy);
+
+    //--------------------------------------------------------------------------
+    //! \brief Set the holding time of the place (see TimedSimulator::holding()).
+    //--------------------------------------------------------------------------
+    void holding(size_t const place, float const value);
+
+    //--------------------------------------------------------------------------
+    //! \brief Simulate until the given time, as TimedSimulator::runUntil(), on
+    //! one thread per partition.
+    //! \return the number of firings.
+    //--------------------------------------------------------------------------
+    size_t runUntil(double const time);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the current simulated time.
+    //--------------------------------------------------------------------------
+    inline double time() const { return m_time; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of times transitions have been fired since the
+    //! latest reset().
+    //--------------------------------------------------------------------------
+    size_t firings() const;
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the marking of available tokens, as
+    //! TimedSimulator::compiled().tokens().
+    //--------------------------------------------------------------------------
+    std::vector<CompiledNet::Count> tokens() const;
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of tokens in the place, available and held (see
+    //! TimedSimulator::tokens()).
+    //--------------------------------------------------------------------------
+    size_t tokens(size_t const place) const;
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of partitions.
+    //--------------------------------------------------------------------------
+    inline size_t partitions() const { return m_processes.size(); }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the partition owning the place or the transition.
+    //--------------------------------------------------------------------------
+    inline size_t placeOwner(size_t const place) const { return m_place_owners[place]; }
+    inline size_t transitionOwner(size_t const transition) const
+    {
+        return m_transition_owners[transition];
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of channels between partitions.
+    //--------------------------------------------------------------------------
+    inline size_t channels() const { return m_channels.size(); }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of messages sent without tokens since the
+    //! latest reset().
+    //--------------------------------------------------------------------------
+    size_t nullMessages() const;
+
+private:
+
+    struct Channel;
+    struct Process;
+
+    //--------------------------------------------------------------------------
+    //! \brief Assign places and transitions to at most the given number of
+    //! partitions.
+    //--------------------------------------------------------------------------
+    size_t partition(std::vector<float> const& delays, size_t const partitions);
+
+    //--------------------------------------------------------------------------
+    //! \brief Body of the thread of a partition.
+    //--------------------------------------------------------------------------
+    void run(Process& process, double const time);
+
+private:
+
+    //! \brief Structure of the simulated net.
+    CompiledNet m_compiled;
+    //! \brief Partition of places and transitions.
+    std::vector<CompiledNet::Index> m_place_owners;
+    std::vector<CompiledNet::Index> m_transition_owners;
+    std::vector<std::unique_ptr<Process>> m_processes;
+    std::vector<std::unique_ptr<Channel>> m_channels;
+    //! \brief Current simulated time.
+    double m_time = 0.0;
+};
+
+} // namespace tpne
+
+#endif
@@ -26,7 +26,9 @@
 #  include <string>
 #  include <deque>
 #  include <vector>
+#  include <unordered_map>
 #  include <cassert>
+#  include <limits>
 #  include <algorithm> // std::random_shuffle
 #  include <random>
 #  include <iostream>
@@ -69,6 +71,41 @@ enum class TypeOfNet
     // TODO state machine
 };
 
+// *****************************************************************************
+//! \brief Settings for defining the type of net (GRAFCET, Petri net, timed
+//! petri net, timed graph event ...). Each net holds its own settings: nets of
+//! different types can be edited and simulated concurrently.
+// *****************************************************************************
+struct NetSettings
+{
+    //! \brief The theory would burn the maximum possibe of tokens that we
+    //! can within a single action (Fire::MaxPossible) but we can also try
+    //! to burn tokens one by one and randomize the transitions
+    //! (Fire::OneByOne). This will favor dispatching tokens along arcs.
+    enum class Fire { OneByOne, MaxPossible };
+
+    //! \brief Semantics of transitions in continuous (fluid) simulations (see
+    //! FluidSimulator): the flow of a transition is its rate multiplied by its
+    //! enabling degree (Server::Infinite) or is its rate as long as it is
+    //! enabled (Server::Finite).
+    enum class Server { Infinite, Finite };
+
+    //--------------------------------------------------------------------------
+    //! \brief Default settings for the given type of net.
+    //--------------------------------------------------------------------------
+    explicit NetSettings(TypeOfNet const type = TypeOfNet::TimedPetriNet);
+
+    //! \brief Max number of tokens in places. For GRAFCET: 1. For other
+    //! nets: +infinity (aka std::numeric_limits<size_t>::max()).
+    size_t maxTokens = std::numeric_limits<size_t>::max();
+
+    //! \brief Burn tokens one by one or as many as possible.
+    Fire firing = Fire::OneByOne;
+
+    //! \brief Semantics of transitions in fluid simulations.
+    Server server = Server::Infinite;
+};
+
 // *****************************************************************************
 //! \brief Since Petri nets are bipartite graph there are two kind of nodes:
 //! place and transition. This class shall not be used directly as instance, it
@@ -94,10 +131,10 @@ public:
     //--------------------------------------------------------------------------
     Node(Type const type_, size_t const id_, std::string const& caption_,
          float const x_, float const y_)
-        : type(type_), id(id_),
-          key((type == Node::Type::Place ? 'P' : 'T') + std::to_string(id)),
-          x(x_), y(y_), caption(caption_.empty() ? key : caption_)
-    {}
+        : type(type_), id(id_), x(x_), y(y_)
+    {
+        caption(caption_);
+    }
 
     //--------------------------------------------------------------------------
     //! \brief Copy operator needed because this class has constant member
@@ -114,14 +151,18 @@ public:
     //! \brief Needed because this class has constant member variables.
     //--------------------------------------------------------------------------
     Node(Node const& other)
-        : Node(other.type, other.id, other.caption, other.x, other.y)
+        : type(other.type), id(other.id), x(other.x), y(other.y),
+          m_caption(other.m_caption), m_settings(other.m_settings)
     {}
 
     //--------------------------------------------------------------------------
     //! \brief Needed because this class has constant member variables.
+    //! Contrary to the copy, incoming and outcoming arcs are moved.
     //--------------------------------------------------------------------------
     Node(Node&& other)
-        : Node(other.type, other.id, other.caption, other.x, other.y)
+        : type(other.type), id(other.id), x(other.x), y(other.y),
+          arcsIn(std::move(other.arcsIn)), arcsOut(std::move(other.arcsOut)),
+          m_caption(other.m_caption), m_settings(other.m_settings)
     {}
 
     //--------------------------------------------------------------------------
@@ -130,10 +171,49 @@ public:
     Node& operator=(Node&& other)
     {
         this->~Node(); // destroy
-        new (this) Node(other); // copy construct in place
+        new (this) Node(std::move(other)); // move construct in place
         return *this;
     }
 
+    //--------------------------------------------------------------------------
+    //! \brief Unique node identifier as string. It is formed by the 'P' char
+    //! for place or by the 'T' char for transition followed by the unique
+    //! identifier (i.e. "P0", "P1", "T0", "T1", ...). The string is computed
+    //! on demand from the type and the identifier and is not stored.
+    //--------------------------------------------------------------------------
+    inline std::string key() const
+    {
+        return (type == Node::Type::Place ? 'P' : 'T') + std::to_string(id);
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Text displayed near a node the user can modify. Defaut value is
+    //! the string unique key().
+    //--------------------------------------------------------------------------
+    inline std::string caption() const
+    {
+        return (m_caption == nullptr) ? key() : *m_caption;
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Change the text displayed near the node. An empty text or a text
+    //! equal to key() restores the default caption. Other texts are interned
+    //! in a pool shared by all nodes: identical captions are stored once.
+    //--------------------------------------------------------------------------
+    void caption(std::string const& caption_);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return true if the caption is the default one (the key()). The
+    //! default caption follows the key when the node is renumbered.
+    //--------------------------------------------------------------------------
+    inline bool hasDefaultCaption() const { return m_caption == nullptr; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the settings of the net holding this node or the default
+    //! settings if the node has not been added to a net.
+    //--------------------------------------------------------------------------
+    NetSettings const& settings() const;
+
 public:
 
     //! \brief Type of nodes: Petri Place or Petri Transition. Once created, it
@@ -142,12 +222,6 @@ public:
     //! \brief Unique identifier (auto-incremented from 0 by the derived class).
     //! Once created, it is not supposed to be changed.
     size_t const id;
-    //! \brief Unique node identifier as string. It is formed by the 'P' char
-    //! for place or by the 'T' char for transition followed by the unique
-    //! identifier (i.e. "P0", "P1", "T0", "T1", ...). Once created, it is not
-    //! supposed to be changed.
-    //! \fixme: TBD to be replaced by a method instead ?
-    std::string const key;
     //! \brief Position inside the window needed for the display.
     //! \fixme: TBD to be moved inside the editor since we do not care of
     //! position.
@@ -156,17 +230,26 @@ public:
     //! \fixme: TBD to be moved inside the editor since we do not care of
     //! position.
     float y;
-    //! \brief Text displayed near a node the user can modify. Defaut value is
-    //! the tring unique \c key.
-    std::string caption;
     //! \brief Hold the incoming arcs to access to previous nodes.
-    //! \note this vector is not updated by this class but shall be made by
-    //! the caller.
+    //! \note this vector is not updated by this class but by the Net class
+    //! when adding or removing arcs. Arcs are sorted by their position in the
+    //! container of the net.
     std::vector<Arc*> arcsIn;
     //! \brief Hold the outcoming arcs to access to successor nodes.
-    //! \note this vector is not updated by this class but shall be made by
-    //! the caller.
+    //! \note this vector is not updated by this class but by the Net class
+    //! when adding or removing arcs. Arcs are sorted by their position in the
+    //! container of the net.
     std::vector<Arc*> arcsOut;
+
+private:
+
+    //! \brief to access m_settings
+    friend class Net;
+
+    //! \brief Interned caption or nullptr for the default caption key().
+    std::string const* m_caption = nullptr;
+    //! \brief Settings of the net holding this node (set by the Net class).
+    NetSettings const* m_settings = nullptr;
 };
 
 // *****************************************************************************
@@ -217,7 +300,7 @@ public:
     //--------------------------------------------------------------------------
     inline friend std::ostream& operator<<(std::ostream& os, Place const& p)
     {
-        os << p.key << " (\"" << p.caption << "\", " << p.tokens
+        os << p.key() << " (\"" << p.caption() << "\", " << p.tokens
            << ", (" << p.x << ", " << p.y << "))";
         return os;
     }
@@ -229,14 +312,74 @@ public:
     size_t tokens;
 };
 
+// *****************************************************************************
+//! \brief Law of the random delay of a transition, for stochastic simulations
+//! (see StochasticSimulator). Parameters depend on the law:
+//!   - Deterministic: a is the delay (0: immediate transition).
+//!   - Exponential: a is the rate (mean delay 1 / a).
+//!   - Uniform: the delay is between a and b.
+//!   - Erlang: sum of b (rounded) exponential delays of rate a.
+//!   - Weibull: a is the shape, b is the scale.
+// *****************************************************************************
+struct Distribution
+{
+    enum class Law { Deterministic, Exponential, Uniform, Erlang, Weibull };
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the name of the law ("exponential" for example).
+    //--------------------------------------------------------------------------
+    static const char* to_str(Law const law);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the law from its name.
+    //! \return false if the name is unknown.
+    //--------------------------------------------------------------------------
+    static bool from_str(std::string const& name, Law& law);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the mean delay.
+    //--------------------------------------------------------------------------
+    double mean() const;
+
+    //--------------------------------------------------------------------------
+    //! \brief Immediate transitions by default.
+    //--------------------------------------------------------------------------
+    inline bool isDefault() const
+    {
+        return (law == Law::Deterministic) && (a == 0.0f);
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Are all drawn delays null ?
+    //--------------------------------------------------------------------------
+    inline bool isImmediate() const
+    {
+        return ((law == Law::Deterministic) && (a == 0.0f)) ||
+               ((law == Law::Uniform) && (a == 0.0f) && (b == 0.0f));
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Check the parameters of the law: positive rate for exponential
+    //! and Erlang laws, at least one phase for Erlang laws, positive shape and
+    //! scale for Weibull laws, 0 <= a <= b for uniform laws and non-negative
+    //! deterministic delays.
+    //! \return the reason of invalid parameters or a dummy string.
+    //--------------------------------------------------------------------------
+    std::string check() const;
+
+    Law law = Law::Deterministic;
+    float a = 0.0f;
+    float b = 0.0f;
+};
+
 // *****************************************************************************
 //! \brief Petri Transition node. A boolean condition (named receptivity) is set
 //! but differ with the type of net (Petri: when the user click on the
 //! transition, timed Petri net: always set to true, GRAFCER depend on boolean
 //! expression with sensors). When the receptivity is true and the transition is
-//! enabled (meaning that all incoming places have at least one token each) the
-//! transition is fired and tokens in incoming places burnt and placed in
-//! outcoming places.
+//! enabled (meaning that all incoming places have at least as many tokens as
+//! the weight of their arc) the transition is fired and tokens in incoming
+//! places burnt and placed in outcoming places.
 //! \note There is currently no method for burning tokens because this is made
 //! by the simulator with animation.
 // *****************************************************************************
@@ -273,15 +416,15 @@ public:
     }
 
     //--------------------------------------------------------------------------
-    //! \brief Check if all immediatly incoming places have at least one token
-    //! on each of them.
+    //! \brief Check if all immediatly incoming places have at least as many
+    //! tokens as the weight of the arc linking them to this transition.
     //--------------------------------------------------------------------------
     bool isValidated() const;
 
     //--------------------------------------------------------------------------
     //! \brief Check if the transition has all its immediatly incoming places
-    //! with at leat one token and if the transitivity (bool expression) is
-    //! true.
+    //! with at least as many tokens as the weight of their arc (see
+    //! isValidated()) and if the transitivity (bool expression) is true.
     //! \note The burning of tokens is made by the PetriEditor class during the
     //! animation.
     //! \return true if can fire else return false.
@@ -290,7 +433,9 @@ public:
 
     //--------------------------------------------------------------------------
     //! \brief Return the maximum number of tokens that can be burn in
-    //! immediatly incoming places if and only if isFireable() is true.
+    //! immediatly incoming places if and only if isFireable() is true. With
+    //! weighted arcs, this is the number of times the transition can fire: an
+    //! incoming place burns this number multiplied by the weight of its arc.
     //! \note This method does not modify the number of tokens in previous
     //! places.
     //! \return the max number of tokens that be burnt or 0u if cannot fire.
@@ -343,7 +488,7 @@ public:
     //--------------------------------------------------------------------------
     friend std::ostream& operator<<(std::ostream& os, Transition const& t)
     {
-        os << t.key << " (\"" << t.caption << "\", " << t.receptivity
+        os << t.key() << " (\"" << t.caption() << "\", " << t.receptivity
            << ", (" << t.x << ", " << t.y << "))";
         return os;
     }
@@ -364,6 +509,11 @@ public:
     //! the result. The simulation will hold boolean expressions. This allows
     //! to separate things.
     bool receptivity = false;
+
+    //! \brief Random delay between the enabling and the firing of the
+    //! transition in stochastic simulations. Fluid simulations take the
+    //! inverse of its mean as the firing rate. Unused by other simulations.
+    Distribution delay;
 };
 
 // *****************************************************************************
@@ -384,11 +534,13 @@ public:
     //! \param[in] to_: Destination node (Place or Transition).
     //! \param[in] duration_: Duration of the process (in unit of time) if \c to_
     //! is a Place (else the duration is forced to NaN).
+    //! \param[in] weight_: Number of tokens consumed or produced by the arc.
     //! \note Nodes shall have different types. Assertion is made here.
     //--------------------------------------------------------------------------
-    Arc(Node& from_, Node& to_, float duration_ = 0.0f)
+    Arc(Node& from_, Node& to_, float duration_ = 0.0f, size_t weight_ = 1u)
         : from(from_), to(to_),
-          duration(from_.type == Node::Type::Transition ? duration_ : NAN)
+          duration(from_.type == Node::Type::Transition ? duration_ : NAN),
+          weight(weight_)
     {
         assert(from.type != to.type);
     }
@@ -407,14 +559,14 @@ public:
     //! \brief Needed because of usage of references.
     //--------------------------------------------------------------------------
     Arc(Arc const& other)
-        : Arc(other.from, other.to, other.duration)
+        : Arc(other.from, other.to, other.duration, other.weight)
     {}
 
     //--------------------------------------------------------------------------
     //! \brief Needed because of usage of references.
     //--------------------------------------------------------------------------
     Arc(Arc&& other)
-        : Arc(other.from, other.to, other.duration)
+        : Arc(other.from, other.to, other.duration, other.weight)
     {}
 
     //--------------------------------------------------------------------------
@@ -452,8 +604,8 @@ public:
     //--------------------------------------------------------------------------
     friend std::ostream& operator<<(std::ostream& os, Arc const& a)
     {
-        os << a.from.key << " \"" << a.from.caption << "\" -> "
-           << a.to.key << " \"" << a.to.caption << "\"";
+        os << a.from.key() << " \"" << a.from.caption() << "\" -> "
+           << a.to.key() << " \"" << a.to.caption() << "\"";
         return os;
     }
 
@@ -467,6 +619,11 @@ public:
     //! \note for the animation of tokens during the simulation, seconds are
     //! used.
     float duration;
+    //! \brief Multiplicity of the arc: number of tokens burnt in the origin
+    //! place (Place -> Transition) or deposited in the destination place
+    //! (Transition -> Place) each time the transition is fired. Shall be > 0.
+    //! Timed event graphs and GRAFCET only use weights of 1.
+    size_t weight = 1u;
     //! \brief Temporary memory used for counting tokens when they arrive to
     //! their destination node (place) and their conversion to an AnimatedToken
     //! instance. This variable is used for avoiding to display on the same
@@ -478,6 +635,57 @@ public:
     size_t count = 0u; // FIXME to be moved to the Editor class
 };
 
+// *****************************************************************************
+//! \brief Generation-checked handle on a Place or a Transition of a Net.
+//! Removing a node makes the latest node of the container take the location and
+//! the unique identifier of the removed one: pointers, references and
+//! identifiers held outside the net may then refer to another node. Handles
+//! stay attached to the same node until it is removed, and a handle on a
+//! removed node is detected as stale by Net::node() returning nullptr.
+//! Handles stay valid on copies of the net (i.e. for undo/redo).
+// *****************************************************************************
+struct NodeHandle
+{
+    bool operator==(NodeHandle const& other) const
+    {
+        return (type == other.type) && (slot == other.slot) &&
+               (generation == other.generation);
+    }
+
+    bool operator!=(NodeHandle const& other) const
+    {
+        return !(*this == other);
+    }
+
+    //! \brief Type of node: Place or Transition.
+    Node::Type type = Node::Type::Place;
+    //! \brief Stable slot inside the net. Invalid by default.
+    size_t slot = static_cast<size_t>(-1);
+    //! \brief Generation of the slot when the handle was created.
+    size_t generation = 0u;
+};
+
+// *****************************************************************************
+//! \brief Generation-checked handle on an Arc of a Net (see NodeHandle).
+// *****************************************************************************
+struct ArcHandle
+{
+    bool operator==(ArcHandle const& other) const
+    {
+        return (slot == other.slot) && (generation == other.generation);
+    }
+
+    bool operator!=(ArcHandle const& other) const
+    {
+        return !(*this == other);
+    }
+
+    //! \brief Stable slot inside the net. Invalid by default.
+    size_t slot = static_cast<size_t>(-1);
+    //! \brief Generation of the slot when the handle was created.
+    size_t generation = 0u;
+};
+
 // *****************************************************************************
 //! \brief Class storing and managing Places, Transitions and Arcs.
 //! This class does not offer method for the simulation but has to be seen as a
@@ -487,6 +695,7 @@ class Net
 {
     friend bool convertTo(Net& net, TypeOfNet const type, std::string& error,
                           std::vector<Arc*>& erroneous_arcs);
+    friend class NetBuilder;
 
 public:
 
@@ -494,26 +703,8 @@ public:
     using Transitions = std::deque<Transition>;
     using Arcs = std::deque<Arc>;
 
-    // *************************************************************************
-    //! \brief Settings for defining the type of net (GRAFCET, Petri net, timed
-    //! petri net, timed graph event ...). This structure is global for the
-    //! current net and is used by the Net class.
-    // *************************************************************************
-    struct Settings
-    {
-        //! \brief Max number of tokens in places. For GRAFCET: 1. For other
-        //! nets: +infinity (aka std::numeric_limits<size_t>::max()).
-        static size_t maxTokens;
-
-        //! \brief The theory would burn the maximum possibe of tokens that we
-        //! can within a single action (Fire::MaxPossible) but we can also try
-        //! to burn tokens one by one and randomize the transitions
-        //! (Fire::OneByOne). This will favor dispatching tokens along arcs.
-        enum class Fire { OneByOne, MaxPossible };
-
-        //! \brief Burn tokens one by one or as many as possible.
-        static Fire firing;
-    };
+    //! \brief Settings for defining the type of net.
+    using Settings = NetSettings;
 
     //--------------------------------------------------------------------------
     //! \brief Default constructor.
@@ -523,15 +714,28 @@ public:
     explicit Net(TypeOfNet const type = TypeOfNet::TimedPetriNet);
 
     //--------------------------------------------------------------------------
-    //! \brief Copy constructor. Needed to remove compilation warnings.
+    //! \brief Copy constructor. Nodes and arcs keep their position in their
+    //! container. Complexity is O(n) where n is the number of nodes and arcs.
     //--------------------------------------------------------------------------
     Net(Net const& other);
 
     //--------------------------------------------------------------------------
-    //! \brief Copy operator. Needed to remove compilation warnings.
+    //! \brief Copy operator. Same behavior than the copy constructor.
     //--------------------------------------------------------------------------
     Net& operator=(Net const& other);
 
+    //--------------------------------------------------------------------------
+    //! \brief Move constructor. Nodes and arcs are not relocated: references
+    //! and pointers to them remain valid and now refer to this net. The other
+    //! net is left empty.
+    //--------------------------------------------------------------------------
+    Net(Net&& other);
+
+    //--------------------------------------------------------------------------
+    //! \brief Move operator. Same behavior than the move constructor.
+    //--------------------------------------------------------------------------
+    Net& operator=(Net&& other);
+
     //--------------------------------------------------------------------------
     //! \brief Remove all nodes and arcs. Reset counters for unique identifiers.
     //! Change the type of net for the new one. Reset the name of the net (give
@@ -549,6 +753,17 @@ public:
     //--------------------------------------------------------------------------
     inline TypeOfNet type() const { return m_type; }
 
+    //--------------------------------------------------------------------------
+    //! \brief Return the settings of the net (set from the type of net).
+    //--------------------------------------------------------------------------
+    inline Settings const& settings() const { return m_settings; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Change the settings of the net. The number of tokens of places
+    //! is constrained by the new settings.
+    //--------------------------------------------------------------------------
+    void settings(Settings const& settings_);
+
     //--------------------------------------------------------------------------
     //! \brief Return true if the Petri nets has no nodes (no places and no
     //! transitions).
@@ -644,8 +859,8 @@ public:
 
     //--------------------------------------------------------------------------
     //! \brief Search and return a place or a transition by its unique
-    //! identifier. Search is O(n) where n is the number of nodes. Return
-    //! nullptr if not found.
+    //! identifier. Search is O(1) thanks to an internal index. Return nullptr
+    //! if not found.
     //! \param[in] key for example "P42" for the Place 42 or "T0" for the
     //! transition 0.
     //--------------------------------------------------------------------------
@@ -654,14 +869,14 @@ public:
 
     //--------------------------------------------------------------------------
     //! \brief Search and return a Transition by its unique identifier. Search
-    //! is O(n) where n is the number of nodes. Return nullptr if not found.
+    //! is O(1) thanks to an internal index. Return nullptr if not found.
     //! \param[in] id for example 42 for the Transition 42.
     //--------------------------------------------------------------------------
     Transition* findTransition(size_t const id);
 
     //--------------------------------------------------------------------------
     //! \brief Search and return a Place by its unique identifier. Search
-    //! is O(n) where n is the number of nodes. Return nullptr if not found.
+    //! is O(1) thanks to an internal index. Return nullptr if not found.
     //! \param[in] id for example 42 for the Place 42.
     //--------------------------------------------------------------------------
     Place* findPlace(size_t const id);
@@ -682,6 +897,18 @@ public:
     //--------------------------------------------------------------------------
     bool addArc(Node& from, Node& to, float const duration = 0.0f);
 
+    //--------------------------------------------------------------------------
+    //! \brief Add a weighted arc between a Place and a Transition. Only the
+    //! Place -> Transition and Transition -> Place cases are offered since the
+    //! weight would be ambiguous on intermediate arcs.
+    //! \param[in] weight: number of tokens consumed (Place -> Transition) or
+    //! produced (Transition -> Place) by each firing. Shall not be 0.
+    //! \return true if the arc is valid and has been added. Else return false
+    //! and call message() to get the exact reason.
+    //--------------------------------------------------------------------------
+    bool addArc(Place& from, Transition& to, float const duration, size_t const weight);
+    bool addArc(Transition& from, Place& to, float const duration, size_t const weight);
+
     //--------------------------------------------------------------------------
     //! \brief Add an arc with an intermediate place between the two given
     //! transitions. This method is usefull for timed event graph.
@@ -694,10 +921,32 @@ public:
     //! \param[in] to: destination node (Place or Transition but not of the same
     //! type than the destination node).
     //! \return the address of the arc if found, else return nullptr.
+    //! \note Search is O(1) thanks to an internal index.
     //--------------------------------------------------------------------------
     Arc* findArc(Node const& from, Node const& to);
     Arc const* findArc(Node const& from, Node const& to) const;
 
+    //--------------------------------------------------------------------------
+    //! \brief Return the handle on the given node or arc of this net. Return an
+    //! invalid handle if the element does not belong to this net.
+    //--------------------------------------------------------------------------
+    NodeHandle handle(Node const& node) const;
+    ArcHandle handle(Arc const& arc) const;
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the node referred by the given handle or nullptr if the
+    //! node has been removed. Complexity is O(1).
+    //--------------------------------------------------------------------------
+    Node* node(NodeHandle const& handle);
+    Node const* node(NodeHandle const& handle) const;
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the arc referred by the given handle or nullptr if the
+    //! arc has been removed. Complexity is O(1).
+    //--------------------------------------------------------------------------
+    Arc* arc(ArcHandle const& handle);
+    Arc const* arc(ArcHandle const& handle) const;
+
     //--------------------------------------------------------------------------
     //! \brief Const getter of all arcs.
     //--------------------------------------------------------------------------
@@ -727,10 +976,21 @@ public:
 
     //--------------------------------------------------------------------------
     //! \brief Populate or update Node::arcsIn and Node::arcsOut for all
-    //! transitions and places in the Petri net.
+    //! transitions and places in the Petri net. Complexity is O(n) where n is
+    //! the number of nodes and arcs.
+    //! \note Adding or removing arcs and nodes already update incrementally
+    //! Node::arcsIn and Node::arcsOut of impacted nodes: this method is only
+    //! needed when arcs have been modified directly.
     //--------------------------------------------------------------------------
     void generateArcsInArcsOut(); // FIXME a placer dana protected
 
+    //--------------------------------------------------------------------------
+    //! \brief Debug consistency check: return true if Node::arcsIn and
+    //! Node::arcsOut of all nodes are the ones generateArcsInArcsOut() would
+    //! produce. Complexity is O(n) where n is the number of nodes and arcs.
+    //--------------------------------------------------------------------------
+    bool sanityArcsInArcsOut() const;
+
     //--------------------------------------------------------------------------
     //! \brief Set to false the receptivity for all transitions.
     //--------------------------------------------------------------------------
@@ -772,10 +1032,179 @@ protected:
     //--------------------------------------------------------------------------
     void helperRemoveArcFromNode(Node& node);
 
+    //--------------------------------------------------------------------------
+    //! \brief Helper method creating an arc between two nodes of different
+    //! types and referencing it in the index of arcs. No sanity checks are
+    //! made.
+    //--------------------------------------------------------------------------
+    Arc& helperAddArc(Node& from, Node& to, float const duration,
+                      size_t const weight = 1u);
+
+    //--------------------------------------------------------------------------
+    //! \brief Common code of the weighted addArc(): check the arc and its
+    //! weight before adding it.
+    //--------------------------------------------------------------------------
+    bool addWeightedArc(Node& from, Node& to, float const duration,
+                        size_t const weight);
+
+    //--------------------------------------------------------------------------
+    //! \brief Helper method removing the arc at the given position in the
+    //! container. For fastest deletion, the latest arc of the container takes
+    //! its location.
+    //--------------------------------------------------------------------------
+    void helperRemoveArc(size_t const i);
+
+    //--------------------------------------------------------------------------
+    //! \brief Populate the indices of places, transitions and arcs from
+    //! scratch. Complexity is O(n) where n is the number of nodes and arcs.
+    //--------------------------------------------------------------------------
+    void generateIndices();
+
+    //--------------------------------------------------------------------------
+    //! \brief Make all nodes refer to the settings of this net. Needed when
+    //! nodes come from another net.
+    //--------------------------------------------------------------------------
+    void bindSettings();
+
+private:
+
+    // *************************************************************************
+    //! \brief Key of the index of arcs. Made of the type and the unique
+    //! identifier of the origin and destination nodes.
+    // *************************************************************************
+    struct ArcKey
+    {
+        ArcKey(Node const& from_, Node const& to_)
+            : from(from_.id), to(to_.id), from_type(from_.type),
+              to_type(to_.type)
+        {}
+
+        bool operator==(ArcKey const& other) const
+        {
+            return (from == other.from) && (to == other.to) &&
+                   (from_type == other.from_type) && (to_type == other.to_type);
+        }
+
+        size_t from;
+        size_t to;
+        Node::Type from_type;
+        Node::Type to_type;
+    };
+
+    // *************************************************************************
+    //! \brief Hash function for the index of arcs.
+    // *************************************************************************
+    struct ArcKeyHash
+    {
+        size_t operator()(ArcKey const& key) const
+        {
+            size_t h = std::hash<size_t>()(key.from) ^ size_t(key.from_type);
+            size_t const g = std::hash<size_t>()(key.to) ^ size_t(key.to_type);
+            h ^= g + 0x9e3779b9u + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+
+    // *************************************************************************
+    //! \brief Map the stable slots of handles to the position of elements in
+    //! their container. The container and the slot map shall be modified
+    //! together: push() after pushing an element at the end of the container,
+    //! erase() when the latest element of the container takes the location of
+    //! the removed element. Slots of removed elements are recycled with a new
+    //! generation.
+    // *************************************************************************
+    class SlotMap
+    {
+    public:
+
+        //! \brief Give a slot to the element pushed at the end of the
+        //! container.
+        size_t push()
+        {
+            size_t slot;
+            if (m_free.empty())
+            {
+                slot = m_slots.size();
+                m_slots.push_back(Slot());
+            }
+            else
+            {
+                slot = m_free.back();
+                m_free.pop_back();
+            }
+            m_slots[slot].position = m_slot_of.size();
+            m_slot_of.push_back(slot);
+            return slot;
+        }
+
+        //! \brief Free the slot of the element at the given position. The
+        //! latest element of the container takes its location.
+        void erase(size_t const position)
+        {
+            size_t const last = m_slot_of.size() - 1u;
+            size_t const slot = m_slot_of[position];
+            m_slots[slot].generation += 1u;
+            m_free.push_back(slot);
+            if (position != last)
+            {
+                m_slot_of[position] = m_slot_of[last];
+                m_slots[m_slot_of[position]].position = position;
+            }
+            m_slot_of.pop_back();
+        }
+
+        //! \brief Return the position of the element in its container or
+        //! size_t(-1) if the slot is stale.
+        size_t position(size_t const slot, size_t const generation) const
+        {
+            if ((slot >= m_slots.size()) || (m_slots[slot].generation != generation))
+                return static_cast<size_t>(-1);
+            return m_slots[slot].position;
+        }
+
+        //! \brief Return the slot of the element at the given position.
+        inline size_t slot(size_t const position) const
+        {
+            return m_slot_of[position];
+        }
+
+        //! \brief Return the current generation of the given slot.
+        inline size_t generation(size_t const slot) const
+        {
+            return m_slots[slot].generation;
+        }
+
+        void clear()
+        {
+            m_slots.clear();
+            m_free.clear();
+            m_slot_of.clear();
+        }
+
+    private:
+
+        struct Slot
+        {
+            //! \brief Position of the element in its container.
+            size_t position = 0u;
+            //! \brief Incremented each time the element is removed.
+            size_t generation = 0u;
+        };
+
+        //! \brief Slots referred by handles.
+        std::vector<Slot> m_slots;
+        //! \brief Removed slots that can be recycled.
+        std::vector<size_t> m_free;
+        //! \brief Position in the container -> slot.
+        std::vector<size_t> m_slot_of;
+    };
+
 private:
 
     //! \brief Type of net GRAFCET, Petri, Timed Petri ...
     TypeOfNet m_type;
+    //! \brief Settings of the net. Nodes refer to it.
+    Settings m_settings;
     //! \brief List of Places. We do not use std::vector to avoid invalidating
     //! node references for arcs after a possible resizing.
     Places m_places;
@@ -784,6 +1213,18 @@ private:
     Transitions m_transitions;
     //! \brief List of Arcs.
     Arcs m_arcs;
+    //! \brief Index of places: unique identifier -> position in m_places.
+    std::unordered_map<size_t, size_t> m_place_indices;
+    //! \brief Index of transitions: unique identifier -> position in
+    //! m_transitions.
+    std::unordered_map<size_t, size_t> m_transition_indices;
+    //! \brief Index of arcs: origin and destination nodes -> position in
+    //! m_arcs.
+    std::unordered_map<ArcKey, size_t, ArcKeyHash> m_arc_indices;
+    //! \brief Stable slots of handles on places, transitions and arcs.
+    SlotMap m_place_slots;
+    SlotMap m_transition_slots;
+    SlotMap m_arc_slots;
     //! \brief Auto increment unique identifier. Start from 0 (code placed in
     //! the cpp file).
     size_t m_next_place_id = 0u;
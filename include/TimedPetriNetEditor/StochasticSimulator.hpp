@@ -0,0 +1,209 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef STOCHASTIC_SIMULATOR_HPP
+#  define STOCHASTIC_SIMULATOR_HPP
+
+#  include "TimedPetriNetEditor/TimedSimulator.hpp"
+#  include "TimedPetriNetEditor/IndexedHeap.hpp"
+
+namespace tpne {
+
+// *****************************************************************************
+//! \brief Headless simulation of a stochastic Petri net: each transition has a
+//! random delay (see Transition::delay) between its enabling and its firing.
+//! Firing is atomic: tokens are burnt in upstream places and deposited in
+//! downstream places at the same instant; durations of arcs are not used.
+//!
+//! The kernel is the next reaction method of Gibson and Bruck: enabled
+//! transitions are stored with their firing time in an indexed min-heap, and
+//! the earliest one is fired. After a firing, only the transitions sharing
+//! places with the fired one (precomputed dependency graph) are enabled,
+//! disabled or kept: the cost of an event is O(d log n) with d the number of
+//! dependent transitions, whatever the size of the net.
+//!
+//! Transitions are single-server with enabling memory: the delay is drawn when
+//! the transition becomes enabled, kept while it stays enabled and drawn again
+//! after each firing. Ties are fired by increasing identifiers. With
+//! exponential delays, the simulation is the one of the Gillespie algorithm.
+//!
+//! Delays are drawn from a SplitMix64 generator with hand written samplers:
+//! same seeds give same simulations on all platforms.
+// *****************************************************************************
+class StochasticSimulator
+{
+public:
+
+    //--------------------------------------------------------------------------
+    //! \brief Empty simulator. Call reset() to simulate a net.
+    //--------------------------------------------------------------------------
+    StochasticSimulator() = default;
+
+    //--------------------------------------------------------------------------
+    //! \brief Compile the net and reset the simulation. Call error() to know if
+    //! the compilation has failed.
+    //--------------------------------------------------------------------------
+    explicit StochasticSimulator(Net const& net, uint64_t const seed = 0u);
+
+    //--------------------------------------------------------------------------
+    //! \brief Compile the net with its current marking, receptivities and
+    //! delays of transitions, set the simulated time to 0 and draw the delays
+    //! of enabled transitions. Observers are kept.
+    //! \return false if the net cannot be compiled, if the parameters of a
+    //! delay are invalid (see Distribution::check()) or if immediate
+    //! transitions could fire forever without letting the time advance
+    //! (immediate transitions without upstream place or in a cycle of
+    //! immediate transitions). See error(). Nothing is then scheduled.
+    //--------------------------------------------------------------------------
+    bool reset(Net const& net, uint64_t const seed = 0u);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the reason of the latest failure of reset().
+    //--------------------------------------------------------------------------
+    inline std::string const& error() const
+    {
+        return m_error.empty() ? m_compiled.error() : m_error;
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Override the delay of the transition. Used for its next drawn
+    //! delay. Valid until the next reset(). Unlike reset(), the delay is not
+    //! checked.
+    //--------------------------------------------------------------------------
+    inline void delay(size_t const transition, Distribution const& law)
+    {
+        m_delays[transition] = law;
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the delay of the transition.
+    //--------------------------------------------------------------------------
+    inline Distribution const& delay(size_t const transition) const
+    {
+        return m_delays[transition];
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Register an observer of firings (TimedSimulator::Observer::onFired()
+    //! only). It shall outlive the simulator or be removed before.
+    //--------------------------------------------------------------------------
+    void addObserver(TimedSimulator::Observer& observer);
+    void removeObserver(TimedSimulator::Observer& observer);
+
+    //--------------------------------------------------------------------------
+    //! \brief Fire the earliest scheduled transition.
+    //! \return false if no transition is enabled: the simulation is stuck.
+    //--------------------------------------------------------------------------
+    bool step();
+
+    //--------------------------------------------------------------------------
+    //! \brief Fire transitions until the given time or until the given number
+    //! of firings is reached. The current time is then set to the given time
+    //! if reached.
+    //! \return the number of firings.
+    //--------------------------------------------------------------------------
+    size_t runUntil(double const time, size_t const firings = static_cast<size_t>(-1));
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the current simulated time.
+    //--------------------------------------------------------------------------
+    inline double time() const { return m_time; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Is a transition scheduled ? If not, the simulation is stuck.
+    //--------------------------------------------------------------------------
+    inline bool waiting() const { return !m_schedule.empty(); }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the time of the next firing. The simulator shall be
+    //! waiting().
+    //--------------------------------------------------------------------------
+    inline double nextTime() const { return m_schedule.key(m_schedule.top()); }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of firings since the reset(), of all
+    //! transitions or of the given one.
+    //--------------------------------------------------------------------------
+    inline size_t firings() const { return m_firings; }
+    inline size_t firings(size_t const transition) const { return m_counts[transition]; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the mean number of firings of the transition per unit of
+    //! time since the reset().
+    //--------------------------------------------------------------------------
+    double throughput(size_t const transition) const;
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the mean number of tokens of the place over the simulated
+    //! time since the reset().
+    //--------------------------------------------------------------------------
+    double meanTokens(size_t const place) const;
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the compiled net holding the marking.
+    //--------------------------------------------------------------------------
+    inline CompiledNet const& compiled() const { return m_compiled; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Draw a delay from the law. Exposed for the tests.
+    //--------------------------------------------------------------------------
+    static double sample(Distribution const& law, FiringPolicy::Random& random);
+
+private:
+
+    void fire(size_t const transition);
+    void schedule(size_t const transition);
+    void integrate(size_t const place);
+    bool checkImmediateCycles(Net const& net);
+
+private:
+
+    //! \brief Snapshot of the simulated net.
+    CompiledNet m_compiled;
+    //! \brief Reason of the latest failure of reset() not related to the
+    //! compilation.
+    std::string m_error;
+    //! \brief Delay of transitions.
+    std::vector<Distribution> m_delays;
+    //! \brief Dependency graph in CSR form: transitions sharing places with
+    //! the transition t are m_dependents[m_dependent_offsets[t]] to
+    //! m_dependents[m_dependent_offsets[t + 1] - 1].
+    std::vector<CompiledNet::Index> m_dependent_offsets;
+    std::vector<CompiledNet::Index> m_dependents;
+    //! \brief Enabled transitions keyed by their firing time.
+    IndexedHeap<double> m_schedule;
+    //! \brief Current simulated time.
+    double m_time = 0.0;
+    //! \brief Number of firings since the reset(), of all transitions and of
+    //! each one.
+    size_t m_firings = 0u;
+    std::vector<size_t> m_counts;
+    //! \brief Integral of the number of tokens of places until m_since.
+    std::vector<double> m_areas;
+    std::vector<double> m_since;
+    //! \brief Random generator of delays.
+    FiringPolicy::Random m_random;
+    //! \brief Notified of firings.
+    std::vector<TimedSimulator::Observer*> m_observers;
+};
+
+} // namespace tpne
+
+#endif
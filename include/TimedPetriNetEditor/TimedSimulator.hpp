@@ -0,0 +1,471 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef TIMED_SIMULATOR_HPP
+#  define TIMED_SIMULATOR_HPP
+
+#  include "TimedPetriNetEditor/CompiledNet.hpp"
+#  include "TimedPetriNetEditor/FiringPolicy.hpp"
+#  include "TimedPetriNetEditor/TokenQueue.hpp"
+#  include <chrono>
+
+namespace tpne {
+
+// *****************************************************************************
+//! \brief Headless discrete-event simulation of a Petri net, independent of the
+//! editor and of the frame rate. When a transition fires, tokens are burnt in
+//! its upstream places and depart along its arcs Transition -> Place: they are
+//! deposited in the downstream places once the duration of the arc is elapsed.
+//! Pending arrivals are stored in a priority queue keyed by simulated time, so
+//! the simulator jumps directly from one event to the next one.
+//!
+//! Tokens departing along the same arc at the same instant are grouped into a
+//! single arrival. For timed Petri nets and timed event graphs, the delay of
+//! arcs is their duration. For Petri nets and GRAFCET, the theory gives no
+//! delay: tokens arrive instantaneously (see delay() to override it).
+//!
+//! Places may have a holding time (see holding()): tokens arriving in them
+//! stay in the place but only enable transitions once the holding time is
+//! elapsed. Their availability times are kept in a TokenQueue per place, so
+//! transitions fire at the earliest time their tokens are available.
+//!
+//! Observers are notified of firings, departures and arrivals: the animation
+//! of the editor is one of them.
+//!
+//! \note The structure of the net is compiled when reset() is called. The
+//! marking and the receptivities can be exchanged with the Net through
+//! compiled().readMarking() and compiled().writeMarking().
+// *****************************************************************************
+class TimedSimulator
+{
+public:
+
+    // *************************************************************************
+    //! \brief Interface for being notified of the events of the simulation.
+    //! Transitions and places are referred by their identifier, arcs by their
+    //! position in the Net.
+    // *************************************************************************
+    class Observer
+    {
+    public:
+
+        virtual ~Observer() = default;
+
+        //----------------------------------------------------------------------
+        //! \brief The transition has been fired the given number of times.
+        //----------------------------------------------------------------------
+        virtual void onFired(double const /*time*/, size_t const /*transition*/,
+                             size_t const /*count*/) {}
+
+        //----------------------------------------------------------------------
+        //! \brief Tokens are departing along the arc Transition -> Place and
+        //! will arrive at the given time.
+        //----------------------------------------------------------------------
+        virtual void onDeparted(double const /*time*/, size_t const /*arc*/,
+                                size_t const /*tokens*/, double const /*arrival*/) {}
+
+        //----------------------------------------------------------------------
+        //! \brief Tokens carried by the arc have been deposited in the place.
+        //----------------------------------------------------------------------
+        virtual void onArrived(double const /*time*/, size_t const /*arc*/,
+                               size_t const /*place*/, size_t const /*tokens*/) {}
+    };
+
+    //--------------------------------------------------------------------------
+    //! \brief Tokens carried by an arc Transition -> Place.
+    //--------------------------------------------------------------------------
+    struct Event
+    {
+        //! \brief Simulated time of the arrival.
+        double time;
+        //! \brief Order of creation, for ordering events of the same time.
+        uint64_t sequence;
+        //! \brief Offset of the arc in the CSR arrays of the compiled net.
+        CompiledNet::Index offset;
+        //! \brief Number of carried tokens.
+        CompiledNet::Count tokens;
+    };
+
+    //--------------------------------------------------------------------------
+    //! \brief Full state of the simulation, for going back to a past time or
+    //! for branching a what-if simulation. See save() and restore().
+    //--------------------------------------------------------------------------
+    struct Checkpoint
+    {
+        //! \brief Simulated time.
+        double time = 0.0;
+        //! \brief Order of creation of the next event.
+        uint64_t sequence = 0u;
+        //! \brief Number of firings since the reset().
+        size_t firings = 0u;
+        //! \brief State of the random generator of each conflict cluster.
+        std::vector<uint64_t> random;
+        //! \brief State of the firing policy (see FiringPolicy::save()).
+        std::vector<uint64_t> policy;
+        //! \brief Marking.
+        std::vector<CompiledNet::Count> tokens;
+        //! \brief Receptivities of transitions (0 or 1).
+        std::vector<uint8_t> receptivities;
+        //! \brief Transitions which may have become fireable.
+        std::vector<CompiledNet::Index> candidates;
+        //! \brief Tokens in flight along arcs, as a heap.
+        std::vector<Event> events;
+        //! \brief Tokens held in places, by place then by availability time.
+        std::vector<std::pair<CompiledNet::Index, TokenQueue::Run>> held;
+    };
+
+    //--------------------------------------------------------------------------
+    //! \brief Empty simulator. Call reset() to simulate a net.
+    //--------------------------------------------------------------------------
+    TimedSimulator() = default;
+
+    //--------------------------------------------------------------------------
+    //! \brief Compile the net and reset the simulation. Call error() to know if
+    //! the compilation has failed.
+    //--------------------------------------------------------------------------
+    explicit TimedSimulator(Net const& net);
+
+    //--------------------------------------------------------------------------
+    //! \brief Compile the net with its current marking and receptivities,
+    //! clear pending events and set the simulated time to 0. Observers are
+    //! kept.
+    //! \return false if the net cannot be compiled (see error()).
+    //--------------------------------------------------------------------------
+    bool reset(Net const& net);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the reason of the latest failure of reset().
+    //--------------------------------------------------------------------------
+    inline std::string const& error() const { return m_compiled.error(); }
+
+    //--------------------------------------------------------------------------
+    //! \brief Seed the random generators used for choosing the order in which
+    //! transitions are fired and restart them. Each conflict cluster draws from
+    //! its own generator, derived from the seed and the cluster: same seeds
+    //! give same simulations, whatever the clusters fired in between.
+    //--------------------------------------------------------------------------
+    void seed(uint32_t const value);
+
+    //--------------------------------------------------------------------------
+    //! \brief Set the policy choosing the order in which transitions in
+    //! conflict are fired (RandomPolicy by default). It is reset for the
+    //! compiled net.
+    //--------------------------------------------------------------------------
+    void policy(std::unique_ptr<FiringPolicy> policy);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the firing policy, for configuring it.
+    //--------------------------------------------------------------------------
+    inline FiringPolicy& policy() { return *m_policy.pointer; }
+    inline FiringPolicy const& policy() const { return *m_policy.pointer; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Register an observer. It shall outlive the simulator or be
+    //! removed before being destroyed.
+    //--------------------------------------------------------------------------
+    void addObserver(Observer& observer);
+
+    //--------------------------------------------------------------------------
+    //! \brief Unregister an observer.
+    //--------------------------------------------------------------------------
+    void removeObserver(Observer& observer);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the registered observers.
+    //--------------------------------------------------------------------------
+    inline std::vector<Observer*> const& observers() const { return m_observers; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Override the delay of the arc Transition -> Place given by its
+    //! offset in the CSR arrays of the compiled net (see
+    //! CompiledNet::postOffset()). Valid until the next reset().
+    //--------------------------------------------------------------------------
+    inline void delay(size_t const offset, float const value)
+    {
+        m_delays[offset] = value;
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the delay of the arc Transition -> Place given by its
+    //! offset in the CSR arrays of the compiled net.
+    //--------------------------------------------------------------------------
+    inline float delay(size_t const offset) const { return m_delays[offset]; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Forward the tokens departing along the arc Transition -> Place
+    //! given by its offset in the CSR arrays of the compiled net, instead of
+    //! scheduling their arrival: they are appended to outbox(). Used when the
+    //! place is simulated by another simulator (see ParallelSimulator). Valid
+    //! until the next reset().
+    //--------------------------------------------------------------------------
+    inline void forward(size_t const offset) { m_forwarded[offset] = 1u; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the forwarded tokens not yet taken. The caller clears it
+    //! once they are sent.
+    //--------------------------------------------------------------------------
+    inline std::vector<Event>& outbox() { return m_outbox; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Schedule the arrival of tokens forwarded by another simulator.
+    //! Their arrival time shall not be earlier than the current time.
+    //--------------------------------------------------------------------------
+    void receive(Event const& event);
+
+    //--------------------------------------------------------------------------
+    //! \brief Set the holding time of the place: tokens arriving in it are
+    //! available for firing transitions once this time is elapsed. Tokens
+    //! already held keep their availability time. Valid until the next
+    //! reset().
+    //--------------------------------------------------------------------------
+    void holding(size_t const place, float const value);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the holding time of the place (0 by default).
+    //--------------------------------------------------------------------------
+    inline float holding(size_t const place) const { return m_holdings[place]; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the tokens of the place which are not yet available.
+    //--------------------------------------------------------------------------
+    inline TokenQueue const& held(size_t const place) const { return m_queues[place]; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of tokens in the place: available ones (see
+    //! compiled().tokens()) and held ones.
+    //--------------------------------------------------------------------------
+    inline size_t tokens(size_t const place) const
+    {
+        return size_t(m_compiled.tokens(place)) + m_queues[place].tokens();
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Fire all fireable transitions at the current time until none of
+    //! them can be fired, then make tokens depart along arcs.
+    //!
+    //! With the firing policy NetSettings::Fire::OneByOne, transitions are
+    //! fired once per round in a random order until tokens run out. Rounds
+    //! where places hold enough tokens for all fireable transitions are made in
+    //! bulk, so the cost does not depend on the number of tokens. The order is
+    //! only chosen between fireable transitions of a same conflict cluster
+    //! (see CompiledNet::cluster()): others are fired in bulk. The random order
+    //! can be replaced by another conflict resolution (see policy()).
+    //! \return the number of times transitions have been fired.
+    //--------------------------------------------------------------------------
+    size_t fire();
+
+    //--------------------------------------------------------------------------
+    //! \brief Fire transitions at the current time then jump to the time of the
+    //! next pending arrival or availability of held tokens, and deposit all
+    //! tokens arriving or becoming available at this time.
+    //! \return false if there was no pending arrival nor held token: the
+    //! simulation is stuck until the marking or receptivities are modified.
+    //--------------------------------------------------------------------------
+    bool step();
+
+    //--------------------------------------------------------------------------
+    //! \brief Simulate until the given time: fire transitions and process all
+    //! arrivals up to this time. The current time is then set to the given
+    //! time.
+    //! \note A cycle of arcs without delay and with always true receptivities
+    //! never lets the time elapse.
+    //! \return the number of firings.
+    //--------------------------------------------------------------------------
+    size_t runUntil(double const time);
+
+    //--------------------------------------------------------------------------
+    //! \brief Simulate as runUntil(time) but stop early once the given number
+    //! of firings is reached (instants are not split: it may be exceeded), or
+    //! once the wall-clock deadline is passed. In both cases, the current time
+    //! is the one of the latest processed arrival and the simulation can be
+    //! continued by calling again this method.
+    //! \return the number of firings.
+    //--------------------------------------------------------------------------
+    size_t runUntil(double const time, size_t const firings,
+                    std::chrono::steady_clock::time_point const deadline);
+
+    //--------------------------------------------------------------------------
+    //! \brief Save the state of the simulation. The simulation restored from
+    //! the checkpoint fires transitions in the same order than the one
+    //! continued after save().
+    //--------------------------------------------------------------------------
+    void save(Checkpoint& checkpoint) const;
+
+    //--------------------------------------------------------------------------
+    //! \brief Go back to a state saved from the same compiled net. Delays of
+    //! arcs and observers are kept.
+    //--------------------------------------------------------------------------
+    void restore(Checkpoint const& checkpoint);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the pending arrivals, as a heap on (time, sequence).
+    //--------------------------------------------------------------------------
+    inline std::vector<Event> const& events() const { return m_events; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the current simulated time.
+    //--------------------------------------------------------------------------
+    inline double time() const { return m_time; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of times transitions have been fired since the
+    //! latest reset().
+    //--------------------------------------------------------------------------
+    inline size_t firings() const { return m_firings; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of pending arrivals.
+    //--------------------------------------------------------------------------
+    inline size_t pending() const { return m_events.size(); }
+
+    //--------------------------------------------------------------------------
+    //! \brief Is there a pending arrival or a held token ? If not, the time
+    //! cannot elapse.
+    //--------------------------------------------------------------------------
+    inline bool waiting() const
+    {
+        return (!m_events.empty()) || (!m_releases.empty());
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the time of the next pending arrival or availability of
+    //! held tokens. The simulator shall be waiting().
+    //--------------------------------------------------------------------------
+    inline double nextTime() const
+    {
+        assert(waiting());
+        if (m_releases.empty())
+            return m_events.front().time;
+        if (m_events.empty())
+            return m_releases.front().time;
+        return std::min(m_events.front().time, m_releases.front().time);
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the compiled net holding the marking and receptivities.
+    //--------------------------------------------------------------------------
+    inline CompiledNet& compiled() { return m_compiled; }
+    inline CompiledNet const& compiled() const { return m_compiled; }
+
+private:
+
+    //--------------------------------------------------------------------------
+    //! \brief Held tokens of the place becoming available at the time.
+    //--------------------------------------------------------------------------
+    struct Release
+    {
+        //! \brief Order of the min-heap of releases.
+        inline bool operator>(Release const& other) const
+        {
+            return (time > other.time) || ((time == other.time) && (place > other.place));
+        }
+
+        double time;
+        CompiledNet::Index place;
+    };
+
+    // *************************************************************************
+    //! \brief Owner of the firing policy, cloned when the simulator is copied.
+    // *************************************************************************
+    struct Policy
+    {
+        Policy() : pointer(new RandomPolicy()) {}
+        Policy(Policy const& other) : pointer(other.pointer->clone()) {}
+        Policy(Policy&&) = default;
+        Policy& operator=(Policy const& other)
+        {
+            pointer = other.pointer->clone();
+            return *this;
+        }
+        Policy& operator=(Policy&&) = default;
+
+        std::unique_ptr<FiringPolicy> pointer;
+    };
+
+private:
+
+    size_t fireAlone(size_t const transition);
+    size_t fireCluster(size_t const cluster);
+    size_t fireRounds();
+    void fireTransition(size_t const transition, size_t const count);
+    void arrive();
+    void hold(size_t const place, double const time, size_t const tokens);
+
+private:
+
+    //! \brief Snapshot of the simulated net.
+    CompiledNet m_compiled;
+    //! \brief Type of the simulated net.
+    TypeOfNet m_type = TypeOfNet::TimedPetriNet;
+    //! \brief Delay of arcs Transition -> Place (indexed by CSR offsets).
+    std::vector<float> m_delays;
+    //! \brief Origin transition of arcs Transition -> Place (indexed by CSR
+    //! offsets).
+    std::vector<CompiledNet::Index> m_sources;
+    //! \brief Pending arrivals as a min-heap on (time, sequence).
+    std::vector<Event> m_events;
+    //! \brief Arcs whose tokens are forwarded (indexed by CSR offsets).
+    std::vector<uint8_t> m_forwarded;
+    //! \brief Forwarded tokens not yet taken by the caller.
+    std::vector<Event> m_outbox;
+    //! \brief Holding time of places.
+    std::vector<float> m_holdings;
+    //! \brief Tokens held in places (indexed by places).
+    std::vector<TokenQueue> m_queues;
+    //! \brief Places whose holding time has been set since the reset().
+    std::vector<CompiledNet::Index> m_holding_places;
+    //! \brief One release per run of held tokens, as a min-heap on (time,
+    //! place).
+    std::vector<Release> m_releases;
+    //! \brief Order of creation of the next event.
+    uint64_t m_sequence = 0u;
+    //! \brief Current simulated time.
+    double m_time = 0.0;
+    //! \brief Number of firings since the latest reset().
+    size_t m_firings = 0u;
+    //! \brief Transitions which may be fireable.
+    std::vector<size_t> m_candidates;
+    //! \brief Candidates of the conflict cluster being fired, tried in the
+    //! order of the firing policy.
+    std::vector<size_t> m_group;
+    //! \brief Transitions fired during the current round.
+    std::vector<size_t> m_fired;
+    //! \brief Number of tokens needed from places for a round of firings.
+    std::vector<size_t> m_demands;
+    std::vector<size_t> m_demanded_places;
+    //! \brief Number of tokens carried by arcs Transition -> Place during the
+    //! current instant (indexed by CSR offsets).
+    std::vector<size_t> m_carried_tokens;
+    //! \brief CSR offsets of arcs carrying tokens during the current instant.
+    std::vector<size_t> m_carrying_arcs;
+    //! \brief Seed of the random generators.
+    uint32_t m_seed = 0u;
+    //! \brief Random generator for the order of firing (indexed by conflict
+    //! clusters).
+    std::vector<FiringPolicy::Random> m_random;
+    //! \brief Conflict resolution.
+    Policy m_policy;
+    //! \brief Notified of events.
+    std::vector<Observer*> m_observers;
+};
+
+} // namespace tpne
+
+#endif
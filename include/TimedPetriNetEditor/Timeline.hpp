@@ -0,0 +1,132 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef TIMELINE_HPP
+#  define TIMELINE_HPP
+
+#  include "TimedPetriNetEditor/TimedSimulator.hpp"
+
+namespace tpne {
+
+// *****************************************************************************
+//! \brief History of snapshots of a TimedSimulator, for rewinding it to any
+//! past simulated time without simulating again from the time zero.
+//!
+//! Snapshots are delta-encoded: only places and receptivities modified since
+//! the previous snapshot are stored. Every N snapshots, a key frame stores the
+//! whole marking so that restoring a snapshot applies at most N deltas. Tokens
+//! in flight and tokens held in places are few and are stored in each snapshot.
+//!
+//! A what-if branch is made by rewinding a copy of the simulator. Taking a
+//! snapshot earlier than the latest one forgets the snapshots after it: the
+//! timeline then follows the new branch.
+// *****************************************************************************
+class Timeline
+{
+public:
+
+    //--------------------------------------------------------------------------
+    //! \brief Set the number of snapshots between two key frames.
+    //--------------------------------------------------------------------------
+    explicit Timeline(size_t const keyframes = 32u);
+
+    //--------------------------------------------------------------------------
+    //! \brief Forget all snapshots.
+    //--------------------------------------------------------------------------
+    void clear();
+
+    //--------------------------------------------------------------------------
+    //! \brief Snapshot the current state of the simulator. Snapshots at or
+    //! after the current simulated time are forgotten first.
+    //--------------------------------------------------------------------------
+    void take(TimedSimulator const& simulator);
+
+    //--------------------------------------------------------------------------
+    //! \brief Restore the latest snapshot taken at or before the given time
+    //! then simulate until this time. Observers of the simulator are not
+    //! notified of the replayed events: they have already been.
+    //! \return false if there is no snapshot before the given time: the
+    //! simulator is not modified.
+    //--------------------------------------------------------------------------
+    bool rewind(TimedSimulator& simulator, double const time) const;
+
+    //--------------------------------------------------------------------------
+    //! \brief Rebuild the state of the given snapshot.
+    //--------------------------------------------------------------------------
+    void restore(size_t const index, TimedSimulator::Checkpoint& checkpoint) const;
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the index of the latest snapshot taken at or before the
+    //! given time, or size() if there is none.
+    //--------------------------------------------------------------------------
+    size_t find(double const time) const;
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of snapshots.
+    //--------------------------------------------------------------------------
+    inline size_t size() const { return m_snapshots.size(); }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the simulated time of the given snapshot.
+    //--------------------------------------------------------------------------
+    inline double time(size_t const index) const { return m_snapshots[index].time; }
+
+private:
+
+    //--------------------------------------------------------------------------
+    //! \brief Difference with the previous snapshot, or with an empty marking
+    //! for key frames.
+    //--------------------------------------------------------------------------
+    struct Snapshot
+    {
+        double time;
+        uint64_t sequence;
+        size_t firings;
+        std::vector<uint64_t> policy;
+        //! \brief Conflict clusters whose random generator has changed.
+        std::vector<std::pair<CompiledNet::Index, uint64_t>> random;
+        //! \brief Places whose number of tokens has changed.
+        std::vector<std::pair<CompiledNet::Index, CompiledNet::Count>> tokens;
+        //! \brief Transitions whose receptivity has toggled.
+        std::vector<CompiledNet::Index> receptivities;
+        std::vector<CompiledNet::Index> candidates;
+        std::vector<TimedSimulator::Event> events;
+        std::vector<std::pair<CompiledNet::Index, TokenQueue::Run>> held;
+    };
+
+private:
+
+    //! \brief Number of snapshots between two key frames.
+    size_t m_keyframes;
+    std::vector<Snapshot> m_snapshots;
+    //! \brief Number of places, transitions and conflict clusters of the
+    //! simulated net.
+    size_t m_places = 0u;
+    size_t m_transitions = 0u;
+    size_t m_clusters = 0u;
+    //! \brief State of the latest snapshot, for computing the next delta.
+    TimedSimulator::Checkpoint m_latest;
+    //! \brief Reused for saving the simulator.
+    TimedSimulator::Checkpoint m_current;
+};
+
+} // namespace tpne
+
+#endif
@@ -0,0 +1,113 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef TOKEN_QUEUE_HPP
+#  define TOKEN_QUEUE_HPP
+
+#  include "TimedPetriNetEditor/CompiledNet.hpp"
+
+namespace tpne {
+
+// *****************************************************************************
+//! \brief Tokens of a place which are not yet available, ordered by their
+//! availability time. Tokens sharing the same availability time are stored as
+//! a single run, so the memory depends on the number of distinct times, not on
+//! the number of tokens. Runs are stored in a ring buffer growing by powers of
+//! two: pushing at the back and popping at the front are O(1).
+//!
+//! Tokens are first in, first out: a token never becomes available before
+//! the tokens pushed before it.
+// *****************************************************************************
+class TokenQueue
+{
+public:
+
+    //--------------------------------------------------------------------------
+    //! \brief Tokens becoming available at the same time.
+    //--------------------------------------------------------------------------
+    struct Run
+    {
+        double time;
+        CompiledNet::Count tokens;
+    };
+
+    //--------------------------------------------------------------------------
+    //! \brief Add tokens becoming available at the given time, or at the time
+    //! of the latest run if later. A run holds at most CompiledNet::maxCount()
+    //! tokens: extra tokens are stored in following runs of the same time, so
+    //! no token is lost.
+    //--------------------------------------------------------------------------
+    void push(double const time, size_t const tokens);
+
+    //--------------------------------------------------------------------------
+    //! \brief Remove the earliest run. The queue shall not be empty.
+    //--------------------------------------------------------------------------
+    void pop();
+
+    //--------------------------------------------------------------------------
+    //! \brief Remove all runs. The memory is kept.
+    //--------------------------------------------------------------------------
+    void clear();
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the i-th run from the earliest one.
+    //--------------------------------------------------------------------------
+    inline Run const& operator[](size_t const i) const
+    {
+        assert(i < m_size);
+        return m_runs[(m_head + i) & (m_runs.size() - 1u)];
+    }
+
+    inline Run const& front() const { return (*this)[0u]; }
+    inline Run const& back() const { return (*this)[m_size - 1u]; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of runs.
+    //--------------------------------------------------------------------------
+    inline size_t size() const { return m_size; }
+    inline bool empty() const { return m_size == 0u; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of tokens of all runs.
+    //--------------------------------------------------------------------------
+    inline size_t tokens() const { return m_tokens; }
+
+private:
+
+    //--------------------------------------------------------------------------
+    //! \brief Add a new run at the back, growing the ring buffer if full.
+    //--------------------------------------------------------------------------
+    void pushRun(double const time, size_t const count);
+
+private:
+
+    //! \brief Ring buffer of runs (power of two size).
+    std::vector<Run> m_runs;
+    //! \brief Position of the earliest run.
+    size_t m_head = 0u;
+    //! \brief Number of runs.
+    size_t m_size = 0u;
+    //! \brief Number of tokens of all runs.
+    size_t m_tokens = 0u;
+};
+
+} // namespace tpne
+
+#endif
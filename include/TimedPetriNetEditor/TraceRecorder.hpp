@@ -0,0 +1,213 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef TRACE_RECORDER_HPP
+#  define TRACE_RECORDER_HPP
+
+#  include "TimedPetriNetEditor/TimedSimulator.hpp"
+#  include <atomic>
+#  include <mutex>
+#  include <thread>
+#  include <cstdio>
+#  include <iostream>
+
+namespace tpne {
+
+//--------------------------------------------------------------------------
+//! \brief Compact binary record of an event of the simulation, as stored in
+//! trace files (in the endianness of the machine).
+//--------------------------------------------------------------------------
+struct TraceRecord
+{
+    //! \brief Value of fields not meaningful for the type of record.
+    static constexpr uint32_t None = 0xFFFFFFFFu;
+
+    enum Type: uint32_t
+    {
+        Started,  //! A new simulation has started: time restarts from 0.
+        Fired,    //! The transition has been fired tokens times.
+        Departed, //! Tokens are departing along the arc.
+        Arrived,  //! Tokens carried by the arc have arrived in the place.
+    };
+
+    //! \brief Simulated time.
+    double time;
+    //! \brief Number of tokens or of firings (saturated).
+    uint32_t tokens;
+    //! \brief Identifier of the transition (Fired) or of the place (Arrived).
+    uint32_t node;
+    //! \brief Position of the arc in the net (Departed, Arrived).
+    uint32_t arc;
+    //! \brief See Type.
+    uint32_t type;
+};
+
+static_assert(sizeof(TraceRecord) == 24u, "Unexpected padding in TraceRecord");
+
+// *****************************************************************************
+//! \brief Record events of the simulation into a binary trace file. Observers
+//! are called by the simulation thread: records are pushed into a lock-free
+//! fixed-size ring buffer (single producer, single consumer) and a writer
+//! thread drains it into the file. The simulation never waits for the disk:
+//! when the ring buffer is full, records are dropped and counted.
+//!
+//! The file starts with the magic "TPNTRACE", the version and the size of a
+//! record (all uint32_t) followed by TraceRecord. See readTrace() and
+//! decodeTrace().
+// *****************************************************************************
+class TraceRecorder: public TimedSimulator::Observer
+{
+public:
+
+    //--------------------------------------------------------------------------
+    //! \brief Set the number of records of the ring buffer (rounded up to a
+    //! power of two).
+    //--------------------------------------------------------------------------
+    explicit TraceRecorder(size_t const capacity = 65536u);
+
+    //--------------------------------------------------------------------------
+    //! \brief Close the trace file if opened.
+    //--------------------------------------------------------------------------
+    ~TraceRecorder();
+
+    //--------------------------------------------------------------------------
+    //! \brief Create the trace file and start the writer thread. A previously
+    //! opened file is closed first.
+    //! \return the error message, or dummy string if succeeded.
+    //--------------------------------------------------------------------------
+    std::string open(std::string const& filename);
+
+    //--------------------------------------------------------------------------
+    //! \brief Write remaining records, stop the writer thread and close the
+    //! file.
+    //--------------------------------------------------------------------------
+    void close();
+
+    //--------------------------------------------------------------------------
+    //! \brief Is a trace file opened ?
+    //--------------------------------------------------------------------------
+    inline bool isOpen() const { return m_file != nullptr; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Number of records of the ring buffer.
+    //--------------------------------------------------------------------------
+    inline size_t capacity() const { return m_buffer.size(); }
+
+    //--------------------------------------------------------------------------
+    //! \brief Number of records dropped because the ring buffer was full.
+    //--------------------------------------------------------------------------
+    inline size_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    //--------------------------------------------------------------------------
+    //! \brief Push a record. Ignored if no file is opened. To be called from
+    //! the thread of the simulation only.
+    //--------------------------------------------------------------------------
+    void record(TraceRecord const& record);
+
+    //--------------------------------------------------------------------------
+    //! \brief Push a TraceRecord::Started record.
+    //--------------------------------------------------------------------------
+    void started();
+
+    virtual void onFired(double const time, size_t const transition,
+                         size_t const count) override;
+    virtual void onDeparted(double const time, size_t const arc,
+                            size_t const tokens, double const arrival) override;
+    virtual void onArrived(double const time, size_t const arc,
+                           size_t const place, size_t const tokens) override;
+
+private:
+
+    void write();
+    size_t flush();
+
+private:
+
+    //! \brief Ring buffer. Its size is a power of two.
+    std::vector<TraceRecord> m_buffer;
+    size_t m_mask;
+    //! \brief Next slot written by the simulation thread. Padding avoids
+    //! false sharing with the slot read by the writer thread.
+    std::atomic<size_t> m_head{0u};
+    char m_padding[64];
+    //! \brief Next slot read by the writer thread.
+    std::atomic<size_t> m_tail{0u};
+    //! \brief Number of records dropped because the ring buffer was full.
+    std::atomic<size_t> m_dropped{0u};
+    //! \brief Set false for stopping the writer thread.
+    std::atomic<bool> m_running{false};
+    std::thread m_writer;
+    FILE* m_file = nullptr;
+};
+
+// *****************************************************************************
+//! \brief Log events of the simulation as human readable lines on a stream.
+//! Opt-in sink: flushing the console for each firing is slow on busy nets.
+//! Lines may be written from the simulation thread and from the GUI thread:
+//! they are serialized by a mutex.
+// *****************************************************************************
+class ConsoleTrace: public TimedSimulator::Observer
+{
+public:
+
+    //--------------------------------------------------------------------------
+    //! \brief The net gives the captions of places and transitions.
+    //--------------------------------------------------------------------------
+    ConsoleTrace(Net const& net, std::ostream& os = std::cout);
+
+    //--------------------------------------------------------------------------
+    //! \brief Log a line prefixed by the wall-clock time.
+    //--------------------------------------------------------------------------
+    void log(std::string const& message);
+
+    virtual void onDeparted(double const time, size_t const arc,
+                            size_t const tokens, double const arrival) override;
+    virtual void onArrived(double const time, size_t const arc,
+                           size_t const place, size_t const tokens) override;
+
+private:
+
+    Net const& m_net;
+    std::ostream& m_os;
+    std::mutex m_mutex;
+};
+
+//--------------------------------------------------------------------------
+//! \brief Format of decodeTrace().
+//--------------------------------------------------------------------------
+enum class TraceFormat { Text, CSV };
+
+//--------------------------------------------------------------------------
+//! \brief Load records of a trace file made by TraceRecorder.
+//! \return the error message, or dummy string if succeeded.
+//--------------------------------------------------------------------------
+std::string readTrace(std::string const& filename, std::vector<TraceRecord>& records);
+
+//--------------------------------------------------------------------------
+//! \brief Convert a trace file made by TraceRecorder into text lines or into
+//! CSV (time,type,node,arc,tokens).
+//! \return the error message, or dummy string if succeeded.
+//--------------------------------------------------------------------------
+std::string decodeTrace(std::string const& filename, std::ostream& os,
+                        TraceFormat const format);
+
+} // namespace tpne
+
+#endif
@@ -157,6 +157,14 @@ void drawArc(ImDrawList* draw_list, Arc const& arc, TypeOfNet const type, ImVec2
             stream << std::fixed << std::setprecision(1) << arc.duration;
             draw_list->AddText(ImVec2(x, y), DURATION_COLOR, stream.str().c_str());
         }
+
+        // Print the weight when it is not the usual one
+        if (arc.weight != 1u)
+        {
+            float x = origin.x + arc.from.x + (arc.to.x - arc.from.x) / 2.0f;
+            float y = origin.y + arc.from.y + (arc.to.y - arc.from.y) / 2.0f + 5.0f;
+            draw_list->AddText(ImVec2(x, y), CAPTION_COLOR, std::to_string(arc.weight).c_str());
+        }
     }
 }
 
@@ -186,7 +194,8 @@ static void drawPetriPlace(ImDrawList* draw_list, Place const& place, ImVec2 con
     draw_list->AddCircle(p, PLACE_RADIUS, OUTLINE_COLOR, 64, 2.5f);
 
     // Draw the caption
-    const char* text = show_caption ? place.caption.c_str() : place.key.c_str();
+    std::string const caption = show_caption ? place.caption() : place.key();
+    const char* text = caption.c_str();
     ImVec2 dim = ImGui::CalcTextSize(text);
     ImVec2 ptext = p - ImVec2(dim.x / 2.0f, PLACE_RADIUS + dim.y);
     draw_list->AddText(ptext, CAPTION_COLOR, text);
@@ -259,7 +268,8 @@ static void drawGrafcetPlace(ImDrawList* draw_list, Place const& place, ImVec2 c
     draw_list->AddRect(pmin, pmax, OUTLINE_COLOR, 0.0f, ImDrawFlags_None, 2.5f);
 
     // Draw the caption inside the square
-    const char* text = place.caption.c_str();
+    std::string const caption = place.caption();
+    const char* text = caption.c_str();
     ImVec2 dim = ImGui::CalcTextSize(text) / 2.0f;
     ImVec2 ptext = p - dim + ImVec2(0.0f, -TRANS_WIDTH / 3.0f + 5.0f);
     draw_list->AddText(ptext, CAPTION_COLOR, text);
@@ -324,13 +334,15 @@ void drawTransition(ImDrawList* draw_list, Transition const& transition,
     // Draw the caption
     if (type == TypeOfNet::GRAFCET)
     {
-        const char* text = transition.caption.c_str();
+        std::string const caption = transition.caption();
+        const char* text = caption.c_str();
         ImVec2 dim = ImGui::CalcTextSize(text) / 2.0f;
         draw_list->AddText(p + ImVec2(dim.x, -dim.y) + ImVec2(TRANS_WIDTH / 2.0f, 0.0f), CAPTION_COLOR, text);
     }
     else
     {
-        const char* text = show_caption ? transition.caption.c_str() : transition.key.c_str();
+        std::string const caption = show_caption ? transition.caption() : transition.key();
+        const char* text = caption.c_str();
         ImVec2 dim = ImGui::CalcTextSize(text);
         ImVec2 ptext = p - ImVec2(dim.x / 2.0f, TRANS_HEIGHT / 2.0f + dim.y);
         draw_list->AddText(ptext, CAPTION_COLOR, text);
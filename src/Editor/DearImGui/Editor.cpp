@@ -702,7 +702,11 @@ void Editor::showCriticalCycles() //const
         {
             ImGui::Text("Found %zu connected components of the optimal policy", res.cycles);
 
-            m_marked_arcs = res.arcs;
+            m_marked_arcs.clear();
+            for (auto const& a: res.arcs)
+            {
+                m_marked_arcs.push_back(m_net.handle(*a));
+            }
             ImGuiTabBarFlags tab_bar_flags = ImGuiTabBarFlags_None;
             if (ImGui::BeginTabBar("CriticalCycleResult", tab_bar_flags))
             {
@@ -714,8 +718,8 @@ void Editor::showCriticalCycles() //const
                         // Only show transitions
                         for (size_t it = 0u; it < res.arcs.size(); it += 2u)
                         {
-                            txt << res.arcs[it]->from.key << " -> "
-                                << res.arcs[it + 1u]->to.key
+                            txt << res.arcs[it]->from.key() << " -> "
+                                << res.arcs[it + 1u]->to.key()
                                 << std::endl;
                         }
                     }
@@ -724,9 +728,9 @@ void Editor::showCriticalCycles() //const
                         // Show transitions and places
                         for (size_t it = 0u; it < res.arcs.size(); it += 2u)
                         {
-                            txt << res.arcs[it]->from.key << " -> "
-                                << res.arcs[it]->to.key << " -> "
-                                << res.arcs[it + 1u]->to.key
+                            txt << res.arcs[it]->from.key() << " -> "
+                                << res.arcs[it]->to.key() << " -> "
+                                << res.arcs[it + 1u]->to.key()
                                 << std::endl;
                         }
                     }
@@ -739,7 +743,7 @@ void Editor::showCriticalCycles() //const
                     std::stringstream txt;
                     for (size_t i = 0u; i < res.durations.size(); ++i)
                     {
-                        txt << "From " << tr[i].key << ": "
+                        txt << "From " << tr[i].key() << ": "
                             << res.durations[i]
                             << " units of time"
                             << std::endl;
@@ -958,15 +962,19 @@ void Editor::inspector()
 
         for (auto& place: m_net.places())
         {
-            ImGui::PushID(place.key.c_str());
+            ImGui::PushID(place.key().c_str());
             ImGui::AlignTextToFramePadding();
-            ImGui::InputText(place.key.c_str(), &place.caption,
+            std::string caption = place.caption();
+            if (ImGui::InputText(place.key().c_str(), &caption,
                 readonly | ImGuiInputTextFlags_CallbackEdit,
                 [](ImGuiInputTextCallbackData*)
                 {
                     modified = true;
                     return 0;
-                });
+                }))
+            {
+                place.caption(caption);
+            }
 
             // Increment/decrement tokens
             ImGui::SameLine();
@@ -1016,14 +1024,18 @@ void Editor::inspector()
         for (auto& t: m_net.transitions())
         {
             // Show contents of transition
-            ImGui::InputText(t.key.c_str(), &t.caption,
+            std::string caption = t.caption();
+            if (ImGui::InputText(t.key().c_str(), &caption,
                 readonly | ImGuiInputTextFlags_CallbackEdit,
                 [](ImGuiInputTextCallbackData*)
                 {
                     modified = true;
                     compiled = false;
                     return 0;
-                });
+                }))
+            {
+                t.caption(caption);
+            }
 
             // For GRAFCET and show syntax error on the transitivity
             if ((m_net.type() == TypeOfNet::GRAFCET) && (!m_simulation.running))
@@ -1066,7 +1078,7 @@ void Editor::inspector()
         {
             if (arc.from.type == Node::Type::Transition)
             {
-                std::string text(arc.from.key + " -> " + arc.to.arcsOut[0]->to.key);
+                std::string text(arc.from.key() + " -> " + arc.to.arcsOut[0]->to.key());
                 float prev_value = arc.duration;
                 ImGui::InputFloat(text.c_str(), &arc.duration, 0.01f, 1.0f, "%.3f", readonly);
                 modified = (prev_value != arc.duration);
@@ -1080,11 +1092,64 @@ void Editor::inspector()
         ImGui::Text("%s", "Durations:");
         for (auto& arc: m_net.arcs())
         {
-            std::string text(arc.from.key + " -> " + arc.to.key);
+            std::string text(arc.from.key() + " -> " + arc.to.key());
             float prev_value = arc.duration;
             ImGui::InputFloat(text.c_str(), &arc.duration, 0.01f, 1.0f, "%.3f", readonly);
             modified = (prev_value != arc.duration);
         }
+        ImGui::Separator();
+        ImGui::Text("%s", "Weights:");
+        for (auto& arc: m_net.arcs())
+        {
+            std::string text(arc.from.key() + " -> " + arc.to.key() + "##weight");
+            size_t const prev_weight = arc.weight;
+            size_t const one = 1u;
+            ImGui::InputScalar(text.c_str(), ImGuiDataType_U64, &arc.weight, &one,
+                               nullptr, "%zu", readonly);
+            if (arc.weight == 0u)
+                arc.weight = 1u;
+            modified |= (prev_weight != arc.weight);
+        }
+        ImGui::End();
+    }
+
+    // Rewind the simulation to a past simulated time, change its speed or
+    // fast-forward it.
+    if (m_simulation.running)
+    {
+        static double until_time = 100.0;
+        static int until_firings = 1000;
+
+        ImGui::Begin("Simulation");
+        float time = float(m_simulation.time());
+        if (ImGui::SliderFloat("Time", &time, 0.0f, time, "%.3f"))
+        {
+            m_simulation.rewind(double(time));
+        }
+        float speed = m_simulation.speed();
+        if (ImGui::SliderFloat("Speed", &speed, 0.1f, 1000.0f, "x%.1f",
+                               ImGuiSliderFlags_Logarithmic))
+        {
+            m_simulation.speed(speed);
+        }
+        ImGui::Separator();
+        ImGui::InputDouble("##until_time", &until_time, 1.0, 10.0, "%.3f");
+        ImGui::SameLine();
+        if (ImGui::Button("Run until time"))
+        {
+            m_simulation.fastForward(until_time);
+        }
+        ImGui::InputInt("##until_firings", &until_firings);
+        ImGui::SameLine();
+        if (ImGui::Button("Run firings"))
+        {
+            m_simulation.fastForward(std::numeric_limits<double>::infinity(),
+                                     size_t(std::max(0, until_firings)));
+        }
+        if (m_simulation.fastForwarding())
+        {
+            ImGui::Text("Fast-forwarding ...");
+        }
         ImGui::End();
     }
 
@@ -1640,7 +1705,7 @@ void Editor::PetriView::handleMoveNode()
         Node* node = m_editor.getNode(m_mouse.position);
         if (node != nullptr)
         {
-            m_mouse.selection.push_back(node);
+            m_mouse.selection.push_back(m_editor.m_net.handle(*node));
             m_editor.m_net.modified = true;
         }
     }
@@ -1895,16 +1960,22 @@ void Editor::PetriView::drawPetriNet(Net& net, Simulation& simulation)
     }
 
     // Draw all tokens transiting from Transitions to Places
-    for (auto const& it: simulation.timedTokens())
+    TimedTokens const& tokens = simulation.timedTokens();
+    for (size_t i = 0u; i < tokens.size(); ++i)
     {
-        drawTimedToken(m_canvas.draw_list, it.tokens, origin.x + it.x, origin.y + it.y);
+        drawTimedToken(m_canvas.draw_list, tokens.tokens(i), origin.x + tokens.x(i),
+                       origin.y + tokens.y(i));
     }
 
     // Update node positions the user is currently moving
-    for (auto& it: m_mouse.selection)
+    for (auto const& it: m_mouse.selection)
     {
-        it->x = m_mouse.position.x;
-        it->y = m_mouse.position.y;
+        Node* node = net.node(it);
+        if (node != nullptr)
+        {
+            node->x = m_mouse.position.x;
+            node->y = m_mouse.position.y;
+        }
     }
 
     // Show the arc we are creating
@@ -1915,9 +1986,13 @@ void Editor::PetriView::drawPetriNet(Net& net, Simulation& simulation)
     }
 
     // Draw critical cycle
-    for (auto& it: m_editor.m_marked_arcs)
+    for (auto const& it: m_editor.m_marked_arcs)
     {
-        drawArc(m_canvas.draw_list, *it, net.type(), origin, -1.0f);
+        Arc const* arc = net.arc(it);
+        if (arc != nullptr)
+        {
+            drawArc(m_canvas.draw_list, *arc, net.type(), origin, -1.0f);
+        }
     }
 
     m_canvas.pop();
@@ -57,6 +57,7 @@ public:
     virtual void run(std::string const& petri_file) override;
     virtual void run(Net const& net) override;
     inline Net& net() { return m_net; }
+    inline Simulation& simulation() { return m_simulation; }
 
 private: // Inheritance from Application class
 
@@ -245,8 +246,9 @@ private:
             //! \brief Selected destination node (place or transition) by the user when
             //! adding an arc.
             Node* to = nullptr;
-            //! \brief The user has select a node to be displaced.
-            std::vector<Node*> selection;
+            //! \brief The user has select a node to be displaced. Handles are
+            //! used since the net may be modified while moving nodes.
+            std::vector<NodeHandle> selection;
         } m_mouse;
     }; // class PetriView
 
@@ -307,7 +309,8 @@ private:
 #endif
     //! \brief Critical cycle found by Howard algorithm. Also used to show
     //! where are erroneous arcs making the Petri net not be a graph event.
-    std::vector<Arc*> m_marked_arcs;
+    //! Handles are used since the net may be modified after the search.
+    std::vector<ArcHandle> m_marked_arcs;
     //! \brief Visualize the net and do the interaction with the user.
     PetriView m_view;
     //! \brief Messages to be displayed on the GUI.
@@ -19,6 +19,7 @@
 //=============================================================================
 
 #include "TimedPetriNetEditor/PetriNet.hpp"
+#include "TimedPetriNetEditor/CompiledNet.hpp"
 #include "TimedPetriNetEditor/Algorithms.hpp"
 #include "TimedPetriNetEditor/SparseMatrix.hpp"
 #include "TimedPetriNetEditor/TropicalAlgebra.hpp"
@@ -60,28 +61,28 @@ bool isEventGraph(Net const& net, std::string& error, std::vector<Arc*>& erroneo
 
             if (p.arcsOut.size() != 1u)
             {
-                message << "  " << p.key
+                message << "  " << p.key()
                         << ((p.arcsOut.size() > 1u)
                             ? " has more than one output arc:"
                             : " has no output arc");
                 for (auto const& a: p.arcsOut)
                 {
                     erroneous_arcs.push_back(a);
-                    message << " " << a->to.key;
+                    message << " " << a->to.key();
                 }
                 message << std::endl;
             }
 
             if (p.arcsIn.size() != 1u)
             {
-                message << "  " << p.key
+                message << "  " << p.key()
                         << ((p.arcsIn.size() > 1u)
                             ? " has more than one input arc:"
                             : " has no input arc");
                 for (auto const& a: p.arcsIn)
                 {
                     erroneous_arcs.push_back(a);
-                    message << " " << a->from.key;
+                    message << " " << a->from.key();
                 }
                 message << std::endl;
             }
@@ -91,6 +92,22 @@ bool isEventGraph(Net const& net, std::string& error, std::vector<Arc*>& erroneo
         }
     }
 
+    // Weighted arcs cannot be expressed in the (max,+) algebra.
+    for (auto const& p: net.places())
+    {
+        for (auto const& a: { p.arcsIn[0], p.arcsOut[0] })
+        {
+            if (a->weight != 1u)
+            {
+                erroneous_arcs.push_back(a);
+                error = "The Petri net is not an event graph. Because:\n  Arc "
+                        + a->from.key() + " -> " + a->to.key()
+                        + " has a weight different than 1\n";
+                return false;
+            }
+        }
+    }
+
     return true;
 }
 
@@ -102,6 +119,36 @@ bool isEventGraph(Net const& net)
     return isEventGraph(net, error, erroneous_arcs);
 }
 
+//------------------------------------------------------------------------------
+bool isEventGraph(CompiledNet const& net)
+{
+    if ((net.places() == 0u) && (net.transitions() == 0u))
+        return false;
+
+    for (size_t p = 0u; p < net.places(); ++p)
+    {
+        if ((net.inputTransitions(p).size() != 1u) ||
+            (net.outputTransitions(p).size() != 1u))
+            return false;
+    }
+
+    for (size_t t = 0u; t < net.transitions(); ++t)
+    {
+        for (auto const w: net.preWeights(t))
+        {
+            if (w != 1u)
+                return false;
+        }
+        for (auto const w: net.postWeights(t))
+        {
+            if (w != 1u)
+                return false;
+        }
+    }
+
+    return true;
+}
+
 //------------------------------------------------------------------------------
 void toCanonicalForm(Net const& net, Net& canonic)
 {
@@ -291,32 +338,34 @@ bool toSysLin(Net const& net, SparseMatrix<MaxPlus>& D, SparseMatrix<MaxPlus>& A
 //------------------------------------------------------------------------------
 bool toAdjacencyMatrices(Net const& net, SparseMatrix<MaxPlus>& tokens, SparseMatrix<MaxPlus>& durations)
 {
-    size_t const nnodes = net.transitions().size();
+    return toAdjacencyMatrices(CompiledNet(net), tokens, durations);
+}
+
+//------------------------------------------------------------------------------
+bool toAdjacencyMatrices(CompiledNet const& net, SparseMatrix<MaxPlus>& tokens, SparseMatrix<MaxPlus>& durations)
+{
+    size_t const nnodes = net.transitions();
 
     durations.clear(); durations.reshape(nnodes, nnodes);
     tokens.clear(); tokens.reshape(nnodes, nnodes);
 
-    for (auto const& p: net.places())
+    for (size_t p = 0u; p < net.places(); ++p)
     {
         // Since we are sure this Petri net is an event graph: places have a
         // single input arc and a single output arc. We can merge the place and
         // its arcs into a single arc.
-        if (p.arcsIn.size() != 1u)
-            return false;
-        if (p.arcsIn[0]->from.type != Node::Type::Transition)
-            return false;
-        if (p.arcsOut.size() != 1u)
+        if (net.inputTransitions(p).size() != 1u)
             return false;
-        if (p.arcsOut[0]->to.type != Node::Type::Transition)
+        if (net.outputTransitions(p).size() != 1u)
             return false;
 
-        Transition& from = *reinterpret_cast<Transition*>(&(p.arcsIn[0]->from));
-        Transition& to = *reinterpret_cast<Transition*>(&(p.arcsOut[0]->to));
+        size_t const from = net.inputTransitions(p)[0];
+        size_t const to = net.outputTransitions(p)[0];
 
         // Note origin and destination are inverted because we use the following
         // matrix product convension: M * x where x is a column vector.
-        durations.set(from.id, to.id, p.arcsIn[0]->duration);
-        tokens.set(from.id, to.id, float(p.tokens));
+        durations.set(from, to, net.inputDurations(p)[0]);
+        tokens.set(from, to, float(net.tokens(p)));
     }
 
     return true;
@@ -336,7 +385,7 @@ std::stringstream showCounterEquation(Net const& net, std::string const& comment
         if (t.arcsIn.size() == 0u)
             continue;
 
-        ss << comment << (use_caption ? t.caption : t.key) << "(t) = ";
+        ss << comment << (use_caption ? t.caption() : t.key()) << "(t) = ";
         ss << (minplus_notation ? "" : "min(");
         std::string separator1;
         for (auto const& ai: t.arcsIn)
@@ -350,7 +399,7 @@ std::stringstream showCounterEquation(Net const& net, std::string const& comment
             for (auto const& ao: ai->from.arcsIn)
             {
                 ss << separator2;
-                ss << (use_caption ? ao->from.caption : ao->from.key);
+                ss << (use_caption ? ao->from.caption() : ao->from.key());
                 if (ao->duration != 0.0f)
                 {
                     ss << "(t - " << ao->duration << ")";
@@ -383,7 +432,7 @@ std::stringstream showDaterEquation(Net const& net, std::string const& comment,
         if (t.arcsIn.size() == 0u)
             continue;
 
-        ss << comment << (use_caption ? t.caption : t.key) << "(n) = ";
+        ss << comment << (use_caption ? t.caption() : t.key()) << "(n) = ";
         ss << (maxplus_notation ? "" : "max(");
         std::string separator1;
         for (auto const& ai: t.arcsIn)
@@ -397,7 +446,7 @@ std::stringstream showDaterEquation(Net const& net, std::string const& comment,
                 {
                     ss << ao->duration << (maxplus_notation ? " " : " + ");
                 }
-                ss << (use_caption ? ao->from.caption : ao->from.key) << "(n";
+                ss << (use_caption ? ao->from.caption() : ao->from.key()) << "(n";
                 if (ai->tokensIn() != 0u)
                 {
                     ss << " - " << ai->tokensIn();
@@ -427,8 +476,25 @@ CriticalCycleResult findCriticalCycle(Net const& net)
     }
 
     // Number of nodes and number of arcs
-    size_t const nnodes = net.transitions().size();
-    size_t const narcs = net.places().size();
+    CompiledNet const compiled(net);
+    size_t const nnodes = compiled.transitions();
+    size_t const narcs = compiled.places();
+
+    // Howard works on int: refuse graphs it cannot index.
+    if (!compiled.error().empty())
+    {
+        result.message << compiled.error();
+        result.success = false;
+        return result;
+    }
+    if ((nnodes > size_t(std::numeric_limits<int>::max())) ||
+        (narcs > size_t(std::numeric_limits<int>::max())))
+    {
+        result.message << "The net is too large for the Howard algorithm: the limit is "
+                       << std::numeric_limits<int>::max() << " nodes";
+        result.success = false;
+        return result;
+    }
 
     // Reserve memory for storing timings
     std::vector<double> T; T.reserve(narcs);
@@ -439,22 +505,24 @@ CriticalCycleResult findCriticalCycle(Net const& net)
     // FIXME should be std::vector<size_t> but Howard wants int*
     std::vector<int> IJ; IJ.reserve(2u * narcs);
 
-    for (auto const& p: net.places())
+    // Places linking two transitions: {(source node, destination node), place}
+    std::unordered_map<size_t, size_t> places; places.reserve(narcs);
+
+    for (size_t p = 0u; p < narcs; ++p)
     {
         // Since we are sure we are an event graph: places have a single input
         // arc and a aingle output arc.
-        assert(p.arcsIn.size() == 1u);
-        assert(p.arcsIn[0]->from.type == Node::Type::Transition);
-        assert(p.arcsOut.size() == 1u);
-        assert(p.arcsOut[0]->to.type == Node::Type::Transition);
-
-        Transition& from = *reinterpret_cast<Transition*>(&(p.arcsIn[0]->from));
-        Transition& to = *reinterpret_cast<Transition*>(&(p.arcsOut[0]->to));
-
-        IJ.push_back(int(from.id)); // Transposed is needed
-        IJ.push_back(int(to.id));
-        T.push_back(p.arcsIn[0]->duration);
-        N.push_back(double(p.tokens));
+        assert(compiled.inputTransitions(p).size() == 1u);
+        assert(compiled.outputTransitions(p).size() == 1u);
+
+        size_t const from = compiled.inputTransitions(p)[0];
+        size_t const to = compiled.outputTransitions(p)[0];
+
+        IJ.push_back(int(from)); // Transposed is needed
+        IJ.push_back(int(to));
+        T.push_back(compiled.inputDurations(p)[0]);
+        N.push_back(double(compiled.tokens(p)));
+        places.emplace(from * nnodes + to, p);
     }
 
     result.eigenvector.resize(nnodes);
@@ -494,21 +562,13 @@ CriticalCycleResult findCriticalCycle(Net const& net)
     {
         size_t from = size_t(optimal_policy[to]);
         result.message << "  T" << from << " -> T" << to << std::endl;
-        // Search for all places that link our transitions.
-        for (auto const& p: net.places())
+        // Search for the place that link our transitions.
+        auto const it = places.find(to * nnodes + from);
+        if (it != places.end())
         {
-            assert(p.arcsIn.size() == 1u);
-            assert(p.arcsOut.size() == 1u);
-            Node* t0 = &p.arcsIn[0]->from;
-            Node* t1 = &p.arcsOut[0]->to;
-            assert(t0->type == Node::Type::Transition);
-            assert(t1->type == Node::Type::Transition);
-            if ((t1->id == from) && (t0->id == to))
-            {
-                result.arcs.push_back(p.arcsIn[0]);
-                result.arcs.push_back(p.arcsOut[0]);
-                break;
-            }
+            Place const& p = net.places()[it->second];
+            result.arcs.push_back(p.arcsIn[0]);
+            result.arcs.push_back(p.arcsOut[0]);
         }
     }
 
@@ -0,0 +1,490 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "TimedPetriNetEditor/CompiledNet.hpp"
+
+namespace tpne {
+
+//------------------------------------------------------------------------------
+//! \brief Transform the number of elements per row into offsets of rows (prefix
+//! sum). The vector shall have one more element than the number of rows.
+static void toOffsets(std::vector<CompiledNet::Index>& offsets)
+{
+    CompiledNet::Index sum = 0u;
+    for (auto& it: offsets)
+    {
+        CompiledNet::Index const count = it;
+        it = sum;
+        sum += count;
+    }
+}
+
+//------------------------------------------------------------------------------
+//! \brief Return the root of the given element in the union-find forest.
+static CompiledNet::Index findRoot(std::vector<CompiledNet::Index>& parents,
+                                   CompiledNet::Index i)
+{
+    while (parents[i] != i)
+    {
+        // Path halving
+        parents[i] = parents[parents[i]];
+        i = parents[i];
+    }
+    return i;
+}
+
+//------------------------------------------------------------------------------
+CompiledNet::CompiledNet(Net const& net)
+{
+    compile(net);
+}
+
+//------------------------------------------------------------------------------
+bool CompiledNet::compile(Net const& net)
+{
+    size_t const nplaces = net.places().size();
+    size_t const ntransitions = net.transitions().size();
+
+    m_settings = net.settings();
+    m_max_tokens = std::min(m_settings.maxTokens, maxCount());
+    m_arcs = net.arcs().size();
+    m_overflows = 0u;
+    m_error.clear();
+
+    // Refuse nets that do not fit inside the type of indices and counters
+    // instead of silently truncating them.
+    if ((nplaces > maxIndex()) || (ntransitions > maxIndex()) || (m_arcs > maxIndex()))
+    {
+        return fail("The net has too many nodes or arcs: the limit is "
+                    + std::to_string(maxIndex()));
+    }
+    for (auto const& a: net.arcs())
+    {
+        if (a.weight > maxCount())
+        {
+            return fail("Arc " + a.from.key() + " -> " + a.to.key()
+                        + " has a weight greater than " + std::to_string(maxCount()));
+        }
+    }
+
+    // Count arcs for each row of CSR arrays. Row i + 1 is used for counting
+    // the number of elements of row i before the prefix sum.
+    m_pre_offsets.assign(ntransitions + 1u, 0u);
+    m_post_offsets.assign(ntransitions + 1u, 0u);
+    m_place_in_offsets.assign(nplaces + 1u, 0u);
+    m_place_out_offsets.assign(nplaces + 1u, 0u);
+    for (auto const& a: net.arcs())
+    {
+        assert(a.from.id < ((a.from.type == Node::Type::Place) ? nplaces : ntransitions));
+        assert(a.to.id < ((a.to.type == Node::Type::Place) ? nplaces : ntransitions));
+        if (a.from.type == Node::Type::Place)
+        {
+            m_pre_offsets[a.to.id]++;
+            m_place_out_offsets[a.from.id]++;
+        }
+        else
+        {
+            m_post_offsets[a.from.id]++;
+            m_place_in_offsets[a.to.id]++;
+        }
+    }
+    toOffsets(m_pre_offsets);
+    toOffsets(m_post_offsets);
+    toOffsets(m_place_in_offsets);
+    toOffsets(m_place_out_offsets);
+
+    // Fill CSR arrays. Iterating on arcs keeps the order of Node::arcsIn and
+    // Node::arcsOut.
+    m_pre_places.resize(m_pre_offsets.back());
+    m_pre_arcs.resize(m_pre_offsets.back());
+    m_pre_weights.resize(m_pre_offsets.back());
+    m_post_places.resize(m_post_offsets.back());
+    m_post_arcs.resize(m_post_offsets.back());
+    m_post_durations.resize(m_post_offsets.back());
+    m_post_weights.resize(m_post_offsets.back());
+    m_place_in_transitions.resize(m_place_in_offsets.back());
+    m_place_in_durations.resize(m_place_in_offsets.back());
+    m_place_out_transitions.resize(m_place_out_offsets.back());
+
+    std::vector<Index> pre(m_pre_offsets.begin(), m_pre_offsets.end() - 1);
+    std::vector<Index> post(m_post_offsets.begin(), m_post_offsets.end() - 1);
+    std::vector<Index> in(m_place_in_offsets.begin(), m_place_in_offsets.end() - 1);
+    std::vector<Index> out(m_place_out_offsets.begin(), m_place_out_offsets.end() - 1);
+    Index i = 0u;
+    for (auto const& a: net.arcs())
+    {
+        if (a.from.type == Node::Type::Place)
+        {
+            Index const k = pre[a.to.id]++;
+            m_pre_places[k] = Index(a.from.id);
+            m_pre_arcs[k] = i;
+            m_pre_weights[k] = Count(a.weight);
+            m_place_out_transitions[out[a.from.id]++] = Index(a.to.id);
+        }
+        else
+        {
+            Index const k = post[a.from.id]++;
+            m_post_places[k] = Index(a.to.id);
+            m_post_arcs[k] = i;
+            m_post_durations[k] = a.duration;
+            m_post_weights[k] = Count(a.weight);
+            Index const j = in[a.to.id]++;
+            m_place_in_transitions[j] = Index(a.from.id);
+            m_place_in_durations[j] = a.duration;
+        }
+        ++i;
+    }
+
+    // Precompute the kind of transitions
+    m_kinds.resize(ntransitions);
+    for (size_t t = 0u; t < ntransitions; ++t)
+    {
+        bool const has_in = (m_pre_offsets[t + 1u] != m_pre_offsets[t]);
+        bool const has_out = (m_post_offsets[t + 1u] != m_post_offsets[t]);
+        m_kinds[t] = has_in ? (has_out ? Kind::State : Kind::Output)
+                            : (has_out ? Kind::Input : Kind::Isolated);
+    }
+
+    // Structural conflict clusters: union of downstream transitions of each
+    // place, then number clusters in the order of their first transition.
+    std::vector<Index> parents(ntransitions);
+    for (size_t t = 0u; t < ntransitions; ++t)
+        parents[t] = Index(t);
+    for (size_t p = 0u; p < nplaces; ++p)
+    {
+        auto const transitions = outputTransitions(p);
+        for (size_t k = 1u; k < transitions.size(); ++k)
+        {
+            Index const a = findRoot(parents, transitions[0]);
+            Index const b = findRoot(parents, transitions[k]);
+            parents[std::max(a, b)] = std::min(a, b);
+        }
+    }
+    m_clusters.resize(ntransitions);
+    m_nclusters = 0u;
+    for (size_t t = 0u; t < ntransitions; ++t)
+    {
+        // Roots are the smallest transitions of their cluster: they are
+        // numbered before the other transitions of their cluster.
+        Index const root = findRoot(parents, Index(t));
+        m_clusters[t] = (root == t) ? Index(m_nclusters++) : m_clusters[root];
+    }
+
+    m_tokens.assign(nplaces, 0u);
+    m_receptivities.assign(ntransitions, 0u);
+    m_candidate_transitions.assign(ntransitions, 1u);
+    m_candidates.resize(ntransitions);
+    for (size_t t = 0u; t < ntransitions; ++t)
+        m_candidates[t] = Index(t);
+    if (!readMarking(net))
+    {
+        return fail("A place has more than " + std::to_string(maxCount())
+                    + " tokens");
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool CompiledNet::fail(std::string const& error)
+{
+    *this = CompiledNet();
+    m_error = error;
+    return false;
+}
+
+//------------------------------------------------------------------------------
+bool CompiledNet::readMarking(Net const& net)
+{
+    assert(net.places().size() == m_tokens.size());
+    assert(net.transitions().size() == m_receptivities.size());
+
+    bool saturated = false;
+    for (auto const& p: net.places())
+    {
+        saturated |= (p.tokens > maxCount());
+        Count const tokens = Count(std::min(p.tokens, maxCount()));
+        if (tokens > m_tokens[p.id])
+        {
+            gainedTokens(p.id);
+        }
+        m_tokens[p.id] = tokens;
+    }
+    for (auto const& t: net.transitions())
+    {
+        if (t.receptivity && (m_receptivities[t.id] == 0u))
+        {
+            touchCandidate(t.id);
+        }
+        m_receptivities[t.id] = t.receptivity ? 1u : 0u;
+    }
+
+    m_dirty_places.assign(m_tokens.size(), 0u);
+    m_modified_places.clear();
+    m_dirty_transitions.assign(m_receptivities.size(), 0u);
+    m_modified_transitions.clear();
+
+    return !saturated;
+}
+
+//------------------------------------------------------------------------------
+void CompiledNet::writeMarking(Net& net)
+{
+    assert(net.places().size() == m_tokens.size());
+    assert(net.transitions().size() == m_receptivities.size());
+
+    for (auto const p: m_modified_places)
+    {
+        net.places()[p].tokens = m_tokens[p];
+        m_dirty_places[p] = 0u;
+    }
+    m_modified_places.clear();
+
+    for (auto const t: m_modified_transitions)
+    {
+        net.transitions()[t].receptivity = (m_receptivities[t] != 0u);
+        m_dirty_transitions[t] = 0u;
+    }
+    m_modified_transitions.clear();
+}
+
+//------------------------------------------------------------------------------
+void CompiledNet::touchPlace(size_t const place)
+{
+    if (m_dirty_places[place] == 0u)
+    {
+        m_dirty_places[place] = 1u;
+        m_modified_places.push_back(Index(place));
+    }
+}
+
+//------------------------------------------------------------------------------
+void CompiledNet::touchCandidate(size_t const transition)
+{
+    if (m_candidate_transitions[transition] == 0u)
+    {
+        m_candidate_transitions[transition] = 1u;
+        m_candidates.push_back(Index(transition));
+    }
+}
+
+//------------------------------------------------------------------------------
+void CompiledNet::gainedTokens(size_t const place)
+{
+    for (auto const t: outputTransitions(place))
+    {
+        touchCandidate(t);
+    }
+}
+
+//------------------------------------------------------------------------------
+void CompiledNet::takeCandidates(std::vector<size_t>& candidates)
+{
+    candidates.clear();
+    for (auto const t: m_candidates)
+    {
+        candidates.push_back(t);
+        m_candidate_transitions[t] = 0u;
+    }
+    m_candidates.clear();
+}
+
+//------------------------------------------------------------------------------
+void CompiledNet::restore(std::vector<Count> const& tokens,
+                          std::vector<uint8_t> const& receptivities,
+                          std::vector<Index> const& candidates)
+{
+    assert(tokens.size() == m_tokens.size());
+    assert(receptivities.size() == m_receptivities.size());
+
+    m_tokens = tokens;
+    m_receptivities = receptivities;
+    for (size_t p = 0u; p < m_tokens.size(); ++p)
+    {
+        touchPlace(p);
+    }
+    for (size_t t = 0u; t < m_receptivities.size(); ++t)
+    {
+        if (m_dirty_transitions[t] == 0u)
+        {
+            m_dirty_transitions[t] = 1u;
+            m_modified_transitions.push_back(Index(t));
+        }
+    }
+
+    for (auto const t: m_candidates)
+    {
+        m_candidate_transitions[t] = 0u;
+    }
+    m_candidates.clear();
+    for (auto const t: candidates)
+    {
+        touchCandidate(t);
+    }
+}
+
+//------------------------------------------------------------------------------
+void CompiledNet::tokens(size_t const place, size_t const count)
+{
+    if (count > maxCount())
+    {
+        ++m_overflows;
+    }
+    Count const tokens = Count(std::min(m_max_tokens, count));
+    if (tokens > m_tokens[place])
+    {
+        gainedTokens(place);
+    }
+    m_tokens[place] = tokens;
+    touchPlace(place);
+}
+
+//------------------------------------------------------------------------------
+void CompiledNet::receptivity(size_t const transition, bool const value)
+{
+    if (value && (m_receptivities[transition] == 0u))
+    {
+        touchCandidate(transition);
+    }
+    m_receptivities[transition] = value ? 1u : 0u;
+    if (m_dirty_transitions[transition] == 0u)
+    {
+        m_dirty_transitions[transition] = 1u;
+        m_modified_transitions.push_back(Index(transition));
+    }
+}
+
+//------------------------------------------------------------------------------
+bool CompiledNet::isValidated(size_t const transition) const
+{
+    // Transition source will always produce tokens. To enabled other
+    // transitions, all its previous Places shall have at least as many tokens
+    // as the weight of their arc.
+    size_t const offset = m_pre_offsets[transition];
+    size_t const end = m_pre_offsets[transition + 1u];
+    for (size_t k = offset; k < end; ++k)
+    {
+        if (m_tokens[m_pre_places[k]] < m_pre_weights[k])
+            return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+size_t CompiledNet::countBurnableTokens(size_t const transition) const
+{
+    // Transition source will fire one token iff the animated token
+    // transitioning along the arcs has reached the Place.
+    auto const places = prePlaces(transition);
+    if (places.size() == 0u)
+        return size_t(receptivity(transition));
+
+    // The transition is false => it does not let burn tokens.
+    if (!receptivity(transition))
+        return 0u;
+
+    // Iterate on all previous places to know how many tokens can be burned.
+    size_t const burnt = enablingDegree(transition);
+    if (burnt == 0u)
+        return 0u;
+    return (m_settings.firing == NetSettings::Fire::OneByOne) ? 1u : burnt;
+}
+
+//------------------------------------------------------------------------------
+size_t CompiledNet::enablingDegree(size_t const transition) const
+{
+    auto const places = prePlaces(transition);
+    if (places.size() == 0u)
+        return 1u;
+
+    size_t degree = static_cast<size_t>(-1);
+    auto const weights = preWeights(transition);
+    for (size_t k = 0u; k < places.size(); ++k)
+    {
+        size_t const tokens = m_tokens[places[k]] / weights[k];
+        if (tokens == 0u)
+            return 0u;
+
+        if (tokens < degree)
+            degree = tokens;
+    }
+    return degree;
+}
+
+//------------------------------------------------------------------------------
+void CompiledNet::consume(size_t const transition, size_t const count)
+{
+    size_t const offset = m_pre_offsets[transition];
+    size_t const end = m_pre_offsets[transition + 1u];
+    for (size_t k = offset; k < end; ++k)
+    {
+        size_t const p = m_pre_places[k];
+        size_t const burnt = count * m_pre_weights[k];
+        assert(m_tokens[p] >= burnt);
+        m_tokens[p] = Count(std::min(m_max_tokens, m_tokens[p] - burnt));
+        touchPlace(p);
+    }
+}
+
+//------------------------------------------------------------------------------
+void CompiledNet::produce(size_t const transition, size_t const count)
+{
+    size_t const offset = m_post_offsets[transition];
+    size_t const end = m_post_offsets[transition + 1u];
+    for (size_t k = offset; k < end; ++k)
+    {
+        size_t const p = m_post_places[k];
+        m_tokens[p] = Count(addTokens(m_tokens[p], count, m_post_weights[k]));
+        gainedTokens(p);
+        touchPlace(p);
+    }
+}
+
+//------------------------------------------------------------------------------
+void CompiledNet::deposit(size_t const place, size_t const count)
+{
+    m_tokens[place] = Count(addTokens(m_tokens[place], count, 1u));
+    gainedTokens(place);
+    touchPlace(place);
+}
+
+//------------------------------------------------------------------------------
+size_t CompiledNet::addTokens(size_t const tokens, size_t const count,
+                              size_t const weight)
+{
+    // Saturated addition of tokens and count * weight. Tokens are lost when
+    // the counter cannot hold them: remember it.
+    size_t const max = maxCount();
+    if ((weight != 0u) && ((count > max / weight) || (count * weight > max - tokens)))
+    {
+        ++m_overflows;
+        return std::min(m_max_tokens, max);
+    }
+    return std::min(m_max_tokens, tokens + count * weight);
+}
+
+//------------------------------------------------------------------------------
+void CompiledNet::fire(size_t const transition, size_t const count)
+{
+    consume(transition, count);
+    produce(transition, count);
+}
+
+} // namespace tpne
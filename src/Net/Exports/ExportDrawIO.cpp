@@ -58,7 +58,7 @@ std::string exportToDrawIO(Net const& net, std::string const& filename)
     // Places
     for (auto const& p: net.places())
     {
-        file << "        <mxCell id=\"" << p.key << "\" value=\"" << p.caption
+        file << "        <mxCell id=\"" << p.key() << "\" value=\"" << p.caption()
              << "\" style=\"ellipse;whiteSpace=wrap;html=1;aspect=fixed;\" vertex=\"1\" parent=\"1\">\n"
              << "          <mxGeometry x=\"" << p.x << "\" y=\"" << p.y
              << "\" width=\"" << (PLACE_RADIUS * scale) << "\" height=\"" << (PLACE_RADIUS * scale)
@@ -70,7 +70,7 @@ std::string exportToDrawIO(Net const& net, std::string const& filename)
     {
         std::string color = (t.isFireable() ? "green" : "red");
 
-        file << "        <mxCell id=\"" << t.key << "\" value=\"" << t.caption
+        file << "        <mxCell id=\"" << t.key() << "\" value=\"" << t.caption()
              << "\" style=\"whiteSpace=wrap;html=1;aspect=fixed;\" vertex=\"1\" parent=\"1\">\n"
              << "          <mxGeometry x=\"" << t.x << "\" y=\"" << t.y
              << "\" width=\"" << (TRANS_WIDTH * scale) << "\" height=\"" << (TRANS_HEIGHT * scale)
@@ -80,9 +80,9 @@ std::string exportToDrawIO(Net const& net, std::string const& filename)
     // Arcs
     for (auto const& a: net.arcs())
     {
-        file << "        <mxCell id=\"" << a.from.key << a.to.key << "\" value=\"\" "
+        file << "        <mxCell id=\"" << a.from.key() << a.to.key() << "\" value=\"\" "
              << "style=\"endArrow=classic;html=1;rounded=0;exitX=0.5;exitY=1;exitDx=0;exitDy=0;entryX=0.5;entryY=0;entryDx=0;entryDy=0;\" "
-             << "edge=\"1\" parent=\"1\" source=\"" << a.from.key << "\" target=\"" << a.to.key << "\">\n"
+             << "edge=\"1\" parent=\"1\" source=\"" << a.from.key() << "\" target=\"" << a.to.key() << "\">\n"
              << "          <mxGeometry width=\"50\" height=\"50\" relative=\"1\" as=\"geometry\">\n"
              << "            <mxPoint x=\"" << a.from.x << "\" y=\"" << a.from.y << "\" as=\"sourcePoint\" />\n"
              << "            <mxPoint x=\"" << a.to.x << "\" y=\"" << a.to.y << "\" as=\"targetPoint\" />\n"
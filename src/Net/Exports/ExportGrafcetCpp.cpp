@@ -155,8 +155,8 @@ public:
             file << del << "X[" << p->from.id << "]";
             del = " & ";
         }
-        file << del << t.key << "();"
-             << " // Transition " << t.id << ": " << t.caption
+        file << del << t.key() << "();"
+             << " // Transition " << t.id << ": " << t.caption()
              << std::endl;
     }
 
@@ -193,7 +193,7 @@ public:
         {
             file << " | init";
         }
-        file << "; // Step " << p.id << ": " << p.caption << std::endl;
+        file << "; // Step " << p.id << ": " << p.caption() << std::endl;
     }
 
     file << std::endl << "        // Update outputs:" << std::endl;
@@ -239,11 +239,11 @@ private:  // You have to implement the following methods in the C++ file
     {
         file << "    //-------------------------------------------------------------------------" << std::endl;
         file << "    //! \\brief Compute the receptivity of the transition " << t.id << "." << std::endl;
-        file << "    //! RPN boolean equation: \"" << t.caption << "\"" << std::endl;
+        file << "    //! RPN boolean equation: \"" << t.caption() << "\"" << std::endl;
         file << "    //! \\return true if the transition is enabled." << std::endl;
         file << "    //-------------------------------------------------------------------------" << std::endl;
         file << "    bool T" << t.id << "() const { return !!("
-             << Receptivity::Parser::translate(t.caption, "C")
+             << Receptivity::Parser::translate(t.caption(), "C")
              << "); }" << std::endl;
     }
 
@@ -251,7 +251,7 @@ private:  // You have to implement the following methods in the C++ file
     for (auto const& p: net.places())
     {
         file << "    //-------------------------------------------------------------------------" << std::endl;
-        file << "    //! \\brief Do actions associated with the step " << p.id << ": " << p.caption << std::endl;
+        file << "    //! \\brief Do actions associated with the step " << p.id << ": " << p.caption() << std::endl;
         file << "    //-------------------------------------------------------------------------" << std::endl;
         file << "    void P" << p.id << "(const bool activated);" << std::endl;
     }
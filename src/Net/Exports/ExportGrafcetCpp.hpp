@@ -106,7 +106,7 @@ public:
     {
         file << "        X[" << m_places[i].id << "] = "
              << (m_places[i].tokens ? "true; " : "false;")
-             << " // " << m_places[i].caption
+             << " // " << m_places[i].caption()
              << std::endl;
     }
 
@@ -200,12 +200,12 @@ private:
     for (auto const& t: m_transitions)
     {
         file << "    //-------------------------------------------------------------------------" << std::endl;
-        file << "    //! \\brief Transition " << t.id <<  ": \"" << t.caption << "\"" << std::endl;
+        file << "    //! \\brief Transition " << t.id <<  ": \"" << t.caption() << "\"" << std::endl;
         file << "    //! \\return true if the transition is enabled." << std::endl;
         file << "    //-------------------------------------------------------------------------" << std::endl;
         if (m_type == PetriNet::Type::GRAFCET)
         {
-            file << "    bool T" << t.id << "() { return " << Receptivity::Parser::translate(t.caption, "C") << "; } const";
+            file << "    bool T" << t.id << "() { return " << Receptivity::Parser::translate(t.caption(), "C") << "; } const";
         }
         else
         {
@@ -217,7 +217,7 @@ private:
     for (auto const& p: m_places)
     {
         file << "    //-------------------------------------------------------------------------" << std::endl;
-        file << "    //! \\brief Do actions associated with the step " << p.id << ": " << p.caption << std::endl;
+        file << "    //! \\brief Do actions associated with the step " << p.id << ": " << p.caption() << std::endl;
         file << "    //-------------------------------------------------------------------------" << std::endl;
         file << "    void P" << p.id << "();" << std::endl << std::endl;
     }
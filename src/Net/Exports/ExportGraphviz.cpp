@@ -43,7 +43,7 @@ std::string exportToGraphviz(Net const& net, std::string const& filename)
     file << "node [shape=circle, color=blue]" << std::endl;
     for (auto const& p: net.places())
     {
-        file << "  " << p.key << " [label=\"" << p.caption;
+        file << "  " << p.key() << " [label=\"" << p.caption();
         if (p.tokens > 0u)
         {
             file << "\\n" << p.tokens << "&bull;";
@@ -57,14 +57,14 @@ std::string exportToGraphviz(Net const& net, std::string const& filename)
     {
         if (t.isFireable())
         {
-            file << "  " << t.key << " [label=\""
-                 << t.caption << "\", color=green];"
+            file << "  " << t.key() << " [label=\""
+                 << t.caption() << "\", color=green];"
                  << std::endl;
         }
         else
         {
-            file << "  " << t.key << " [label=\""
-                 << t.caption << "\"];"
+            file << "  " << t.key() << " [label=\""
+                 << t.caption() << "\"];"
                  << std::endl;
         }
     }
@@ -73,7 +73,7 @@ std::string exportToGraphviz(Net const& net, std::string const& filename)
     file << "edge [style=\"\"]" << std::endl;
     for (auto const& a: net.arcs())
     {
-        file << "  " << a.from.key << " -> " << a.to.key;
+        file << "  " << a.from.key() << " -> " << a.to.key();
         if (a.from.type == Node::Type::Transition)
         {
             file << " [label=\"" << a.duration << "\"]";
@@ -52,7 +52,7 @@ std::string exportToJSON(Net const& net, std::string const& filename)
     for (auto const& p: net.places())
     {
         file << separator; separator = ",\n";
-        file << "            { \"id\": " << p.id << ", \"caption\": \"" << p.caption
+        file << "            { \"id\": " << p.id << ", \"caption\": \"" << p.caption()
              << "\", \"tokens\": " << p.tokens << ", \"x\": " << p.x
              << ", \"y\": " << p.y << " }";
     }
@@ -63,8 +63,14 @@ std::string exportToJSON(Net const& net, std::string const& filename)
     for (auto const& t: net.transitions())
     {
         file << separator; separator = ",\n";
-        file << "            { \"id\": " << t.id << ", \"caption\": \"" << t.caption << "\", \"x\": "
-             << t.x << ", \"y\": " << t.y << ", \"angle\": " << t.angle << " }";
+        file << "            { \"id\": " << t.id << ", \"caption\": \"" << t.caption() << "\", \"x\": "
+             << t.x << ", \"y\": " << t.y << ", \"angle\": " << t.angle;
+        if (!t.delay.isDefault())
+        {
+            file << ", \"delay\": { \"law\": \"" << Distribution::to_str(t.delay.law)
+                 << "\", \"a\": " << t.delay.a << ", \"b\": " << t.delay.b << " }";
+        }
+        file << " }";
     }
 
     // Arcs
@@ -73,9 +79,11 @@ std::string exportToJSON(Net const& net, std::string const& filename)
     for (auto const& a: net.arcs())
     {
         file << separator; separator = ",\n";
-        file << "            { \"from\": \"" << a.from.key << "\", " << "\"to\": \"" << a.to.key << "\"";
+        file << "            { \"from\": \"" << a.from.key() << "\", " << "\"to\": \"" << a.to.key() << "\"";
         if (a.from.type == Node::Type::Transition)
             file << ", \"duration\": " << a.duration;
+        if (a.weight != 1u)
+            file << ", \"weight\": " << a.weight;
         file << " }";
     }
 
@@ -81,7 +81,7 @@ std::string exportToJulia(Net const& net, std::string const& filename)
         if (t.isInput())
         {
             indices[t.id] = nb_inputs++;
-            file << "# " << t.key << ": input (U"
+            file << "# " << t.key() << ": input (U"
                  << nb_inputs << ")" << std::endl;
         }
     }
@@ -92,7 +92,7 @@ std::string exportToJulia(Net const& net, std::string const& filename)
         if (t.isState())
         {
             indices[t.id] = nb_states++;
-            file << "# " << t.key << ": state (X"
+            file << "# " << t.key() << ": state (X"
                  << nb_states << ")" << std::endl;
         }
     }
@@ -103,7 +103,7 @@ std::string exportToJulia(Net const& net, std::string const& filename)
         if (t.isOutput())
         {
             indices[t.id] = nb_outputs++;
-            file << "# " << t.key << ": output (Y" << nb_outputs
+            file << "# " << t.key() << ": output (Y" << nb_outputs
                  << ")" << std::endl;
         }
     }
@@ -126,7 +126,7 @@ std::string exportToJulia(Net const& net, std::string const& filename)
         Transition& from = *reinterpret_cast<Transition*>(&(p.arcsIn[0]->from));
         Transition& to = *reinterpret_cast<Transition*>(&(p.arcsOut[0]->to));
 
-        file << "# Arc " << p.key << ": " << from.key << " -> " << to.key
+        file << "# Arc " << p.key() << ": " << from.key() << " -> " << to.key()
              << " (Duration: " << p.arcsIn[0]->duration
              << ", Tokens: " << p.tokens << ")" << std::endl;
     }
@@ -46,8 +46,8 @@ std::string exportToPNML(Net const& net, std::string const& filename)
     // Places
     for (auto const& p: net.places())
     {
-        file << "       <place id=\"" << p.key << "\">" << std::endl;
-        file << "           <name><text>" << p.caption << "</text>" << std::endl;
+        file << "       <place id=\"" << p.key() << "\">" << std::endl;
+        file << "           <name><text>" << p.caption() << "</text>" << std::endl;
         file << "           <graphics><offset x=\"0\" y=\"0\"/></graphics></name>" << std::endl;
         file << "           <graphics><position x=\"" << p.x << "\" y=\"" << p.y << "\"/></graphics>" << std::endl;
         file << "           <initialMarking><text>" << p.tokens << "</text></initialMarking>" << std::endl;
@@ -57,8 +57,8 @@ std::string exportToPNML(Net const& net, std::string const& filename)
     // Transitions
     for (auto const& t: net.transitions())
     {
-        file << "       <transition id=\"" << t.key << "\">" << std::endl;
-        file << "           <name><text>" << t.caption << "</text><graphics><offset x=\"0\" y=\"0\"/></graphics></name>" << std::endl;
+        file << "       <transition id=\"" << t.key() << "\">" << std::endl;
+        file << "           <name><text>" << t.caption() << "</text><graphics><offset x=\"0\" y=\"0\"/></graphics></name>" << std::endl;
         file << "           <graphics><position x=\"" << t.x << "\" y=\"" << t.y << "\"/></graphics>" << std::endl;
         file << "       </transition>" << std::endl;
     }
@@ -66,8 +66,10 @@ std::string exportToPNML(Net const& net, std::string const& filename)
     // Arcs
     for (auto const& a: net.arcs())
     {
-        file << "       <arc id=\"" << a.from.key << a.to.key << "\" source=\"" << a.from.key << "\" target=\"" << a.to.key << "\">" << std::endl;
+        file << "       <arc id=\"" << a.from.key() << a.to.key() << "\" source=\"" << a.from.key() << "\" target=\"" << a.to.key() << "\">" << std::endl;
         file << "           <inscription><text>" << a.duration << "</text></inscription>" << std::endl;
+        if (a.weight != 1u)
+            file << "           <weight><text>" << a.weight << "</text></weight>" << std::endl;
         file << "           <graphics/>" << std::endl;
         file << "       </arc>" << std::endl;
     }
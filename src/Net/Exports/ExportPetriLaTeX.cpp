@@ -54,11 +54,11 @@ std::string exportToPetriLaTeX(Net const& net, std::string const& filename)
     for (auto const& p: net.places())
     {
         file << "\\node[place, "
-             << "label=above:$" << p.caption << "$, "
+             << "label=above:$" << p.caption() << "$, "
              << "fill=blue!25, "
              << "draw=blue!75, "
              << "tokens=" << p.tokens << "] "
-             << "(" << p.key << ") at (" << int(p.x * scale_x)
+             << "(" << p.key() << ") at (" << int(p.x * scale_x)
              << ", " << int(-p.y * scale_y) << ") {};"
              << std::endl;
     }
@@ -70,10 +70,10 @@ std::string exportToPetriLaTeX(Net const& net, std::string const& filename)
         std::string color = (t.isFireable() ? "green" : "red");
 
         file << "\\node[transition, "
-             << "label=above:$" << t.caption << "$, "
+             << "label=above:$" << t.caption() << "$, "
              << "fill=" << color << "!25, "
              << "draw=" << color << "!75] "
-             << "(" << t.key << ") at (" << int(t.x * scale_x)
+             << "(" << t.key() << ") at (" << int(t.x * scale_x)
              << ", " << int(-t.y * scale_y) << ") {};"
              << std::endl;
     }
@@ -87,16 +87,16 @@ std::string exportToPetriLaTeX(Net const& net, std::string const& filename)
             std::stringstream duration;
             duration << std::fixed << std::setprecision(2) << a.duration;
             file << "\\draw[-latex, thick] "
-                 << "(" << a.from.key << ") -- "
+                 << "(" << a.from.key() << ") -- "
                  << "node[midway, above right] "
                  << "{" << duration.str() << "} "
-                 << "(" << a.to.key << ");"
+                 << "(" << a.to.key() << ");"
                  << std::endl;
         }
         else
         {
             file << "\\draw[-latex, thick] "
-                 << "(" << a.from.key << ") -- " << "(" << a.to.key << ");"
+                 << "(" << a.from.key() << ") -- " << "(" << a.to.key() << ");"
                  << std::endl;
         }
     }
@@ -125,7 +125,7 @@ std::string exportToPNEditor(Net const& net, std::string const& filename)
 
         for (auto const& p: net.places())
         {
-            file << p.caption << std::endl;
+            file << p.caption() << std::endl;
         }
     }
 
@@ -143,7 +143,7 @@ std::string exportToPNEditor(Net const& net, std::string const& filename)
 
         for (auto const& t: net.transitions())
         {
-            file << t.caption << std::endl;
+            file << t.caption() << std::endl;
         }
     }
 
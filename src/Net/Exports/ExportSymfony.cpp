@@ -56,7 +56,7 @@ std::string exportToSymfony(Net const& net, std::string const& filename)
     {
         if (p.tokens > 0u)
         {
-            file << "                - " << p.caption << std::endl;
+            file << "                - " << p.caption() << std::endl;
         }
     }
 
@@ -64,7 +64,7 @@ std::string exportToSymfony(Net const& net, std::string const& filename)
     file << "            places:" << std::endl;
     for (auto const& p: net.places())
     {
-        file << "                - " << p.caption << std::endl;
+        file << "                - " << p.caption() << std::endl;
     }
 
     // Transitions
@@ -72,12 +72,12 @@ std::string exportToSymfony(Net const& net, std::string const& filename)
     for (auto const& t: net.transitions())
     {
         // From
-        file << "                " << t.caption << ":" << std::endl;
+        file << "                " << t.caption() << ":" << std::endl;
         file << "                    from:" << std::endl;
 
         for (auto const& it: t.arcsIn)
         {
-            file << "                        - " << it->from.caption << std::endl;
+            file << "                        - " << it->from.caption() << std::endl;
         }
 
 
@@ -85,7 +85,7 @@ std::string exportToSymfony(Net const& net, std::string const& filename)
         file << "                    to:" << std::endl;
         for (auto const& it: t.arcsOut)
         {
-            file << "                        - " << it->to.caption << std::endl;
+            file << "                        - " << it->to.caption() << std::endl;
         }
     }
     return {};
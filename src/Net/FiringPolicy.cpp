@@ -0,0 +1,242 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "TimedPetriNetEditor/FiringPolicy.hpp"
+#include <algorithm>
+#include <random>
+#include <cassert>
+
+namespace tpne {
+
+//------------------------------------------------------------------------------
+std::unique_ptr<FiringPolicy> RandomPolicy::clone() const
+{
+    return std::unique_ptr<FiringPolicy>(new RandomPolicy(*this));
+}
+
+//------------------------------------------------------------------------------
+void RandomPolicy::reset(size_t const /*transitions*/)
+{
+    m_pending.clear();
+    m_next = 0u;
+    m_shuffled = false;
+}
+
+//------------------------------------------------------------------------------
+void RandomPolicy::push(size_t const transition)
+{
+    // Previous round fully popped: start a new one.
+    if (m_shuffled && (m_next == m_pending.size()))
+    {
+        reset(0u);
+    }
+    m_pending.push_back(transition);
+}
+
+//------------------------------------------------------------------------------
+size_t RandomPolicy::pop(Random& random)
+{
+    assert(!empty());
+    if (!m_shuffled)
+    {
+        std::shuffle(m_pending.begin(), m_pending.end(), random);
+        m_shuffled = true;
+    }
+    return m_pending[m_next++];
+}
+
+//------------------------------------------------------------------------------
+void PriorityPolicy::priority(size_t const transition, int const value)
+{
+    if (transition >= m_priorities.size())
+    {
+        m_priorities.resize(transition + 1u, 0);
+    }
+    m_priorities[transition] = value;
+}
+
+//------------------------------------------------------------------------------
+int PriorityPolicy::priority(size_t const transition) const
+{
+    return (transition < m_priorities.size()) ? m_priorities[transition] : 0;
+}
+
+//------------------------------------------------------------------------------
+std::unique_ptr<FiringPolicy> PriorityPolicy::clone() const
+{
+    return std::unique_ptr<FiringPolicy>(new PriorityPolicy(*this));
+}
+
+//------------------------------------------------------------------------------
+void PriorityPolicy::reset(size_t const transitions)
+{
+    m_priorities.resize(transitions, 0);
+    m_heap.reset(transitions);
+}
+
+//------------------------------------------------------------------------------
+void PriorityPolicy::push(size_t const transition)
+{
+    // Min-heap: the highest priority has the lowest key.
+    m_heap.push(transition, -int64_t(priority(transition)));
+}
+
+//------------------------------------------------------------------------------
+size_t PriorityPolicy::pop(Random& /*random*/)
+{
+    return m_heap.pop();
+}
+
+//------------------------------------------------------------------------------
+std::unique_ptr<FiringPolicy> FifoPolicy::clone() const
+{
+    return std::unique_ptr<FiringPolicy>(new FifoPolicy(*this));
+}
+
+//------------------------------------------------------------------------------
+void FifoPolicy::reset(size_t const transitions)
+{
+    m_stamps.assign(transitions, 0u);
+    m_counter = 0u;
+    m_heap.reset(transitions);
+}
+
+//------------------------------------------------------------------------------
+void FifoPolicy::push(size_t const transition)
+{
+    if (transition >= m_stamps.size())
+    {
+        m_stamps.resize(transition + 1u, 0u);
+    }
+    m_heap.push(transition, int64_t(m_stamps[transition]));
+}
+
+//------------------------------------------------------------------------------
+size_t FifoPolicy::pop(Random& /*random*/)
+{
+    return m_heap.pop();
+}
+
+//------------------------------------------------------------------------------
+void FifoPolicy::fired(size_t const transition)
+{
+    if (transition >= m_stamps.size())
+    {
+        m_stamps.resize(transition + 1u, 0u);
+    }
+    m_stamps[transition] = ++m_counter;
+}
+
+//------------------------------------------------------------------------------
+void FifoPolicy::save(std::vector<uint64_t>& state) const
+{
+    state.assign(m_stamps.begin(), m_stamps.end());
+    state.push_back(m_counter);
+}
+
+//------------------------------------------------------------------------------
+void FifoPolicy::restore(std::vector<uint64_t> const& state)
+{
+    if (state.empty())
+        return ;
+
+    m_stamps.assign(state.begin(), state.end() - 1);
+    m_counter = state.back();
+}
+
+//------------------------------------------------------------------------------
+void WeightedRandomPolicy::weight(size_t const transition, uint32_t const value)
+{
+    assert((m_tree.empty()) || (m_count == 0u));
+    if (transition >= m_weights.size())
+    {
+        m_weights.resize(transition + 1u, 1u);
+    }
+    m_weights[transition] = std::max(1u, value);
+}
+
+//------------------------------------------------------------------------------
+uint32_t WeightedRandomPolicy::weight(size_t const transition) const
+{
+    return (transition < m_weights.size()) ? m_weights[transition] : 1u;
+}
+
+//------------------------------------------------------------------------------
+std::unique_ptr<FiringPolicy> WeightedRandomPolicy::clone() const
+{
+    return std::unique_ptr<FiringPolicy>(new WeightedRandomPolicy(*this));
+}
+
+//------------------------------------------------------------------------------
+void WeightedRandomPolicy::reset(size_t const transitions)
+{
+    m_weights.resize(transitions, 1u);
+    size_t size = 1u;
+    while (size < transitions)
+        size <<= 1u;
+    m_tree.assign(size + 1u, 0u);
+    m_count = 0u;
+}
+
+//------------------------------------------------------------------------------
+void WeightedRandomPolicy::add(size_t const transition, int64_t const delta)
+{
+    for (size_t i = transition + 1u; i < m_tree.size(); i += i & (~i + 1u))
+    {
+        m_tree[i] = uint64_t(int64_t(m_tree[i]) + delta);
+    }
+}
+
+//------------------------------------------------------------------------------
+void WeightedRandomPolicy::push(size_t const transition)
+{
+    if (transition + 1u >= m_tree.size())
+    {
+        reset(transition + 1u);
+    }
+    add(transition, int64_t(weight(transition)));
+    ++m_count;
+}
+
+//------------------------------------------------------------------------------
+size_t WeightedRandomPolicy::pop(Random& random)
+{
+    assert(!empty());
+
+    // The whole sum is held by the root of the power of two tree. Descend it
+    // for the first transition whose prefix sum exceeds the drawn value.
+    size_t const size = m_tree.size() - 1u;
+    uint64_t value = std::uniform_int_distribution<uint64_t>(0u, m_tree[size] - 1u)(random);
+    size_t position = 0u;
+    for (size_t step = size; step != 0u; step >>= 1u)
+    {
+        if ((position + step < m_tree.size()) && (m_tree[position + step] <= value))
+        {
+            position += step;
+            value -= m_tree[position];
+        }
+    }
+
+    add(position, -int64_t(weight(position)));
+    --m_count;
+    return position;
+}
+
+} // namespace tpne
@@ -0,0 +1,358 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "TimedPetriNetEditor/FluidSimulator.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace tpne {
+
+//! \brief Maximal number of rounds of the fixed point of finite server flows.
+static constexpr size_t MAX_ROUNDS = 1000u;
+
+//------------------------------------------------------------------------------
+FluidSimulator::FluidSimulator(Net const& net)
+{
+    reset(net);
+}
+
+//------------------------------------------------------------------------------
+bool FluidSimulator::reset(Net const& net)
+{
+    m_error.clear();
+    bool res = m_compiled.compile(net);
+    size_t const places = m_compiled.places();
+    size_t const transitions = m_compiled.transitions();
+
+    m_server = net.settings().server;
+    m_time = 0.0;
+    m_events = 0u;
+    m_marking.resize(places);
+    for (size_t p = 0u; p < places; ++p)
+    {
+        m_marking[p] = double(m_compiled.tokens(p));
+    }
+    m_firings.assign(transitions, 0.0);
+    m_rates.assign(transitions, 0.0);
+    for (auto const& t: net.transitions())
+    {
+        if (t.id >= transitions)
+            continue;
+
+        double const mean = t.delay.mean();
+        if (mean > 0.0)
+        {
+            m_rates[t.id] = 1.0 / mean;
+        }
+        else if (res)
+        {
+            m_error = "Transition " + t.key() + " has no delay: immediate "
+                      "transitions have no fluid approximation";
+            res = false;
+        }
+    }
+
+    // Downstream transitions of places with the weight of their arcs.
+    m_consumer_offsets.assign(places + 1u, 0u);
+    for (size_t t = 0u; t < transitions; ++t)
+    {
+        for (auto const p: m_compiled.prePlaces(t))
+        {
+            ++m_consumer_offsets[p + 1u];
+        }
+    }
+    for (size_t p = 0u; p < places; ++p)
+    {
+        m_consumer_offsets[p + 1u] += m_consumer_offsets[p];
+    }
+    m_consumers.resize(m_consumer_offsets[places]);
+    m_consumer_weights.resize(m_consumer_offsets[places]);
+    std::vector<CompiledNet::Index> cursors(m_consumer_offsets.begin(),
+                                            m_consumer_offsets.end() - 1);
+    for (size_t t = 0u; t < transitions; ++t)
+    {
+        auto const pre = m_compiled.prePlaces(t);
+        auto const weights = m_compiled.preWeights(t);
+        for (size_t i = 0u; i < pre.size(); ++i)
+        {
+            CompiledNet::Index const slot = cursors[pre[i]]++;
+            m_consumers[slot] = CompiledNet::Index(t);
+            m_consumer_weights[slot] = double(weights[i]);
+        }
+    }
+
+    return res;
+}
+
+//------------------------------------------------------------------------------
+std::vector<double> const& FluidSimulator::flows()
+{
+    compute(m_marking, m_flows);
+    return m_flows;
+}
+
+//------------------------------------------------------------------------------
+double FluidSimulator::throughput(size_t const transition) const
+{
+    return (m_time > 0.0) ? m_firings[transition] / m_time : 0.0;
+}
+
+//------------------------------------------------------------------------------
+void FluidSimulator::compute(std::vector<double> const& marking, std::vector<double>& flows)
+{
+    if (m_server == NetSettings::Server::Infinite)
+        infiniteFlows(marking, flows);
+    else
+        finiteFlows(marking, flows);
+}
+
+//------------------------------------------------------------------------------
+void FluidSimulator::infiniteFlows(std::vector<double> const& marking,
+                                   std::vector<double>& flows) const
+{
+    size_t const transitions = m_compiled.transitions();
+    flows.resize(transitions);
+    for (size_t t = 0u; t < transitions; ++t)
+    {
+        if (!m_compiled.receptivity(t))
+        {
+            flows[t] = 0.0;
+            continue;
+        }
+
+        // Enabling degree: transitions without upstream places fire at
+        // their rate.
+        auto const pre = m_compiled.prePlaces(t);
+        auto const weights = m_compiled.preWeights(t);
+        double degree = pre.size() == 0u ? 1.0 : HUGE_VAL;
+        for (size_t i = 0u; i < pre.size(); ++i)
+        {
+            degree = std::min(degree, std::max(0.0, marking[pre[i]]) / double(weights[i]));
+        }
+        flows[t] = m_rates[t] * degree;
+    }
+}
+
+//------------------------------------------------------------------------------
+void FluidSimulator::finiteFlows(std::vector<double> const& marking,
+                                 std::vector<double>& flows)
+{
+    size_t const places = m_compiled.places();
+    size_t const transitions = m_compiled.transitions();
+
+    // Demand of receptive transitions on their upstream places.
+    m_demands.assign(places, 0.0);
+    for (size_t p = 0u; p < places; ++p)
+    {
+        for (size_t i = m_consumer_offsets[p]; i < m_consumer_offsets[p + 1u]; ++i)
+        {
+            size_t const t = m_consumers[i];
+            if (m_compiled.receptivity(t))
+            {
+                m_demands[p] += m_consumer_weights[i] * m_rates[t];
+            }
+        }
+    }
+
+    // Transitions whose upstream places are all marked fire at their rate.
+    // The others start from a null flow.
+    flows.assign(transitions, 0.0);
+    for (size_t t = 0u; t < transitions; ++t)
+    {
+        if (!m_compiled.receptivity(t))
+            continue;
+        auto const pre = m_compiled.prePlaces(t);
+        if (std::all_of(pre.begin(), pre.end(), [&marking](CompiledNet::Index const p)
+                        { return marking[p] > 0.0; }))
+        {
+            flows[t] = m_rates[t];
+        }
+    }
+
+    // Then increase the flows of the others up to the share of the flow
+    // received by their empty upstream places. Starting from null flows gives
+    // the least fixed point: an empty circuit keeps null flows.
+    for (size_t round = 0u; round < MAX_ROUNDS; ++round)
+    {
+        m_inflows.assign(places, 0.0);
+        for (size_t t = 0u; t < transitions; ++t)
+        {
+            if (flows[t] == 0.0)
+                continue;
+            auto const post = m_compiled.postPlaces(t);
+            auto const weights = m_compiled.postWeights(t);
+            for (size_t i = 0u; i < post.size(); ++i)
+            {
+                m_inflows[post[i]] += flows[t] * double(weights[i]);
+            }
+        }
+
+        bool changed = false;
+        for (size_t t = 0u; t < transitions; ++t)
+        {
+            if ((!m_compiled.receptivity(t)) || (flows[t] == m_rates[t]))
+                continue;
+
+            double flow = m_rates[t];
+            for (auto const p: m_compiled.prePlaces(t))
+            {
+                if (marking[p] <= 0.0)
+                {
+                    flow = std::min(flow, m_inflows[p] * m_rates[t] / m_demands[p]);
+                }
+            }
+            if (flow > flows[t] * (1.0 + 1e-12))
+            {
+                flows[t] = flow;
+                changed = true;
+            }
+        }
+        if (!changed)
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+void FluidSimulator::apply(std::vector<double> const& firings, double const factor,
+                           std::vector<double>& marking) const
+{
+    for (size_t t = 0u; t < m_compiled.transitions(); ++t)
+    {
+        if (firings[t] == 0.0)
+            continue;
+
+        double const amount = factor * firings[t];
+        auto const pre = m_compiled.prePlaces(t);
+        auto const pre_weights = m_compiled.preWeights(t);
+        for (size_t i = 0u; i < pre.size(); ++i)
+        {
+            marking[pre[i]] -= amount * double(pre_weights[i]);
+        }
+        auto const post = m_compiled.postPlaces(t);
+        auto const post_weights = m_compiled.postWeights(t);
+        for (size_t i = 0u; i < post.size(); ++i)
+        {
+            marking[post[i]] += amount * double(post_weights[i]);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void FluidSimulator::runUntil(double const time)
+{
+    if (m_server == NetSettings::Server::Infinite)
+        advanceInfinite(time);
+    else
+        advanceFinite(time);
+}
+
+//------------------------------------------------------------------------------
+void FluidSimulator::advanceInfinite(double const time)
+{
+    size_t const transitions = m_compiled.transitions();
+    std::vector<double>& k1 = m_stages[0];
+    std::vector<double>& k2 = m_stages[1];
+    std::vector<double>& k3 = m_stages[2];
+    std::vector<double>& k4 = m_stages[3];
+
+    // Runge-Kutta 4 on the cumulated flows: the marking is then updated by
+    // the incidence of the same firings.
+    while (m_time < time)
+    {
+        double const h = std::min(m_step, time - m_time);
+
+        infiniteFlows(m_marking, k1);
+        m_temporary = m_marking;
+        apply(k1, 0.5 * h, m_temporary);
+        infiniteFlows(m_temporary, k2);
+        m_temporary = m_marking;
+        apply(k2, 0.5 * h, m_temporary);
+        infiniteFlows(m_temporary, k3);
+        m_temporary = m_marking;
+        apply(k3, h, m_temporary);
+        infiniteFlows(m_temporary, k4);
+
+        m_flows.resize(transitions);
+        for (size_t t = 0u; t < transitions; ++t)
+        {
+            m_flows[t] = (k1[t] + 2.0 * k2[t] + 2.0 * k3[t] + k4[t]) * (h / 6.0);
+            m_firings[t] += m_flows[t];
+        }
+        apply(m_flows, 1.0, m_marking);
+        for (auto& m: m_marking)
+        {
+            m = std::max(0.0, m);
+        }
+
+        m_time = (h < m_step) ? time : m_time + h;
+        ++m_events;
+    }
+}
+
+//------------------------------------------------------------------------------
+void FluidSimulator::advanceFinite(double const time)
+{
+    size_t const places = m_compiled.places();
+    size_t const transitions = m_compiled.transitions();
+
+    while (m_time < time)
+    {
+        // Flows are constant until the next place becomes empty.
+        finiteFlows(m_marking, m_flows);
+        m_derivatives.assign(places, 0.0);
+        apply(m_flows, 1.0, m_derivatives);
+
+        double dt = time - m_time;
+        bool event = false;
+        for (size_t p = 0u; p < places; ++p)
+        {
+            if ((m_marking[p] > 0.0) && (m_derivatives[p] < 0.0) &&
+                (m_marking[p] < -m_derivatives[p] * dt))
+            {
+                dt = -m_marking[p] / m_derivatives[p];
+                event = true;
+            }
+        }
+
+        for (size_t t = 0u; t < transitions; ++t)
+        {
+            m_firings[t] += m_flows[t] * dt;
+        }
+        for (size_t p = 0u; p < places; ++p)
+        {
+            if ((m_derivatives[p] < 0.0) && (m_marking[p] <= -m_derivatives[p] * dt))
+                m_marking[p] = 0.0;
+            else
+                m_marking[p] += m_derivatives[p] * dt;
+        }
+
+        if (event)
+        {
+            m_time += dt;
+            ++m_events;
+        }
+        else
+        {
+            m_time = time;
+        }
+    }
+}
+
+} // namespace tpne
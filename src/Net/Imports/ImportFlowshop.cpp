@@ -19,7 +19,7 @@
 //=============================================================================
 
 #include "Imports.hpp"
-#include "TimedPetriNetEditor/PetriNet.hpp"
+#include "TimedPetriNetEditor/NetBuilder.hpp"
 #include <sstream>
 #include <fstream>
 #include <cstring>
@@ -95,6 +95,7 @@ std::string importFlowshop(Net& net, std::string const& filename)
     size_t x = margin + dx; size_t y = margin + dy;
 
     size_t id = 0u;
+    NetBuilder builder(net);
     std::string line;
 
     // End the current line
@@ -128,7 +129,7 @@ std::string importFlowshop(Net& net, std::string const& filename)
 
                 if (value != "nan")
                 {
-                    net.addPlace(id, Transition::to_str(id), float(x), float(y), 0);
+                    builder.addPlace(id, Transition::to_str(id), float(x), float(y), 0);
                     id++;
                 }
                 x += dx;
@@ -152,7 +153,7 @@ std::string importFlowshop(Net& net, std::string const& filename)
     x = margin + dx - dx / 2u; y = margin;
     for (const auto& columnName : matrix.columnNames)
     {
-        net.addPlace(id++, columnName, float(x), float(y), 0);
+        builder.addPlace(id++, columnName, float(x), float(y), 0);
         //net.addPlace(id++, columnName, x, ymax, 0);
         x += dx;
     }
@@ -160,11 +161,18 @@ std::string importFlowshop(Net& net, std::string const& filename)
     x = margin; y = margin + dy + dy / 2u;
     for (const auto& rowName : matrix.rowNames)
     {
-        net.addPlace(id++, rowName, float(x), float(y), 0);
+        builder.addPlace(id++, rowName, float(x), float(y), 0);
         //net.addPlace(id++, rowName, xmax, y, 0);
         y += dy;
     }
 
+    if (!builder.finalize())
+    {
+        error << "Failed loading " << filename << ". " << builder.error()
+              << std::endl;
+        return error.str();
+    }
+
     return {};
 }
 
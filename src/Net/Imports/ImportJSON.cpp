@@ -19,7 +19,7 @@
 //=============================================================================
 
 #include "Imports.hpp"
-#include "TimedPetriNetEditor/PetriNet.hpp"
+#include "TimedPetriNetEditor/NetBuilder.hpp"
 #include "nlohmann/json.hpp"
 #include <sstream>
 #include <fstream>
@@ -95,48 +95,84 @@ std::string importFromJSON(Net& net, std::string const& filename)
     }
     net.name = std::string(jnet["name"]);
 
+    NetBuilder builder(net);
+    builder.reserve(jnet["places"].size(), jnet["transitions"].size(),
+                    jnet["arcs"].size());
+
     // Places
     for (nlohmann::json const& p : jnet["places"]) {
-        net.addPlace(p["id"], p["caption"], p["x"], p["y"], p["tokens"]);
+        builder.addPlace(p["id"], p["caption"], p["x"], p["y"], p["tokens"]);
     }
 
     // Transitions
     for (nlohmann::json const& t : jnet["transitions"]) {
-        net.addTransition(t["id"], t["caption"], t["x"], t["y"], t["angle"]);
+        builder.addTransition(t["id"], t["caption"], t["x"], t["y"], t["angle"]);
     }
 
     // Arcs
     for (nlohmann::json const& a : jnet["arcs"])
     {
-        Node* from = net.findNode(a["from"]);
-        Node* to = net.findNode(a["to"]);
-        if ((from == nullptr) || (to == nullptr))
+        float duration = NAN;
+        auto const& it = a.find("duration");
+        if (it != a.end())
+        {
+            duration = *it;
+        }
+        size_t weight = 1u;
+        auto const& w = a.find("weight");
+        if (w != a.end())
+        {
+            weight = *w;
+        }
+        builder.addArc(std::string(a["from"]), std::string(a["to"]), duration, weight);
+    }
+
+    if (!builder.finalize())
+    {
+        switch (builder.failure())
+        {
+        case NetBuilder::Failure::UnknownNode:
         {
+            nlohmann::json const& a = jnet["arcs"][builder.failedArc()];
             error << "Failed parsing '" << filename << "'. Reason was 'Arc "
                   << a["from"] << " -> " << a["to"] << " refer to unknown nodes'"
                   << std::endl;
-            return error.str();
+            break;
         }
+        case NetBuilder::Failure::NegativeDuration:
+        case NetBuilder::Failure::NullWeight:
+            error << "Failed parsing '" << filename << "'. Reason was '"
+                  << builder.error() << "'" << std::endl;
+            break;
+        default:
+            error << "Failed loading " << filename << ". "
+                  << builder.error() << std::endl;
+            break;
+        }
+        return error.str();
+    }
 
-        float duration = NAN;
-        auto const& it = a.find("duration");
-        if (it != a.end())
+    // Optional delays of transitions for stochastic simulations.
+    for (nlohmann::json const& t : jnet["transitions"])
+    {
+        auto const& d = t.find("delay");
+        if (d == t.end())
+            continue;
+
+        Distribution delay;
+        if ((!d->contains("law")) ||
+            (!Distribution::from_str(std::string((*d)["law"]), delay.law)))
         {
-            duration = *it;
-            if (duration < 0.0f)
-            {
-                error << "Failed parsing '" << filename << "'. Reason was 'Arc "
-                      << from->key << " -> " << to->key << " has negative duration'"
-                      << std::endl;
-                return error.str();
-            }
+            error << "Failed parsing '" << filename << "'. Reason was '"
+                  << "Unknown delay law of transition T" << t["id"] << "'" << std::endl;
+            return error.str();
         }
-        if (!net.addArc(*from, *to, duration))
+        delay.a = d->value("a", 0.0f);
+        delay.b = d->value("b", 0.0f);
+        Transition* transition = net.findTransition(t["id"]);
+        if (transition != nullptr)
         {
-            error << "Failed loading " << filename
-                  << ". Arc " << from->key << " -> " << to->key
-                  << " is badly formed" << std::endl;
-            return error.str();
+            transition->delay = delay;
         }
     }
 
@@ -19,7 +19,7 @@
 //=============================================================================
 
 #include "Imports.hpp"
-#include "TimedPetriNetEditor/PetriNet.hpp"
+#include "TimedPetriNetEditor/NetBuilder.hpp"
 #include "tinyxml2/tinyxml2.h"
 #include <sstream>
 #include <fstream>
@@ -50,6 +50,7 @@ std::string importFromPNML(Net& net, std::string const& filename)
                                          ->FirstChildElement("net")
                                          ->FirstChildElement("page");
 
+    NetBuilder builder(net);
     size_t place_id = 0u;
     size_t transition_id = 0u;
     std::map<std::string, std::string> lookup_ids;
@@ -80,7 +81,7 @@ std::string importFromPNML(Net& net, std::string const& filename)
                             ->Attribute("y"));
         }
 
-        net.addPlace(place_id, caption, x, y, size_t(tokens));
+        builder.addPlace(place_id, caption, x, y, size_t(tokens));
         place_id++;
     }
 
@@ -104,7 +105,7 @@ std::string importFromPNML(Net& net, std::string const& filename)
                             ->Attribute("y"));
         }
         int angle = 0;
-        net.addTransition(transition_id, caption, x, y, angle);
+        builder.addTransition(transition_id, caption, x, y, angle);
         transition_id++;
     }
 
@@ -114,35 +115,47 @@ std::string importFromPNML(Net& net, std::string const& filename)
     {
         const auto source = child->Attribute("source");
         const auto target = child->Attribute("target");
-        Node* from = net.findNode(lookup_ids[source]);
-        Node* to = net.findNode(lookup_ids[target]);
-        if ((from == nullptr) || (to == nullptr))
-        {
-            error << "Failed parsing '" << filename << "'. Reason was 'Arc "
-                << source << " -> " << target << " refer to unknown nodes'"
-                << std::endl;
-            return error.str();
-        }
-
         float duration = NAN;
         if (child->FirstChildElement("inscription") != nullptr)
         {
             duration = std::stof(child->FirstChildElement("inscription")
                             ->FirstChildElement("text")->GetText());
-            if (duration < 0.0f)
+        }
+        size_t weight = 1u;
+        if (child->FirstChildElement("weight") != nullptr)
+        {
+            weight = std::stoul(child->FirstChildElement("weight")
+                            ->FirstChildElement("text")->GetText());
+        }
+        builder.addArc(lookup_ids[source], lookup_ids[target], duration, weight);
+    }
+
+    if (!builder.finalize())
+    {
+        if (builder.failure() == NetBuilder::Failure::UnknownNode)
+        {
+            // Retrieve the original identifiers of the faulty arc.
+            tinyxml2::XMLElement *child = levelElement->FirstChildElement("arc");
+            for (size_t i = 0u; i < builder.failedArc(); ++i)
             {
-                error << "Failed parsing '" << filename << "'. Reason was 'Arc "
-                    << from->key << " -> " << to->key << " has negative duration'"
-                    << std::endl;
-                return error.str();
+                child = child->NextSiblingElement("arc");
             }
+            error << "Failed parsing '" << filename << "'. Reason was 'Arc "
+                << child->Attribute("source") << " -> " << child->Attribute("target")
+                << " refer to unknown nodes'" << std::endl;
+        }
+        else if ((builder.failure() == NetBuilder::Failure::NegativeDuration) ||
+                 (builder.failure() == NetBuilder::Failure::NullWeight))
+        {
+            error << "Failed parsing '" << filename << "'. Reason was '"
+                << builder.error() << "'" << std::endl;
         }
-        if (!net.addArc(*from, *to, duration))
+        else
         {
             error << "Failed loading " << filename
-                << ". Arc " << from->key << " -> " << to->key
-                << " is badly formed" << std::endl;
+                << ". " << builder.error() << std::endl;
         }
+        return error.str();
     }
     return {};
 }
@@ -19,7 +19,7 @@
 //=============================================================================
 
 #include "Imports.hpp"
-#include "TimedPetriNetEditor/PetriNet.hpp"
+#include "TimedPetriNetEditor/NetBuilder.hpp"
 #include "Utils/Utils.hpp"
 
 #include <fstream>
@@ -72,9 +72,11 @@ std::string importFromTimedEventGraph(Net& net, std::string const& filename)
     size_t dx = (w - 2u * margin) / (nodes_by_line - 1u);
     size_t dy = (h - 2u * margin) / (nodes_by_line - 1u);
     size_t x = margin, y = margin;
+    NetBuilder builder(net);
+    builder.reserve(0u, transitions, lines);
     for (size_t id = 0u; id < transitions; ++id)
     {
-        net.addTransition(id, Transition::to_str(id), randomInt(0,800), randomInt(0,600), 0);
+        builder.addTransition(id, Transition::to_str(id), randomInt(0,800), randomInt(0,600), 0);
         x += dx;
         if (x > w - margin) { x = margin; y += dy; }
     }
@@ -100,10 +102,14 @@ std::string importFromTimedEventGraph(Net& net, std::string const& filename)
             return error.str();
         }
 
-        Transition* t0 = net.findTransition(initial_transition);
-        Transition* t1 = net.findTransition(final_transition);
-        assert((t0 != nullptr) && (t1 != nullptr));
-        net.addArc(*t0, *t1, tokens, duration);
+        builder.addArc(initial_transition, final_transition, tokens, duration);
+    }
+
+    if (!builder.finalize())
+    {
+        error << "Failed loading " << filename << ". " << builder.error()
+              << std::endl;
+        return error.str();
     }
 
     return {};
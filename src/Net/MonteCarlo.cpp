@@ -0,0 +1,252 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "TimedPetriNetEditor/MonteCarlo.hpp"
+#include <thread>
+#include <mutex>
+
+namespace tpne {
+
+//------------------------------------------------------------------------------
+//! \brief SplitMix64: derive well distributed seeds of replications from the
+//! master seed.
+static uint32_t replicationSeed(uint64_t const seed, size_t const replication)
+{
+    uint64_t z = seed + 0x9E3779B97F4A7C15ull * (uint64_t(replication) + 1u);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return uint32_t(z ^ (z >> 31));
+}
+
+//------------------------------------------------------------------------------
+//! \brief Statistics of a single replication.
+struct Replication
+{
+    //! \brief Number of firings of each transition.
+    std::vector<size_t> firings;
+    //! \brief Integral of the number of tokens of each place over time.
+    std::vector<double> areas;
+    //! \brief Has the replication ended in a deadlock ?
+    bool deadlock = false;
+};
+
+// *****************************************************************************
+//! \brief Fill the statistics of a replication from the events of the
+//! simulation. The marking is integrated over time lazily: a place is only
+//! visited when its number of tokens changes.
+// *****************************************************************************
+class Statistics: public TimedSimulator::Observer
+{
+public:
+
+    Statistics(TimedSimulator const& simulator, Replication& replication)
+        : m_simulator(simulator), m_replication(replication),
+          m_tokens(simulator.compiled().tokens().begin(), simulator.compiled().tokens().end()),
+          m_since(simulator.compiled().places(), 0.0)
+    {
+        m_replication.firings.assign(simulator.compiled().transitions(), 0u);
+        m_replication.areas.assign(simulator.compiled().places(), 0.0);
+        m_replication.deadlock = false;
+    }
+
+    virtual void onFired(double const time, size_t const transition,
+                         size_t const count) override
+    {
+        m_replication.firings[transition] += count;
+        for (auto const p: m_simulator.compiled().prePlaces(transition))
+        {
+            update(time, p);
+        }
+    }
+
+    virtual void onArrived(double const time, size_t const /*arc*/,
+                           size_t const place, size_t const /*tokens*/) override
+    {
+        update(time, place);
+    }
+
+    //! \brief Integrate the marking up to the end of the replication.
+    void finish(double const time)
+    {
+        for (size_t p = 0u; p < m_tokens.size(); ++p)
+        {
+            m_replication.areas[p] += double(m_tokens[p]) * (time - m_since[p]);
+        }
+    }
+
+private:
+
+    void update(double const time, size_t const place)
+    {
+        m_replication.areas[place] += double(m_tokens[place]) * (time - m_since[place]);
+        m_since[place] = time;
+        m_tokens[place] = m_simulator.tokens(place);
+    }
+
+private:
+
+    TimedSimulator const& m_simulator;
+    Replication& m_replication;
+    //! \brief Number of tokens of places since the time m_since.
+    std::vector<size_t> m_tokens;
+    std::vector<double> m_since;
+};
+
+// *****************************************************************************
+//! \brief Range of replications owned by a worker. The owner takes them from
+//! the front, idle workers steal them from the back.
+// *****************************************************************************
+struct WorkQueue
+{
+    std::mutex mutex;
+    size_t first = 0u;
+    size_t last = 0u;
+
+    bool popFront(size_t& replication)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (first == last)
+            return false;
+        replication = first++;
+        return true;
+    }
+
+    bool popBack(size_t& replication)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (first == last)
+            return false;
+        replication = --last;
+        return true;
+    }
+};
+
+//------------------------------------------------------------------------------
+//! \brief Simulate a replication from a copy of the compiled net.
+static void simulate(TimedSimulator simulator, double const duration,
+                     uint32_t const seed, Replication& replication)
+{
+    Statistics statistics(simulator, replication);
+    simulator.seed(seed);
+    simulator.addObserver(statistics);
+
+    while (true)
+    {
+        simulator.fire();
+        if (!simulator.waiting())
+        {
+            replication.deadlock = true;
+            break;
+        }
+        if (simulator.nextTime() > duration)
+            break;
+        simulator.step();
+    }
+    statistics.finish(duration);
+}
+
+//------------------------------------------------------------------------------
+MonteCarloResult runMonteCarlo(Net const& net, size_t const replications,
+                               double const duration, uint64_t const seed,
+                               size_t const threads)
+{
+    MonteCarloResult result;
+
+    // The net is compiled once then copied for each replication.
+    TimedSimulator const prototype(net);
+    if (!prototype.error().empty())
+    {
+        result.message = prototype.error();
+        return result;
+    }
+
+    // Split replications into one range per worker.
+    size_t workers = (threads == 0u) ? std::thread::hardware_concurrency() : threads;
+    workers = std::max(size_t(1u), std::min(workers, replications));
+    std::vector<WorkQueue> queues(workers);
+    for (size_t w = 0u; w < workers; ++w)
+    {
+        queues[w].first = replications * w / workers;
+        queues[w].last = replications * (w + 1u) / workers;
+    }
+
+    std::vector<Replication> statistics(replications);
+    auto worker = [&](size_t const w)
+    {
+        size_t replication;
+        while (true)
+        {
+            // Own replications first, then steal from the others.
+            bool found = queues[w].popFront(replication);
+            for (size_t i = 1u; (!found) && (i < workers); ++i)
+            {
+                found = queues[(w + i) % workers].popBack(replication);
+            }
+            if (!found)
+                return ;
+
+            simulate(prototype, duration, replicationSeed(seed, replication),
+                     statistics[replication]);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t w = 1u; w < workers; ++w)
+    {
+        pool.emplace_back(worker, w);
+    }
+    worker(0u);
+    for (auto& it: pool)
+    {
+        it.join();
+    }
+
+    // Aggregate in the order of replications for reproducible sums.
+    result.throughputs.assign(prototype.compiled().transitions(), 0.0);
+    result.markings.assign(prototype.compiled().places(), 0.0);
+    for (auto const& it: statistics)
+    {
+        for (size_t t = 0u; t < it.firings.size(); ++t)
+        {
+            result.throughputs[t] += double(it.firings[t]);
+        }
+        for (size_t p = 0u; p < it.areas.size(); ++p)
+        {
+            result.markings[p] += it.areas[p];
+        }
+        result.deadlocks += it.deadlock ? 1u : 0u;
+    }
+
+    result.replications = replications;
+    if (replications != 0u)
+    {
+        double const n = double(replications);
+        double const elapsed = (duration > 0.0) ? n * duration : n;
+        for (auto& it: result.throughputs)
+            it /= elapsed;
+        for (auto& it: result.markings)
+            it /= elapsed;
+        result.deadlock_frequency = double(result.deadlocks) / n;
+    }
+    result.success = true;
+    return result;
+}
+
+} // namespace tpne
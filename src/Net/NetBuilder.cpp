@@ -0,0 +1,171 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "TimedPetriNetEditor/NetBuilder.hpp"
+
+namespace tpne {
+
+//------------------------------------------------------------------------------
+NetBuilder::NetBuilder(Net& net)
+    : m_net(net)
+{}
+
+//------------------------------------------------------------------------------
+void NetBuilder::reserve(size_t const places, size_t const transitions,
+                         size_t const arcs)
+{
+    m_places.reserve(places);
+    m_transitions.reserve(transitions);
+    m_arcs.reserve(arcs);
+}
+
+//------------------------------------------------------------------------------
+void NetBuilder::addPlace(size_t const id, std::string const& caption,
+                          float const x, float const y, size_t const tokens)
+{
+    m_places.push_back({ id, caption, x, y, tokens, 0 });
+}
+
+//------------------------------------------------------------------------------
+void NetBuilder::addTransition(size_t const id, std::string const& caption,
+                               float const x, float const y, int const angle)
+{
+    m_transitions.push_back({ id, caption, x, y, 0u, angle });
+}
+
+//------------------------------------------------------------------------------
+void NetBuilder::addArc(std::string const& from, std::string const& to,
+                        float const duration, size_t const weight)
+{
+    m_arcs.push_back({ from, to, duration, weight, 0u, false });
+}
+
+//------------------------------------------------------------------------------
+void NetBuilder::addArc(size_t const from, size_t const to, size_t const tokens,
+                        float const duration)
+{
+    m_arcs.push_back({ Transition::to_str(from), Transition::to_str(to),
+                       duration, 1u, tokens, true });
+}
+
+//------------------------------------------------------------------------------
+bool NetBuilder::fail(Failure const failure, std::string const& error,
+                      size_t const arc)
+{
+    m_failure = failure;
+    m_failed_arc = arc;
+    m_error = error;
+    m_places.clear();
+    m_transitions.clear();
+    m_arcs.clear();
+    return false;
+}
+
+//------------------------------------------------------------------------------
+bool NetBuilder::finalize()
+{
+    m_failure = Failure::None;
+    m_failed_arc = 0u;
+    m_error.clear();
+
+    m_net.m_place_indices.reserve(m_net.m_places.size() + m_places.size());
+    m_net.m_transition_indices.reserve(m_net.m_transitions.size() + m_transitions.size());
+    m_net.m_arc_indices.reserve(m_net.m_arcs.size() + m_arcs.size());
+
+    // Nodes. Duplicated identifiers are detected by hashing: the indices of
+    // the net already hold the identifiers of the previous nodes.
+    for (auto const& p: m_places)
+    {
+        if (m_net.m_place_indices.find(p.id) != m_net.m_place_indices.end())
+        {
+            return fail(Failure::DuplicatedNode, "Node " + Place::to_str(p.id)
+                        + " is duplicated");
+        }
+        m_net.addPlace(p.id, p.caption, p.x, p.y, p.tokens);
+    }
+    for (auto const& t: m_transitions)
+    {
+        if (m_net.m_transition_indices.find(t.id) != m_net.m_transition_indices.end())
+        {
+            return fail(Failure::DuplicatedNode, "Node " + Transition::to_str(t.id)
+                        + " is duplicated");
+        }
+        m_net.addTransition(t.id, t.caption, t.x, t.y, t.angle);
+    }
+
+    // Arcs, in the order they have been queued.
+    for (size_t i = 0u; i < m_arcs.size(); ++i)
+    {
+        PendingArc const& a = m_arcs[i];
+        Node* from = m_net.findNode(a.from);
+        Node* to = m_net.findNode(a.to);
+        if ((from == nullptr) || (to == nullptr))
+        {
+            return fail(Failure::UnknownNode, "Arc " + a.from + " -> " + a.to
+                        + " refer to unknown nodes", i);
+        }
+        if (a.duration < 0.0f)
+        {
+            return fail(Failure::NegativeDuration, "Arc " + from->key() + " -> "
+                        + to->key() + " has negative duration", i);
+        }
+        if (a.weight == 0u)
+        {
+            return fail(Failure::NullWeight, "Arc " + from->key() + " -> "
+                        + to->key() + " has null weight", i);
+        }
+
+        if (a.through_place)
+        {
+            if ((from->type != Node::Type::Transition) || (to->type != Node::Type::Transition))
+            {
+                return fail(Failure::UnknownNode, "Arc " + a.from + " -> " + a.to
+                            + " refer to unknown nodes", i);
+            }
+        }
+        else if (m_net.findArc(*from, *to) != nullptr)
+        {
+            return fail(Failure::DuplicatedArc, "Arc " + from->key() + " -> "
+                        + to->key() + " is badly formed", i);
+        }
+
+        if (from->type != to->type)
+        {
+            m_net.helperAddArc(*from, *to, a.duration, a.weight);
+        }
+        else
+        {
+            // Create the intermediate node
+            float const x = from->x + (to->x - from->x) / 2.0f;
+            float const y = from->y + (to->y - from->y) / 2.0f;
+            Node& n = m_net.addOppositeNode(to->type, x, y, a.tokens);
+            m_net.helperAddArc(*from, n, a.duration, a.weight);
+            m_net.helperAddArc(n, *to, a.duration, a.weight);
+        }
+    }
+
+    m_places.clear();
+    m_transitions.clear();
+    m_arcs.clear();
+    m_net.modified = true;
+    return true;
+}
+
+} // namespace tpne
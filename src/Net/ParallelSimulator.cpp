@@ -0,0 +1,457 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "TimedPetriNetEditor/ParallelSimulator.hpp"
+#include "Utils/SpscQueue.hpp"
+#include <cmath>
+#include <thread>
+
+namespace tpne {
+
+// *****************************************************************************
+//! \brief One-way link between two partitions.
+// *****************************************************************************
+struct ParallelSimulator::Channel
+{
+    //! \brief Tokens sent at once, and the promise that later tokens will not
+    //! arrive before the given time.
+    struct Packet
+    {
+        std::vector<TimedSimulator::Event> events;
+        double promise;
+    };
+
+    Channel(size_t const from_, size_t const to_, double const lookahead_)
+        : from(from_), to(to_), lookahead(lookahead_),
+          promised(lookahead_), clock(lookahead_)
+    {}
+
+    size_t from;
+    size_t to;
+    //! \brief Smallest delay of arcs from the sender to the receiver.
+    double lookahead;
+    SpscQueue<Packet> queue;
+    //! \brief Sender side: tokens to send and latest sent promise.
+    std::vector<TimedSimulator::Event> pending;
+    double promised;
+    //! \brief Receiver side: latest received promise.
+    double clock;
+};
+
+// *****************************************************************************
+//! \brief Simulation of a partition.
+// *****************************************************************************
+struct ParallelSimulator::Process
+{
+    TimedSimulator simulator;
+    std::vector<Channel*> inputs;
+    std::vector<Channel*> outputs;
+    //! \brief Output channels indexed by receiving partitions (or nullptr).
+    std::vector<Channel*> routes;
+    size_t nulls = 0u;
+};
+
+//------------------------------------------------------------------------------
+static size_t root(std::vector<size_t>& parents, size_t node)
+{
+    while (parents[node] != node)
+    {
+        parents[node] = parents[parents[node]];
+        node = parents[node];
+    }
+    return node;
+}
+
+//------------------------------------------------------------------------------
+static void unite(std::vector<size_t>& parents, size_t const a, size_t const b)
+{
+    size_t const ra = root(parents, a);
+    size_t const rb = root(parents, b);
+    parents[std::max(ra, rb)] = std::min(ra, rb);
+}
+
+//------------------------------------------------------------------------------
+ParallelSimulator::ParallelSimulator() = default;
+
+//------------------------------------------------------------------------------
+ParallelSimulator::~ParallelSimulator() = default;
+
+//------------------------------------------------------------------------------
+ParallelSimulator::ParallelSimulator(Net const& net, size_t const partitions)
+{
+    reset(net, partitions);
+}
+
+//------------------------------------------------------------------------------
+size_t ParallelSimulator::partition(std::vector<float> const& delays, size_t const partitions)
+{
+    size_t const places = m_compiled.places();
+    size_t const transitions = m_compiled.transitions();
+    size_t const nodes = places + transitions;
+
+    // Nodes which cannot be separated: places are numbered first, then
+    // transitions.
+    std::vector<size_t> parents(nodes);
+    for (size_t n = 0u; n < nodes; ++n)
+    {
+        parents[n] = n;
+    }
+    for (size_t t = 0u; t < transitions; ++t)
+    {
+        for (auto const p: m_compiled.prePlaces(t))
+        {
+            unite(parents, p, places + t);
+        }
+        bool const source = (m_compiled.kind(t) == CompiledNet::Kind::Input);
+        size_t const offset = m_compiled.postOffset(t);
+        auto const post = m_compiled.postPlaces(t);
+        for (size_t i = 0u; i < post.size(); ++i)
+        {
+            if (source || !(delays[offset + i] > 0.0f))
+            {
+                unite(parents, post[i], places + t);
+            }
+        }
+    }
+
+    // Weight of groups: their nodes and arcs.
+    std::vector<size_t> weights(nodes, 0u);
+    size_t total = 0u;
+    for (size_t n = 0u; n < nodes; ++n)
+    {
+        size_t weight = 1u;
+        if (n >= places)
+        {
+            weight += m_compiled.prePlaces(n - places).size() +
+                      m_compiled.postPlaces(n - places).size();
+        }
+        weights[root(parents, n)] += weight;
+        total += weight;
+    }
+
+    // Order groups by a breadth-first traversal of the net, then cut this
+    // order into partitions of balanced weights.
+    std::vector<size_t> parts(nodes, static_cast<size_t>(-1));
+    std::vector<uint8_t> visited(nodes, 0u);
+    std::vector<size_t> queue;
+    queue.reserve(nodes);
+    size_t cumulated = 0u;
+    size_t count = 0u;
+    for (size_t start = 0u; start < nodes; ++start)
+    {
+        if (visited[start] != 0u)
+            continue;
+
+        visited[start] = 1u;
+        queue.assign(1u, start);
+        for (size_t head = 0u; head < queue.size(); ++head)
+        {
+            size_t const n = queue[head];
+            size_t const group = root(parents, n);
+            if (parts[group] == static_cast<size_t>(-1))
+            {
+                size_t const part = std::min(partitions - 1u, cumulated * partitions / total);
+                // Partitions are numbered without gaps.
+                parts[group] = std::min(part, count);
+                count = std::max(count, parts[group] + 1u);
+                cumulated += weights[group];
+            }
+
+            auto visit = [&visited, &queue](size_t const next)
+            {
+                if (visited[next] == 0u)
+                {
+                    visited[next] = 1u;
+                    queue.push_back(next);
+                }
+            };
+            if (n < places)
+            {
+                for (auto const t: m_compiled.inputTransitions(n))
+                    visit(places + t);
+                for (auto const t: m_compiled.outputTransitions(n))
+                    visit(places + t);
+            }
+            else
+            {
+                for (auto const p: m_compiled.prePlaces(n - places))
+                    visit(p);
+                for (auto const p: m_compiled.postPlaces(n - places))
+                    visit(p);
+            }
+        }
+    }
+
+    m_place_owners.resize(places);
+    for (size_t p = 0u; p < places; ++p)
+    {
+        m_place_owners[p] = CompiledNet::Index(parts[root(parents, p)]);
+    }
+    m_transition_owners.resize(transitions);
+    for (size_t t = 0u; t < transitions; ++t)
+    {
+        m_transition_owners[t] = CompiledNet::Index(parts[root(parents, places + t)]);
+    }
+    return std::max(size_t(1u), count);
+}
+
+//------------------------------------------------------------------------------
+bool ParallelSimulator::reset(Net const& net, size_t const partitions)
+{
+    m_time = 0.0;
+    m_processes.clear();
+    m_channels.clear();
+    m_place_owners.clear();
+    m_transition_owners.clear();
+    if (!m_compiled.compile(net))
+        return false;
+
+    // Delays of arcs, as given by TimedSimulator.
+    bool const timed = (net.type() == TypeOfNet::TimedPetriNet) ||
+                       (net.type() == TypeOfNet::TimedEventGraph);
+    std::vector<float> delays(m_compiled.postSize(), 0.0f);
+    if (timed)
+    {
+        for (size_t t = 0u; t < m_compiled.transitions(); ++t)
+        {
+            auto const durations = m_compiled.postDurations(t);
+            std::copy(durations.begin(), durations.end(),
+                      delays.begin() + long(m_compiled.postOffset(t)));
+        }
+    }
+    size_t const count = partition(delays, std::max(size_t(1u), partitions));
+
+    // Each partition empties and disables the nodes it does not own.
+    for (size_t i = 0u; i < count; ++i)
+    {
+        m_processes.emplace_back(new Process);
+        Process& process = *m_processes.back();
+        process.routes.assign(count, nullptr);
+        TimedSimulator& simulator = process.simulator;
+        simulator.reset(net);
+        for (size_t p = 0u; p < m_compiled.places(); ++p)
+        {
+            if (m_place_owners[p] != i)
+                simulator.compiled().tokens(p, 0u);
+        }
+        for (size_t t = 0u; t < m_compiled.transitions(); ++t)
+        {
+            if (m_transition_owners[t] != i)
+                simulator.compiled().receptivity(t, false);
+        }
+    }
+
+    // Channels along arcs crossing partitions, whose lookahead is their
+    // smallest delay.
+    for (size_t t = 0u; t < m_compiled.transitions(); ++t)
+    {
+        size_t const from = m_transition_owners[t];
+        size_t const offset = m_compiled.postOffset(t);
+        auto const post = m_compiled.postPlaces(t);
+        for (size_t i = 0u; i < post.size(); ++i)
+        {
+            size_t const to = m_place_owners[post[i]];
+            if (to == from)
+                continue;
+
+            double const lookahead = double(delays[offset + i]);
+            Process& sender = *m_processes[from];
+            sender.simulator.forward(offset + i);
+            Channel* channel = sender.routes[to];
+            if (channel == nullptr)
+            {
+                m_channels.emplace_back(new Channel(from, to, lookahead));
+                channel = m_channels.back().get();
+                sender.routes[to] = channel;
+                sender.outputs.push_back(channel);
+                m_processes[to]->inputs.push_back(channel);
+            }
+            else if (lookahead < channel->lookahead)
+            {
+                channel->lookahead = channel->promised = channel->clock = lookahead;
+            }
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void ParallelSimulator::seed(uint32_t const value)
+{
+    for (auto& process: m_processes)
+    {
+        process->simulator.seed(value);
+    }
+}
+
+//------------------------------------------------------------------------------
+void ParallelSimulator::policy(FiringPolicy const& policy)
+{
+    for (auto& process: m_processes)
+    {
+        process->simulator.policy(policy.clone());
+    }
+}
+
+//------------------------------------------------------------------------------
+void ParallelSimulator::holding(size_t const place, float const value)
+{
+    m_processes[m_place_owners[place]]->simulator.holding(place, value);
+}
+
+//------------------------------------------------------------------------------
+size_t ParallelSimulator::firings() const
+{
+    size_t firings = 0u;
+    for (auto const& process: m_processes)
+    {
+        firings += process->simulator.firings();
+    }
+    return firings;
+}
+
+//------------------------------------------------------------------------------
+size_t ParallelSimulator::nullMessages() const
+{
+    size_t nulls = 0u;
+    for (auto const& process: m_processes)
+    {
+        nulls += process->nulls;
+    }
+    return nulls;
+}
+
+//------------------------------------------------------------------------------
+std::vector<CompiledNet::Count> ParallelSimulator::tokens() const
+{
+    std::vector<CompiledNet::Count> marking(m_place_owners.size());
+    for (size_t p = 0u; p < marking.size(); ++p)
+    {
+        marking[p] = CompiledNet::Count(
+            m_processes[m_place_owners[p]]->simulator.compiled().tokens(p));
+    }
+    return marking;
+}
+
+//------------------------------------------------------------------------------
+size_t ParallelSimulator::tokens(size_t const place) const
+{
+    return m_processes[m_place_owners[place]]->simulator.tokens(place);
+}
+
+//------------------------------------------------------------------------------
+size_t ParallelSimulator::runUntil(double const time)
+{
+    size_t const start = firings();
+    if (m_processes.size() == 1u)
+    {
+        m_processes[0]->simulator.runUntil(time);
+    }
+    else if (!m_processes.empty())
+    {
+        std::vector<std::thread> pool;
+        pool.reserve(m_processes.size());
+        for (auto& process: m_processes)
+        {
+            Process* p = process.get();
+            pool.emplace_back([this, p, time]() { run(*p, time); });
+        }
+        for (auto& thread: pool)
+        {
+            thread.join();
+        }
+    }
+
+    m_time = std::max(m_time, time);
+    return firings() - start;
+}
+
+//------------------------------------------------------------------------------
+void ParallelSimulator::run(Process& process, double const time)
+{
+    TimedSimulator& simulator = process.simulator;
+
+    while (true)
+    {
+        // Receive tokens and promises.
+        bool received = false;
+        Channel::Packet packet;
+        for (auto channel: process.inputs)
+        {
+            while (channel->queue.pop(packet))
+            {
+                for (auto const& event: packet.events)
+                {
+                    simulator.receive(event);
+                }
+                channel->clock = std::max(channel->clock, packet.promise);
+                received = true;
+            }
+        }
+
+        // Instants earlier than all promises are safe: all their tokens have
+        // been received.
+        double safe = HUGE_VAL;
+        for (auto channel: process.inputs)
+        {
+            safe = std::min(safe, channel->clock);
+        }
+        simulator.runUntil((safe > time) ? time : std::nextafter(safe, -HUGE_VAL));
+
+        // The partition fires again at its next instant at the earliest, or
+        // when receiving tokens.
+        double next = safe;
+        if (simulator.waiting())
+        {
+            next = std::min(next, simulator.nextTime());
+        }
+        for (auto const& event: simulator.outbox())
+        {
+            process.routes[m_place_owners[m_compiled.postPlace(event.offset)]]
+                ->pending.push_back(event);
+        }
+        simulator.outbox().clear();
+        for (auto channel: process.outputs)
+        {
+            double const promise = next + channel->lookahead;
+            if ((!channel->pending.empty()) || (promise > channel->promised))
+            {
+                if (channel->pending.empty())
+                {
+                    ++process.nulls;
+                }
+                channel->promised = std::max(channel->promised, promise);
+                channel->queue.push({ std::move(channel->pending), channel->promised });
+                channel->pending.clear();
+            }
+        }
+
+        // Done once no more token can arrive until the given time.
+        if (safe > time)
+            break;
+        if (!received)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+} // namespace tpne
@@ -30,35 +30,28 @@
 #include <cstring>
 #include <ctype.h>
 #include <limits>
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+#include <cmath>
 
 namespace tpne {
 
 //------------------------------------------------------------------------------
-// Default net configuration: timed petri net. To change the type of nets, call
-// Net::changeTypeOfNet(Net::TypeOfNet const)
-size_t Net::Settings::maxTokens = std::numeric_limits<size_t>::max();
-Net::Settings::Fire Net::Settings::firing = Net::Settings::Fire::OneByOne;
-
-//------------------------------------------------------------------------------
-static void applyNewNetSettings(TypeOfNet const type)
+NetSettings::NetSettings(TypeOfNet const type)
 {
     switch (type)
     {
     case TypeOfNet::GRAFCET:
-        Net::Settings::maxTokens = 1u;
-        Net::Settings::firing = Net::Settings::Fire::OneByOne;
+        maxTokens = 1u;
+        firing = Fire::OneByOne;
         break;
     case TypeOfNet::PetriNet:
-        Net::Settings::maxTokens = std::numeric_limits<size_t>::max();
-        Net::Settings::firing = Net::Settings::Fire::OneByOne;
-        break;
     case TypeOfNet::TimedPetriNet:
-        Net::Settings::maxTokens = std::numeric_limits<size_t>::max();
-        Net::Settings::firing = Net::Settings::Fire::OneByOne;
-        break;
     case TypeOfNet::TimedEventGraph:
-        Net::Settings::maxTokens = std::numeric_limits<size_t>::max();
-        Net::Settings::firing = Net::Settings::Fire::OneByOne;
+        maxTokens = std::numeric_limits<size_t>::max();
+        firing = Fire::OneByOne;
         break;
     default:
         assert(false && "Undefined Petri behavior");
@@ -66,6 +59,50 @@ static void applyNewNetSettings(TypeOfNet const type)
     }
 }
 
+//------------------------------------------------------------------------------
+//! \brief Extract the type and the unique identifier of a node from its key
+//! (i.e. "P42" gives Place and 42).
+//! \return false if the key is malformed.
+static bool parseKey(std::string const& key, Node::Type& type, size_t& id)
+{
+    if (key.size() < 2u)
+        return false;
+
+    if (key[0] == 'P')
+        type = Node::Type::Place;
+    else if (key[0] == 'T')
+        type = Node::Type::Transition;
+    else
+        return false;
+
+    // Keys are made with std::to_string so "P01" does not refer to "P1".
+    if ((key[1] == '0') && (key.size() > 2u))
+        return false;
+
+    id = 0u;
+    for (size_t i = 1u; i < key.size(); ++i)
+    {
+        if (!isdigit(key[i]))
+            return false;
+
+        size_t const digit = size_t(key[i] - '0');
+        if (id > (std::numeric_limits<size_t>::max() - digit) / 10u)
+            return false;
+        id = id * 10u + digit;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//! \brief Remove the given arc from the list of incoming or outcoming arcs of
+//! a node. The order of the remaining arcs is kept.
+static void eraseArc(std::vector<Arc*>& arcs, Arc const* arc)
+{
+    auto it = std::find(arcs.begin(), arcs.end(), arc);
+    assert((it != arcs.end()) && "arc not referenced by its node");
+    arcs.erase(it);
+}
+
 //------------------------------------------------------------------------------
 std::string to_str(TypeOfNet const type)
 {
@@ -84,19 +121,53 @@ std::string to_str(TypeOfNet const type)
     }
 }
 
+//------------------------------------------------------------------------------
+//! \brief Return the unique copy of the given caption stored in the pool shared
+//! by all nodes of all nets. Strings of an unordered_set are never moved on
+//! rehash so the returned pointer stays valid until the end of the program.
+static std::string const* internCaption(std::string const& caption)
+{
+    static std::mutex mutex;
+    static std::unordered_set<std::string> pool;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return &*pool.insert(caption).first;
+}
+
+//------------------------------------------------------------------------------
+void Node::caption(std::string const& caption_)
+{
+    if (caption_.empty() || (caption_ == key()))
+    {
+        m_caption = nullptr;
+    }
+    else
+    {
+        m_caption = internCaption(caption_);
+    }
+}
+
+//------------------------------------------------------------------------------
+NetSettings const& Node::settings() const
+{
+    static NetSettings const defaults;
+    return (m_settings == nullptr) ? defaults : *m_settings;
+}
+
 //------------------------------------------------------------------------------
 Place::Place(size_t const id_, std::string const& caption_, float const x_,
              float const y_, size_t const tokens_)
     : Node(Node::Type::Place, id_, caption_, x_, y_)
 {
-    // Petri net: infinite number of tokens but in GRAFCET max is one.
-    tokens = std::min(Net::Settings::maxTokens, tokens_);
+    // Petri net: infinite number of tokens but in GRAFCET max is one. The
+    // place has no net yet: the net constrains tokens when adding it.
+    tokens = tokens_;
 }
 
 //------------------------------------------------------------------------------
 size_t Place::increment(size_t const count)
 {
-    tokens = std::min(Net::Settings::maxTokens, tokens + count);
+    tokens = std::min(settings().maxTokens, tokens + count);
     return tokens;
 }
 
@@ -107,6 +178,81 @@ size_t Place::decrement(size_t const count)
     return tokens;
 }
 
+//------------------------------------------------------------------------------
+static const char* s_laws[] = {
+    "deterministic", "exponential", "uniform", "erlang", "weibull"
+};
+
+//------------------------------------------------------------------------------
+const char* Distribution::to_str(Law const law)
+{
+    return s_laws[size_t(law)];
+}
+
+//------------------------------------------------------------------------------
+bool Distribution::from_str(std::string const& name, Law& law)
+{
+    for (size_t i = 0u; i < sizeof(s_laws) / sizeof(s_laws[0]); ++i)
+    {
+        if (name == s_laws[i])
+        {
+            law = Law(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+double Distribution::mean() const
+{
+    switch (law)
+    {
+    case Law::Exponential:
+        return 1.0 / double(a);
+    case Law::Uniform:
+        return (double(a) + double(b)) / 2.0;
+    case Law::Erlang:
+        return std::round(double(b)) / double(a);
+    case Law::Weibull:
+        return double(b) * std::tgamma(1.0 + 1.0 / double(a));
+    default:
+        return double(a);
+    }
+}
+
+//------------------------------------------------------------------------------
+std::string Distribution::check() const
+{
+    // Written for refusing NaN too.
+    switch (law)
+    {
+    case Law::Exponential:
+        if (!(a > 0.0f))
+            return "the rate of an exponential law shall be positive";
+        break;
+    case Law::Uniform:
+        if (!(a >= 0.0f) || !(b >= a))
+            return "the bounds of an uniform law shall be 0 <= a <= b";
+        break;
+    case Law::Erlang:
+        if (!(a > 0.0f))
+            return "the rate of an Erlang law shall be positive";
+        if (!(std::round(b) >= 1.0f))
+            return "an Erlang law shall have at least one phase";
+        break;
+    case Law::Weibull:
+        if (!(a > 0.0f) || !(b > 0.0f))
+            return "the shape and the scale of a Weibull law shall be positive";
+        break;
+    default:
+        if (!(a >= 0.0f))
+            return "a deterministic delay shall not be negative";
+        break;
+    }
+    return {};
+}
+
 //------------------------------------------------------------------------------
 bool Transition::isValidated() const
 {
@@ -115,10 +261,10 @@ bool Transition::isValidated() const
         return true;
 
     // To enabled this current transition, all its previous Places shall have at
-    // least one token.
+    // least as many tokens as the weight of their arc.
     for (auto& a: arcsIn)
     {
-        if (a->tokensIn() == 0u)
+        if (a->tokensIn() < a->weight)
             return false;
     }
 
@@ -142,63 +288,121 @@ size_t Transition::countBurnableTokens() const
     size_t burnt = static_cast<size_t>(-1);
     for (auto& a: arcsIn)
     {
-        const size_t tokens = a->tokensIn();
+        const size_t tokens = a->tokensIn() / a->weight;
         if (tokens == 0u)
             return 0u;
 
         if (tokens < burnt)
             burnt = tokens;
     }
-    return (Net::Settings::firing == Net::Settings::Fire::OneByOne) ? 1u : burnt;
+    return (settings().firing == NetSettings::Fire::OneByOne) ? 1u : burnt;
 }
 
 //------------------------------------------------------------------------------
 Net::Net(TypeOfNet const type)
-    : m_type(type), name(to_str(type))
+    : m_type(type), m_settings(type), name(to_str(type))
+{}
+
+//------------------------------------------------------------------------------
+Net::Net(Net const& other)
+    : m_type(other.m_type), m_settings(other.m_settings)
 {
-   applyNewNetSettings(type);
+    *this = other;
 }
 
 //------------------------------------------------------------------------------
-Net::Net(Net const& other)
+Net& Net::operator=(Net const& other)
 {
     if (this == &other)
-        return ;
+        return *this;
 
     m_type = other.m_type;
-    applyNewNetSettings(m_type);
+    m_settings = other.m_settings;
+
+    // Copied nodes have no arcs. Since identifiers are also positions in
+    // containers, the arcs of the other net are remapped to the nodes of this
+    // net by direct access, in the same order.
     m_places = other.m_places;
     m_transitions = other.m_transitions;
-
-    // For arcs: we have to redo references to nodes
     m_arcs.clear();
-    for (auto const& it: other.m_arcs)
+    for (auto const& a: other.m_arcs)
+    {
+        Node& from = (a.from.type == Node::Type::Place)
+                     ? static_cast<Node&>(m_places[a.from.id])
+                     : static_cast<Node&>(m_transitions[a.from.id]);
+        Node& to = (a.to.type == Node::Type::Place)
+                   ? static_cast<Node&>(m_places[a.to.id])
+                   : static_cast<Node&>(m_transitions[a.to.id]);
+        m_arcs.push_back(Arc(from, to, a.duration, a.weight));
+    }
+
+    // Same positions, same order: reserve the exact size of adjacency lists
+    // before filling them.
+    for (size_t i = 0u; i < m_places.size(); ++i)
     {
-        Node& from = (it.from.type == Node::Type::Place)
-                     ? reinterpret_cast<Node&>(m_places[it.from.id])
-                     : reinterpret_cast<Node&>(m_transitions[it.from.id]);
-        Node& to = (it.to.type == Node::Type::Place)
-                   ? reinterpret_cast<Node&>(m_places[it.to.id])
-                   : reinterpret_cast<Node&>(m_transitions[it.to.id]);
-        m_arcs.push_back(Arc(from, to, it.duration));
+        m_places[i].arcsIn.reserve(other.m_places[i].arcsIn.size());
+        m_places[i].arcsOut.reserve(other.m_places[i].arcsOut.size());
+    }
+    for (size_t i = 0u; i < m_transitions.size(); ++i)
+    {
+        m_transitions[i].arcsIn.reserve(other.m_transitions[i].arcsIn.size());
+        m_transitions[i].arcsOut.reserve(other.m_transitions[i].arcsOut.size());
     }
     generateArcsInArcsOut();
+    bindSettings();
+
+    // Nodes and arcs keep their location in containers: indices and handles
+    // are still valid on the copy.
+    m_place_indices = other.m_place_indices;
+    m_transition_indices = other.m_transition_indices;
+    m_arc_indices = other.m_arc_indices;
+    m_place_slots = other.m_place_slots;
+    m_transition_slots = other.m_transition_slots;
+    m_arc_slots = other.m_arc_slots;
 
     m_next_place_id = other.m_next_place_id;
     m_next_transition_id = other.m_next_transition_id;
     name = other.name;
     m_message.str(std::string());
     modified = false;
+    return *this;
 }
 
 //------------------------------------------------------------------------------
-Net& Net::operator=(Net const& other)
+Net::Net(Net&& other)
+    : m_type(other.m_type), m_settings(other.m_settings)
+{
+    *this = std::move(other);
+}
+
+//------------------------------------------------------------------------------
+Net& Net::operator=(Net&& other)
 {
     if (this == &other)
         return *this;
 
-    this->~Net(); // destroy
-    new (this) Net(other); // copy construct in place
+    m_type = other.m_type;
+    m_settings = other.m_settings;
+
+    // Moving a std::deque does not relocate its elements: arcs still refer to
+    // the nodes and adjacency lists still point to the arcs.
+    m_places = std::move(other.m_places);
+    m_transitions = std::move(other.m_transitions);
+    m_arcs = std::move(other.m_arcs);
+    bindSettings();
+    m_place_indices = std::move(other.m_place_indices);
+    m_transition_indices = std::move(other.m_transition_indices);
+    m_arc_indices = std::move(other.m_arc_indices);
+    m_place_slots = std::move(other.m_place_slots);
+    m_transition_slots = std::move(other.m_transition_slots);
+    m_arc_slots = std::move(other.m_arc_slots);
+    m_next_place_id = other.m_next_place_id;
+    m_next_transition_id = other.m_next_transition_id;
+    name = std::move(other.name);
+    m_message.str(std::string());
+    modified = other.modified;
+
+    other.clear();
     return *this;
 }
 
@@ -206,7 +410,7 @@ Net& Net::operator=(Net const& other)
 void Net::reset(TypeOfNet const type)
 {
     m_type = type;
-    applyNewNetSettings(type);
+    m_settings = Settings(type);
     clear();
     name = to_str(type);
 }
@@ -217,6 +421,12 @@ void Net::clear()
     m_places.clear();
     m_transitions.clear();
     m_arcs.clear();
+    m_place_indices.clear();
+    m_transition_indices.clear();
+    m_arc_indices.clear();
+    m_place_slots.clear();
+    m_transition_slots.clear();
+    m_arc_slots.clear();
     m_next_place_id = 0u;
     m_next_transition_id = 0u;
     modified = true;
@@ -249,7 +459,7 @@ bool Net::tokens(std::vector<size_t> const& tokens_)
     size_t i = tokens_.size();
     while (i--)
     {
-        m_places[i].tokens = std::min(Net::Settings::maxTokens, tokens_[i]);
+        m_places[i].tokens = std::min(m_settings.maxTokens, tokens_[i]);
     }
 
     return true;
@@ -259,8 +469,13 @@ bool Net::tokens(std::vector<size_t> const& tokens_)
 Place& Net::addPlace(float const x, float const y, size_t const tokens)
 {
     modified = true;
+    m_place_indices.emplace(m_next_place_id, m_places.size());
+    m_place_slots.push();
     m_places.push_back(Place(m_next_place_id++, "", x, y, tokens));
-    return m_places.back();
+    Place& place = m_places.back();
+    place.m_settings = &m_settings;
+    place.tokens = std::min(m_settings.maxTokens, place.tokens);
+    return place;
 }
 
 //------------------------------------------------------------------------------
@@ -268,19 +483,27 @@ Place& Net::addPlace(size_t const id, std::string const& caption, float const x,
                      float const y, size_t const tokens)
 {
     modified = true;
+    m_place_indices.emplace(id, m_places.size());
+    m_place_slots.push();
     m_places.push_back(Place(id, caption, x, y, tokens));
     if (id + 1u > m_next_place_id)
         m_next_place_id = id + 1u;
-    return m_places.back();
+    Place& place = m_places.back();
+    place.m_settings = &m_settings;
+    place.tokens = std::min(m_settings.maxTokens, place.tokens);
+    return place;
 }
 
 //------------------------------------------------------------------------------
 Transition& Net::addTransition(float const x, float const y)
 {
     modified = true;
+    m_transition_indices.emplace(m_next_transition_id, m_transitions.size());
+    m_transition_slots.push();
     m_transitions.push_back(
         Transition(m_next_transition_id++, "", x, y, 0u,
                    (m_type == TypeOfNet::TimedPetriNet) ? true : false));
+    m_transitions.back().m_settings = &m_settings;
     return m_transitions.back();
 }
 
@@ -289,11 +512,14 @@ Transition& Net::addTransition(size_t const id, std::string const& caption,
                                float const x, float const y, int const angle)
 {
     modified = true;
+    m_transition_indices.emplace(id, m_transitions.size());
+    m_transition_slots.push();
     m_transitions.push_back(
         Transition(id, caption, x, y, angle,
                    (m_type == TypeOfNet::TimedPetriNet) ? true : false));
     if (id + 1u > m_next_transition_id)
         m_next_transition_id = id + 1u;
+    m_transitions.back().m_settings = &m_settings;
     return m_transitions.back();
 }
 
@@ -304,8 +530,8 @@ bool Net::sanityArc(Node const& from, Node const& to, bool const strict) const
     if (findArc(from, to) != nullptr)
     {
         m_message.str("");
-        m_message << "Failed adding arc " << from.key
-                  << " --> " << to.key
+        m_message << "Failed adding arc " << from.key()
+                  << " --> " << to.key()
                   << ": Arc already exist"
                   << std::endl;
         return false;
@@ -313,11 +539,11 @@ bool Net::sanityArc(Node const& from, Node const& to, bool const strict) const
 
     // Key if the origin node exists (TBD: is this really
     // necessary since findArc would have returned false ?)
-    if (findNode(from.key) == nullptr)
+    if (findNode(from.key()) == nullptr)
     {
-        m_message << "Failed adding arc " << from.key
-                  << " --> " << to.key
-                  << ": The node " << from.key
+        m_message << "Failed adding arc " << from.key()
+                  << " --> " << to.key()
+                  << ": The node " << from.key()
                   << " does not exist"
                   << std::endl;
         return false;
@@ -325,11 +551,11 @@ bool Net::sanityArc(Node const& from, Node const& to, bool const strict) const
 
     // Key if the destination node exists (TBD: is this really
     // necessary since findArc would have returned false ?)
-    if (findNode(to.key) == nullptr)
+    if (findNode(to.key()) == nullptr)
     {
-        m_message << "Failed adding arc " << from.key
-                  << " --> " << to.key
-                  << ": The node " << to.key
+        m_message << "Failed adding arc " << from.key()
+                  << " --> " << to.key()
+                  << ": The node " << to.key()
                   << " does not exist"
                   << std::endl;
         return false;
@@ -341,8 +567,8 @@ bool Net::sanityArc(Node const& from, Node const& to, bool const strict) const
     {
         // Option 1: we simply fail (for example when loading file)
         m_message.str("");
-        m_message << "Failed adding arc " << from.key
-                  << " --> " << to.key
+        m_message << "Failed adding arc " << from.key()
+                  << " --> " << to.key()
                   << ": nodes type shall not be the same"
                   << std::endl;
         return false;
@@ -352,7 +578,6 @@ bool Net::sanityArc(Node const& from, Node const& to, bool const strict) const
 }
 
 //------------------------------------------------------------------------------
-// FIXME: faire l'equivalent de generateArcsInArcsOut
 bool Net::addArc(Transition& from, Transition& to, size_t const tokens, float const duration)
 {
     // Create the intermediate node
@@ -361,22 +586,16 @@ bool Net::addArc(Transition& from, Transition& to, size_t const tokens, float co
     Place& n = addPlace(x, y, tokens);
 
     // Frist arc
-    m_arcs.push_back(Arc(from, n, duration));
-    from.arcsOut.push_back(&m_arcs.back());
-    n.arcsIn.push_back(&m_arcs.back());
+    helperAddArc(from, n, duration);
 
     // Second arc
-    m_arcs.push_back(Arc(n, to, duration));
-    n.arcsOut.push_back(&m_arcs.back());
-    to.arcsIn.push_back(&m_arcs.back());
+    helperAddArc(n, to, duration);
 
-    generateArcsInArcsOut(); // FIXME a optimiser !!!
     modified = true;
     return true;
 }
 
 //------------------------------------------------------------------------------
-// FIXME: faire l'equivalent de generateArcsInArcsOut
 bool Net::addArc(Node& from, Node& to, float const duration)
 {
     if (!sanityArc(from, to, false))
@@ -387,9 +606,7 @@ bool Net::addArc(Node& from, Node& to, float const duration)
     // Create an arc "Place -> Transition" or "Transition -> Place" 
     if (from.type != to.type)
     {
-        m_arcs.push_back(Arc(from, to, duration));
-        from.arcsOut.push_back(&m_arcs.back());
-        to.arcsIn.push_back(&m_arcs.back());
+        helperAddArc(from, to, duration);
     }
     else // Manage the case "Place -> Place" or "Transition -> Transition"
     {
@@ -399,40 +616,199 @@ bool Net::addArc(Node& from, Node& to, float const duration)
         Node& n = addOppositeNode(to.type, x, y);
 
         // Frist arc
-        m_arcs.push_back(Arc(from, n, duration));
-        from.arcsOut.push_back(&m_arcs.back());
-        n.arcsIn.push_back(&m_arcs.back());
+        helperAddArc(from, n, duration);
 
         // Second arc
-        m_arcs.push_back(Arc(n, to, duration));
-        n.arcsOut.push_back(&m_arcs.back());
-        to.arcsIn.push_back(&m_arcs.back());
+        helperAddArc(n, to, duration);
     }
 
-    generateArcsInArcsOut(); // FIXME a optimiser !!!
     return true;
 }
 
 //------------------------------------------------------------------------------
-Arc* Net::findArc(Node const& from, Node const& to)
+bool Net::addArc(Place& from, Transition& to, float const duration, size_t const weight)
+{
+    return addWeightedArc(from, to, duration, weight);
+}
+
+//------------------------------------------------------------------------------
+bool Net::addArc(Transition& from, Place& to, float const duration, size_t const weight)
+{
+    return addWeightedArc(from, to, duration, weight);
+}
+
+//------------------------------------------------------------------------------
+bool Net::addWeightedArc(Node& from, Node& to, float const duration, size_t const weight)
 {
-    for (auto& it: m_arcs)
+    if (!sanityArc(from, to, true))
+        return false;
+
+    if (weight == 0u)
     {
-        if ((it.from.key == from.key) && (it.to.key == to.key))
-            return &it;
+        m_message.str("");
+        m_message << "Failed adding arc " << from.key()
+                  << " --> " << to.key()
+                  << ": null weight"
+                  << std::endl;
+        return false;
     }
-    return nullptr;
+
+    modified = true;
+    helperAddArc(from, to, duration, weight);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+Arc& Net::helperAddArc(Node& from, Node& to, float const duration,
+                       size_t const weight)
+{
+    m_arc_indices.emplace(ArcKey(from, to), m_arcs.size());
+    m_arc_slots.push();
+    m_arcs.push_back(Arc(from, to, duration, weight));
+    from.arcsOut.push_back(&m_arcs.back());
+    to.arcsIn.push_back(&m_arcs.back());
+    return m_arcs.back();
+}
+
+//------------------------------------------------------------------------------
+Arc* Net::findArc(Node const& from, Node const& to)
+{
+    auto const it = m_arc_indices.find(ArcKey(from, to));
+    if (it == m_arc_indices.end())
+        return nullptr;
+    return &m_arcs[it->second];
 }
 
 //------------------------------------------------------------------------------
 Arc const* Net::findArc(Node const& from, Node const& to) const
 {
-    for (auto& it: m_arcs)
+    auto const it = m_arc_indices.find(ArcKey(from, to));
+    if (it == m_arc_indices.end())
+        return nullptr;
+    return &m_arcs[it->second];
+}
+
+//------------------------------------------------------------------------------
+NodeHandle Net::handle(Node const& node) const
+{
+    NodeHandle h;
+    h.type = node.type;
+
+    if (node.type == Node::Type::Place)
+    {
+        auto const it = m_place_indices.find(node.id);
+        if ((it != m_place_indices.end()) && (&m_places[it->second] == &node))
+        {
+            h.slot = m_place_slots.slot(it->second);
+            h.generation = m_place_slots.generation(h.slot);
+        }
+    }
+    else
+    {
+        auto const it = m_transition_indices.find(node.id);
+        if ((it != m_transition_indices.end()) && (&m_transitions[it->second] == &node))
+        {
+            h.slot = m_transition_slots.slot(it->second);
+            h.generation = m_transition_slots.generation(h.slot);
+        }
+    }
+
+    return h;
+}
+
+//------------------------------------------------------------------------------
+ArcHandle Net::handle(Arc const& arc) const
+{
+    ArcHandle h;
+
+    auto const it = m_arc_indices.find(ArcKey(arc.from, arc.to));
+    if ((it != m_arc_indices.end()) && (&m_arcs[it->second] == &arc))
+    {
+        h.slot = m_arc_slots.slot(it->second);
+        h.generation = m_arc_slots.generation(h.slot);
+    }
+
+    return h;
+}
+
+//------------------------------------------------------------------------------
+Node* Net::node(NodeHandle const& handle)
+{
+    if (handle.type == Node::Type::Place)
     {
-        if ((it.from.key == from.key) && (it.to.key == to.key))
-            return &it;
+        size_t const i = m_place_slots.position(handle.slot, handle.generation);
+        return (i < m_places.size()) ? &m_places[i] : nullptr;
+    }
+
+    size_t const i = m_transition_slots.position(handle.slot, handle.generation);
+    return (i < m_transitions.size()) ? &m_transitions[i] : nullptr;
+}
+
+//------------------------------------------------------------------------------
+Node const* Net::node(NodeHandle const& handle) const
+{
+    return const_cast<Net*>(this)->node(handle);
+}
+
+//------------------------------------------------------------------------------
+Arc* Net::arc(ArcHandle const& handle)
+{
+    size_t const i = m_arc_slots.position(handle.slot, handle.generation);
+    return (i < m_arcs.size()) ? &m_arcs[i] : nullptr;
+}
+
+//------------------------------------------------------------------------------
+Arc const* Net::arc(ArcHandle const& handle) const
+{
+    return const_cast<Net*>(this)->arc(handle);
+}
+
+//------------------------------------------------------------------------------
+void Net::generateIndices()
+{
+    m_place_indices.clear();
+    m_place_indices.reserve(m_places.size());
+    for (size_t i = 0u; i < m_places.size(); ++i)
+    {
+        m_place_indices.emplace(m_places[i].id, i);
+    }
+
+    m_transition_indices.clear();
+    m_transition_indices.reserve(m_transitions.size());
+    for (size_t i = 0u; i < m_transitions.size(); ++i)
+    {
+        m_transition_indices.emplace(m_transitions[i].id, i);
+    }
+
+    m_arc_indices.clear();
+    m_arc_indices.reserve(m_arcs.size());
+    for (size_t i = 0u; i < m_arcs.size(); ++i)
+    {
+        m_arc_indices.emplace(ArcKey(m_arcs[i].from, m_arcs[i].to), i);
+    }
+}
+
+//------------------------------------------------------------------------------
+void Net::bindSettings()
+{
+    for (auto& p: m_places)
+    {
+        p.m_settings = &m_settings;
+    }
+    for (auto& t: m_transitions)
+    {
+        t.m_settings = &m_settings;
+    }
+}
+
+//------------------------------------------------------------------------------
+void Net::settings(Settings const& settings_)
+{
+    m_settings = settings_;
+    for (auto& p: m_places)
+    {
+        p.tokens = std::min(m_settings.maxTokens, p.tokens);
     }
-    return nullptr;
 }
 
 //------------------------------------------------------------------------------
@@ -442,103 +818,108 @@ void Net::generateArcsInArcsOut()
     {
         trans.arcsIn.clear();
         trans.arcsOut.clear();
-
-        for (auto& a: m_arcs)
-        {
-            if ((a.from.type == Node::Type::Place) && (a.to.id == trans.id))
-                trans.arcsIn.push_back(&a);
-            else if ((a.to.type == Node::Type::Place) && (a.from.id == trans.id))
-                trans.arcsOut.push_back(&a);
-        }
     }
 
-    // if (true)
     for (auto& p: m_places)
     {
         p.arcsIn.clear();
         p.arcsOut.clear();
+    }
 
-        for (auto& a: m_arcs)
-        {
-            if ((a.from.type == Node::Type::Transition) && (a.to.id == p.id))
-                p.arcsIn.push_back(&a);
-            else if ((a.to.type == Node::Type::Transition) && (a.from.id == p.id))
-                p.arcsOut.push_back(&a);
-        }
+    // Iterating on arcs in the order of the container keeps arcsIn and arcsOut
+    // sorted by the position of arcs.
+    for (auto& a: m_arcs)
+    {
+        a.from.arcsOut.push_back(&a);
+        a.to.arcsIn.push_back(&a);
     }
 }
 
 //------------------------------------------------------------------------------
-Node* Net::findNode(std::string const& key)
+bool Net::sanityArcsInArcsOut() const
 {
-    if (key[0] == 'P')
+    size_t count_in = 0u;
+    size_t count_out = 0u;
+
+    // Check that arcsIn and arcsOut of the given node only refer to arcs of
+    // this net that are linked to the node, in the order of the container.
+    auto check = [this](Node const& node, std::vector<Arc*> const& arcs,
+                        bool const incoming) -> bool
     {
-        for (auto& p: m_places)
+        size_t previous = 0u;
+        for (size_t k = 0u; k < arcs.size(); ++k)
         {
-            if (p.key == key)
-                return &p;
+            Arc const* a = arcs[k];
+            if (&(incoming ? a->to : a->from) != &node)
+                return false;
+
+            auto const it = m_arc_indices.find(ArcKey(a->from, a->to));
+            if ((it == m_arc_indices.end()) || (&m_arcs[it->second] != a))
+                return false;
+
+            if ((k != 0u) && (it->second <= previous))
+                return false;
+            previous = it->second;
         }
-        return nullptr;
+        return true;
+    };
+
+    for (auto const& trans: m_transitions)
+    {
+        if (!check(trans, trans.arcsIn, true) || !check(trans, trans.arcsOut, false))
+            return false;
+        count_in += trans.arcsIn.size();
+        count_out += trans.arcsOut.size();
     }
 
-    if (key[0] == 'T')
+    for (auto const& p: m_places)
     {
-        for (auto& t: m_transitions)
-        {
-            if (t.key == key)
-                return &t;
-        }
-        return nullptr;
+        if (!check(p, p.arcsIn, true) || !check(p, p.arcsOut, false))
+            return false;
+        count_in += p.arcsIn.size();
+        count_out += p.arcsOut.size();
     }
 
-    return nullptr;
+    // Arcs are unique per node, so all arcs are referenced once.
+    return (count_in == m_arcs.size()) && (count_out == m_arcs.size());
 }
 
 //------------------------------------------------------------------------------
-Node const* Net::findNode(std::string const& key) const
+Node* Net::findNode(std::string const& key)
 {
-    if (key[0] == 'P')
-    {
-        for (auto& p: m_places)
-        {
-            if (p.key == key)
-                return &p;
-        }
-        return nullptr;
-    }
-    else if (key[0] == 'T')
-    {
-        for (auto& t: m_transitions)
-        {
-            if (t.key == key)
-                return &t;
-        }
+    Node::Type type;
+    size_t id;
+
+    if (!parseKey(key, type, id))
         return nullptr;
-    }
 
-    return nullptr;
+    if (type == Node::Type::Place)
+        return findPlace(id);
+    return findTransition(id);
+}
+
+//------------------------------------------------------------------------------
+Node const* Net::findNode(std::string const& key) const
+{
+    return const_cast<Net*>(this)->findNode(key);
 }
 
 //------------------------------------------------------------------------------
 Transition* Net::findTransition(size_t const id)
 {
-    for (auto& t: m_transitions)
-    {
-        if (t.id == id)
-            return &t;
-    }
-    return nullptr;
+    auto const it = m_transition_indices.find(id);
+    if (it == m_transition_indices.end())
+        return nullptr;
+    return &m_transitions[it->second];
 }
 
 //------------------------------------------------------------------------------
 Place* Net::findPlace(size_t const id)
 {
-    for (auto& p: m_places)
-    {
-        if (p.id == id)
-            return &p;
-    }
-    return nullptr;
+    auto const it = m_place_indices.find(id);
+    if (it == m_place_indices.end())
+        return nullptr;
+    return &m_places[it->second];
 }
 
 //------------------------------------------------------------------------------
@@ -550,118 +931,202 @@ bool Net::removeArc(Arc const& a)
 //------------------------------------------------------------------------------
 bool Net::removeArc(Node const& from, Node const& to)
 {
-// Supprimer les arcs qui touchent la place supprimee
+    auto const it = m_arc_indices.find(ArcKey(from, to));
+    if (it == m_arc_indices.end())
+        return false;
 
-    size_t i = m_arcs.size();
-    while (i--)
+    helperRemoveArc(it->second);
+    assert(sanityArcsInArcsOut());
+    modified = true;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void Net::helperRemoveArc(size_t const i)
+{
+    // Found the undesired arc: unlink it from its nodes and make the latest
+    // element take its location in the container.
+    size_t const last = m_arcs.size() - 1u;
+    Arc& a = m_arcs[i];
+    eraseArc(a.from.arcsOut, &a);
+    eraseArc(a.to.arcsIn, &a);
+    m_arc_indices.erase(ArcKey(a.from, a.to));
+    if (i != last)
     {
-        if ((m_arcs[i].from.key == from.key) && (m_arcs[i].to.key == to.key))
+        Arc& e = m_arcs[last];
+        eraseArc(e.from.arcsOut, &e);
+        eraseArc(e.to.arcsIn, &e);
+        a = e;
+        m_arc_indices[ArcKey(a.from, a.to)] = i;
+
+        // Keep arcsIn and arcsOut sorted by the position of arcs in the
+        // container, as generateArcsInArcsOut() would do.
+        auto const before = [this](Arc const* x, size_t const position)
         {
-            // Found the undesired arc: make the latest element take its
-            // location in the container.
-            m_arcs[i] = m_arcs[m_arcs.size() - 1u];
-            m_arcs.pop_back();
-
-            generateArcsInArcsOut();
-            return true;
-        }
+            return m_arc_indices.find(ArcKey(x->from, x->to))->second < position;
+        };
+        auto& out = a.from.arcsOut;
+        out.insert(std::lower_bound(out.begin(), out.end(), i, before), &a);
+        auto& in = a.to.arcsIn;
+        in.insert(std::lower_bound(in.begin(), in.end(), i, before), &a);
     }
-    return false;
+    m_arc_slots.erase(i);
+    m_arcs.pop_back();
 }
 
 //------------------------------------------------------------------------------
 void Net::helperRemovePlace(Node& node)
 {
-    size_t i = m_places.size();
-    while (i--)
+    auto const it = m_place_indices.find(node.id);
+    if (it == m_place_indices.end())
+        return ;
+
+    // Found the undesired node: make the latest element take its location in
+    // the container. But before doing this we have to restore references on
+    // impacted arcs.
+    size_t const i = it->second;
+    size_t const last = m_places.size() - 1u;
+    Place& pi = m_places[i];
+    Place& pe = m_places[last];
+    if (i != last)
     {
-        // Found the undesired node: make the latest element take its
-        // location in the container. But before doing this we have to
-        // restore references on impacted arcs.
-        if (m_places[i].id == node.id)
+        // Swap element but keep the ID of the removed element
+        if (pe.hasDefaultCaption())
+        {
+            m_places[i] = Place(pi.id, pi.key(), pe.x, pe.y, pe.tokens);
+        }
+        else
+        {
+            m_places[i] = Place(pi.id, pe.caption(), pe.x, pe.y, pe.tokens);
+        }
+
+        // Update the references to nodes of the arcs of the moved element.
+        // Arcs stay at the same location in their container, so the moved
+        // element can take over the incoming and outcoming arcs.
+        Place& pn = m_places[i];
+        pn.m_settings = &m_settings;
+        for (auto& a: pe.arcsIn)
+        {
+            auto const index = m_arc_indices.find(ArcKey(a->from, a->to));
+            size_t const j = index->second;
+            m_arc_indices.erase(index);
+            *a = Arc(a->from, pn, a->duration, a->weight);
+            m_arc_indices[ArcKey(a->from, a->to)] = j;
+        }
+        for (auto& a: pe.arcsOut)
         {
-            // Swap element but keep the ID of the removed element
-            Place& pi = m_places[i];
-            Place& pe = m_places[m_places.size() - 1u];
-            if (pe.caption == pe.key)
-            {
-                m_places[i] = Place(pi.id, pi.key, pe.x, pe.y, pe.tokens);
-            }
-            else
-            {
-                m_places[i] = Place(pi.id, pe.caption, pe.x, pe.y, pe.tokens);
-            }
-            assert(m_next_place_id >= 1u);
-            m_next_place_id -= 1u;
-
-            // Update the references to nodes of the arc
-            for (auto& a: m_arcs) // TODO optim: use in/out arcs but they may not be generated
-            {
-                if (a.to.key == pe.key)
-                    a = Arc(a.from, m_places[i], a.duration);
-                if (a.from.key == pe.key)
-                    a = Arc(m_places[i], a.to, a.duration);
-            }
-
-            m_places.pop_back();
+            auto const index = m_arc_indices.find(ArcKey(a->from, a->to));
+            size_t const j = index->second;
+            m_arc_indices.erase(index);
+            *a = Arc(pn, a->to, a->duration, a->weight);
+            m_arc_indices[ArcKey(a->from, a->to)] = j;
         }
+        pn.arcsIn = std::move(pe.arcsIn);
+        pn.arcsOut = std::move(pe.arcsOut);
     }
+
+    // The moved element is no longer at the end of the container.
+    auto const moved = m_place_indices.find(pe.id);
+    if ((moved != m_place_indices.end()) && (moved->second == last))
+    {
+        m_place_indices.erase(moved);
+    }
+
+    assert(m_next_place_id >= 1u);
+    m_next_place_id -= 1u;
+    m_place_slots.erase(i);
+    m_places.pop_back();
 }
 
 //------------------------------------------------------------------------------
 void Net::helperRemoveTransition(Node& node)
 {
-    size_t i = m_transitions.size();
-    while (i--)
+    auto const it = m_transition_indices.find(node.id);
+    if (it == m_transition_indices.end())
+        return ;
+
+    // Found the undesired node: make the latest element take its location in
+    // the container. But before doing this we have to restore references on
+    // impacted arcs.
+    size_t const i = it->second;
+    size_t const last = m_transitions.size() - 1u;
+    Transition& ti = m_transitions[i];
+    Transition& te = m_transitions[last];
+    if (i != last)
     {
-        // Found the undesired node: make the latest element take its
-        // location in the container. But before doing this we have to
-        // restore references on impacted arcs.
-        if (m_transitions[i].id == node.id)
+        if (te.hasDefaultCaption())
+        {
+            m_transitions[i] = Transition(ti.id, ti.key(), te.x, te.y, te.angle,
+                                          (m_type == TypeOfNet::TimedPetriNet)
+                                          ? true : false);
+        }
+        else
         {
-            Transition& ti = m_transitions[i];
-            Transition& te = m_transitions[m_transitions.size() - 1u];
-            if (te.caption == te.key)
-            {
-                m_transitions[i] = Transition(ti.id, ti.key, te.x, te.y, te.angle,
-                                                (m_type == TypeOfNet::TimedPetriNet)
-                                                ? true : false);
-            }
-            else
-            {
-                m_transitions[i] = Transition(ti.id, te.caption, te.x, te.y, te.angle,
-                                                (m_type == TypeOfNet::TimedPetriNet)
-                                                ? true : false);
-            }
-            assert(m_next_transition_id >= 1u);
-            m_next_transition_id -= 1u;
-
-            // Update the references to nodes of the arc
-            for (auto& a: m_arcs) // TODO optim: use in/out arcs but they may not be generated
-            {
-                if (a.to.key == te.key)
-                    a = Arc(a.from, m_transitions[i], a.duration);
-                if (a.from.key == te.key)
-                    a = Arc(m_transitions[i], a.to, a.duration);
-            }
-
-            m_transitions.pop_back();
+            m_transitions[i] = Transition(ti.id, te.caption(), te.x, te.y, te.angle,
+                                          (m_type == TypeOfNet::TimedPetriNet)
+                                          ? true : false);
         }
+
+        // Update the references to nodes of the arcs of the moved element.
+        // Arcs stay at the same location in their container, so the moved
+        // element can take over the incoming and outcoming arcs.
+        Transition& tn = m_transitions[i];
+        tn.m_settings = &m_settings;
+        tn.receptivity = te.receptivity;
+        tn.delay = te.delay;
+        for (auto& a: te.arcsIn)
+        {
+            auto const index = m_arc_indices.find(ArcKey(a->from, a->to));
+            size_t const j = index->second;
+            m_arc_indices.erase(index);
+            *a = Arc(a->from, tn, a->duration, a->weight);
+            m_arc_indices[ArcKey(a->from, a->to)] = j;
+        }
+        for (auto& a: te.arcsOut)
+        {
+            auto const index = m_arc_indices.find(ArcKey(a->from, a->to));
+            size_t const j = index->second;
+            m_arc_indices.erase(index);
+            *a = Arc(tn, a->to, a->duration, a->weight);
+            m_arc_indices[ArcKey(a->from, a->to)] = j;
+        }
+        tn.arcsIn = std::move(te.arcsIn);
+        tn.arcsOut = std::move(te.arcsOut);
     }
+
+    // The moved element is no longer at the end of the container.
+    auto const moved = m_transition_indices.find(te.id);
+    if ((moved != m_transition_indices.end()) && (moved->second == last))
+    {
+        m_transition_indices.erase(moved);
+    }
+
+    assert(m_next_transition_id >= 1u);
+    m_next_transition_id -= 1u;
+    m_transition_slots.erase(i);
+    m_transitions.pop_back();
 }
 
 //------------------------------------------------------------------------------
 void Net::helperRemoveArcFromNode(Node& node)
 {
-    size_t s = m_arcs.size();
-    size_t i = s;
-    while (i--)
+    std::vector<size_t> positions;
+    positions.reserve(node.arcsIn.size() + node.arcsOut.size());
+    for (auto const& a: node.arcsIn)
     {
-        if ((m_arcs[i].to.key == node.key) || (m_arcs[i].from.key == node.key))
-        {
-            m_arcs[i] = m_arcs[m_arcs.size() - 1u];
-            m_arcs.pop_back();
-        }
+        positions.push_back(m_arc_indices.find(ArcKey(a->from, a->to))->second);
+    }
+    for (auto const& a: node.arcsOut)
+    {
+        positions.push_back(m_arc_indices.find(ArcKey(a->from, a->to))->second);
+    }
+
+    // Since the latest arc takes the location of the removed one, we have
+    // to start from the greatest position to the lowest one.
+    std::sort(positions.begin(), positions.end(), std::greater<size_t>());
+    for (auto const i: positions)
+    {
+        helperRemoveArc(i);
     }
 }
 
@@ -712,8 +1177,7 @@ void Net::removeNode(Node& node)
         }
     }
 
-    // Restore in arcs and out arcs for each node
-    generateArcsInArcsOut();
+    assert(sanityArcsInArcsOut());
     modified = true;
 }
 
@@ -809,9 +1273,8 @@ bool convertTo(Net& net, TypeOfNet const type, std::string& error, std::vector<A
         // when the user wants to start its simulation.
     }
 
-    applyNewNetSettings(type);
-
     net.m_type = type;
+    net.m_settings = Net::Settings(type);
     net.resetReceptivies();
 
     if (type == TypeOfNet::GRAFCET)
@@ -821,7 +1284,7 @@ bool convertTo(Net& net, TypeOfNet const type, std::string& error, std::vector<A
         // net (json format) without loosing number of tokens for other nets.
         for (auto& place: net.places())
         {
-            place.tokens = std::min(Net::Settings::maxTokens, place.tokens);
+            place.tokens = std::min(net.m_settings.maxTokens, place.tokens);
         }
     }
 
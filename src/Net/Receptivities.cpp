@@ -29,15 +29,22 @@ Receptivity::StepExp::StepExp(Net& net, std::string const& name)
     : m_net(net)
 {
     assert((name[0] == 'X') && "Incorrect place identifier");
-    m_id = std::stoul(&name[1]); // FIXME better error management
+    size_t const id = std::stoul(&name[1]); // FIXME better error management
+    Place* p = m_net.findPlace(id);
+    if (p != nullptr)
+    {
+        m_place = m_net.handle(*p);
+    }
 }
 
 //-----------------------------------------------------------------------------
 bool Receptivity::StepExp::evaluate() const
 {
-    Place* p = m_net.findPlace(m_id);
+    Node const* p = m_net.node(m_place);
     assert((p != nullptr) && "Unknowm place id");
-    return !!(p->tokens); // size_t to boolean conversion
+    if (p == nullptr)
+        return false;
+    return !!(reinterpret_cast<Place const*>(p)->tokens); // size_t to boolean conversion
 }
 
 //-----------------------------------------------------------------------------
@@ -21,6 +21,7 @@
 #ifndef RECEPTIVITIES_HPP
 #  define RECEPTIVITIES_HPP
 
+#  include "TimedPetriNetEditor/PetriNet.hpp"
 #  include <memory>
 #  include <string>
 #  include <stack>
@@ -30,8 +31,6 @@
 
 namespace tpne {
 
-class Net;
-
 // ****************************************************************************
 //! \brief Quick and dirty container of sensor boolean values.
 //! \fixme should store analogical value.
@@ -104,9 +103,9 @@ public:
     private:
 
         Net& m_net;
-        //! \brief Place ID. The GRAFCET net shall no remove the place t let this
-        //! ID valid.
-        size_t m_id;
+        //! \brief Handle on the place. Stays attached to the same place when
+        //! other places are removed. Stale if the place has been removed.
+        NodeHandle m_place;
     };
 
     // *************************************************************************
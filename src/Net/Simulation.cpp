@@ -22,41 +22,63 @@
 
 namespace tpne {
 
+//! \brief Period of the worker thread.
+static std::chrono::milliseconds const TICK(8);
+//! \brief Wall-clock time given to the simulation per tick. Beyond it, the
+//! simulation clock lags behind.
+static std::chrono::milliseconds const BUDGET(8);
+
 //------------------------------------------------------------------------------
-static const char* current_time() // FIXME defined several times
+void Simulation::Inputs::clear()
 {
-    static char buffer[32];
-
-    time_t current_time = ::time(nullptr);
-    strftime(buffer, sizeof (buffer), "[%H:%M:%S] ", localtime(&current_time));
-    return buffer;
+    tokens.clear();
+    receptivities.clear();
+    rewind = false;
+    fast_forward = false;
 }
 
 //------------------------------------------------------------------------------
 Simulation::Simulation(Net& net, Messages& messages)
-    : m_net(net), m_messages(messages)
+    : m_net(net), m_messages(messages), m_console(net)
 {
     m_timed_tokens.reserve(128u);
 }
 
 //------------------------------------------------------------------------------
-std::vector<Transition*> const& Simulation::shuffle_transitions(bool const reset)
+Simulation::~Simulation()
 {
-    static std::random_device rd;
-    static std::mt19937 g(rd());
+    stopWorker();
+}
 
-    if (reset)
+//------------------------------------------------------------------------------
+void Simulation::console(bool const enable)
+{
+    if (enable == m_logging)
+        return ;
+
+    m_logging = enable;
+    if (enable)
+        m_simulator.addObserver(m_console);
+    else
+        m_simulator.removeObserver(m_console);
+}
+
+//------------------------------------------------------------------------------
+bool Simulation::trace(std::string const& filename)
+{
+    m_simulator.removeObserver(m_recorder);
+    m_recorder.close();
+    if (filename.empty())
+        return true;
+
+    std::string const error = m_recorder.open(filename);
+    if (!error.empty())
     {
-        // Avoid useless copy at each iteration of the simulation. Do it
-        // once at the begining of the simulation.
-        m_shuffled_transitions.clear();
-        m_shuffled_transitions.reserve(m_net.transitions().size());
-        for (auto& trans: m_net.transitions())
-            m_shuffled_transitions.push_back(&trans);
+        m_messages.setError(error);
+        return false;
     }
-    std::shuffle(m_shuffled_transitions.begin(),
-                 m_shuffled_transitions.end(), g);
-    return m_shuffled_transitions;
+    m_simulator.addObserver(m_recorder);
+    return true;
 }
 
 //------------------------------------------------------------------------------
@@ -99,12 +121,7 @@ void Simulation::stateStarting()
     // Reset states of the simulator
     m_net.generateArcsInArcsOut();
     m_initial_tokens = m_net.tokens();
-    shuffle_transitions(true);
     m_timed_tokens.clear();
-    for (auto& a: m_net.arcs())
-    {
-        a.count = 0u;
-    }
 
     // Reset values on transitivities and sensors for GRAFCET
     m_net.resetReceptivies();
@@ -113,8 +130,60 @@ void Simulation::stateStarting()
         running = false;
     }
 
+    // Freeze the structure of the net for the simulation
+    if (!m_simulator.reset(m_net))
+    {
+        m_messages.setError(m_simulator.error());
+        running = false;
+        return ;
+    }
+
+    // In theory tokens are not timed in Petri nets and GRAFCET but it is
+    // nicer for the user to see them moving along arcs. For timed nets, avoid
+    // cycles of null durations freezing the editor.
+    for (size_t i = 0u; i < m_simulator.compiled().postSize(); ++i)
+    {
+        switch (m_net.type())
+        {
+        case TypeOfNet::PetriNet:
+            m_simulator.delay(i, 0.2f);
+            break;
+        case TypeOfNet::GRAFCET:
+            m_simulator.delay(i, 1.5f);
+            break;
+        default:
+            m_simulator.delay(i, std::max(0.001f, m_simulator.delay(i)));
+            break;
+        }
+    }
+    std::random_device rd;
+    m_simulator.seed(rd());
+    m_fast_forward = false;
+
+    // Snapshots for rewinding the simulation.
+    m_timeline.clear();
+    m_next_snapshot = 0.0;
+    snapshot();
+
+    // State shown by the GUI thread.
+    m_shown_tokens = m_net.tokens();
+    m_shown_receptivities.resize(m_net.transitions().size());
+    for (auto const& t: m_net.transitions())
+    {
+        m_shown_receptivities[t.id] = t.receptivity;
+    }
+    m_time = 0.0;
+    m_fast_forwarding = false;
+    m_sensors.clear();
+    m_inputs.clear();
+    m_frames.update(); // Forget the latest frame of the previous simulation
+
     //
-    std::cout << current_time() << "Simulation has started!" << std::endl;
+    m_recorder.started();
+    if (m_logging)
+    {
+        m_console.log("Simulation has started!");
+    }
     if (m_net.type() == TypeOfNet::PetriNet)
     {
         m_messages.setInfo(
@@ -128,6 +197,8 @@ void Simulation::stateStarting()
         m_messages.setInfo("Simulation has started!");
     }
 
+    m_working = true;
+    m_worker = std::thread(&Simulation::work, this);
     m_state = Simulation::State::Simulating;
 }
 
@@ -148,7 +219,7 @@ bool Simulation::generateSensors()
         m_receptivities.clear();
         for (auto const& it: m_net.transitions())
         {
-            std::string error = m_receptivities[it.id].compile(it.caption, m_net);
+            std::string error = m_receptivities[it.id].compile(it.caption(), m_net);
             if (!error.empty())
             {
                 m_messages.setWarning(error);
@@ -163,7 +234,7 @@ bool Simulation::generateSensors()
 //------------------------------------------------------------------------------
 bool Simulation::generateSensor(Transition const& transition)
 {
-    std::string error = m_receptivities[transition.id].compile(transition.caption, m_net);
+    std::string error = m_receptivities[transition.id].compile(transition.caption(), m_net);
     if (!error.empty())
     {
         m_messages.setWarning(error);
@@ -173,18 +244,34 @@ bool Simulation::generateSensor(Transition const& transition)
     return true;
 }
 
+//------------------------------------------------------------------------------
+void Simulation::stopWorker()
+{
+    if (!m_worker.joinable())
+        return ;
+
+    m_working = false;
+    m_worker.join();
+}
+
 //------------------------------------------------------------------------------
 void Simulation::stateHalting()
 {
+    stopWorker();
+
     m_messages.setInfo("Simulation has ended!");
-    std::cout << current_time() << "Simulation has ended!"
-                << std::endl << std::endl;
+    if (m_logging)
+    {
+        m_console.log("Simulation has ended!\n");
+    }
 
     // Restore burnt tokens from the simulation
     m_net.tokens(m_initial_tokens);
     m_net.resetReceptivies();
     m_receptivities.clear();
     m_timed_tokens.clear();
+    m_timeline.clear();
+    m_sensors.clear();
     Sensors::instance().clear();
     m_state = Simulation::State::Idle;
 }
@@ -192,9 +279,6 @@ void Simulation::stateHalting()
 //------------------------------------------------------------------------------
 void Simulation::stateSimulating(float const dt)
 {
-    bool burnt = false;
-    size_t burning = 0u;
-
     // The user has requested to halt the simulation ?
     if (!running)
     {
@@ -211,138 +295,292 @@ void Simulation::stateSimulating(float const dt)
         // }  Sensors::modified = false;
     }
 
-    // For each transition check if it is activated (all incoming Places
-    // have at least one token to burn. Note: since here we care Petri but
-    // not Grafcet the transitivity is always true). If yes, we will burn
-    // the maximum possible of tokens in a single step for the animation.
-    // But in the aim to divide tokens the most kindly over the maximum
-    // transitions possible we have to iterate and burn tokens one by one.
-    do
+    // The user may have added or removed tokens, or clicked on transitions
+    // since the previous step.
+    forwardInputs();
+
+    // Show the latest state published by the worker thread, if any, else
+    // keep on moving tokens until the next one.
+    if (!m_frames.update())
     {
-        // Randomize the order of fired transition.
-        // TODO: filter the list to speed up ?
-        auto& transitions = shuffle_transitions();
+        if (!m_fast_forwarding)
+        {
+            m_timed_tokens.updateAll(dt * m_speed);
+            m_timed_tokens.compact();
+        }
+        return ;
+    }
 
-        burning = 0u;
-        for (auto& trans: transitions)
+    Frame const& frame = m_frames.front();
+    showFrame(frame);
+    recordSensors(frame.time);
+
+    // Tokens have been lost: the simulation is no longer meaningful.
+    if (frame.overflows != 0u)
+    {
+        m_messages.setError("Places cannot hold more than "
+                            + std::to_string(CompiledNet::maxCount())
+                            + " tokens: tokens have been lost");
+        running = false;
+        m_state = Simulation::State::Halting;
+        return ;
+    }
+
+    if ((!frame.waiting) &&
+        (m_net.type() != TypeOfNet::PetriNet) && (m_net.type() != TypeOfNet::GRAFCET))
+    {
+        if (m_logging)
         {
-            // The theory would burn the maximum possibe of tokens that
-            // we can in a single action but we can also try to burn tokens
-            // one by one and randomize the transitions.
-            size_t tokens = 0u;
-            if (trans->isFireable())
-            {
-                tokens = trans->countBurnableTokens();
-            }
+            m_console.log("The simulation cannot burn tokens.");
+        }
+        running = false;
+        m_state = Simulation::State::Halting;
+    }
+}
 
-            if (tokens > 0u)
-            {
-                assert(tokens <= Net::Settings::maxTokens);
-                //TODO trans->fading.restart();
-
-                burning = tokens; // keep iterating on this loop
-                burnt = true; // At least one place has been fired
-
-                // Transition source
-                if (trans->isInput())
-                {
-                    burning = 0u;
-                    trans->receptivity = false;
-                }
-                else
-                {
-                    // Burn tokens on each predecessor Places
-                    for (auto& a: trans->arcsIn)
-                    {
-                        // Burn tokens
-                        size_t& tks = a->tokensIn();
-                        assert(tks >= tokens);
-                        tks = std::min(Net::Settings::maxTokens, tks - tokens);
-
-                        // Invalidate transitions of previous places
-                        if (m_net.type() == TypeOfNet::PetriNet)
-                        {
-                            Transition& tr = reinterpret_cast<Transition&>(a->to);
-                            tr.receptivity = false;
-                        }
-                        //TODO a->fading.restart();
-                    }
-                }
-
-                // Count the number of tokens for the animation
-                for (auto& a: trans->arcsOut)
-                {
-                    a->count = std::min(Net::Settings::maxTokens, a->count + tokens);
-                }
-            }
+//------------------------------------------------------------------------------
+void Simulation::forwardInputs()
+{
+    bool saturated = false;
+    Inputs inputs;
+    for (auto const& p: m_net.places())
+    {
+        size_t const shown = m_shown_tokens[p.id];
+        if (p.tokens != shown)
+        {
+            saturated |= (p.tokens > CompiledNet::maxCount());
+            if (p.tokens > shown)
+                inputs.tokens.push_back({ p.id, p.tokens - shown, 0u });
+            else
+                inputs.tokens.push_back({ p.id, 0u, shown - p.tokens });
+            m_shown_tokens[p.id] = p.tokens;
+        }
+    }
+    for (auto const& t: m_net.transitions())
+    {
+        if (t.receptivity != m_shown_receptivities[t.id])
+        {
+            inputs.receptivities.emplace_back(t.id, t.receptivity);
+            m_shown_receptivities[t.id] = t.receptivity;
         }
-    } while (burning != 0u);
+    }
+    if (saturated)
+    {
+        m_messages.setWarning("Places holding too many tokens have been saturated");
+    }
+    if (inputs.tokens.empty() && inputs.receptivities.empty())
+        return ;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_inputs.tokens.insert(m_inputs.tokens.end(), inputs.tokens.begin(),
+                           inputs.tokens.end());
+    m_inputs.receptivities.insert(m_inputs.receptivities.end(),
+                                  inputs.receptivities.begin(),
+                                  inputs.receptivities.end());
+}
+
+//------------------------------------------------------------------------------
+void Simulation::showFrame(Frame const& frame)
+{
+    m_time = frame.time;
+    m_fast_forwarding = frame.fast_forward;
+
+    // Marking and receptivities.
+    for (auto& p: m_net.places())
+    {
+        p.tokens = m_shown_tokens[p.id] = frame.tokens[p.id];
+    }
+    for (auto& t: m_net.transitions())
+    {
+        t.receptivity = m_shown_receptivities[t.id] = (frame.receptivities[t.id] != 0u);
+    }
 
-    // Create animated tokens with the correct number of tokens they are
-    // carrying.
-    if (burnt)
+    // Animate tokens in flight from their position at this time.
+    m_timed_tokens.clear();
+    for (auto const& it: frame.flights)
     {
-        for (auto& a: m_net.arcs()) // FIXME: speedup: trans->arcsOut
+        m_timed_tokens.spawn(m_net.arcs()[it.arc], it.tokens, m_net.type(), it.offset);
+    }
+}
+
+//------------------------------------------------------------------------------
+void Simulation::recordSensors(double const time)
+{
+    if (m_net.type() != TypeOfNet::GRAFCET)
+        return ;
+
+    // Sensors are copied only when modified.
+    while ((!m_sensors.empty()) && (m_sensors.back().first > time))
+    {
+        m_sensors.pop_back();
+    }
+    auto const& values = Sensors::instance().database();
+    if (m_sensors.empty() || (*m_sensors.back().second != values))
+    {
+        m_sensors.emplace_back(time,
+            std::make_shared<const std::map<const std::string, int>>(values));
+    }
+}
+
+//------------------------------------------------------------------------------
+bool Simulation::rewind(double const time)
+{
+    if ((m_state != Simulation::State::Simulating) || (time >= m_time))
+        return false;
+
+    for (auto it = m_sensors.rbegin(); it != m_sensors.rend(); ++it)
+    {
+        if (it->first <= time)
         {
-            if (a.count > 0u) // number of tokens carried by a single animation
-            {
-                std::cout << current_time()
-                            << "Transition " << a.from.caption << " burnt "
-                            << a.count << " token"
-                            << (a.count == 1u ? "" : "s")
-                            << std::endl;
-                m_timed_tokens.emplace_back(a, a.count, m_net.type());
-                //TODO a.fading.restart();
-                a.count = 0u;
-            }
+            Sensors::instance().database() = *it->second;
+            break;
         }
     }
 
-    // Tokens Transition --> Places are transitioning.
-    if (m_timed_tokens.size() > 0u)
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_inputs.rewind = true;
+    m_inputs.rewind_time = time;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void Simulation::fastForward(double const time, size_t const firings)
+{
+    if (m_state != Simulation::State::Simulating)
+        return ;
+
+    m_fast_forwarding = true;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_inputs.fast_forward = true;
+    m_inputs.goal_time = time;
+    m_inputs.goal_firings = firings;
+}
+
+//------------------------------------------------------------------------------
+void Simulation::work()
+{
+    auto previous = std::chrono::steady_clock::now();
+    while (m_working)
     {
-        size_t i = m_timed_tokens.size();
-        while (i--)
+        auto const now = std::chrono::steady_clock::now();
+        float const dt = std::chrono::duration<float>(now - previous).count();
+        previous = now;
+
+        // Modifications and requests of the user since the previous tick.
         {
-            TimedToken& an = m_timed_tokens[i];
-            if (an.update(dt))
-            {
-                // Animated token reached its ddestination: Place
-                std::cout << current_time()
-                            << "Place " << an.arc->to.caption
-                            << " got " << an.tokens << " token"
-                            << (an.tokens == 1u ? "" : "s")
-                            << std::endl;
-
-                // Drop the number of tokens it was carrying.
-                an.arc->tokensOut() += an.tokens;
-
-                // Transition source. In Petri net we keep using the mouse to
-                // fire source transition to generate a single token by mouse
-                // click while in other mode the transition fires once the
-                // animation ends.
-                if (m_net.type() != TypeOfNet::PetriNet)
-                {
-                    Transition& t = reinterpret_cast<Transition&>(an.arc->from);
-                    if (t.isInput())
-                    {
-                        t.receptivity = true;
-                    }
-                }
-
-                // Remove it
-                m_timed_tokens[i] = m_timed_tokens[m_timed_tokens.size() - 1u];
-                m_timed_tokens.pop_back();
-            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::swap(m_inputs, m_taken);
         }
+        apply(m_taken);
+        m_taken.clear();
+
+        advance(dt, now + BUDGET);
+        publish();
+
+        std::this_thread::sleep_until(now + TICK);
     }
-    else if ((m_net.type() != TypeOfNet::PetriNet) && (m_net.type() != TypeOfNet::GRAFCET))
+}
+
+//------------------------------------------------------------------------------
+void Simulation::apply(Inputs const& inputs)
+{
+    CompiledNet& net = m_simulator.compiled();
+    for (auto const& it: inputs.tokens)
     {
-        std::cout << current_time() << "The simulation cannot burn tokens."
-                    << std::endl;
-        running = false;
-        m_state = Simulation::State::Halting;
+        // Saturated on both sides. Tokens held in the place cannot be
+        // removed.
+        size_t const tokens = net.tokens(it.place);
+        size_t const added = std::min(it.added, CompiledNet::maxCount() - tokens);
+        size_t const removed = std::min(it.removed, tokens + added);
+        net.tokens(it.place, tokens + added - removed);
+    }
+    for (auto const& it: inputs.receptivities)
+    {
+        net.receptivity(it.first, it.second);
+    }
+
+    if (inputs.rewind && m_timeline.rewind(m_simulator, inputs.rewind_time))
+    {
+        m_next_snapshot = inputs.rewind_time;
+        m_fast_forward = false;
     }
+
+    if (inputs.fast_forward)
+    {
+        size_t const firings = m_simulator.firings();
+        m_fast_forward = true;
+        m_goal_time = inputs.goal_time;
+        m_goal_firings = firings + std::min(inputs.goal_firings,
+                                            static_cast<size_t>(-1) - firings);
+    }
+}
+
+//------------------------------------------------------------------------------
+void Simulation::advance(float const dt, std::chrono::steady_clock::time_point const deadline)
+{
+    // Fire transitions and deposit tokens that have arrived during the tick,
+    // scaled by the speed factor, or toward the goal of the fast-forward. The
+    // simulation clock lags behind when the budget is exceeded.
+    if (m_fast_forward)
+    {
+        size_t const firings = m_simulator.firings();
+        m_simulator.runUntil(m_goal_time, m_goal_firings - std::min(m_goal_firings, firings),
+                             deadline);
+        m_fast_forward = (m_simulator.time() < m_goal_time) &&
+                         (m_simulator.firings() < m_goal_firings);
+    }
+    else
+    {
+        m_simulator.runUntil(m_simulator.time() + double(dt * m_speed),
+                             static_cast<size_t>(-1), deadline);
+    }
+    snapshot();
+}
+
+//------------------------------------------------------------------------------
+void Simulation::snapshot()
+{
+    // Snapshot period in simulated seconds.
+    static double const period = 0.5;
+
+    if (m_simulator.time() < m_next_snapshot)
+        return ;
+
+    m_timeline.take(m_simulator);
+    m_next_snapshot = m_simulator.time() + period;
+}
+
+//------------------------------------------------------------------------------
+void Simulation::publish()
+{
+    CompiledNet const& net = m_simulator.compiled();
+    Frame& frame = m_frames.back();
+
+    frame.time = m_simulator.time();
+    frame.fast_forward = m_fast_forward;
+    frame.waiting = m_simulator.waiting();
+    frame.overflows = net.overflows();
+    frame.tokens.resize(net.places());
+    for (size_t p = 0u; p < net.places(); ++p)
+    {
+        frame.tokens[p] = m_simulator.tokens(p);
+    }
+    frame.receptivities.resize(net.transitions());
+    for (size_t t = 0u; t < net.transitions(); ++t)
+    {
+        frame.receptivities[t] = net.receptivity(t) ? 1u : 0u;
+    }
+    frame.flights.clear();
+    for (auto const& event: m_simulator.events())
+    {
+        float const delay = m_simulator.delay(event.offset);
+        float const left = float(event.time - m_simulator.time());
+        float const offset = (delay > 0.0f) ? (1.0f - left / delay) : 1.0f;
+        frame.flights.push_back({ net.postArc(event.offset), event.tokens,
+                                  std::max(0.0f, offset) });
+    }
+
+    m_frames.publish();
 }
 
-} // namespace tpne
\ No newline at end of file
+} // namespace tpne
@@ -22,20 +22,29 @@
 #  define SIMULATION_NET_HPP
 
 #  include "TimedPetriNetEditor/PetriNet.hpp"
+#  include "TimedPetriNetEditor/TimedSimulator.hpp"
+#  include "TimedPetriNetEditor/TraceRecorder.hpp"
+#  include "TimedPetriNetEditor/Timeline.hpp"
 #  include "Net/Receptivities.hpp"
 #  include "Net/TimedTokens.hpp"
 #  include "Utils/Messages.hpp"
+#  include "Utils/TripleBuffer.hpp"
+#  include <mutex>
 
 namespace tpne {
 
 // *****************************************************************************
-//! \brief
+//! \brief Simulation of the net edited by the user. The TimedSimulator runs on
+//! a worker thread and publishes the marking and the tokens in flight through
+//! a lock-free triple buffer. The GUI thread never waits for the simulation:
+//! step() forwards the modifications made by the user on the net to the
+//! worker, then shows the latest published state in the net and in animated
+//! tokens. The net is only accessed by the GUI thread.
 // *****************************************************************************
 class Simulation
 {
 public:
 
-    using TimedTokens = std::vector<TimedToken>;
     using Receptivities = std::map<size_t, Receptivity>;
 
     // *************************************************************************
@@ -49,18 +58,125 @@ public:
     };
 
     Simulation(Net& net, Messages& m_messages);
+    ~Simulation();
     void step(float const dt);
     bool generateSensors();
     bool generateSensor(Transition const& transition);
     inline TimedTokens const& timedTokens() const { return m_timed_tokens; }
     inline Receptivities const& receptivities() const { return m_receptivities; }
 
+    //--------------------------------------------------------------------------
+    //! \brief Enable or disable logging events of the simulation on the
+    //! console. Disabled by default. Not to be called while simulating.
+    //--------------------------------------------------------------------------
+    void console(bool const enable);
+
+    //--------------------------------------------------------------------------
+    //! \brief Record events of the simulation into the given binary trace file
+    //! (see decodeTrace()). Pass dummy string for stopping the recording. Not
+    //! to be called while simulating.
+    //! \return false if the file cannot be created (see messages).
+    //--------------------------------------------------------------------------
+    bool trace(std::string const& filename);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the simulated time of the latest shown state.
+    //--------------------------------------------------------------------------
+    inline double time() const { return m_time; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Go back to the given past simulated time: marking, tokens in
+    //! flight, receptivities and sensors are restored from the nearest
+    //! snapshot. The simulation then continues from this time.
+    //! \return false if the simulation is not running or if the time is not
+    //! in the past.
+    //--------------------------------------------------------------------------
+    bool rewind(double const time);
+
+    //--------------------------------------------------------------------------
+    //! \brief Set the number of simulated seconds per real second.
+    //--------------------------------------------------------------------------
+    inline void speed(float const factor) { m_speed = std::max(0.0f, factor); }
+    inline float speed() const { return m_speed; }
+
+    //--------------------------------------------------------------------------
+    //! \brief Simulate as fast as the budget allows, without animating tokens,
+    //! until the given simulated time or until transitions have been fired the
+    //! given number of times. The simulation then continues at the selected
+    //! speed.
+    //--------------------------------------------------------------------------
+    void fastForward(double const time, size_t const firings = static_cast<size_t>(-1));
+
+    //--------------------------------------------------------------------------
+    //! \brief Is the simulation fast-forwarding ?
+    //--------------------------------------------------------------------------
+    inline bool fastForwarding() const { return m_fast_forwarding; }
+
 private:
 
-    std::vector<Transition*> const& shuffle_transitions(bool const reset = false);
+    //--------------------------------------------------------------------------
+    //! \brief Token in flight, published for the animation.
+    //--------------------------------------------------------------------------
+    struct Flight
+    {
+        //! \brief Index of the arc Transition -> Place in the net.
+        size_t arc;
+        size_t tokens;
+        //! \brief Ratio of the duration of the arc already elapsed.
+        float offset;
+    };
+
+    //--------------------------------------------------------------------------
+    //! \brief State published by the worker thread for the GUI thread.
+    //--------------------------------------------------------------------------
+    struct Frame
+    {
+        double time = 0.0;
+        bool fast_forward = false;
+        //! \brief Are there tokens in flight or held in places ?
+        bool waiting = false;
+        //! \brief Number of token counters saturated at CompiledNet::maxCount().
+        size_t overflows = 0u;
+        std::vector<size_t> tokens;
+        std::vector<uint8_t> receptivities;
+        std::vector<Flight> flights;
+    };
+
+    //--------------------------------------------------------------------------
+    //! \brief Modifications and requests of the user for the worker thread.
+    //--------------------------------------------------------------------------
+    struct Inputs
+    {
+        void clear();
+
+        //! \brief Tokens added to or removed from places by the user. Deltas,
+        //! not absolute numbers, since the user has edited a state the worker
+        //! thread may have simulated further since.
+        struct Delta { size_t place; size_t added; size_t removed; };
+        std::vector<Delta> tokens;
+        //! \brief New receptivities of transitions.
+        std::vector<std::pair<size_t, bool>> receptivities;
+        bool rewind = false;
+        double rewind_time = 0.0;
+        bool fast_forward = false;
+        double goal_time = 0.0;
+        size_t goal_firings = 0u;
+    };
+
     void stateStarting();
     void stateSimulating(float const dt);
     void stateHalting();
+    void stopWorker();
+    void forwardInputs();
+    void showFrame(Frame const& frame);
+    void recordSensors(double const time);
+
+    // Worker thread.
+    void work();
+    void apply(Inputs const& inputs);
+    void advance(float const dt, std::chrono::steady_clock::time_point const deadline);
+    void snapshot();
+    void publish();
 
 public:
 
@@ -77,9 +193,52 @@ private:
     Net& m_net;
     //! \brief Used for error messages.
     Messages& m_messages;
-    //! \brief List of shuffled Transitions.
-    std::vector<Transition*> m_shuffled_transitions;
+
+    // Owned by the worker thread while simulating.
+
+    //! \brief Headless simulation firing transitions.
+    TimedSimulator m_simulator;
+    //! \brief Periodic snapshots of the simulation.
+    Timeline m_timeline;
+    //! \brief Simulated time of the next snapshot.
+    double m_next_snapshot = 0.0;
+    //! \brief Fast-forward until the simulated time or the number of firings.
+    bool m_fast_forward = false;
+    double m_goal_time = 0.0;
+    size_t m_goal_firings = 0u;
+    //! \brief Inputs being applied.
+    Inputs m_taken;
+    //! \brief Opt-in sinks of events of the simulation.
+    ConsoleTrace m_console;
+    TraceRecorder m_recorder;
+    bool m_logging = false;
+
+    // Shared between threads.
+
+    std::thread m_worker;
+    std::atomic<bool> m_working{false};
+    //! \brief Simulated seconds per real second.
+    std::atomic<float> m_speed{1.0f};
+    //! \brief Inputs not yet taken by the worker thread.
+    std::mutex m_mutex;
+    Inputs m_inputs;
+    //! \brief Latest state of the simulation.
+    TripleBuffer<Frame> m_frames;
+
+    // Owned by the GUI thread.
+
+    //! \brief Marking and receptivities shown in the net, for detecting
+    //! modifications made by the user.
+    std::vector<size_t> m_shown_tokens;
+    std::vector<bool> m_shown_receptivities;
+    //! \brief Simulated time of the shown state.
+    double m_time = 0.0;
+    bool m_fast_forwarding = false;
+    //! \brief Values of GRAFCET sensors along the simulated time. Shared
+    //! between times as long as they are not modified.
+    std::vector<std::pair<double, std::shared_ptr<const std::map<const std::string, int>>>> m_sensors;
     //! \brief Animation of tokens when transitioning from Transitions to Places.
+    //! Spawned from each published frame and moved between frames.
     TimedTokens m_timed_tokens;
     //! \brief Memorize initial number of tokens in places.
     std::vector<size_t> m_initial_tokens;
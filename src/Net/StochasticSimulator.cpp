@@ -0,0 +1,328 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "TimedPetriNetEditor/StochasticSimulator.hpp"
+#include <cmath>
+
+namespace tpne {
+
+//------------------------------------------------------------------------------
+//! \brief Uniform number in [0, 1) made of 53 random bits.
+static double uniform(FiringPolicy::Random& random)
+{
+    uint64_t const bits = (uint64_t(random()) << 32) | uint64_t(random());
+    return double(bits >> 11) * (1.0 / 9007199254740992.0);
+}
+
+//------------------------------------------------------------------------------
+double StochasticSimulator::sample(Distribution const& law, FiringPolicy::Random& random)
+{
+    double delay;
+    switch (law.law)
+    {
+    case Distribution::Law::Exponential:
+        delay = -std::log1p(-uniform(random)) / double(law.a);
+        break;
+    case Distribution::Law::Uniform:
+        delay = double(law.a) + double(law.b - law.a) * uniform(random);
+        break;
+    case Distribution::Law::Erlang:
+    {
+        // Sum of logarithms rather than logarithm of the product of uniforms,
+        // which underflows for many phases.
+        size_t const phases = size_t(std::max(1.0f, std::round(law.b)));
+        double sum = 0.0;
+        for (size_t i = 0u; i < phases; ++i)
+        {
+            sum -= std::log1p(-uniform(random));
+        }
+        delay = sum / double(law.a);
+        break;
+    }
+    case Distribution::Law::Weibull:
+        delay = double(law.b) * std::pow(-std::log1p(-uniform(random)), 1.0 / double(law.a));
+        break;
+    default:
+        delay = double(law.a);
+        break;
+    }
+    return std::max(0.0, delay);
+}
+
+//------------------------------------------------------------------------------
+StochasticSimulator::StochasticSimulator(Net const& net, uint64_t const seed)
+{
+    reset(net, seed);
+}
+
+//------------------------------------------------------------------------------
+bool StochasticSimulator::reset(Net const& net, uint64_t const seed)
+{
+    m_error.clear();
+    bool res = m_compiled.compile(net);
+    size_t const transitions = m_compiled.transitions();
+
+    m_time = 0.0;
+    m_firings = 0u;
+    m_counts.assign(transitions, 0u);
+    m_areas.assign(m_compiled.places(), 0.0);
+    m_since.assign(m_compiled.places(), 0.0);
+    m_random.state = seed;
+    m_delays.resize(transitions);
+    for (auto const& t: net.transitions())
+    {
+        if (t.id >= transitions)
+            continue;
+
+        m_delays[t.id] = t.delay;
+        std::string const error = t.delay.check();
+        if (res && !error.empty())
+        {
+            m_error = "Transition " + t.key() + " has an invalid delay: " + error;
+            res = false;
+        }
+    }
+
+    // Dependency graph: firing a transition modifies its upstream and
+    // downstream places, so only transitions consuming from them can be
+    // enabled or disabled.
+    std::vector<size_t> marks(transitions, static_cast<size_t>(-1));
+    m_dependent_offsets.assign(transitions + 1u, 0u);
+    m_dependents.clear();
+    for (size_t t = 0u; t < transitions; ++t)
+    {
+        marks[t] = t;
+        for (auto const& places: { m_compiled.prePlaces(t), m_compiled.postPlaces(t) })
+        {
+            for (auto const p: places)
+            {
+                for (auto const d: m_compiled.outputTransitions(p))
+                {
+                    if (marks[d] != t)
+                    {
+                        marks[d] = t;
+                        m_dependents.push_back(d);
+                    }
+                }
+            }
+        }
+        m_dependent_offsets[t + 1u] = CompiledNet::Index(m_dependents.size());
+    }
+
+    if (res)
+    {
+        res = checkImmediateCycles(net);
+    }
+
+    // Nothing is scheduled for invalid nets: the simulation is stuck.
+    m_schedule.reset(transitions);
+    for (size_t t = 0u; (t < transitions) && res; ++t)
+    {
+        schedule(t);
+    }
+
+    return res;
+}
+
+//------------------------------------------------------------------------------
+bool StochasticSimulator::checkImmediateCycles(Net const& net)
+{
+    // Immediate transitions without upstream place, or in a cycle of immediate
+    // transitions, may fire forever without letting the time advance. Cycles
+    // are searched by an iterative depth-first search on immediate
+    // transitions, linked when one feeds a place consumed by the other.
+    enum Color : uint8_t { White, Grey, Black };
+    struct Visit { size_t transition; size_t place; size_t next; };
+    size_t const transitions = m_compiled.transitions();
+    std::vector<uint8_t> colors(transitions, White);
+    std::vector<Visit> stack;
+
+    for (size_t root = 0u; root < transitions; ++root)
+    {
+        if ((colors[root] != White) || !m_delays[root].isImmediate())
+            continue;
+
+        if (m_compiled.prePlaces(root).size() == 0u)
+        {
+            m_error = "Transition " + net.transitions()[root].key()
+                      + " is immediate without upstream place: it would fire"
+                        " forever at the same time";
+            return false;
+        }
+
+        colors[root] = Grey;
+        stack.push_back({ root, 0u, 0u });
+        while (!stack.empty())
+        {
+            Visit& visit = stack.back();
+            auto const places = m_compiled.postPlaces(visit.transition);
+            if (visit.place == places.size())
+            {
+                colors[visit.transition] = Black;
+                stack.pop_back();
+                continue;
+            }
+
+            auto const successors = m_compiled.outputTransitions(places[visit.place]);
+            if (visit.next == successors.size())
+            {
+                ++visit.place;
+                visit.next = 0u;
+                continue;
+            }
+
+            size_t const next = successors[visit.next++];
+            if (!m_delays[next].isImmediate())
+                continue;
+
+            if (colors[next] == Grey)
+            {
+                m_error = "Transition " + net.transitions()[next].key()
+                          + " is in a cycle of immediate transitions: they"
+                            " would fire forever at the same time";
+                return false;
+            }
+            if (colors[next] == White)
+            {
+                colors[next] = Grey;
+                stack.push_back({ next, 0u, 0u });
+            }
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void StochasticSimulator::addObserver(TimedSimulator::Observer& observer)
+{
+    m_observers.push_back(&observer);
+}
+
+//------------------------------------------------------------------------------
+void StochasticSimulator::removeObserver(TimedSimulator::Observer& observer)
+{
+    m_observers.erase(std::remove(m_observers.begin(), m_observers.end(),
+                                  &observer), m_observers.end());
+}
+
+//------------------------------------------------------------------------------
+void StochasticSimulator::schedule(size_t const transition)
+{
+    if (!m_compiled.isFireable(transition))
+    {
+        m_schedule.remove(transition);
+        return ;
+    }
+
+    // Enabling memory: keep the firing time while enabled.
+    if (m_schedule.contains(transition))
+        return ;
+
+    double const delay = sample(m_delays[transition], m_random);
+    if (std::isfinite(delay))
+    {
+        m_schedule.push(transition, m_time + delay);
+    }
+}
+
+//------------------------------------------------------------------------------
+void StochasticSimulator::integrate(size_t const place)
+{
+    m_areas[place] += double(m_compiled.tokens(place)) * (m_time - m_since[place]);
+    m_since[place] = m_time;
+}
+
+//------------------------------------------------------------------------------
+void StochasticSimulator::fire(size_t const transition)
+{
+    for (auto const p: m_compiled.prePlaces(transition))
+    {
+        integrate(p);
+    }
+    for (auto const p: m_compiled.postPlaces(transition))
+    {
+        integrate(p);
+    }
+    m_compiled.fire(transition, 1u);
+
+    // The fired transition draws a new delay if still enabled.
+    m_schedule.remove(transition);
+    schedule(transition);
+    CompiledNet::Index const* it = m_dependents.data() + m_dependent_offsets[transition];
+    CompiledNet::Index const* end = m_dependents.data() + m_dependent_offsets[transition + 1u];
+    for (; it != end; ++it)
+    {
+        schedule(*it);
+    }
+
+    ++m_firings;
+    ++m_counts[transition];
+    for (auto observer: m_observers)
+    {
+        observer->onFired(m_time, transition, 1u);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool StochasticSimulator::step()
+{
+    if (m_schedule.empty())
+        return false;
+
+    size_t const transition = m_schedule.top();
+    m_time = m_schedule.key(transition);
+    fire(transition);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+size_t StochasticSimulator::runUntil(double const time, size_t const firings)
+{
+    size_t const start = m_firings;
+    while (m_firings - start < firings)
+    {
+        if (m_schedule.empty() || (nextTime() > time))
+        {
+            m_time = std::max(m_time, time);
+            break;
+        }
+        step();
+    }
+    return m_firings - start;
+}
+
+//------------------------------------------------------------------------------
+double StochasticSimulator::throughput(size_t const transition) const
+{
+    return (m_time > 0.0) ? double(m_counts[transition]) / m_time : 0.0;
+}
+
+//------------------------------------------------------------------------------
+double StochasticSimulator::meanTokens(size_t const place) const
+{
+    if (m_time <= 0.0)
+        return double(m_compiled.tokens(place));
+
+    double const area = m_areas[place] +
+        double(m_compiled.tokens(place)) * (m_time - m_since[place]);
+    return area / m_time;
+}
+
+} // namespace tpne
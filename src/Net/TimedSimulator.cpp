@@ -0,0 +1,568 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "TimedPetriNetEditor/TimedSimulator.hpp"
+#include <functional>
+
+namespace tpne {
+
+//------------------------------------------------------------------------------
+//! \brief Order of the min-heap of events: the earliest event, then the oldest
+//! one, on the top.
+static bool later(TimedSimulator::Event const& a, TimedSimulator::Event const& b)
+{
+    return (a.time > b.time) || ((a.time == b.time) && (a.sequence > b.sequence));
+}
+
+//------------------------------------------------------------------------------
+//! \brief Initial state of the random generator of a conflict cluster: the
+//! SplitMix64 mixing of the seed and the cluster, so that nearby seeds or
+//! clusters give unrelated sequences.
+static uint64_t stream(uint64_t const seed, size_t const cluster)
+{
+    uint64_t z = seed + 0x9E3779B97F4A7C15ull * (uint64_t(cluster) + 1u);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+//------------------------------------------------------------------------------
+TimedSimulator::TimedSimulator(Net const& net)
+{
+    reset(net);
+}
+
+//------------------------------------------------------------------------------
+bool TimedSimulator::reset(Net const& net)
+{
+    m_type = net.type();
+    m_events.clear();
+    m_releases.clear();
+    for (auto const p: m_holding_places)
+    {
+        m_queues[p].clear();
+    }
+    m_holding_places.clear();
+    m_sequence = 0u;
+    m_time = 0.0;
+    m_firings = 0u;
+    m_carrying_arcs.clear();
+
+    bool const res = m_compiled.compile(net);
+
+    // Delays of arcs. In Petri nets and GRAFCET tokens are not timed.
+    bool const timed = (m_type == TypeOfNet::TimedPetriNet) ||
+                       (m_type == TypeOfNet::TimedEventGraph);
+    m_delays.resize(m_compiled.postSize());
+    m_sources.resize(m_compiled.postSize());
+    for (size_t t = 0u; t < m_compiled.transitions(); ++t)
+    {
+        size_t const offset = m_compiled.postOffset(t);
+        auto const durations = m_compiled.postDurations(t);
+        for (size_t i = 0u; i < durations.size(); ++i)
+        {
+            m_delays[offset + i] = timed ? durations[i] : 0.0f;
+            m_sources[offset + i] = CompiledNet::Index(t);
+        }
+    }
+    m_carried_tokens.assign(m_compiled.postSize(), 0u);
+    m_forwarded.assign(m_compiled.postSize(), 0u);
+    m_outbox.clear();
+    m_candidates.clear();
+    m_group.clear();
+    m_fired.clear();
+    m_demands.assign(m_compiled.places(), 0u);
+    m_holdings.assign(m_compiled.places(), 0.0f);
+    m_queues.resize(m_compiled.places());
+    m_demanded_places.clear();
+    m_policy.pointer->reset(m_compiled.transitions());
+    seed(m_seed);
+
+    return res;
+}
+
+//------------------------------------------------------------------------------
+void TimedSimulator::seed(uint32_t const value)
+{
+    m_seed = value;
+    m_random.resize(m_compiled.clusters());
+    for (size_t c = 0u; c < m_random.size(); ++c)
+    {
+        m_random[c].state = stream(m_seed, c);
+    }
+}
+
+//------------------------------------------------------------------------------
+void TimedSimulator::policy(std::unique_ptr<FiringPolicy> policy)
+{
+    assert(policy != nullptr);
+    m_policy.pointer = std::move(policy);
+    m_policy.pointer->reset(m_compiled.transitions());
+}
+
+//------------------------------------------------------------------------------
+void TimedSimulator::holding(size_t const place, float const value)
+{
+    if (std::find(m_holding_places.begin(), m_holding_places.end(), place) ==
+        m_holding_places.end())
+    {
+        m_holding_places.push_back(CompiledNet::Index(place));
+    }
+    m_holdings[place] = std::max(0.0f, value);
+}
+
+//------------------------------------------------------------------------------
+void TimedSimulator::addObserver(Observer& observer)
+{
+    m_observers.push_back(&observer);
+}
+
+//------------------------------------------------------------------------------
+void TimedSimulator::removeObserver(Observer& observer)
+{
+    m_observers.erase(std::remove(m_observers.begin(), m_observers.end(),
+                                  &observer), m_observers.end());
+}
+
+//------------------------------------------------------------------------------
+void TimedSimulator::save(Checkpoint& checkpoint) const
+{
+    checkpoint.random.resize(m_random.size());
+    for (size_t c = 0u; c < m_random.size(); ++c)
+    {
+        checkpoint.random[c] = m_random[c].state;
+    }
+    m_policy.pointer->save(checkpoint.policy);
+    checkpoint.time = m_time;
+    checkpoint.sequence = m_sequence;
+    checkpoint.firings = m_firings;
+    checkpoint.tokens = m_compiled.tokens();
+    checkpoint.receptivities.resize(m_compiled.transitions());
+    for (size_t t = 0u; t < m_compiled.transitions(); ++t)
+    {
+        checkpoint.receptivities[t] = m_compiled.receptivity(t) ? 1u : 0u;
+    }
+    checkpoint.candidates = m_compiled.candidates();
+    checkpoint.events = m_events;
+    checkpoint.held.clear();
+    for (auto const p: m_holding_places)
+    {
+        TokenQueue const& queue = m_queues[p];
+        for (size_t i = 0u; i < queue.size(); ++i)
+        {
+            checkpoint.held.emplace_back(p, queue[i]);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void TimedSimulator::restore(Checkpoint const& checkpoint)
+{
+    assert(checkpoint.random.size() == m_random.size());
+    for (size_t c = 0u; c < m_random.size(); ++c)
+    {
+        m_random[c].state = checkpoint.random[c];
+    }
+    m_policy.pointer->restore(checkpoint.policy);
+    m_time = checkpoint.time;
+    m_sequence = checkpoint.sequence;
+    m_firings = checkpoint.firings;
+    m_compiled.restore(checkpoint.tokens, checkpoint.receptivities,
+                       checkpoint.candidates);
+    m_events = checkpoint.events;
+
+    // One release per run of held tokens.
+    m_releases.clear();
+    for (auto const p: m_holding_places)
+    {
+        m_queues[p].clear();
+    }
+    for (auto const& it: checkpoint.held)
+    {
+        m_queues[it.first].push(it.second.time, it.second.tokens);
+        m_releases.push_back({ it.second.time, it.first });
+    }
+    std::make_heap(m_releases.begin(), m_releases.end(), std::greater<Release>());
+}
+
+//------------------------------------------------------------------------------
+void TimedSimulator::receive(Event const& event)
+{
+    assert(event.time >= m_time);
+
+    // Ordered after the local events of the same time.
+    m_events.push_back(event);
+    m_events.back().sequence = m_sequence++;
+    std::push_heap(m_events.begin(), m_events.end(), later);
+}
+
+//------------------------------------------------------------------------------
+size_t TimedSimulator::fire()
+{
+    size_t firings = 0u;
+
+    // Only transitions downstream of places which have gained tokens, or
+    // whose receptivity has become true, may have become fireable.
+    m_compiled.takeCandidates(m_candidates);
+
+    // Transitions of different conflict clusters do not share upstream places:
+    // the order in which clusters are fired does not matter. Inside a cluster,
+    // candidates are ordered by identifier so that the firing policy does not
+    // depend on candidates of other clusters.
+    std::sort(m_candidates.begin(), m_candidates.end(),
+              [this](size_t const a, size_t const b)
+              {
+                  size_t const ca = m_compiled.cluster(a);
+                  size_t const cb = m_compiled.cluster(b);
+                  return (ca < cb) || ((ca == cb) && (a < b));
+              });
+    size_t first = 0u;
+    while (first < m_candidates.size())
+    {
+        size_t const cluster = m_compiled.cluster(m_candidates[first]);
+        size_t last = first + 1u;
+        while ((last < m_candidates.size()) &&
+               (m_compiled.cluster(m_candidates[last]) == cluster))
+        {
+            ++last;
+        }
+
+        // Other transitions of the cluster are not fireable: a single
+        // candidate has no conflict and is fired without random choice.
+        if (last - first == 1u)
+        {
+            firings += fireAlone(m_candidates[first]);
+        }
+        else
+        {
+            m_group.assign(m_candidates.begin() + long(first),
+                           m_candidates.begin() + long(last));
+            firings += fireCluster(cluster);
+        }
+        first = last;
+    }
+
+    // Make tokens depart, in the order of arcs in the net.
+    std::sort(m_carrying_arcs.begin(), m_carrying_arcs.end(),
+              [this](size_t const a, size_t const b)
+              {
+                  return m_compiled.postArc(a) < m_compiled.postArc(b);
+              });
+    for (auto const i: m_carrying_arcs)
+    {
+        // Carried tokens have been saturated at maxCount() when fired.
+        assert(m_carried_tokens[i] <= CompiledNet::maxCount());
+        Event const event = { m_time + double(m_delays[i]), m_sequence++,
+                              CompiledNet::Index(i),
+                              CompiledNet::Count(m_carried_tokens[i]) };
+        if (m_forwarded[i] != 0u)
+        {
+            m_outbox.push_back(event);
+        }
+        else
+        {
+            m_events.push_back(event);
+            std::push_heap(m_events.begin(), m_events.end(), later);
+        }
+        for (auto it: m_observers)
+        {
+            it->onDeparted(m_time, m_compiled.postArc(i), event.tokens, event.time);
+        }
+        m_carried_tokens[i] = 0u;
+    }
+    m_carrying_arcs.clear();
+
+    m_firings += firings;
+    return firings;
+}
+
+//------------------------------------------------------------------------------
+size_t TimedSimulator::fireAlone(size_t const transition)
+{
+    if (!m_compiled.isFireable(transition))
+        return 0u;
+
+    // Without conflict, firing once per round until tokens run out is the same
+    // than firing as many times as possible.
+    size_t count = m_compiled.countBurnableTokens(transition);
+    if ((count != 0u) && (m_type != TypeOfNet::PetriNet) &&
+        (m_compiled.kind(transition) != CompiledNet::Kind::Input))
+    {
+        count = m_compiled.enablingDegree(transition);
+    }
+    if (count != 0u)
+    {
+        fireTransition(transition, count);
+    }
+    return count;
+}
+
+//------------------------------------------------------------------------------
+size_t TimedSimulator::fireCluster(size_t const cluster)
+{
+    size_t firings = 0u;
+
+    // To divide tokens the most kindly over the maximum transitions possible
+    // we have to iterate and burn tokens one by one (depending on the firing
+    // policy of the net) in the order chosen by the firing policy. Burning
+    // tokens cannot enable other transitions: only the fired ones are tried
+    // again, in the next round or immediately.
+    // Draws of a cluster do not depend on the other clusters, so partitions of
+    // a ParallelSimulator draw as the sequential simulation does.
+    FiringPolicy& policy = *m_policy.pointer;
+    FiringPolicy::Random& random = m_random[cluster];
+    bool const rounds = policy.rounds();
+    bool const one_by_one = (m_compiled.settings().firing == NetSettings::Fire::OneByOne);
+    while (!m_group.empty())
+    {
+        // Skip the rounds where all candidates fire whatever the order.
+        if (one_by_one && rounds)
+        {
+            firings += fireRounds();
+        }
+
+        m_fired.clear();
+        for (auto const trans: m_group)
+        {
+            policy.push(trans);
+        }
+        while (!policy.empty())
+        {
+            size_t const trans = policy.pop(random);
+            if (!m_compiled.isFireable(trans))
+                continue;
+
+            size_t const tokens = m_compiled.countBurnableTokens(trans);
+            if (tokens == 0u)
+                continue;
+
+            fireTransition(trans, tokens);
+            firings += tokens;
+            if (rounds)
+                m_fired.push_back(trans);
+            else
+                policy.push(trans);
+        }
+        std::swap(m_group, m_fired);
+    }
+
+    return firings;
+}
+
+//------------------------------------------------------------------------------
+void TimedSimulator::fireTransition(size_t const transition, size_t const count)
+{
+    // Transition source: fires again once its tokens have arrived.
+    if (m_compiled.kind(transition) == CompiledNet::Kind::Input)
+    {
+        m_compiled.receptivity(transition, false);
+    }
+    else
+    {
+        // Burn tokens on each predecessor Places
+        m_compiled.consume(transition, count);
+
+        // In Petri nets the user has to click again on the transition.
+        if ((m_type == TypeOfNet::PetriNet) &&
+            (m_compiled.prePlaces(transition).size() != 0u))
+        {
+            m_compiled.receptivity(transition, false);
+        }
+    }
+
+    m_policy.pointer->fired(transition);
+    for (auto it: m_observers)
+    {
+        it->onFired(m_time, transition, count);
+    }
+
+    // Count the number of tokens carried by arcs
+    size_t const offset = m_compiled.postOffset(transition);
+    size_t const arcs = m_compiled.postPlaces(transition).size();
+    for (size_t i = offset; i < offset + arcs; ++i)
+    {
+        if (m_carried_tokens[i] == 0u)
+        {
+            m_carrying_arcs.push_back(i);
+        }
+        m_carried_tokens[i] = m_compiled.addTokens(m_carried_tokens[i], count,
+                                                   m_compiled.postWeight(i));
+    }
+}
+
+//------------------------------------------------------------------------------
+size_t TimedSimulator::fireRounds()
+{
+    // Source transitions, and transitions of Petri nets, fire once then lose
+    // their receptivity: rounds cannot be repeated.
+    if (m_type == TypeOfNet::PetriNet)
+        return 0u;
+
+    // Fireable candidates and the number of tokens they need from each place
+    // for firing once.
+    m_fired.clear();
+    for (auto const trans: m_group)
+    {
+        if ((m_compiled.kind(trans) == CompiledNet::Kind::Input) ||
+            (!m_compiled.isFireable(trans)))
+            continue;
+
+        m_fired.push_back(trans);
+        auto const places = m_compiled.prePlaces(trans);
+        auto const weights = m_compiled.preWeights(trans);
+        for (size_t k = 0u; k < places.size(); ++k)
+        {
+            if (m_demands[places[k]] == 0u)
+            {
+                m_demanded_places.push_back(places[k]);
+            }
+            m_demands[places[k]] += weights[k];
+        }
+    }
+
+    // Number of rounds where every place can feed all of them: each one fires
+    // once per round whatever the order.
+    size_t rounds = m_fired.empty() ? 0u : static_cast<size_t>(-1);
+    for (auto const p: m_demanded_places)
+    {
+        rounds = std::min(rounds, m_compiled.tokens(p) / m_demands[p]);
+        m_demands[p] = 0u;
+    }
+    m_demanded_places.clear();
+    if (rounds == 0u)
+        return 0u;
+
+    for (auto const trans: m_fired)
+    {
+        fireTransition(trans, rounds);
+    }
+    return rounds * m_fired.size();
+}
+
+//------------------------------------------------------------------------------
+void TimedSimulator::arrive()
+{
+    assert(waiting());
+
+    // Deposit all tokens arriving at the same time. In places with a holding
+    // time, they are held until available, after the ones already held.
+    m_time = nextTime();
+    while ((!m_events.empty()) && (m_events.front().time == m_time))
+    {
+        std::pop_heap(m_events.begin(), m_events.end(), later);
+        Event const event = m_events.back();
+        m_events.pop_back();
+
+        size_t const place = m_compiled.postPlace(event.offset);
+        if ((m_holdings[place] > 0.0f) || (!m_queues[place].empty()))
+        {
+            hold(place, m_time + double(m_holdings[place]), event.tokens);
+        }
+        else
+        {
+            m_compiled.deposit(place, event.tokens);
+        }
+
+        // Transition source. In Petri net we keep using the mouse to fire
+        // source transition to generate a single token by mouse click while in
+        // other mode the transition fires once the tokens have arrived.
+        size_t const trans = m_sources[event.offset];
+        if ((m_type != TypeOfNet::PetriNet) &&
+            (m_compiled.kind(trans) == CompiledNet::Kind::Input))
+        {
+            m_compiled.receptivity(trans, true);
+        }
+
+        for (auto it: m_observers)
+        {
+            it->onArrived(m_time, m_compiled.postArc(event.offset), place, event.tokens);
+        }
+    }
+
+    // Held tokens becoming available.
+    while ((!m_releases.empty()) && (m_releases.front().time == m_time))
+    {
+        std::pop_heap(m_releases.begin(), m_releases.end(), std::greater<Release>());
+        TokenQueue& queue = m_queues[m_releases.back().place];
+        m_compiled.deposit(m_releases.back().place, queue.front().tokens);
+        queue.pop();
+        m_releases.pop_back();
+    }
+}
+
+//------------------------------------------------------------------------------
+void TimedSimulator::hold(size_t const place, double const time, size_t const tokens)
+{
+    // Tokens held until the same time share the run, and its release.
+    TokenQueue& queue = m_queues[place];
+    size_t const runs = queue.size();
+    queue.push(time, tokens);
+    if (queue.size() != runs)
+    {
+        m_releases.push_back({ queue.back().time, CompiledNet::Index(place) });
+        std::push_heap(m_releases.begin(), m_releases.end(), std::greater<Release>());
+    }
+}
+
+//------------------------------------------------------------------------------
+bool TimedSimulator::step()
+{
+    fire();
+    if (!waiting())
+        return false;
+
+    arrive();
+    return true;
+}
+
+//------------------------------------------------------------------------------
+size_t TimedSimulator::runUntil(double const time)
+{
+    return runUntil(time, static_cast<size_t>(-1),
+                    std::chrono::steady_clock::time_point::max());
+}
+
+//------------------------------------------------------------------------------
+size_t TimedSimulator::runUntil(double const time, size_t const firings,
+                                std::chrono::steady_clock::time_point const deadline)
+{
+    size_t const start = m_firings;
+
+    fire();
+    for (size_t n = 1u; m_firings - start < firings; ++n)
+    {
+        if ((!waiting()) || (nextTime() > time))
+        {
+            m_time = std::max(m_time, time);
+            break;
+        }
+
+        // Reading the clock costs more than processing a few instants.
+        if ((n % 16u == 0u) && (std::chrono::steady_clock::now() >= deadline))
+            break;
+
+        arrive();
+        fire();
+    }
+
+    return m_firings - start;
+}
+
+} // namespace tpne
@@ -20,65 +20,151 @@
 
 #include "TimedPetriNetEditor/PetriNet.hpp"
 #include "Net/TimedTokens.hpp"
-#include "Utils/Utils.hpp"
 
 namespace tpne {
 
 //------------------------------------------------------------------------------
-TimedToken::TimedToken(Arc& arc_,size_t const tokens_, TypeOfNet const type_)
-    : arc(&arc_), x(arc_.from.x), y(arc_.from.y), tokens(tokens_), type(type_)
+//! \brief Node where tokens are shown arriving. With graph event we have to
+//! skip implicit places.
+static Node const& destination(Arc const& arc, TypeOfNet const type)
 {
-    assert(arc->from.type == Node::Type::Transition);
-    assert(arc->to.type == Node::Type::Place);
-
-    // Note: we are supposing the norm and duration is never updated by
-    // the user during the simulation.
     if (type != TypeOfNet::TimedEventGraph)
-    {
-        magnitude = norm(arc->from, arc->to);
-    }
-    else
-    {
-        // With graph event we have to skip implicit places.
-        assert(arc->to.arcsOut.size() == 1u && "malformed graph event");
-        Node& next = arc->to.arcsOut[0]->to;
-        magnitude = norm(arc->from, next);
-    }
+        return arc.to;
+
+    assert(arc.to.arcsOut.size() == 1u && "malformed graph event");
+    return arc.to.arcsOut[0]->to;
+}
 
-    // Set the token animation speed. Depending on the type of Petri net,
-    // and for pure entertainment reason, override the arc duration to
-    // avoid unpleasant instaneous transitions (teleportation effect).
-    switch (type_)
+//------------------------------------------------------------------------------
+//! \brief Duration of the animation of tokens along the arc. Depending on the
+//! type of Petri net, and for pure entertainment reason, override the arc
+//! duration to avoid unpleasant instaneous transitions (teleportation effect).
+static float animationDuration(Arc const& arc, TypeOfNet const type)
+{
+    switch (type)
     {
     case TypeOfNet::TimedPetriNet:
     case TypeOfNet::TimedEventGraph:
-        speed = magnitude / std::max(0.000001f, arc->duration);
-        break;
+        return std::max(0.000001f, arc.duration);
         // In theory duration is 0 but nicer for the user to see animation.
     case TypeOfNet::PetriNet:
-        speed = magnitude / 0.2f;
-        break;
+        return 0.2f;
         // In theory duration is 0 but nicer for the user to see animation.
     case TypeOfNet::GRAFCET:
-        speed = magnitude / 1.5f;
-        break;
+        return 1.5f;
     default:
         assert(false && "Unknown type of net");
-        break;
+        return 1.0f;
+    }
+}
+
+//------------------------------------------------------------------------------
+void TimedTokens::spawn(Arc const& arc, size_t const tokens, TypeOfNet const type,
+                        float const offset)
+{
+    Node const& next = destination(arc, type);
+    float const dx = next.x - arc.from.x;
+    float const dy = next.y - arc.from.y;
+
+    m_arcs.push_back(&arc);
+    m_tokens.push_back(tokens);
+    m_offsets.push_back(offset);
+    m_rates.push_back(1.0f / animationDuration(arc, type));
+    m_from_x.push_back(arc.from.x);
+    m_from_y.push_back(arc.from.y);
+    m_dx.push_back(dx);
+    m_dy.push_back(dy);
+    m_x.push_back(arc.from.x + dx * std::min(offset, 1.0f));
+    m_y.push_back(arc.from.y + dy * std::min(offset, 1.0f));
+}
+
+//------------------------------------------------------------------------------
+void TimedTokens::updateAll(float const dt)
+{
+    size_t const count = size();
+    float* offsets = m_offsets.data();
+    float const* rates = m_rates.data();
+    float const* from_x = m_from_x.data();
+    float const* from_y = m_from_y.data();
+    float const* dx = m_dx.data();
+    float const* dy = m_dy.data();
+    float* x = m_x.data();
+    float* y = m_y.data();
+
+    // Branchless loop over contiguous arrays.
+    for (size_t i = 0u; i < count; ++i)
+    {
+        offsets[i] += dt * rates[i];
+        float const ratio = std::min(offsets[i], 1.0f);
+        x[i] = from_x[i] + dx[i] * ratio;
+        y[i] = from_y[i] + dy[i] * ratio;
+    }
+}
+
+//------------------------------------------------------------------------------
+size_t TimedTokens::compact()
+{
+    size_t const count = size();
+    size_t kept = 0u;
+    for (size_t i = 0u; i < count; ++i)
+    {
+        if (m_offsets[i] >= 1.0f)
+            continue;
+
+        m_arcs[kept] = m_arcs[i];
+        m_tokens[kept] = m_tokens[i];
+        m_offsets[kept] = m_offsets[i];
+        m_rates[kept] = m_rates[i];
+        m_from_x[kept] = m_from_x[i];
+        m_from_y[kept] = m_from_y[i];
+        m_dx[kept] = m_dx[i];
+        m_dy[kept] = m_dy[i];
+        m_x[kept] = m_x[i];
+        m_y[kept] = m_y[i];
+        ++kept;
     }
+
+    m_arcs.resize(kept);
+    m_tokens.resize(kept);
+    m_offsets.resize(kept);
+    m_rates.resize(kept);
+    m_from_x.resize(kept);
+    m_from_y.resize(kept);
+    m_dx.resize(kept);
+    m_dy.resize(kept);
+    m_x.resize(kept);
+    m_y.resize(kept);
+    return count - kept;
 }
 
 //------------------------------------------------------------------------------
-bool TimedToken::update(float const dt)
+void TimedTokens::clear()
 {
-    // With graph event we have to skip implicit places.
-    Node& next = (type != TypeOfNet::TimedEventGraph)
-                ? arc->to : arc->to.arcsOut[0]->to;
+    m_arcs.clear();
+    m_tokens.clear();
+    m_offsets.clear();
+    m_rates.clear();
+    m_from_x.clear();
+    m_from_y.clear();
+    m_dx.clear();
+    m_dy.clear();
+    m_x.clear();
+    m_y.clear();
+}
 
-    offset += dt * speed / magnitude;
-    x = arc->from.x + (next.x - arc->from.x) * offset;
-    y = arc->from.y + (next.y - arc->from.y) * offset;
-    return (offset >= 1.0);
+//------------------------------------------------------------------------------
+void TimedTokens::reserve(size_t const count)
+{
+    m_arcs.reserve(count);
+    m_tokens.reserve(count);
+    m_offsets.reserve(count);
+    m_rates.reserve(count);
+    m_from_x.reserve(count);
+    m_from_y.reserve(count);
+    m_dx.reserve(count);
+    m_dy.reserve(count);
+    m_x.reserve(count);
+    m_y.reserve(count);
 }
 
 } // namespace tpne
\ No newline at end of file
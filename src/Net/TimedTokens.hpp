@@ -21,10 +21,12 @@
 #ifndef TIMED_TOKENS_HPP
 #  define TIMED_TOKENS_HPP
 
+#  include <vector>
+#  include <cstddef>
+
 namespace tpne {
 
 class Arc;
-class Place;
 enum class TypeOfNet;
 
 // *****************************************************************************
@@ -35,86 +37,75 @@ enum class TypeOfNet;
 //! showing many tokens (dots) at the same position, we "group" them as a dot
 //! with the number of tokens carried as caption. Since we are working on timed
 //! petri nets arcs have a duration which is also constrain their velocity.
+//!
+//! Tokens in flight are stored as a structure of arrays, for animating
+//! thousands of them. Coordinates of the origin and destination nodes are
+//! cached at spawn() so that updateAll() only reads contiguous floats and can
+//! be vectorized. Arrived tokens are not removed by updateAll()
+//! but by the separate compact() pass.
 // *****************************************************************************
-struct TimedToken
+class TimedTokens
 {
-    //--------------------------------------------------------------------------
-    //! \brief Constructor.
-    //! \param[in] arc_: to which arc token are moving along. Shall be an arc
-    //! Transition -> Place. No check is performed here.
-    //! \param[in] tokens_: the number of tokens it shall carry.
-    //! \param[in] type_: Type of the net (Petri, timed Petri, GRAFCET ...)
-    //--------------------------------------------------------------------------
-    TimedToken(Arc& arc_, size_t const tokens_, TypeOfNet const type_);
-#if 0
-    //--------------------------------------------------------------------------
-    //! \brief Hack needed because of references
-    //--------------------------------------------------------------------------
-    TimedToken& operator=(TimedToken const& other)
-    {
-        this->~TimedToken(); // destroy
-        new (this) TimedToken(other); // copy construct in place
-        return *this;
-    }
+public:
 
     //--------------------------------------------------------------------------
-    //! \brief Needed to remove compilation warnings
+    //! \brief Add tokens moving along the given arc.
+    //! \param[in] arc: arc Transition -> Place. No check is performed here.
+    //! \param[in] tokens: the number of tokens it shall carry.
+    //! \param[in] type: Type of the net (Petri, timed Petri, GRAFCET ...)
+    //! \param[in] offset: ratio of the arc already transitioned.
     //--------------------------------------------------------------------------
-    TimedToken(TimedToken const& other)
-        : TimedToken(other.arc, other.tokens, other.type)
-    {}
+    void spawn(Arc const& arc, size_t const tokens, TypeOfNet const type,
+               float const offset = 0.0f);
 
     //--------------------------------------------------------------------------
-    //! \brief Needed to remove compilation warnings
+    //! \brief Move all tokens along their arc. Tokens stop at the destination.
+    //! \param[in] dt: the delta time (in seconds) from the previous call.
     //--------------------------------------------------------------------------
-    TimedToken(TimedToken&& other)
-        : TimedToken(other.arc, other.tokens, other.type)
-    {}
+    void updateAll(float const dt);
 
     //--------------------------------------------------------------------------
-    //! \brief Needed to remove compilation warnings
+    //! \brief Remove tokens having arrived to their destination. The order of
+    //! the remaining tokens is not kept.
+    //! \return the number of removed tokens.
     //--------------------------------------------------------------------------
-    TimedToken& operator=(TimedToken&& other)
-    {
-        this->~TimedToken(); // destroy
-        new (this) TimedToken(other); // copy construct in place
-        return *this;
-    }
-#endif
+    size_t compact();
+
     //--------------------------------------------------------------------------
-    //! \brief Update position on the screen.
-    //! \param[in] dt: the delta time (in seconds) from the previous call.
-    //! \return true when arriving to the destination node (Place) else false.
+    //! \brief Remove all tokens. The memory is kept for the next spawns.
     //--------------------------------------------------------------------------
-    bool update(float const dt);
+    void clear();
+    void reserve(size_t const count);
+    inline size_t size() const { return m_arcs.size(); }
+    inline bool empty() const { return m_arcs.empty(); }
 
     //--------------------------------------------------------------------------
-    //! \brief Return the reference of the destination node casted as a Place.
-    //! \note Since Tokens are animated from Transition to Places there is no
-    //! confusion possible in the type of destination node.
+    //! \brief Accessors of the i-th token.
     //--------------------------------------------------------------------------
-    inline Place& toPlace()
-    {
-        return *reinterpret_cast<Place*>(&(arc->to));
-    }
+    inline Arc const& arc(size_t const i) const { return *m_arcs[i]; }
+    inline size_t tokens(size_t const i) const { return m_tokens[i]; }
+    inline float offset(size_t const i) const { return m_offsets[i]; }
+    inline float x(size_t const i) const { return m_x[i]; }
+    inline float y(size_t const i) const { return m_y[i]; }
+
+private:
 
-    //! \brief In which arc the token is moving along.
-    Arc* arc;
-    //! \brief X-axis coordinate in the window used for the display.
-    float x;
-    //! \brief Y-axis coordinate in the window used for the display.
-    float y;
+    //! \brief In which arc tokens are moving along.
+    std::vector<Arc const*> m_arcs;
     //! \brief Number of carried tokens.
-    size_t tokens;
-    //! \brief
-    TypeOfNet type;
-    //! \brief The length of the arc.
-    float magnitude;
-    //! \brief The speed of the token moving along the arc.
-    float speed;
-    //! \brief What ratio the token has transitioned over the arc (0%: origin
-    //! position, 100%: destination position).
-    float offset = 0.0f;
+    std::vector<size_t> m_tokens;
+    //! \brief Ratio of the arc transitioned (0: origin, 1: destination).
+    std::vector<float> m_offsets;
+    //! \brief Ratio of the arc transitioned per second.
+    std::vector<float> m_rates;
+    //! \brief Origin position and displacement to the destination.
+    std::vector<float> m_from_x;
+    std::vector<float> m_from_y;
+    std::vector<float> m_dx;
+    std::vector<float> m_dy;
+    //! \brief Current position in the window used for the display.
+    std::vector<float> m_x;
+    std::vector<float> m_y;
 };
 
 } // namespace tpne
@@ -0,0 +1,172 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "TimedPetriNetEditor/Timeline.hpp"
+
+namespace tpne {
+
+//------------------------------------------------------------------------------
+Timeline::Timeline(size_t const keyframes)
+    : m_keyframes(std::max(size_t(1u), keyframes))
+{}
+
+//------------------------------------------------------------------------------
+void Timeline::clear()
+{
+    m_snapshots.clear();
+    m_places = m_transitions = 0u;
+}
+
+//------------------------------------------------------------------------------
+void Timeline::take(TimedSimulator const& simulator)
+{
+    // Going back in time: the future is replaced by a new branch.
+    size_t const count = m_snapshots.size();
+    while ((!m_snapshots.empty()) && (m_snapshots.back().time >= simulator.time()))
+    {
+        m_snapshots.pop_back();
+    }
+    if ((m_snapshots.size() != count) && (!m_snapshots.empty()))
+    {
+        restore(m_snapshots.size() - 1u, m_latest);
+    }
+
+    m_places = simulator.compiled().places();
+    m_transitions = simulator.compiled().transitions();
+    m_clusters = simulator.compiled().clusters();
+    simulator.save(m_current);
+
+    // Key frames are compared to an empty marking.
+    bool const keyframe = (m_snapshots.size() % m_keyframes == 0u);
+    if (keyframe)
+    {
+        m_latest.tokens.assign(m_places, 0u);
+        m_latest.receptivities.assign(m_transitions, 0u);
+        m_latest.random.assign(m_clusters, 0u);
+    }
+
+    Snapshot snapshot;
+    snapshot.time = m_current.time;
+    snapshot.sequence = m_current.sequence;
+    snapshot.firings = m_current.firings;
+    snapshot.policy = m_current.policy;
+    for (size_t p = 0u; p < m_places; ++p)
+    {
+        if (m_current.tokens[p] != m_latest.tokens[p])
+        {
+            snapshot.tokens.emplace_back(CompiledNet::Index(p), m_current.tokens[p]);
+        }
+    }
+    for (size_t t = 0u; t < m_transitions; ++t)
+    {
+        if (m_current.receptivities[t] != m_latest.receptivities[t])
+        {
+            snapshot.receptivities.push_back(CompiledNet::Index(t));
+        }
+    }
+    for (size_t c = 0u; c < m_clusters; ++c)
+    {
+        if (m_current.random[c] != m_latest.random[c])
+        {
+            snapshot.random.emplace_back(CompiledNet::Index(c), m_current.random[c]);
+        }
+    }
+    snapshot.candidates = m_current.candidates;
+    snapshot.events = m_current.events;
+    snapshot.held = m_current.held;
+    m_snapshots.push_back(std::move(snapshot));
+
+    std::swap(m_latest, m_current);
+}
+
+//------------------------------------------------------------------------------
+void Timeline::restore(size_t const index, TimedSimulator::Checkpoint& checkpoint) const
+{
+    assert(index < m_snapshots.size());
+
+    // Replay deltas from the previous key frame.
+    checkpoint.tokens.assign(m_places, 0u);
+    checkpoint.receptivities.assign(m_transitions, 0u);
+    checkpoint.random.assign(m_clusters, 0u);
+    for (size_t i = index - index % m_keyframes; i <= index; ++i)
+    {
+        for (auto const& it: m_snapshots[i].tokens)
+        {
+            checkpoint.tokens[it.first] = it.second;
+        }
+        for (auto const t: m_snapshots[i].receptivities)
+        {
+            checkpoint.receptivities[t] ^= 1u;
+        }
+        for (auto const& it: m_snapshots[i].random)
+        {
+            checkpoint.random[it.first] = it.second;
+        }
+    }
+
+    Snapshot const& snapshot = m_snapshots[index];
+    checkpoint.time = snapshot.time;
+    checkpoint.sequence = snapshot.sequence;
+    checkpoint.firings = snapshot.firings;
+    checkpoint.policy = snapshot.policy;
+    checkpoint.candidates = snapshot.candidates;
+    checkpoint.events = snapshot.events;
+    checkpoint.held = snapshot.held;
+}
+
+//------------------------------------------------------------------------------
+size_t Timeline::find(double const time) const
+{
+    auto it = std::upper_bound(m_snapshots.begin(), m_snapshots.end(), time,
+                               [](double const t, Snapshot const& snapshot)
+                               {
+                                   return t < snapshot.time;
+                               });
+    if (it == m_snapshots.begin())
+        return m_snapshots.size();
+    return size_t(it - m_snapshots.begin()) - 1u;
+}
+
+//------------------------------------------------------------------------------
+bool Timeline::rewind(TimedSimulator& simulator, double const time) const
+{
+    size_t const index = find(time);
+    if (index == m_snapshots.size())
+        return false;
+
+    TimedSimulator::Checkpoint checkpoint;
+    restore(index, checkpoint);
+    simulator.restore(checkpoint);
+
+    // Replay without notifying the observers a second time.
+    std::vector<TimedSimulator::Observer*> const observers = simulator.observers();
+    for (auto it: observers)
+    {
+        simulator.removeObserver(*it);
+    }
+    simulator.runUntil(time);
+    for (auto it: observers)
+    {
+        simulator.addObserver(*it);
+    }
+    return true;
+}
+
+} // namespace tpne
@@ -0,0 +1,87 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "TimedPetriNetEditor/TokenQueue.hpp"
+
+namespace tpne {
+
+//------------------------------------------------------------------------------
+void TokenQueue::push(double time, size_t tokens)
+{
+    if (tokens == 0u)
+        return ;
+
+    // Same availability time: merge with the latest run, as much as it can
+    // hold.
+    if ((m_size != 0u) && (time <= back().time))
+    {
+        Run& run = m_runs[(m_head + m_size - 1u) & (m_runs.size() - 1u)];
+        size_t const merged = std::min(tokens, CompiledNet::maxCount() - run.tokens);
+        run.tokens = CompiledNet::Count(run.tokens + merged);
+        m_tokens += merged;
+        tokens -= merged;
+        time = run.time;
+    }
+
+    // Remaining tokens go into new runs.
+    while (tokens != 0u)
+    {
+        size_t const count = std::min(tokens, CompiledNet::maxCount());
+        pushRun(time, count);
+        tokens -= count;
+    }
+}
+
+//------------------------------------------------------------------------------
+void TokenQueue::pushRun(double const time, size_t const count)
+{
+    // Full: unroll the ring buffer into a buffer twice bigger.
+    if (m_size == m_runs.size())
+    {
+        std::vector<Run> runs(std::max(size_t(4u), 2u * m_runs.size()));
+        for (size_t i = 0u; i < m_size; ++i)
+        {
+            runs[i] = (*this)[i];
+        }
+        m_runs.swap(runs);
+        m_head = 0u;
+    }
+
+    m_runs[(m_head + m_size) & (m_runs.size() - 1u)] = { time, CompiledNet::Count(count) };
+    m_tokens += count;
+    ++m_size;
+}
+
+//------------------------------------------------------------------------------
+void TokenQueue::pop()
+{
+    assert(m_size != 0u);
+    m_tokens -= front().tokens;
+    m_head = (m_head + 1u) & (m_runs.size() - 1u);
+    --m_size;
+}
+
+//------------------------------------------------------------------------------
+void TokenQueue::clear()
+{
+    m_head = m_size = m_tokens = 0u;
+}
+
+} // namespace tpne
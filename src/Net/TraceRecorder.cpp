@@ -0,0 +1,318 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "TimedPetriNetEditor/TraceRecorder.hpp"
+#include <fstream>
+#include <cstring>
+#include <ctime>
+
+namespace tpne {
+
+static char const TRACE_MAGIC[8] = { 'T', 'P', 'N', 'T', 'R', 'A', 'C', 'E' };
+static uint32_t const TRACE_VERSION = 1u;
+constexpr uint32_t TraceRecord::None;
+
+//------------------------------------------------------------------------------
+//! \brief Write the wall-clock time in the given buffer. Reentrant: called
+//! from both the GUI thread and the simulation thread.
+static const char* current_time(char (&buffer)[32])
+{
+    time_t const current_time = ::time(nullptr);
+    struct tm local;
+#if defined(_WIN32)
+    localtime_s(&local, &current_time);
+#else
+    localtime_r(&current_time, &local);
+#endif
+    strftime(buffer, sizeof (buffer), "[%H:%M:%S] ", &local);
+    return buffer;
+}
+
+//------------------------------------------------------------------------------
+static uint32_t saturate(size_t const value)
+{
+    return uint32_t(std::min(value, size_t(TraceRecord::None - 1u)));
+}
+
+//------------------------------------------------------------------------------
+TraceRecorder::TraceRecorder(size_t const capacity)
+{
+    size_t size = 1u;
+    while (size < capacity)
+        size <<= 1u;
+    m_buffer.resize(size);
+    m_mask = size - 1u;
+}
+
+//------------------------------------------------------------------------------
+TraceRecorder::~TraceRecorder()
+{
+    close();
+}
+
+//------------------------------------------------------------------------------
+std::string TraceRecorder::open(std::string const& filename)
+{
+    close();
+
+    m_file = fopen(filename.c_str(), "wb");
+    if (m_file == nullptr)
+    {
+        return "Failed creating the trace file '" + filename + "'. Reason was '"
+               + strerror(errno) + "'";
+    }
+
+    uint32_t const header[2] = { TRACE_VERSION, uint32_t(sizeof(TraceRecord)) };
+    fwrite(TRACE_MAGIC, sizeof(TRACE_MAGIC), 1u, m_file);
+    fwrite(header, sizeof(header), 1u, m_file);
+
+    m_head.store(0u, std::memory_order_relaxed);
+    m_tail.store(0u, std::memory_order_relaxed);
+    m_dropped.store(0u, std::memory_order_relaxed);
+    m_running.store(true, std::memory_order_release);
+    m_writer = std::thread(&TraceRecorder::write, this);
+    return {};
+}
+
+//------------------------------------------------------------------------------
+void TraceRecorder::close()
+{
+    if (m_file == nullptr)
+        return ;
+
+    m_running.store(false, std::memory_order_release);
+    m_writer.join();
+    fclose(m_file);
+    m_file = nullptr;
+}
+
+//------------------------------------------------------------------------------
+void TraceRecorder::record(TraceRecord const& record)
+{
+    if (m_file == nullptr)
+        return ;
+
+    size_t const head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) == m_buffer.size())
+    {
+        m_dropped.fetch_add(1u, std::memory_order_relaxed);
+        return ;
+    }
+    m_buffer[head & m_mask] = record;
+    m_head.store(head + 1u, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+void TraceRecorder::started()
+{
+    record({ 0.0, 0u, TraceRecord::None, TraceRecord::None, TraceRecord::Started });
+}
+
+//------------------------------------------------------------------------------
+void TraceRecorder::onFired(double const time, size_t const transition,
+                            size_t const count)
+{
+    record({ time, saturate(count), uint32_t(transition), TraceRecord::None,
+             TraceRecord::Fired });
+}
+
+//------------------------------------------------------------------------------
+void TraceRecorder::onDeparted(double const time, size_t const arc,
+                               size_t const tokens, double const /*arrival*/)
+{
+    record({ time, saturate(tokens), TraceRecord::None, uint32_t(arc),
+             TraceRecord::Departed });
+}
+
+//------------------------------------------------------------------------------
+void TraceRecorder::onArrived(double const time, size_t const arc,
+                              size_t const place, size_t const tokens)
+{
+    record({ time, saturate(tokens), uint32_t(place), uint32_t(arc),
+             TraceRecord::Arrived });
+}
+
+//------------------------------------------------------------------------------
+size_t TraceRecorder::flush()
+{
+    size_t const tail = m_tail.load(std::memory_order_relaxed);
+    size_t const head = m_head.load(std::memory_order_acquire);
+    if (head == tail)
+        return 0u;
+
+    // Write the contiguous slots until the end of the ring buffer: the
+    // remaining ones are written by the next call.
+    size_t const first = tail & m_mask;
+    size_t const count = std::min(head - tail, m_buffer.size() - first);
+    fwrite(&m_buffer[first], sizeof(TraceRecord), count, m_file);
+    m_tail.store(tail + count, std::memory_order_release);
+    return count;
+}
+
+//------------------------------------------------------------------------------
+void TraceRecorder::write()
+{
+    while (true)
+    {
+        // Read the flag before draining: records pushed before close() are
+        // written.
+        bool const stopping = !m_running.load(std::memory_order_acquire);
+        if ((flush() == 0u) && stopping)
+            break;
+
+        if (m_head.load(std::memory_order_acquire) ==
+            m_tail.load(std::memory_order_relaxed))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    fflush(m_file);
+}
+
+//------------------------------------------------------------------------------
+ConsoleTrace::ConsoleTrace(Net const& net, std::ostream& os)
+    : m_net(net), m_os(os)
+{}
+
+//------------------------------------------------------------------------------
+void ConsoleTrace::log(std::string const& message)
+{
+    char buffer[32];
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_os << current_time(buffer) << message << std::endl;
+}
+
+//------------------------------------------------------------------------------
+void ConsoleTrace::onDeparted(double const /*time*/, size_t const arc,
+                              size_t const tokens, double const /*arrival*/)
+{
+    char buffer[32];
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_os << current_time(buffer)
+         << "Transition " << m_net.arcs()[arc].from.caption() << " burnt "
+         << tokens << " token" << (tokens == 1u ? "" : "s") << '\n';
+}
+
+//------------------------------------------------------------------------------
+void ConsoleTrace::onArrived(double const /*time*/, size_t const arc,
+                             size_t const /*place*/, size_t const tokens)
+{
+    char buffer[32];
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_os << current_time(buffer)
+         << "Place " << m_net.arcs()[arc].to.caption() << " got "
+         << tokens << " token" << (tokens == 1u ? "" : "s") << '\n';
+}
+
+//------------------------------------------------------------------------------
+std::string readTrace(std::string const& filename, std::vector<TraceRecord>& records)
+{
+    records.clear();
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        return "Failed opening the trace file '" + filename + "'. Reason was '"
+               + strerror(errno) + "'";
+    }
+
+    char magic[sizeof(TRACE_MAGIC)];
+    uint32_t header[2];
+    if ((!file.read(magic, sizeof(magic))) ||
+        (!file.read(reinterpret_cast<char*>(header), sizeof(header))) ||
+        (memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0))
+    {
+        return "The file '" + filename + "' is not a trace file";
+    }
+    if ((header[0] != TRACE_VERSION) || (header[1] != sizeof(TraceRecord)))
+    {
+        return "The trace file '" + filename + "' has an unsupported version";
+    }
+
+    TraceRecord record;
+    while (file.read(reinterpret_cast<char*>(&record), sizeof(record)))
+    {
+        records.push_back(record);
+    }
+    if (file.gcount() != 0)
+    {
+        return "The trace file '" + filename + "' is truncated";
+    }
+    return {};
+}
+
+//------------------------------------------------------------------------------
+std::string decodeTrace(std::string const& filename, std::ostream& os,
+                        TraceFormat const format)
+{
+    static const char* names[] = { "started", "fired", "departed", "arrived" };
+
+    std::vector<TraceRecord> records;
+    std::string error = readTrace(filename, records);
+    if (!error.empty())
+        return error;
+
+    if (format == TraceFormat::CSV)
+    {
+        os << "time,type,node,arc,tokens\n";
+    }
+    for (auto const& it: records)
+    {
+        if (it.type > TraceRecord::Arrived)
+        {
+            return "The trace file '" + filename + "' has an unknown record";
+        }
+
+        if (format == TraceFormat::CSV)
+        {
+            os << it.time << ',' << names[it.type] << ',';
+            if (it.node != TraceRecord::None) { os << it.node; }
+            os << ',';
+            if (it.arc != TraceRecord::None) { os << it.arc; }
+            os << ',' << it.tokens << '\n';
+            continue;
+        }
+
+        os << '[' << it.time << "] ";
+        switch (it.type)
+        {
+        case TraceRecord::Started:
+            os << "Simulation has started!";
+            break;
+        case TraceRecord::Fired:
+            os << "Transition T" << it.node << " fired " << it.tokens
+               << " time" << (it.tokens == 1u ? "" : "s");
+            break;
+        case TraceRecord::Departed:
+            os << "Arc " << it.arc << " carries " << it.tokens
+               << " token" << (it.tokens == 1u ? "" : "s");
+            break;
+        default:
+            os << "Place P" << it.node << " got " << it.tokens
+               << " token" << (it.tokens == 1u ? "" : "s")
+               << " from arc " << it.arc;
+            break;
+        }
+        os << '\n';
+    }
+    return {};
+}
+
+} // namespace tpne
@@ -55,7 +55,7 @@ void ForceDirected::reset(float width, float height, Net& net)
     std::map<std::string, size_t> lookup;
     for (size_t n = 0u; n < N; ++n)
     {
-        lookup[m_vertices[n].node->key] = n;
+        lookup[m_vertices[n].node->key()] = n;
     }
 
     // Add edges "source node" -> "destination node".
@@ -67,14 +67,14 @@ void ForceDirected::reset(float width, float height, Net& net)
 
         for (auto& it: v.node->arcsIn)
         {
-            v.neighbors.emplace_back(m_vertices[lookup[it->from.key]].node);
-            v.neighbors.emplace_back(m_vertices[lookup[it->to.key]].node);
+            v.neighbors.emplace_back(m_vertices[lookup[it->from.key()]].node);
+            v.neighbors.emplace_back(m_vertices[lookup[it->to.key()]].node);
         }
 
         for (auto& it: v.node->arcsOut)
         {
-            v.neighbors.emplace_back(m_vertices[lookup[it->from.key]].node);
-            v.neighbors.emplace_back(m_vertices[lookup[it->to.key]].node);
+            v.neighbors.emplace_back(m_vertices[lookup[it->from.key()]].node);
+            v.neighbors.emplace_back(m_vertices[lookup[it->to.key()]].node);
         }
     }
 }
@@ -104,7 +104,7 @@ void ForceDirected::step()
         // Repulsive forces: nodes -- nodes
         for (auto& u: m_vertices)
         {
-            if (u.node->key == v.node->key)
+            if (u.node->key() == v.node->key())
                 continue ;
 
             const ImVec2 u_position(u.node->x, u.node->y);
@@ -117,7 +117,7 @@ void ForceDirected::step()
         // Attractive forces: edges
         for (auto& u: v.neighbors)
         {
-            if (u->key == v.node->key)
+            if (u->key() == v.node->key())
                 continue ;
 
             const ImVec2 u_position(u->x, u->y);
@@ -0,0 +1,98 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef PETRIEDITOR_SPSC_QUEUE_HPP
+#  define PETRIEDITOR_SPSC_QUEUE_HPP
+
+#  include <atomic>
+#  include <utility>
+
+namespace tpne {
+
+// ****************************************************************************
+//! \brief Unbounded lock-free queue between a single producer thread and a
+//! single consumer thread. Values are stored in a linked list whose head is a
+//! dummy node owned by the consumer: the producer only touches the tail, so
+//! neither of them ever waits for the other.
+// ****************************************************************************
+template<class T>
+class SpscQueue
+{
+public:
+
+    SpscQueue() : m_head(new Node), m_tail(m_head) {}
+    SpscQueue(SpscQueue const&) = delete;
+    SpscQueue& operator=(SpscQueue const&) = delete;
+
+    ~SpscQueue()
+    {
+        while (m_head != nullptr)
+        {
+            Node* next = m_head->next.load(std::memory_order_relaxed);
+            delete m_head;
+            m_head = next;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //! \brief Producer: append a value.
+    //-------------------------------------------------------------------------
+    inline void push(T&& value)
+    {
+        Node* node = new Node;
+        node->value = std::move(value);
+        m_tail->next.store(node, std::memory_order_release);
+        m_tail = node;
+    }
+
+    //-------------------------------------------------------------------------
+    //! \brief Consumer: take the oldest value.
+    //! \return false if the queue is empty: the value is unchanged.
+    //-------------------------------------------------------------------------
+    inline bool pop(T& value)
+    {
+        Node* next = m_head->next.load(std::memory_order_acquire);
+        if (next == nullptr)
+            return false;
+
+        // The next node becomes the dummy one.
+        value = std::move(next->value);
+        delete m_head;
+        m_head = next;
+        return true;
+    }
+
+private:
+
+    struct Node
+    {
+        T value;
+        std::atomic<Node*> next{nullptr};
+    };
+
+    //! \brief Dummy node owned by the consumer.
+    Node* m_head;
+    //! \brief Latest node owned by the producer.
+    Node* m_tail;
+};
+
+} // namespace tpne
+
+#endif
@@ -0,0 +1,91 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#ifndef PETRIEDITOR_TRIPLE_BUFFER_HPP
+#  define PETRIEDITOR_TRIPLE_BUFFER_HPP
+
+#  include <atomic>
+#  include <cstdint>
+
+namespace tpne {
+
+// ****************************************************************************
+//! \brief Lock-free exchange of the latest value between a single producer
+//! thread and a single consumer thread. The producer fills the back slot then
+//! publishes it; the consumer takes the latest published slot as its front
+//! slot. None of them ever waits for the other: unread values are replaced by
+//! newer ones. Slots are reused, so their allocated memory is kept.
+// ****************************************************************************
+template<class T>
+class TripleBuffer
+{
+public:
+
+    //-------------------------------------------------------------------------
+    //! \brief Producer: slot to fill before calling publish().
+    //-------------------------------------------------------------------------
+    inline T& back() { return m_slots[m_back]; }
+
+    //-------------------------------------------------------------------------
+    //! \brief Producer: make the back slot the latest value. The back slot is
+    //! then an older slot to fill again.
+    //-------------------------------------------------------------------------
+    inline void publish()
+    {
+        m_back = m_middle.exchange(uint8_t(m_back | FRESH),
+                                   std::memory_order_acq_rel) & INDEX;
+    }
+
+    //-------------------------------------------------------------------------
+    //! \brief Consumer: take the latest published value as front slot.
+    //! \return false if no value has been published since the previous call:
+    //! the front slot is unchanged.
+    //-------------------------------------------------------------------------
+    inline bool update()
+    {
+        if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0u)
+            return false;
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    //! \brief Consumer: the value taken by the latest update().
+    //-------------------------------------------------------------------------
+    inline T const& front() const { return m_slots[m_front]; }
+
+private:
+
+    //! \brief Flag of the middle slot when not yet taken by the consumer.
+    static constexpr uint8_t FRESH = 4u;
+    static constexpr uint8_t INDEX = 3u;
+
+    T m_slots[3];
+    //! \brief Slot owned by the producer.
+    uint8_t m_back = 0u;
+    //! \brief Slot owned by the consumer.
+    uint8_t m_front = 1u;
+    //! \brief Slot exchanged between them, with the FRESH flag.
+    std::atomic<uint8_t> m_middle{2u};
+};
+
+} // namespace tpne
+
+#endif
@@ -262,8 +262,7 @@ bool petri_remove_place(int64_t const pn, int64_t const id)
     if ((id < 0) || (size_t(id) >= g_petri_nets[size_t(pn)]->places().size()))
         return false;
 
-    std::string strid = tpne::Place::to_str(size_t(id));
-    tpne::Node* node = g_petri_nets[size_t(pn)]->findNode(strid);
+    tpne::Node* node = g_petri_nets[size_t(pn)]->findPlace(size_t(id));
     if (node == nullptr)
         return false;
 
@@ -279,8 +278,7 @@ bool petri_remove_transition(int64_t const pn, int64_t const id)
     if ((id < 0) || (size_t(id) >= g_petri_nets[size_t(pn)]->transitions().size()))
         return false;
 
-    std::string strid = tpne::Transition::to_str(size_t(id));
-    tpne::Node* node = g_petri_nets[size_t(pn)]->findNode(strid);
+    tpne::Node* node = g_petri_nets[size_t(pn)]->findTransition(size_t(id));
     if (node == nullptr)
         return false;
 
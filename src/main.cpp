@@ -5,9 +5,14 @@
 static void usage(const char* name)
 {
     std::cout
-      << name << " [petri.json]" << std::endl
+      << name << " [-l] [-t trace.bin] [petri.json]" << std::endl
+      << name << " -d trace.bin | -c trace.bin" << std::endl
       << "Where:" << std::endl
       << "  [petri.json] is an optional Petri net file to load (i.e. examples/Howard1.json)" << std::endl
+      << "  -l logs events of simulations on the console" << std::endl
+      << "  -t records events of simulations into the binary trace file" << std::endl
+      << "  -d decodes the binary trace file into text on the console" << std::endl
+      << "  -c decodes the binary trace file into CSV on the console" << std::endl
       << std::endl;
 }
 
@@ -16,16 +21,36 @@ int main(int argc, char* argv[])
 {
     // Parse the command line
     std::string filename;
+    std::string trace;
+    bool logging = false;
     opterr = 0;
     int opt;
 
-    while ((opt = getopt(argc, argv, "h")) != -1)
+    while ((opt = getopt(argc, argv, "hlt:d:c:")) != -1)
     {
         switch (opt)
         {
             case 'h':
                 usage(argv[0]);
                 return EXIT_FAILURE;
+            case 'l':
+                logging = true;
+                break;
+            case 't':
+                trace = optarg;
+                break;
+            case 'd':
+            case 'c':
+            {
+                std::string error = tpne::decodeTrace(optarg, std::cout,
+                    (opt == 'd') ? tpne::TraceFormat::Text : tpne::TraceFormat::CSV);
+                if (!error.empty())
+                {
+                    std::cerr << error << std::endl;
+                    return EXIT_FAILURE;
+                }
+                return EXIT_SUCCESS;
+            }
             case '?':
                 std::cerr << "Unknown option: '" << char(optopt) << "'!" << std::endl;
                 usage(argv[0]);
@@ -40,6 +65,12 @@ int main(int argc, char* argv[])
     }
 
     tpne::Editor editor(1100, 768, "Petri Net Editor");
+    editor.simulation().console(logging);
+    if ((!trace.empty()) && (!editor.simulation().trace(trace)))
+    {
+        std::cerr << "Failed creating the trace file '" << trace << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
     editor.run(filename);
 
     return EXIT_SUCCESS;
@@ -0,0 +1,352 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "main.hpp"
+#define protected public
+#define private public
+#  include "TimedPetriNetEditor/PetriNet.hpp"
+#  include "TimedPetriNetEditor/CompiledNet.hpp"
+#  include "TimedPetriNetEditor/Algorithms.hpp"
+#  include "TimedPetriNetEditor/SparseMatrix.hpp"
+#  include "TimedPetriNetEditor/TropicalAlgebra.hpp"
+#undef protected
+#undef private
+
+using namespace ::tpne;
+
+//------------------------------------------------------------------------------
+TEST(TestCompiledNet, TestEmptyNet)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+    CompiledNet compiled(net);
+
+    ASSERT_EQ(compiled.places(), 0u);
+    ASSERT_EQ(compiled.transitions(), 0u);
+    ASSERT_EQ(compiled.arcs(), 0u);
+    ASSERT_EQ(compiled.postSize(), 0u);
+    ASSERT_EQ(compiled.tokens().empty(), true);
+    ASSERT_EQ(isEventGraph(compiled), false);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestCompiledNet, TestStructure)
+{
+    // T0 -> P0 -> T1 -> P1, P2 -> T2 and T3 isolated
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 2u);
+    Place& p1 = net.addPlace(0.0f, 0.0f, 0u);
+    Place& p2 = net.addPlace(0.0f, 0.0f, 1u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    Transition& t1 = net.addTransition(0.0f, 0.0f);
+    Transition& t2 = net.addTransition(0.0f, 0.0f);
+    net.addTransition(0.0f, 0.0f);
+    ASSERT_EQ(net.addArc(t0, p0, 1.0f), true);
+    ASSERT_EQ(net.addArc(p0, t1), true);
+    ASSERT_EQ(net.addArc(t1, p1, 2.0f), true);
+    ASSERT_EQ(net.addArc(t1, p2, 3.0f), true);
+    ASSERT_EQ(net.addArc(p2, t2), true);
+
+    CompiledNet compiled(net);
+    ASSERT_EQ(compiled.places(), 3u);
+    ASSERT_EQ(compiled.transitions(), 4u);
+    ASSERT_EQ(compiled.arcs(), 5u);
+    ASSERT_EQ(compiled.postSize(), 3u);
+    ASSERT_THAT(compiled.tokens(), ElementsAre(2u, 0u, 1u));
+
+    ASSERT_EQ(compiled.kind(0u), CompiledNet::Kind::Input);
+    ASSERT_EQ(compiled.kind(1u), CompiledNet::Kind::State);
+    ASSERT_EQ(compiled.kind(2u), CompiledNet::Kind::Output);
+    ASSERT_EQ(compiled.kind(3u), CompiledNet::Kind::Isolated);
+
+    // Transitions
+    ASSERT_EQ(compiled.prePlaces(0u).size(), 0u);
+    ASSERT_EQ(compiled.postPlaces(0u).size(), 1u);
+    ASSERT_EQ(compiled.postPlaces(0u)[0], 0u);
+    ASSERT_EQ(compiled.postArcs(0u)[0], 0u);
+    ASSERT_EQ(compiled.postDurations(0u)[0], 1.0f);
+    ASSERT_EQ(compiled.prePlaces(1u).size(), 1u);
+    ASSERT_EQ(compiled.prePlaces(1u)[0], 0u);
+    ASSERT_EQ(compiled.preArcs(1u)[0], 1u);
+    ASSERT_EQ(compiled.postPlaces(1u).size(), 2u);
+    ASSERT_EQ(compiled.postPlaces(1u)[0], 1u);
+    ASSERT_EQ(compiled.postPlaces(1u)[1], 2u);
+    ASSERT_EQ(compiled.postArcs(1u)[0], 2u);
+    ASSERT_EQ(compiled.postArcs(1u)[1], 3u);
+    ASSERT_EQ(compiled.postDurations(1u)[0], 2.0f);
+    ASSERT_EQ(compiled.postDurations(1u)[1], 3.0f);
+    ASSERT_EQ(compiled.postOffset(1u), 1u);
+    ASSERT_EQ(compiled.postArc(2u), 3u);
+    ASSERT_EQ(compiled.prePlaces(2u).size(), 1u);
+    ASSERT_EQ(compiled.prePlaces(2u)[0], 2u);
+    ASSERT_EQ(compiled.postPlaces(2u).size(), 0u);
+    ASSERT_EQ(compiled.prePlaces(3u).size(), 0u);
+    ASSERT_EQ(compiled.postPlaces(3u).size(), 0u);
+
+    // Places
+    ASSERT_EQ(compiled.inputTransitions(0u).size(), 1u);
+    ASSERT_EQ(compiled.inputTransitions(0u)[0], 0u);
+    ASSERT_EQ(compiled.inputDurations(0u)[0], 1.0f);
+    ASSERT_EQ(compiled.outputTransitions(0u).size(), 1u);
+    ASSERT_EQ(compiled.outputTransitions(0u)[0], 1u);
+    ASSERT_EQ(compiled.inputTransitions(1u).size(), 1u);
+    ASSERT_EQ(compiled.outputTransitions(1u).size(), 0u);
+    ASSERT_EQ(compiled.inputTransitions(2u)[0], 1u);
+    ASSERT_EQ(compiled.inputDurations(2u)[0], 3.0f);
+    ASSERT_EQ(compiled.outputTransitions(2u)[0], 2u);
+
+    ASSERT_EQ(isEventGraph(compiled), false);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestCompiledNet, TestFiring)
+{
+    // P0, P1 -> T0 -> P2
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 3u);
+    Place& p1 = net.addPlace(0.0f, 0.0f, 2u);
+    Place& p2 = net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    ASSERT_EQ(net.addArc(p0, t0), true);
+    ASSERT_EQ(net.addArc(p1, t0), true);
+    ASSERT_EQ(net.addArc(t0, p2), true);
+
+    CompiledNet compiled(net);
+    ASSERT_EQ(compiled.receptivity(0u), t0.receptivity);
+    ASSERT_EQ(compiled.isValidated(0u), t0.isValidated());
+    ASSERT_EQ(compiled.isFireable(0u), t0.isFireable());
+    ASSERT_EQ(compiled.countBurnableTokens(0u), t0.countBurnableTokens());
+
+    compiled.fire(0u, 2u);
+    ASSERT_THAT(compiled.tokens(), ElementsAre(1u, 0u, 2u));
+    ASSERT_EQ(compiled.isValidated(0u), false);
+    ASSERT_EQ(compiled.countBurnableTokens(0u), 0u);
+
+    // The net is not modified until written back
+    ASSERT_EQ(p0.tokens, 3u);
+    ASSERT_EQ(p1.tokens, 2u);
+    ASSERT_EQ(p2.tokens, 0u);
+    compiled.receptivity(0u, false);
+    compiled.writeMarking(net);
+    ASSERT_EQ(p0.tokens, 1u);
+    ASSERT_EQ(p1.tokens, 0u);
+    ASSERT_EQ(p2.tokens, 2u);
+    ASSERT_EQ(t0.receptivity, false);
+
+    // Marking modified from the net
+    p1.tokens = 4u;
+    t0.receptivity = true;
+    compiled.readMarking(net);
+    ASSERT_THAT(compiled.tokens(), ElementsAre(1u, 4u, 2u));
+    ASSERT_EQ(compiled.isFireable(0u), true);
+    compiled.tokens(2u, 42u);
+    compiled.writeMarking(net);
+    ASSERT_EQ(p2.tokens, 42u);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestCompiledNet, TestWeightedFiring)
+{
+    // P0 -(2)-> T0 -(3)-> P1
+    Net net(TypeOfNet::PetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 5u);
+    net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    ASSERT_EQ(net.addArc(p0, t0, 0.0f, 2u), true);
+    ASSERT_EQ(net.addArc(t0, net.places()[1], 0.0f, 3u), true);
+    t0.receptivity = true;
+
+    CompiledNet compiled(net);
+    ASSERT_EQ(compiled.preWeights(0u).size(), 1u);
+    ASSERT_EQ(compiled.preWeights(0u)[0], 2u);
+    ASSERT_EQ(compiled.postWeights(0u).size(), 1u);
+    ASSERT_EQ(compiled.postWeights(0u)[0], 3u);
+    ASSERT_EQ(compiled.isValidated(0u), t0.isValidated());
+    ASSERT_EQ(compiled.countBurnableTokens(0u), t0.countBurnableTokens());
+    compiled.fire(0u, 2u);
+    ASSERT_THAT(compiled.tokens(), ElementsAre(1u, 6u));
+    ASSERT_EQ(compiled.isValidated(0u), false);
+
+    // Weighted arcs are not allowed in event graphs
+    ASSERT_EQ(isEventGraph(compiled), false);
+    ASSERT_EQ(isEventGraph(net), false);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestCompiledNet, TestCandidates)
+{
+    // P0 -> T0 -> P1 -> T1 and P1 -> T2
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 1u);
+    Place& p1 = net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    Transition& t1 = net.addTransition(0.0f, 0.0f);
+    Transition& t2 = net.addTransition(0.0f, 0.0f);
+    ASSERT_EQ(net.addArc(p0, t0), true);
+    ASSERT_EQ(net.addArc(t0, p1), true);
+    ASSERT_EQ(net.addArc(p1, t1), true);
+    ASSERT_EQ(net.addArc(p1, t2), true);
+
+    // All transitions are candidates once compiled
+    CompiledNet compiled(net);
+    std::vector<size_t> candidates;
+    compiled.takeCandidates(candidates);
+    ASSERT_THAT(candidates, ElementsAre(0u, 1u, 2u));
+    compiled.takeCandidates(candidates);
+    ASSERT_EQ(candidates.size(), 0u);
+
+    // Burning tokens cannot enable transitions
+    compiled.consume(0u, 1u);
+    compiled.takeCandidates(candidates);
+    ASSERT_EQ(candidates.size(), 0u);
+
+    // Only transitions downstream of places gaining tokens are candidates
+    compiled.produce(0u, 1u);
+    compiled.deposit(1u, 1u);
+    compiled.takeCandidates(candidates);
+    ASSERT_THAT(candidates, ElementsAre(1u, 2u));
+
+    // Receptivities becoming true
+    compiled.receptivity(0u, false);
+    compiled.takeCandidates(candidates);
+    ASSERT_EQ(candidates.size(), 0u);
+    compiled.receptivity(0u, true);
+    compiled.takeCandidates(candidates);
+    ASSERT_THAT(candidates, ElementsAre(0u));
+
+    // Changes made on the net
+    compiled.receptivity(1u, false);
+    compiled.takeCandidates(candidates);
+    p0.tokens = 1u;
+    t1.receptivity = true;
+    t2.receptivity = false;
+    compiled.readMarking(net);
+    compiled.takeCandidates(candidates);
+    ASSERT_THAT(candidates, ElementsAre(0u, 1u));
+}
+
+//------------------------------------------------------------------------------
+TEST(TestCompiledNet, TestClusters)
+{
+    // P0 -> T0, T2. P1 -> T2, T3. P2 -> T1. T4 is a source.
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 3u);
+    Place& p1 = net.addPlace(0.0f, 0.0f, 2u);
+    Place& p2 = net.addPlace(0.0f, 0.0f, 0u);
+    for (size_t i = 0u; i < 5u; ++i)
+        net.addTransition(0.0f, 0.0f);
+    ASSERT_EQ(net.addArc(p0, net.transitions()[0]), true);
+    ASSERT_EQ(net.addArc(p0, net.transitions()[2]), true);
+    ASSERT_EQ(net.addArc(p1, net.transitions()[2]), true);
+    ASSERT_EQ(net.addArc(p1, net.transitions()[3]), true);
+    ASSERT_EQ(net.addArc(p2, net.transitions()[1]), true);
+    ASSERT_EQ(net.addArc(net.transitions()[4], p2), true);
+
+    CompiledNet compiled(net);
+    ASSERT_EQ(compiled.clusters(), 3u);
+    ASSERT_EQ(compiled.cluster(0u), 0u);
+    ASSERT_EQ(compiled.cluster(1u), 1u);
+    ASSERT_EQ(compiled.cluster(2u), 0u);
+    ASSERT_EQ(compiled.cluster(3u), 0u);
+    ASSERT_EQ(compiled.cluster(4u), 2u);
+
+    // Enabling degrees
+    ASSERT_EQ(compiled.enablingDegree(0u), 3u);
+    ASSERT_EQ(compiled.enablingDegree(1u), 0u);
+    ASSERT_EQ(compiled.enablingDegree(2u), 2u);
+    ASSERT_EQ(compiled.enablingDegree(4u), 1u);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestCompiledNet, TestLimits)
+{
+    ASSERT_EQ(CompiledNet::maxIndex(), size_t(std::numeric_limits<CompiledNet::Index>::max()));
+    ASSERT_EQ(CompiledNet::maxCount(), size_t(std::numeric_limits<CompiledNet::Count>::max()));
+
+    // P0 -> T0 -> P1
+    Net net(TypeOfNet::PetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 1u);
+    Place& p1 = net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    ASSERT_EQ(net.addArc(p0, t0), true);
+    ASSERT_EQ(net.addArc(t0, p1), true);
+
+    CompiledNet compiled;
+    ASSERT_EQ(compiled.compile(net), true);
+    ASSERT_STREQ(compiled.error().c_str(), "");
+
+    // Counters saturate instead of overflowing and lost tokens are counted
+    ASSERT_EQ(compiled.overflowed(), false);
+    compiled.tokens(1u, CompiledNet::maxCount());
+    ASSERT_EQ(compiled.overflowed(), false);
+    compiled.produce(0u, 2u);
+    ASSERT_EQ(compiled.tokens(1u), CompiledNet::maxCount());
+    ASSERT_EQ(compiled.overflows(), 1u);
+    compiled.tokens(1u, CompiledNet::maxCount() - 1u);
+    compiled.produce(0u, 1u);
+    ASSERT_EQ(compiled.tokens(1u), CompiledNet::maxCount());
+    ASSERT_EQ(compiled.overflows(), 1u);
+    compiled.deposit(1u, 1u);
+    ASSERT_EQ(compiled.overflows(), 2u);
+
+    // Compiling again forgets them
+    ASSERT_EQ(compiled.compile(net), true);
+    ASSERT_EQ(compiled.overflowed(), false);
+
+#if defined(TPNE_COMPACT_INDEX)
+    compiled.tokens(1u, CompiledNet::maxCount() + 1u);
+    ASSERT_EQ(compiled.tokens(1u), CompiledNet::maxCount());
+    ASSERT_EQ(compiled.overflows(), 1u);
+
+    // Nets exceeding the limits are refused
+    p1.tokens = CompiledNet::maxCount() + 1u;
+    ASSERT_EQ(compiled.readMarking(net), false);
+    ASSERT_EQ(compiled.tokens(1u), CompiledNet::maxCount());
+    ASSERT_EQ(compiled.compile(net), false);
+    ASSERT_STREQ(compiled.error().c_str(), "A place has more than 4294967295 tokens");
+    ASSERT_EQ(compiled.places(), 0u);
+
+    p1.tokens = 0u;
+    net.arcs()[0].weight = CompiledNet::maxCount() + 1u;
+    ASSERT_EQ(compiled.compile(net), false);
+    ASSERT_STREQ(compiled.error().c_str(), "Arc P0 -> T0 has a weight greater than 4294967295");
+#endif
+}
+
+//------------------------------------------------------------------------------
+TEST(TestCompiledNet, TestEventGraph)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+    bool stringify;
+
+    ASSERT_STREQ(loadFromFile(net, "../data/examples/Howard2.json", stringify).c_str(), "");
+    CompiledNet compiled(net);
+    ASSERT_EQ(isEventGraph(compiled), isEventGraph(net));
+
+    SparseMatrix<MaxPlus> tokens1, tokens2;
+    SparseMatrix<MaxPlus> durations1, durations2;
+    ASSERT_EQ(toAdjacencyMatrices(compiled, tokens1, durations1), true);
+    ASSERT_EQ(toAdjacencyMatrices(net, tokens2, durations2), true);
+    ASSERT_EQ(tokens1.i, tokens2.i);
+    ASSERT_EQ(tokens1.j, tokens2.j);
+    ASSERT_EQ(tokens1.d, tokens2.d);
+    ASSERT_EQ(durations1.i, durations2.i);
+    ASSERT_EQ(durations1.j, durations2.j);
+    ASSERT_EQ(durations1.d, durations2.d);
+}
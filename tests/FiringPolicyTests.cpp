@@ -0,0 +1,174 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "main.hpp"
+#include "TimedPetriNetEditor/PetriNet.hpp"
+#include "TimedPetriNetEditor/TimedSimulator.hpp"
+
+using namespace ::tpne;
+
+//------------------------------------------------------------------------------
+class Firings: public TimedSimulator::Observer
+{
+public:
+
+    void onFired(double const /*time*/, size_t const transition, size_t const count) override
+    {
+        for (size_t i = 0u; i < count; ++i)
+            fired.push_back(transition);
+    }
+
+    std::vector<size_t> fired;
+};
+
+//------------------------------------------------------------------------------
+// P0 holding the given tokens is shared by the given number of transitions,
+// each one giving back its token to P0 after one unit of time.
+static void createLoops(Net& net, size_t const tokens, size_t const transitions)
+{
+    Place& p0 = net.addPlace(0.0f, 0.0f, tokens);
+    for (size_t i = 0u; i < transitions; ++i)
+    {
+        Transition& t = net.addTransition(0.0f, 0.0f);
+        net.addArc(p0, t);
+        net.addArc(t, p0, 1.0f);
+    }
+    net.resetReceptivies();
+}
+
+//------------------------------------------------------------------------------
+TEST(TestFiringPolicy, TestIndexedHeap)
+{
+    IndexedHeap<int64_t> heap;
+    heap.reset(8u);
+    ASSERT_EQ(heap.empty(), true);
+    heap.push(3u, 5);
+    heap.push(1u, 2);
+    heap.push(6u, 9);
+    heap.push(4u, 2);
+    heap.push(0u, 7);
+    ASSERT_EQ(heap.size(), 5u);
+    ASSERT_EQ(heap.contains(6u), true);
+    ASSERT_EQ(heap.contains(2u), false);
+
+    // Update keys and remove in the middle of the heap.
+    heap.push(6u, 1);
+    heap.push(1u, 8);
+    heap.remove(3u);
+    heap.remove(3u);
+    ASSERT_EQ(heap.contains(3u), false);
+
+    // Ties are ordered by identifiers.
+    ASSERT_EQ(heap.pop(), 6u);
+    ASSERT_EQ(heap.pop(), 4u);
+    ASSERT_EQ(heap.pop(), 0u);
+    ASSERT_EQ(heap.pop(), 1u);
+    ASSERT_EQ(heap.empty(), true);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestFiringPolicy, TestPriority)
+{
+    // P0 (10 tokens) -> T0, T1, T2 and P1 (3 tokens) -> T2
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 10u);
+    Place& p1 = net.addPlace(0.0f, 0.0f, 3u);
+    for (size_t i = 0u; i < 3u; ++i)
+    {
+        Place& p = net.addPlace(0.0f, 0.0f, 0u);
+        Transition& t = net.addTransition(0.0f, 0.0f);
+        net.addArc(p0, t);
+        net.addArc(t, p, 1.0f);
+    }
+    net.addArc(p1, net.transitions()[2]);
+    net.resetReceptivies();
+
+    std::unique_ptr<PriorityPolicy> policy(new PriorityPolicy());
+    policy->priority(1u, 1);
+    policy->priority(2u, 5);
+    TimedSimulator simulator(net);
+    simulator.policy(std::move(policy));
+
+    // The copy keeps the priorities.
+    TimedSimulator copy(simulator);
+    ASSERT_EQ(dynamic_cast<PriorityPolicy&>(copy.policy()).priority(2u), 5);
+
+    // T2 takes the tokens it can, then T1 takes the remaining ones.
+    for (auto* s: { &simulator, &copy })
+    {
+        ASSERT_EQ(s->runUntil(1.0), 10u);
+        ASSERT_EQ(s->compiled().tokens(2u), 0u);
+        ASSERT_EQ(s->compiled().tokens(3u), 7u);
+        ASSERT_EQ(s->compiled().tokens(4u), 3u);
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(TestFiringPolicy, TestFifo)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+    createLoops(net, 1u, 3u);
+    TimedSimulator simulator(net);
+    simulator.policy(std::unique_ptr<FiringPolicy>(new FifoPolicy()));
+    Firings firings;
+    simulator.addObserver(firings);
+
+    // The single token is given in turn to each transition.
+    simulator.runUntil(1.0);
+    TimedSimulator::Checkpoint checkpoint;
+    simulator.save(checkpoint);
+    simulator.runUntil(5.0);
+    ASSERT_EQ(firings.fired, std::vector<size_t>({ 0u, 1u, 2u, 0u, 1u, 2u }));
+
+    // The turn is restored with the checkpoint.
+    firings.fired.clear();
+    simulator.restore(checkpoint);
+    simulator.runUntil(5.0);
+    ASSERT_EQ(firings.fired, std::vector<size_t>({ 2u, 0u, 1u, 2u }));
+}
+
+//------------------------------------------------------------------------------
+TEST(TestFiringPolicy, TestWeightedRandom)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+    createLoops(net, 1u, 3u);
+    std::unique_ptr<WeightedRandomPolicy> policy(new WeightedRandomPolicy());
+    policy->weight(0u, 6u);
+    policy->weight(1u, 3u);
+    policy->weight(2u, 0u);
+    ASSERT_EQ(policy->weight(2u), 1u);
+    TimedSimulator simulator(net);
+    simulator.policy(std::move(policy));
+    simulator.seed(42u);
+    Firings firings;
+    simulator.addObserver(firings);
+
+    // Firings are shared proportionally to the weights.
+    simulator.runUntil(9999.0);
+    ASSERT_EQ(firings.fired.size(), 10000u);
+    size_t counts[3] = { 0u, 0u, 0u };
+    for (auto const t: firings.fired)
+    {
+        counts[t] += 1u;
+    }
+    ASSERT_NEAR(double(counts[0]), 6000.0, 200.0);
+    ASSERT_NEAR(double(counts[1]), 3000.0, 200.0);
+    ASSERT_NEAR(double(counts[2]), 1000.0, 200.0);
+}
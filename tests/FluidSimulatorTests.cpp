@@ -0,0 +1,183 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "main.hpp"
+#include "TimedPetriNetEditor/PetriNet.hpp"
+#include "TimedPetriNetEditor/FluidSimulator.hpp"
+
+using namespace ::tpne;
+
+//------------------------------------------------------------------------------
+static void rate(Transition& transition, float const value)
+{
+    transition.delay.law = Distribution::Law::Exponential;
+    transition.delay.a = value;
+}
+
+//------------------------------------------------------------------------------
+static void server(Net& net, NetSettings::Server const semantics)
+{
+    NetSettings settings = net.settings();
+    settings.server = semantics;
+    net.settings(settings);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestFluidSimulator, TestInfiniteServer)
+{
+    // A million of tokens leaving P0 at rate 1: m(t) = 1e6 exp(-t).
+    Net net(TypeOfNet::TimedPetriNet);
+    net.addPlace(0.0f, 0.0f, 1000000u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    net.addArc(net.places()[0], t0);
+    rate(t0, 1.0f);
+    net.resetReceptivies();
+
+    FluidSimulator simulator(net);
+    ASSERT_STREQ(simulator.error().c_str(), "");
+    ASSERT_EQ(simulator.server(), NetSettings::Server::Infinite);
+    ASSERT_EQ(simulator.rate(0u), 1.0);
+    ASSERT_EQ(simulator.flows()[0], 1000000.0);
+    simulator.runUntil(1.0);
+    ASSERT_EQ(simulator.time(), 1.0);
+    ASSERT_NEAR(simulator.marking(0u), 1e6 * std::exp(-1.0), 1e-3);
+    ASSERT_NEAR(simulator.firings(0u), 1e6 - simulator.marking(0u), 1e-6);
+    ASSERT_EQ(simulator.events(), 100u);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestFluidSimulator, TestInfiniteServerSteadyState)
+{
+    // N tokens looping between T0 (rate 1) and T1 (rate 3): 3/4 of them wait
+    // in P0 and the throughput is 3N/4.
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 1000000u);
+    Place& p1 = net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    Transition& t1 = net.addTransition(0.0f, 0.0f);
+    net.addArc(p0, t0);
+    net.addArc(t0, p1, 0.0f);
+    net.addArc(p1, t1);
+    net.addArc(t1, p0, 0.0f);
+    rate(t0, 1.0f);
+    rate(t1, 3.0f);
+    net.resetReceptivies();
+
+    FluidSimulator simulator(net);
+    simulator.step(0.05);
+    simulator.runUntil(20.0);
+    ASSERT_NEAR(simulator.marking(0u), 750000.0, 1e-3);
+    ASSERT_NEAR(simulator.marking(0u) + simulator.marking(1u), 1e6, 1e-6);
+    ASSERT_NEAR(simulator.flows()[0], 750000.0, 1e-3);
+    ASSERT_NEAR(simulator.flows()[1], 750000.0, 1e-3);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestFluidSimulator, TestFiniteServer)
+{
+    // Source T0 (rate 1) feeding P0 drained by T1 (rate 2): P0 becomes empty
+    // at t = 5 then T1 follows the flow of T0.
+    Net net(TypeOfNet::TimedPetriNet);
+    server(net, NetSettings::Server::Finite);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 5u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    Transition& t1 = net.addTransition(0.0f, 0.0f);
+    net.addArc(t0, p0, 0.0f);
+    net.addArc(p0, t1);
+    rate(t0, 1.0f);
+    rate(t1, 2.0f);
+    net.resetReceptivies();
+
+    FluidSimulator simulator(net);
+    ASSERT_EQ(simulator.server(), NetSettings::Server::Finite);
+    simulator.runUntil(10.0);
+    ASSERT_EQ(simulator.time(), 10.0);
+    ASSERT_EQ(simulator.events(), 1u);
+    ASSERT_EQ(simulator.marking(0u), 0.0);
+    ASSERT_DOUBLE_EQ(simulator.firings(0u), 10.0);
+    ASSERT_DOUBLE_EQ(simulator.firings(1u), 15.0);
+    ASSERT_DOUBLE_EQ(simulator.throughput(1u), 1.5);
+    ASSERT_EQ(simulator.flows()[1], 1.0);
+
+    // Faster source: the place is marked again.
+    simulator.rate(0u, 3.0);
+    simulator.runUntil(12.0);
+    ASSERT_DOUBLE_EQ(simulator.marking(0u), 2.0);
+    ASSERT_EQ(simulator.events(), 1u);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestFluidSimulator, TestFiniteServerSharing)
+{
+    // The flow of T0 entering the empty place P0 is shared by T1 and T2 in
+    // proportion of their rates. The empty circuit P1, T3, P2, T4 stays idle.
+    Net net(TypeOfNet::TimedPetriNet);
+    server(net, NetSettings::Server::Finite);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 0u);
+    Place& p1 = net.addPlace(0.0f, 0.0f, 0u);
+    Place& p2 = net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    Transition& t1 = net.addTransition(0.0f, 0.0f);
+    Transition& t2 = net.addTransition(0.0f, 0.0f);
+    Transition& t3 = net.addTransition(0.0f, 0.0f);
+    Transition& t4 = net.addTransition(0.0f, 0.0f);
+    net.addArc(t0, p0, 0.0f);
+    net.addArc(p0, t1);
+    net.addArc(p0, t2);
+    net.addArc(p1, t3);
+    net.addArc(t3, p2, 0.0f);
+    net.addArc(p2, t4);
+    net.addArc(t4, p1, 0.0f);
+    rate(t0, 3.0f);
+    rate(t1, 1.0f);
+    rate(t2, 3.0f);
+    rate(t3, 1.0f);
+    rate(t4, 1.0f);
+    net.resetReceptivies();
+
+    FluidSimulator simulator(net);
+    std::vector<double> const& flows = simulator.flows();
+    ASSERT_DOUBLE_EQ(flows[0], 3.0);
+    ASSERT_DOUBLE_EQ(flows[1], 0.75);
+    ASSERT_DOUBLE_EQ(flows[2], 2.25);
+    ASSERT_EQ(flows[3], 0.0);
+    ASSERT_EQ(flows[4], 0.0);
+    simulator.runUntil(4.0);
+    ASSERT_EQ(simulator.marking(0u), 0.0);
+    ASSERT_DOUBLE_EQ(simulator.firings(2u), 9.0);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestFluidSimulator, TestImmediateTransitions)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+    net.addPlace(0.0f, 0.0f, 1u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    net.addArc(net.places()[0], t0);
+
+    FluidSimulator simulator;
+    ASSERT_EQ(simulator.reset(net), false);
+    ASSERT_STREQ(simulator.error().c_str(), "Transition T0 has no delay: "
+                 "immediate transitions have no fluid approximation");
+    rate(t0, 2.0f);
+    ASSERT_EQ(simulator.reset(net), true);
+    ASSERT_STREQ(simulator.error().c_str(), "");
+    ASSERT_EQ(simulator.rate(0u), 2.0);
+}
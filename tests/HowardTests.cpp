@@ -182,22 +182,22 @@ TEST(TestHoward, TestPetriNetSemiSimple)
     ASSERT_EQ(res.durations[2], 6.5);
     ASSERT_EQ(res.durations[3], 6.5);
     ASSERT_EQ(res.arcs.size(), 8u);
-    ASSERT_STREQ(res.arcs[0]->from.key.c_str(), "T0");
-    ASSERT_STREQ(res.arcs[0]->to.key.c_str(), "P0");
-    ASSERT_STREQ(res.arcs[1]->from.key.c_str(), "P0");
-    ASSERT_STREQ(res.arcs[1]->to.key.c_str(), "T2");
-    ASSERT_STREQ(res.arcs[2]->from.key.c_str(), "T1");
-    ASSERT_STREQ(res.arcs[2]->to.key.c_str(), "P1");
-    ASSERT_STREQ(res.arcs[3]->from.key.c_str(), "P1");
-    ASSERT_STREQ(res.arcs[3]->to.key.c_str(), "T0");
-    ASSERT_STREQ(res.arcs[4]->from.key.c_str(), "T2");
-    ASSERT_STREQ(res.arcs[4]->to.key.c_str(), "P2");
-    ASSERT_STREQ(res.arcs[5]->from.key.c_str(), "P2");
-    ASSERT_STREQ(res.arcs[5]->to.key.c_str(), "T1");
-    ASSERT_STREQ(res.arcs[6]->from.key.c_str(), "T3");
-    ASSERT_STREQ(res.arcs[6]->to.key.c_str(), "P3");
-    ASSERT_STREQ(res.arcs[7]->from.key.c_str(), "P3");
-    ASSERT_STREQ(res.arcs[7]->to.key.c_str(), "T0");
+    ASSERT_STREQ(res.arcs[0]->from.key().c_str(), "T0");
+    ASSERT_STREQ(res.arcs[0]->to.key().c_str(), "P0");
+    ASSERT_STREQ(res.arcs[1]->from.key().c_str(), "P0");
+    ASSERT_STREQ(res.arcs[1]->to.key().c_str(), "T2");
+    ASSERT_STREQ(res.arcs[2]->from.key().c_str(), "T1");
+    ASSERT_STREQ(res.arcs[2]->to.key().c_str(), "P1");
+    ASSERT_STREQ(res.arcs[3]->from.key().c_str(), "P1");
+    ASSERT_STREQ(res.arcs[3]->to.key().c_str(), "T0");
+    ASSERT_STREQ(res.arcs[4]->from.key().c_str(), "T2");
+    ASSERT_STREQ(res.arcs[4]->to.key().c_str(), "P2");
+    ASSERT_STREQ(res.arcs[5]->from.key().c_str(), "P2");
+    ASSERT_STREQ(res.arcs[5]->to.key().c_str(), "T1");
+    ASSERT_STREQ(res.arcs[6]->from.key().c_str(), "T3");
+    ASSERT_STREQ(res.arcs[6]->to.key().c_str(), "P3");
+    ASSERT_STREQ(res.arcs[7]->from.key().c_str(), "P3");
+    ASSERT_STREQ(res.arcs[7]->to.key().c_str(), "T0");
 
     std::stringstream expected;
     expected << "Found 1 connected components of the optimal policy:\n"
@@ -237,18 +237,18 @@ TEST(TestHoward, TestSemiHowardExample)
     ASSERT_EQ(res.durations[1], 1.0);
     ASSERT_EQ(res.durations[2], 2.0);
     ASSERT_EQ(res.arcs.size(), 6u);
-    ASSERT_STREQ(res.arcs[0]->from.key.c_str(), "T0");
-    ASSERT_STREQ(res.arcs[0]->to.key.c_str(), "P0");
-    ASSERT_STREQ(res.arcs[1]->from.key.c_str(), "P0");
-    ASSERT_STREQ(res.arcs[1]->to.key.c_str(), "T1");
-    ASSERT_STREQ(res.arcs[2]->from.key.c_str(), "T1");
-    ASSERT_STREQ(res.arcs[2]->to.key.c_str(), "P1");
-    ASSERT_STREQ(res.arcs[3]->from.key.c_str(), "P1");
-    ASSERT_STREQ(res.arcs[3]->to.key.c_str(), "T0");
-    ASSERT_STREQ(res.arcs[4]->from.key.c_str(), "T2");
-    ASSERT_STREQ(res.arcs[4]->to.key.c_str(), "P4");
-    ASSERT_STREQ(res.arcs[5]->from.key.c_str(), "P4");
-    ASSERT_STREQ(res.arcs[5]->to.key.c_str(), "T2");
+    ASSERT_STREQ(res.arcs[0]->from.key().c_str(), "T0");
+    ASSERT_STREQ(res.arcs[0]->to.key().c_str(), "P0");
+    ASSERT_STREQ(res.arcs[1]->from.key().c_str(), "P0");
+    ASSERT_STREQ(res.arcs[1]->to.key().c_str(), "T1");
+    ASSERT_STREQ(res.arcs[2]->from.key().c_str(), "T1");
+    ASSERT_STREQ(res.arcs[2]->to.key().c_str(), "P1");
+    ASSERT_STREQ(res.arcs[3]->from.key().c_str(), "P1");
+    ASSERT_STREQ(res.arcs[3]->to.key().c_str(), "T0");
+    ASSERT_STREQ(res.arcs[4]->from.key().c_str(), "T2");
+    ASSERT_STREQ(res.arcs[4]->to.key().c_str(), "P4");
+    ASSERT_STREQ(res.arcs[5]->from.key().c_str(), "P4");
+    ASSERT_STREQ(res.arcs[5]->to.key().c_str(), "T2");
 
     std::stringstream expected;
     expected << "Found 2 connected components of the optimal policy:\n"
@@ -295,38 +295,38 @@ TEST(TestHoward, TestSemiNetherlandsExample)
     ASSERT_NEAR(res.durations[6], 47.6667, 0.001);
     ASSERT_NEAR(res.durations[7], 47.6667, 0.001);
     ASSERT_EQ(res.arcs.size(), 16u);
-    ASSERT_STREQ(res.arcs[0]->from.key.c_str(), "T0");
-    ASSERT_STREQ(res.arcs[0]->to.key.c_str(), "P0");
-    ASSERT_STREQ(res.arcs[1]->from.key.c_str(), "P0");
-    ASSERT_STREQ(res.arcs[1]->to.key.c_str(), "T1");
-    ASSERT_STREQ(res.arcs[2]->from.key.c_str(), "T1");
-    ASSERT_STREQ(res.arcs[2]->to.key.c_str(), "P1");
-    ASSERT_STREQ(res.arcs[3]->from.key.c_str(), "P1");
-    ASSERT_STREQ(res.arcs[3]->to.key.c_str(), "T3");
-    ASSERT_STREQ(res.arcs[4]->from.key.c_str(), "T2");
-    ASSERT_STREQ(res.arcs[4]->to.key.c_str(), "P2");
-    ASSERT_STREQ(res.arcs[5]->from.key.c_str(), "P2");
-    ASSERT_STREQ(res.arcs[5]->to.key.c_str(), "T0");
-    ASSERT_STREQ(res.arcs[6]->from.key.c_str(), "T3");
-    ASSERT_STREQ(res.arcs[6]->to.key.c_str(), "P4");
-    ASSERT_STREQ(res.arcs[7]->from.key.c_str(), "P4");
-    ASSERT_STREQ(res.arcs[7]->to.key.c_str(), "T2");
-    ASSERT_STREQ(res.arcs[8]->from.key.c_str(), "T4");
-    ASSERT_STREQ(res.arcs[8]->to.key.c_str(), "P7");
-    ASSERT_STREQ(res.arcs[9]->from.key.c_str(), "P7");
-    ASSERT_STREQ(res.arcs[9]->to.key.c_str(), "T6");
-    ASSERT_STREQ(res.arcs[10]->from.key.c_str(), "T5");
-    ASSERT_STREQ(res.arcs[10]->to.key.c_str(), "P8");
-    ASSERT_STREQ(res.arcs[11]->from.key.c_str(), "P8");
-    ASSERT_STREQ(res.arcs[11]->to.key.c_str(), "T4");
-    ASSERT_STREQ(res.arcs[12]->from.key.c_str(), "T6");
-    ASSERT_STREQ(res.arcs[12]->to.key.c_str(), "P9");
-    ASSERT_STREQ(res.arcs[13]->from.key.c_str(), "P9");
-    ASSERT_STREQ(res.arcs[13]->to.key.c_str(), "T1");
-    ASSERT_STREQ(res.arcs[14]->from.key.c_str(), "T7");
-    ASSERT_STREQ(res.arcs[14]->to.key.c_str(), "P11");
-    ASSERT_STREQ(res.arcs[15]->from.key.c_str(), "P11");
-    ASSERT_STREQ(res.arcs[15]->to.key.c_str(), "T5");
+    ASSERT_STREQ(res.arcs[0]->from.key().c_str(), "T0");
+    ASSERT_STREQ(res.arcs[0]->to.key().c_str(), "P0");
+    ASSERT_STREQ(res.arcs[1]->from.key().c_str(), "P0");
+    ASSERT_STREQ(res.arcs[1]->to.key().c_str(), "T1");
+    ASSERT_STREQ(res.arcs[2]->from.key().c_str(), "T1");
+    ASSERT_STREQ(res.arcs[2]->to.key().c_str(), "P1");
+    ASSERT_STREQ(res.arcs[3]->from.key().c_str(), "P1");
+    ASSERT_STREQ(res.arcs[3]->to.key().c_str(), "T3");
+    ASSERT_STREQ(res.arcs[4]->from.key().c_str(), "T2");
+    ASSERT_STREQ(res.arcs[4]->to.key().c_str(), "P2");
+    ASSERT_STREQ(res.arcs[5]->from.key().c_str(), "P2");
+    ASSERT_STREQ(res.arcs[5]->to.key().c_str(), "T0");
+    ASSERT_STREQ(res.arcs[6]->from.key().c_str(), "T3");
+    ASSERT_STREQ(res.arcs[6]->to.key().c_str(), "P4");
+    ASSERT_STREQ(res.arcs[7]->from.key().c_str(), "P4");
+    ASSERT_STREQ(res.arcs[7]->to.key().c_str(), "T2");
+    ASSERT_STREQ(res.arcs[8]->from.key().c_str(), "T4");
+    ASSERT_STREQ(res.arcs[8]->to.key().c_str(), "P7");
+    ASSERT_STREQ(res.arcs[9]->from.key().c_str(), "P7");
+    ASSERT_STREQ(res.arcs[9]->to.key().c_str(), "T6");
+    ASSERT_STREQ(res.arcs[10]->from.key().c_str(), "T5");
+    ASSERT_STREQ(res.arcs[10]->to.key().c_str(), "P8");
+    ASSERT_STREQ(res.arcs[11]->from.key().c_str(), "P8");
+    ASSERT_STREQ(res.arcs[11]->to.key().c_str(), "T4");
+    ASSERT_STREQ(res.arcs[12]->from.key().c_str(), "T6");
+    ASSERT_STREQ(res.arcs[12]->to.key().c_str(), "P9");
+    ASSERT_STREQ(res.arcs[13]->from.key().c_str(), "P9");
+    ASSERT_STREQ(res.arcs[13]->to.key().c_str(), "T1");
+    ASSERT_STREQ(res.arcs[14]->from.key().c_str(), "T7");
+    ASSERT_STREQ(res.arcs[14]->to.key().c_str(), "P11");
+    ASSERT_STREQ(res.arcs[15]->from.key().c_str(), "P11");
+    ASSERT_STREQ(res.arcs[15]->to.key().c_str(), "T5");
 
     std::stringstream expected;
     expected << "Found 1 connected components of the optimal policy:\n"
@@ -197,3 +197,27 @@ TEST(TestJSONLoader, LoadUnexistingFile)
     ASSERT_STREQ(loadFromFile(net, "foooobar.json", stringify).c_str(),
     "Failed opening 'foooobar.json'. Reason was 'No such file or directory'\n");
 }
+
+//------------------------------------------------------------------------------
+TEST(TestJSONLoader, SaveAndLoadDelays)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+    bool stringify;
+
+    Place& p0 = net.addPlace(1.0, 1.0, 2u);
+    Transition& t0 = net.addTransition(2.0, 1.0);
+    Transition& t1 = net.addTransition(3.0, 1.0);
+    net.addArc(t0, p0, 1.0f);
+    net.addArc(p0, t1);
+    t0.delay.law = Distribution::Law::Erlang;
+    t0.delay.a = 2.5f;
+    t0.delay.b = 3.0f;
+    ASSERT_STREQ(saveToFile(net, "/tmp/foo.json").c_str(), "");
+
+    ASSERT_STREQ(loadFromFile(net, "/tmp/foo.json", stringify).c_str(), "");
+    ASSERT_EQ(net.m_transitions.size(), 2u);
+    ASSERT_EQ(net.findTransition(0u)->delay.law, Distribution::Law::Erlang);
+    ASSERT_EQ(net.findTransition(0u)->delay.a, 2.5f);
+    ASSERT_EQ(net.findTransition(0u)->delay.b, 3.0f);
+    ASSERT_EQ(net.findTransition(1u)->delay.isDefault(), true);
+}
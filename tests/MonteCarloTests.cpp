@@ -0,0 +1,86 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "main.hpp"
+#define protected public
+#define private public
+#  include "TimedPetriNetEditor/PetriNet.hpp"
+#  include "TimedPetriNetEditor/MonteCarlo.hpp"
+#undef protected
+#undef private
+
+using namespace ::tpne;
+
+//------------------------------------------------------------------------------
+TEST(TestMonteCarlo, TestDeterministicNet)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+    createCycle(net);
+
+    // T0 fires at 0, 5, ... 95 and T1 at 3, 8, ... 98. Tokens are in places
+    // only at instants.
+    MonteCarloResult result = runMonteCarlo(net, 10u, 99.0, 42u, 2u);
+    ASSERT_EQ(result.success, true);
+    ASSERT_EQ(result.replications, 10u);
+    ASSERT_EQ(result.throughputs.size(), 2u);
+    ASSERT_DOUBLE_EQ(result.throughputs[0], 20.0 / 99.0);
+    ASSERT_DOUBLE_EQ(result.throughputs[1], 20.0 / 99.0);
+    ASSERT_DOUBLE_EQ(result.markings[0], 0.0);
+    ASSERT_DOUBLE_EQ(result.markings[1], 0.0);
+    ASSERT_EQ(result.deadlocks, 0u);
+    ASSERT_EQ(result.deadlock_frequency, 0.0);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestMonteCarlo, TestReproducible)
+{
+    // P0 (1 token) -> T0 -(1)-> P1: deadlock. P0 -> T1 -(1)-> P0: loop.
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 1u);
+    Place& p1 = net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    Transition& t1 = net.addTransition(0.0f, 0.0f);
+    net.addArc(p0, t0);
+    net.addArc(t0, p1, 1.0f);
+    net.addArc(p0, t1);
+    net.addArc(t1, p0, 1.0f);
+    net.resetReceptivies();
+
+    // The token loops a geometric number of times (1 in mean) before being
+    // lost: it then stays in P1 until the end.
+    MonteCarloResult r1 = runMonteCarlo(net, 1000u, 10.0, 42u, 1u);
+    ASSERT_EQ(r1.success, true);
+    ASSERT_GE(r1.deadlock_frequency, 0.99);
+    ASSERT_NEAR(r1.throughputs[1], 0.1, 0.03);
+    // T0 fires once per deadlock, and rarely at the end of the simulation,
+    // too late for the deadlock to be seen.
+    ASSERT_GE(r1.throughputs[0] * 10.0, r1.deadlock_frequency - 1e-9);
+    ASSERT_NEAR(r1.throughputs[0] * 10.0, r1.deadlock_frequency, 0.005);
+    ASSERT_NEAR(r1.markings[1], 0.8, 0.03);
+
+    // Same master seed gives same results whatever the number of threads.
+    MonteCarloResult r2 = runMonteCarlo(net, 1000u, 10.0, 42u, 4u);
+    ASSERT_EQ(r1.throughputs, r2.throughputs);
+    ASSERT_EQ(r1.markings, r2.markings);
+    ASSERT_EQ(r1.deadlocks, r2.deadlocks);
+
+    MonteCarloResult r3 = runMonteCarlo(net, 1000u, 10.0, 43u, 4u);
+    ASSERT_NE(r1.throughputs, r3.throughputs);
+}
@@ -0,0 +1,143 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "main.hpp"
+#define protected public
+#define private public
+#  include "TimedPetriNetEditor/PetriNet.hpp"
+#  include "TimedPetriNetEditor/NetBuilder.hpp"
+#undef protected
+#undef private
+
+using namespace ::tpne;
+
+//------------------------------------------------------------------------------
+TEST(TestNetBuilder, TestSameNetThanIncremental)
+{
+    // Net built element by element
+    Net expected(TypeOfNet::TimedPetriNet);
+    Place& p0 = expected.addPlace(0u, "P0", 0.0f, 0.0f, 1u);
+    Place& p1 = expected.addPlace(1u, "Buffer", 2.0f, 0.0f, 0u);
+    Transition& t0 = expected.addTransition(0u, "T0", 1.0f, 0.0f, 0);
+    Transition& t1 = expected.addTransition(1u, "T1", 3.0f, 0.0f, 0);
+    ASSERT_EQ(expected.addArc(p0, t0, NAN), true);
+    ASSERT_EQ(expected.addArc(t0, p1, 2.0f), true);
+    ASSERT_EQ(expected.addArc(p1, p0, 3.0f), true); // Creates T2
+    ASSERT_EQ(expected.addArc(t1, t0, 5u, 4.0f), true); // Creates P2
+
+    // Same net built by bulk. Arcs can be queued before their nodes.
+    Net net(TypeOfNet::TimedPetriNet);
+    NetBuilder builder(net);
+    builder.reserve(2u, 2u, 4u);
+    builder.addArc("P0", "T0", NAN);
+    builder.addArc("T0", "P1", 2.0f);
+    builder.addArc("P1", "P0", 3.0f);
+    builder.addArc(1u, 0u, 5u, 4.0f);
+    builder.addPlace(0u, "P0", 0.0f, 0.0f, 1u);
+    builder.addPlace(1u, "Buffer", 2.0f, 0.0f, 0u);
+    builder.addTransition(0u, "T0", 1.0f, 0.0f, 0);
+    builder.addTransition(1u, "T1", 3.0f, 0.0f, 0);
+    ASSERT_EQ(net.isEmpty(), true);
+    ASSERT_EQ(builder.finalize(), true);
+    ASSERT_EQ(builder.failure(), NetBuilder::Failure::None);
+
+    ASSERT_EQ(net.places().size(), expected.places().size());
+    ASSERT_EQ(net.transitions().size(), expected.transitions().size());
+    ASSERT_EQ(net.arcs().size(), expected.arcs().size());
+    for (size_t i = 0u; i < net.places().size(); ++i)
+    {
+        ASSERT_EQ(net.places()[i].id, expected.places()[i].id);
+        ASSERT_EQ(net.places()[i].caption(), expected.places()[i].caption());
+        ASSERT_EQ(net.places()[i].tokens, expected.places()[i].tokens);
+        ASSERT_EQ(net.places()[i].x, expected.places()[i].x);
+    }
+    for (size_t i = 0u; i < net.arcs().size(); ++i)
+    {
+        ASSERT_EQ(net.arcs()[i].from.key(), expected.arcs()[i].from.key());
+        ASSERT_EQ(net.arcs()[i].to.key(), expected.arcs()[i].to.key());
+    }
+    ASSERT_EQ(net.places()[2].tokens, 5u);
+    ASSERT_EQ(net.arcs()[4].duration, 4.0f);
+    ASSERT_EQ(net.sanityArcsInArcsOut(), true);
+    ASSERT_EQ(net.m_next_place_id, 3u);
+    ASSERT_EQ(net.m_next_transition_id, 3u);
+
+    // Queues have been emptied: finalize again does nothing
+    ASSERT_EQ(builder.finalize(), true);
+    ASSERT_EQ(net.arcs().size(), expected.arcs().size());
+}
+
+//------------------------------------------------------------------------------
+TEST(TestNetBuilder, TestFailures)
+{
+    // Duplicated nodes
+    {
+        Net net(TypeOfNet::TimedPetriNet);
+        NetBuilder builder(net);
+        builder.addPlace(0u, "", 0.0f, 0.0f, 0u);
+        builder.addPlace(1u, "", 0.0f, 0.0f, 0u);
+        builder.addPlace(0u, "", 0.0f, 0.0f, 0u);
+        ASSERT_EQ(builder.finalize(), false);
+        ASSERT_EQ(builder.failure(), NetBuilder::Failure::DuplicatedNode);
+        ASSERT_STREQ(builder.error().c_str(), "Node P0 is duplicated");
+    }
+
+    // Unknown nodes
+    {
+        Net net(TypeOfNet::TimedPetriNet);
+        NetBuilder builder(net);
+        builder.addPlace(0u, "", 0.0f, 0.0f, 0u);
+        builder.addTransition(0u, "", 0.0f, 0.0f, 0);
+        builder.addArc("P0", "T0");
+        builder.addArc("P0", "T1");
+        ASSERT_EQ(builder.finalize(), false);
+        ASSERT_EQ(builder.failure(), NetBuilder::Failure::UnknownNode);
+        ASSERT_EQ(builder.failedArc(), 1u);
+        ASSERT_STREQ(builder.error().c_str(), "Arc P0 -> T1 refer to unknown nodes");
+    }
+
+    // Negative duration
+    {
+        Net net(TypeOfNet::TimedPetriNet);
+        NetBuilder builder(net);
+        builder.addPlace(0u, "", 0.0f, 0.0f, 0u);
+        builder.addTransition(0u, "", 0.0f, 0.0f, 0);
+        builder.addArc("T0", "P0", -1.0f);
+        ASSERT_EQ(builder.finalize(), false);
+        ASSERT_EQ(builder.failure(), NetBuilder::Failure::NegativeDuration);
+        ASSERT_EQ(builder.failedArc(), 0u);
+        ASSERT_STREQ(builder.error().c_str(), "Arc T0 -> P0 has negative duration");
+    }
+
+    // Duplicated arcs
+    {
+        Net net(TypeOfNet::TimedPetriNet);
+        NetBuilder builder(net);
+        builder.addPlace(0u, "", 0.0f, 0.0f, 0u);
+        builder.addTransition(0u, "", 0.0f, 0.0f, 0);
+        builder.addArc("T0", "P0", 1.0f);
+        builder.addArc("P0", "T0");
+        builder.addArc("T0", "P0", 2.0f);
+        ASSERT_EQ(builder.finalize(), false);
+        ASSERT_EQ(builder.failure(), NetBuilder::Failure::DuplicatedArc);
+        ASSERT_EQ(builder.failedArc(), 2u);
+        ASSERT_STREQ(builder.error().c_str(), "Arc T0 -> P0 is badly formed");
+    }
+}
@@ -0,0 +1,151 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "main.hpp"
+#include "TimedPetriNetEditor/PetriNet.hpp"
+#include "TimedPetriNetEditor/ParallelSimulator.hpp"
+
+using namespace ::tpne;
+
+//------------------------------------------------------------------------------
+// Ring of stations: the tokens of the place Pk are shared by the transitions
+// Tk and Tk' moving them to the next station. A source feeds the first station
+// and the arc from the station 3 to the station 4 has no delay.
+static void createStations(Net& net, size_t const stations)
+{
+    for (size_t k = 0u; k < stations; ++k)
+    {
+        net.addPlace(0.0f, 0.0f, 3u);
+    }
+    for (size_t k = 0u; k < stations; ++k)
+    {
+        Transition& a = net.addTransition(0.0f, 0.0f);
+        Transition& b = net.addTransition(0.0f, 0.0f);
+        Place& from = net.places()[k];
+        Place& to = net.places()[(k + 1u) % stations];
+        net.addArc(from, a);
+        net.addArc(from, b);
+        net.addArc(a, to, (k == 3u) ? 0.0f : float(1u + k % 3u));
+        net.addArc(b, to, 0.5f + float(k % 2u));
+    }
+    Transition& source = net.addTransition(0.0f, 0.0f);
+    net.addArc(source, net.places()[0], 2.0f);
+    net.resetReceptivies();
+}
+
+//------------------------------------------------------------------------------
+static void compare(TimedSimulator& sequential, ParallelSimulator& parallel)
+{
+    for (double time = 0.0; time <= 40.0; time += 2.5)
+    {
+        size_t const expected = sequential.runUntil(time);
+        ASSERT_EQ(parallel.runUntil(time), expected);
+        ASSERT_EQ(parallel.time(), sequential.time());
+        ASSERT_EQ(parallel.firings(), sequential.firings());
+        ASSERT_EQ(parallel.tokens(), sequential.compiled().tokens());
+        for (size_t p = 0u; p < sequential.compiled().places(); ++p)
+        {
+            ASSERT_EQ(parallel.tokens(p), sequential.tokens(p));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(TestParallelSimulator, TestPartitions)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+    createStations(net, 8u);
+    ParallelSimulator simulator(net, 4u);
+    ASSERT_STREQ(simulator.error().c_str(), "");
+    ASSERT_EQ(simulator.partitions(), 4u);
+    ASSERT_GE(simulator.channels(), 4u);
+
+    // Places are owned by the partition of their downstream transitions.
+    // Arcs without delay and arcs from sources do not cross partitions.
+    for (size_t k = 0u; k < 8u; ++k)
+    {
+        ASSERT_EQ(simulator.transitionOwner(2u * k), simulator.placeOwner(k));
+        ASSERT_EQ(simulator.transitionOwner(2u * k + 1u), simulator.placeOwner(k));
+    }
+    ASSERT_EQ(simulator.placeOwner(3u), simulator.placeOwner(4u));
+    ASSERT_EQ(simulator.transitionOwner(16u), simulator.placeOwner(0u));
+
+    // Cannot be cut further.
+    ParallelSimulator single(net, 100u);
+    ASSERT_EQ(single.partitions(), 7u);
+    ParallelSimulator none(net, 0u);
+    ASSERT_EQ(none.partitions(), 1u);
+    ASSERT_EQ(none.channels(), 0u);
+
+    // Untimed nets have no lookahead: a single partition.
+    Net petri(TypeOfNet::PetriNet);
+    createStations(petri, 8u);
+    ParallelSimulator untimed(petri, 4u);
+    ASSERT_EQ(untimed.partitions(), 1u);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestParallelSimulator, TestSameAsSequential)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+    createStations(net, 8u);
+
+    PriorityPolicy priorities;
+    priorities.reset(net.transitions().size());
+    for (size_t t = 0u; t < 16u; t += 4u)
+    {
+        priorities.priority(t, 1);
+    }
+
+    TimedSimulator sequential(net);
+    sequential.policy(priorities.clone());
+    ParallelSimulator parallel(net, 4u);
+    parallel.policy(priorities);
+    compare(sequential, parallel);
+    ASSERT_GT(parallel.firings(), 100u);
+    ASSERT_GT(parallel.nullMessages(), 0u);
+
+    // Default random policy: each conflict cluster draws from its own
+    // generator, whatever the partition simulating it.
+    TimedSimulator random_sequential(net);
+    random_sequential.seed(42u);
+    ParallelSimulator random_parallel(net, 4u);
+    random_parallel.seed(42u);
+    compare(random_sequential, random_parallel);
+    ASSERT_GT(random_parallel.firings(), 100u);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestParallelSimulator, TestHoldingTimes)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+    createStations(net, 12u);
+
+    TimedSimulator sequential(net);
+    sequential.policy(std::unique_ptr<FiringPolicy>(new FifoPolicy()));
+    sequential.holding(6u, 1.25f);
+    sequential.holding(9u, 0.5f);
+    ParallelSimulator parallel(net, 3u);
+    parallel.policy(FifoPolicy());
+    parallel.holding(6u, 1.25f);
+    parallel.holding(9u, 0.5f);
+    ASSERT_EQ(parallel.partitions(), 3u);
+    compare(sequential, parallel);
+}
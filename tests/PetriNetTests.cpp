@@ -38,8 +38,8 @@ TEST(TestPetriNet, TestNodeCreation)
     ASSERT_EQ(n1.type, Node::Place);
     ASSERT_EQ(n1.x, 3.5f);
     ASSERT_EQ(n1.y, 4.0f);
-    ASSERT_STREQ(n1.key.c_str(), "P2");
-    ASSERT_STREQ(n1.caption.c_str(), "P2");
+    ASSERT_STREQ(n1.key().c_str(), "P2");
+    ASSERT_STREQ(n1.caption().c_str(), "P2");
     ASSERT_EQ(n1.arcsIn.size(), 0u);
     ASSERT_EQ(n1.arcsOut.size(), 0u);
 
@@ -49,8 +49,8 @@ TEST(TestPetriNet, TestNodeCreation)
     ASSERT_EQ(n2.type, Node::Transition);
     ASSERT_EQ(n2.x, 4.0f);
     ASSERT_EQ(n2.y, 3.5f);
-    ASSERT_STREQ(n2.key.c_str(), "T42");
-    ASSERT_STREQ(n2.caption.c_str(), "hello");
+    ASSERT_STREQ(n2.key().c_str(), "T42");
+    ASSERT_STREQ(n2.caption().c_str(), "hello");
     ASSERT_EQ(n2.arcsIn.size(), 0u);
     ASSERT_EQ(n2.arcsOut.size(), 0u);
 
@@ -67,8 +67,8 @@ TEST(TestPetriNet, TestNodeCreation)
     ASSERT_EQ(n1.type, Node::Transition);
     ASSERT_EQ(n1.x, 4.0f);
     ASSERT_EQ(n1.y, 3.5f);
-    ASSERT_STREQ(n1.key.c_str(), "T42");
-    ASSERT_STREQ(n1.caption.c_str(), "hello");
+    ASSERT_STREQ(n1.key().c_str(), "T42");
+    ASSERT_STREQ(n1.caption().c_str(), "hello");
     ASSERT_EQ(n1.arcsIn.size(), 0u);
     ASSERT_EQ(n1.arcsOut.size(), 0u);
 
@@ -78,8 +78,8 @@ TEST(TestPetriNet, TestNodeCreation)
     ASSERT_EQ(n4.type, Node::Transition);
     ASSERT_EQ(n4.x, 4.0f);
     ASSERT_EQ(n4.y, 3.5f);
-    ASSERT_STREQ(n4.key.c_str(), "T42");
-    ASSERT_STREQ(n4.caption.c_str(), "hello");
+    ASSERT_STREQ(n4.key().c_str(), "T42");
+    ASSERT_STREQ(n4.caption().c_str(), "hello");
     ASSERT_EQ(n4.arcsIn.size(), 0u);
     ASSERT_EQ(n4.arcsOut.size(), 0u);
 
@@ -99,8 +99,8 @@ TEST(TestPetriNet, TestPlaceCreation)
     ASSERT_EQ(p1.tokens, 12u);
     ASSERT_EQ(p1.x, 3.5f);
     ASSERT_EQ(p1.y, 4.0f);
-    ASSERT_STREQ(p1.key.c_str(), "P42");
-    ASSERT_STREQ(p1.caption.c_str(), "Hello");
+    ASSERT_STREQ(p1.key().c_str(), "P42");
+    ASSERT_STREQ(p1.caption().c_str(), "Hello");
     ASSERT_EQ(p1.arcsIn.size(), 0u);
     ASSERT_EQ(p1.arcsOut.size(), 0u);
 
@@ -111,8 +111,8 @@ TEST(TestPetriNet, TestPlaceCreation)
     ASSERT_EQ(p2.tokens, 12u);
     ASSERT_EQ(p2.x, 3.5f);
     ASSERT_EQ(p2.y, 4.0f);
-    ASSERT_STREQ(p2.key.c_str(), "P42");
-    ASSERT_STREQ(p2.caption.c_str(), "Hello");
+    ASSERT_STREQ(p2.key().c_str(), "P42");
+    ASSERT_STREQ(p2.caption().c_str(), "Hello");
     ASSERT_EQ(p2.arcsIn.size(), 0u);
     ASSERT_EQ(p2.arcsOut.size(), 0u);
 
@@ -131,8 +131,8 @@ TEST(TestPetriNet, TestPlaceCreation)
     ASSERT_EQ(p3.tokens, 12u);
     ASSERT_EQ(p3.x, 3.5f);
     ASSERT_EQ(p3.y, 4.0f);
-    ASSERT_STREQ(p3.key.c_str(), "P42");
-    ASSERT_STREQ(p3.caption.c_str(), "Hello");
+    ASSERT_STREQ(p3.key().c_str(), "P42");
+    ASSERT_STREQ(p3.caption().c_str(), "Hello");
     ASSERT_EQ(p3.arcsIn.size(), 0u);
     ASSERT_EQ(p3.arcsOut.size(), 0u);
 
@@ -152,8 +152,8 @@ TEST(TestPetriNet, TestTransitionCreation)
     ASSERT_EQ(t1.x, 3.5f);
     ASSERT_EQ(t1.y, 4.0f);
     ASSERT_EQ(t1.receptivity, false);
-    ASSERT_STREQ(t1.key.c_str(), "T42");
-    ASSERT_STREQ(t1.caption.c_str(), "Hello");
+    ASSERT_STREQ(t1.key().c_str(), "T42");
+    ASSERT_STREQ(t1.caption().c_str(), "Hello");
     ASSERT_EQ(t1.arcsIn.size(), 0u);
     ASSERT_EQ(t1.arcsOut.size(), 0u);
     ASSERT_EQ(t1.isFireable(), false);
@@ -169,8 +169,8 @@ TEST(TestPetriNet, TestTransitionCreation)
     ASSERT_EQ(t2.x, 3.5f);
     ASSERT_EQ(t2.y, 4.0f);
     ASSERT_EQ(t2.receptivity, false);
-    ASSERT_STREQ(t2.key.c_str(), "T42");
-    ASSERT_STREQ(t2.caption.c_str(), "Hello");
+    ASSERT_STREQ(t2.key().c_str(), "T42");
+    ASSERT_STREQ(t2.caption().c_str(), "Hello");
     ASSERT_EQ(t2.arcsIn.size(), 0u);
     ASSERT_EQ(t2.arcsOut.size(), 0u);
     ASSERT_EQ(t2.isFireable(), false);
@@ -193,8 +193,8 @@ TEST(TestPetriNet, TestTransitionCreation)
     ASSERT_EQ(t3.x, 3.5f);
     ASSERT_EQ(t3.y, 4.0f);
     ASSERT_EQ(t3.receptivity, false);
-    ASSERT_STREQ(t3.key.c_str(), "T42");
-    ASSERT_STREQ(t3.caption.c_str(), "Hello");
+    ASSERT_STREQ(t3.key().c_str(), "T42");
+    ASSERT_STREQ(t3.caption().c_str(), "Hello");
     ASSERT_EQ(t3.arcsIn.size(), 0u);
     ASSERT_EQ(t3.arcsOut.size(), 0u);
     ASSERT_EQ(t3.isFireable(), false);
@@ -220,16 +220,16 @@ TEST(TestPetriNet, TestArcCreation)
     ASSERT_EQ(a1.from.type, Node::Transition);
     ASSERT_EQ(a1.from.x, 3.5f);
     ASSERT_EQ(a1.from.y, 4.0f);
-    ASSERT_STREQ(a1.from.key.c_str(), "T42");
-    ASSERT_STREQ(a1.from.caption.c_str(), "T42");
+    ASSERT_STREQ(a1.from.key().c_str(), "T42");
+    ASSERT_STREQ(a1.from.caption().c_str(), "T42");
     ASSERT_EQ(a1.from.arcsIn.size(), 0u);
     ASSERT_EQ(a1.from.arcsOut.size(), 0u);
     ASSERT_EQ(a1.to.id, 43u);
     ASSERT_EQ(a1.to.type, Node::Place);
     ASSERT_EQ(a1.to.x, 4.6f);
     ASSERT_EQ(a1.to.y, 5.1f);
-    ASSERT_STREQ(a1.to.key.c_str(), "P43");
-    ASSERT_STREQ(a1.to.caption.c_str(), "P43");
+    ASSERT_STREQ(a1.to.key().c_str(), "P43");
+    ASSERT_STREQ(a1.to.caption().c_str(), "P43");
     ASSERT_EQ(a1.to.arcsIn.size(), 0u);
     ASSERT_EQ(a1.to.arcsOut.size(), 0u);
     ASSERT_EQ(reinterpret_cast<Transition&>(a1.from).angle, 45);
@@ -243,16 +243,16 @@ TEST(TestPetriNet, TestArcCreation)
     ASSERT_EQ(a2.to.type, Node::Transition);
     ASSERT_EQ(a2.to.x, 3.5f);
     ASSERT_EQ(a2.to.y, 4.0f);
-    ASSERT_STREQ(a2.to.key.c_str(), "T42");
-    ASSERT_STREQ(a2.to.caption.c_str(), "T42");
+    ASSERT_STREQ(a2.to.key().c_str(), "T42");
+    ASSERT_STREQ(a2.to.caption().c_str(), "T42");
     ASSERT_EQ(a2.to.arcsIn.size(), 0u);
     ASSERT_EQ(a2.to.arcsOut.size(), 0u);
     ASSERT_EQ(a2.from.id, 43u);
     ASSERT_EQ(a2.from.type, Node::Place);
     ASSERT_EQ(a2.from.x, 4.6f);
     ASSERT_EQ(a2.from.y, 5.1f);
-    ASSERT_STREQ(a2.from.key.c_str(), "P43");
-    ASSERT_STREQ(a2.from.caption.c_str(), "P43");
+    ASSERT_STREQ(a2.from.key().c_str(), "P43");
+    ASSERT_STREQ(a2.from.caption().c_str(), "P43");
     ASSERT_EQ(a2.from.arcsIn.size(), 0u);
     ASSERT_EQ(a2.from.arcsOut.size(), 0u);
     ASSERT_EQ(reinterpret_cast<Transition&>(a2.to).angle, 45);
@@ -270,16 +270,16 @@ TEST(TestPetriNet, TestArcCreation)
     ASSERT_EQ(a3.from.type, Node::Transition);
     ASSERT_EQ(a3.from.x, 3.5f);
     ASSERT_EQ(a3.from.y, 4.0f);
-    ASSERT_STREQ(a3.from.key.c_str(), "T42");
-    ASSERT_STREQ(a3.from.caption.c_str(), "T42");
+    ASSERT_STREQ(a3.from.key().c_str(), "T42");
+    ASSERT_STREQ(a3.from.caption().c_str(), "T42");
     ASSERT_EQ(a3.from.arcsIn.size(), 0u);
     ASSERT_EQ(a3.from.arcsOut.size(), 0u);
     ASSERT_EQ(a3.to.id, 43u);
     ASSERT_EQ(a3.to.type, Node::Place);
     ASSERT_EQ(a3.to.x, 4.6f);
     ASSERT_EQ(a3.to.y, 5.1f);
-    ASSERT_STREQ(a3.to.key.c_str(), "P43");
-    ASSERT_STREQ(a3.to.caption.c_str(), "P43");
+    ASSERT_STREQ(a3.to.key().c_str(), "P43");
+    ASSERT_STREQ(a3.to.caption().c_str(), "P43");
     ASSERT_EQ(a3.to.arcsIn.size(), 0u);
     ASSERT_EQ(a3.to.arcsOut.size(), 0u);
     ASSERT_EQ(reinterpret_cast<Transition&>(a3.from).angle, 45);
@@ -294,16 +294,16 @@ TEST(TestPetriNet, TestArcCreation)
     ASSERT_EQ(a4.from.type, Node::Transition);
     ASSERT_EQ(a4.from.x, 3.5f);
     ASSERT_EQ(a4.from.y, 4.0f);
-    ASSERT_STREQ(a4.from.key.c_str(), "T42");
-    ASSERT_STREQ(a4.from.caption.c_str(), "T42");
+    ASSERT_STREQ(a4.from.key().c_str(), "T42");
+    ASSERT_STREQ(a4.from.caption().c_str(), "T42");
     ASSERT_EQ(a4.from.arcsIn.size(), 0u);
     ASSERT_EQ(a4.from.arcsOut.size(), 0u);
     ASSERT_EQ(a4.to.id, 43u);
     ASSERT_EQ(a4.to.type, Node::Place);
     ASSERT_EQ(a4.to.x, 4.6f);
     ASSERT_EQ(a4.to.y, 5.1f);
-    ASSERT_STREQ(a4.to.key.c_str(), "P43");
-    ASSERT_STREQ(a4.to.caption.c_str(), "P43");
+    ASSERT_STREQ(a4.to.key().c_str(), "P43");
+    ASSERT_STREQ(a4.to.caption().c_str(), "P43");
     ASSERT_EQ(a4.to.arcsIn.size(), 0u);
     ASSERT_EQ(a4.to.arcsOut.size(), 0u);
     ASSERT_EQ(reinterpret_cast<Transition&>(a4.from).angle, 45);
@@ -416,41 +416,41 @@ TEST(TestPetriNet, TestAddRemoveOperations)
     Place& p0 = net.addPlace(3.14f, 2.16f, 10u);
     ASSERT_EQ(net.m_next_place_id, 1u);
     ASSERT_EQ(p0.id, 0u);
-    ASSERT_STREQ(p0.key.c_str(), "P0");
-    ASSERT_STREQ(p0.caption.c_str(), "P0");
+    ASSERT_STREQ(p0.key().c_str(), "P0");
+    ASSERT_STREQ(p0.caption().c_str(), "P0");
     ASSERT_EQ(net.isEmpty(), false);
     ASSERT_EQ(isEventGraph(net, error, erroneous_arcs), false);
     ASSERT_STREQ(error.c_str(), "The Petri net is not an event graph. Because:\n  P0 has no output arc\n  P0 has no input arc\n");
     ASSERT_EQ(erroneous_arcs.empty(), true);
     ASSERT_EQ(net.findNode("P0"), &p0);
     ASSERT_EQ(net.m_places.size(), 1u);
-    ASSERT_STREQ(net.m_places[0].key.c_str(), "P0");
+    ASSERT_STREQ(net.m_places[0].key().c_str(), "P0");
 
     // Add Transition 0: net = P0 T0
     Transition* t0 = &net.addTransition(3.14f, 2.16f);
     ASSERT_EQ(net.m_next_transition_id, 1u);
     ASSERT_EQ(t0->id, 0u);
-    ASSERT_STREQ(t0->key.c_str(), "T0");
-    ASSERT_STREQ(t0->caption.c_str(), "T0");
+    ASSERT_STREQ(t0->key().c_str(), "T0");
+    ASSERT_STREQ(t0->caption().c_str(), "T0");
     ASSERT_EQ(net.isEmpty(), false);
     ASSERT_EQ(isEventGraph(net, error, erroneous_arcs), false);
     ASSERT_STREQ(error.c_str(), "The Petri net is not an event graph. Because:\n  P0 has no output arc\n  P0 has no input arc\n");
     ASSERT_EQ(erroneous_arcs.empty(), true);
     ASSERT_EQ(net.findNode("T0"), t0);
     ASSERT_EQ(net.m_transitions.size(), 1u);
-    ASSERT_STREQ(net.m_transitions[0].key.c_str(), "T0");
+    ASSERT_STREQ(net.m_transitions[0].key().c_str(), "T0");
 
     // Add Place 1: net = P0 T0 P1
     Place& p1 = net.addPlace(3.14f, 2.16f, 10u);
     ASSERT_EQ(net.m_next_place_id, 2u);
     ASSERT_EQ(p1.id, 1u);
-    ASSERT_STREQ(p1.key.c_str(), "P1");
-    ASSERT_STREQ(p1.caption.c_str(), "P1");
+    ASSERT_STREQ(p1.key().c_str(), "P1");
+    ASSERT_STREQ(p1.caption().c_str(), "P1");
     ASSERT_EQ(net.findNode("P1"), &p1);
-    ASSERT_STREQ(net.m_places[0].key.c_str(), "P0");
-    ASSERT_STREQ(net.m_places[1].key.c_str(), "P1");
-    ASSERT_STREQ(net.m_places[0].caption.c_str(), "P0");
-    ASSERT_STREQ(net.m_places[1].caption.c_str(), "P1");
+    ASSERT_STREQ(net.m_places[0].key().c_str(), "P0");
+    ASSERT_STREQ(net.m_places[1].key().c_str(), "P1");
+    ASSERT_STREQ(net.m_places[0].caption().c_str(), "P0");
+    ASSERT_STREQ(net.m_places[1].caption().c_str(), "P1");
 
     // Add arcs: net = P0--T0--P1
     ASSERT_EQ(net.addArc(p0, *t0), true);
@@ -477,16 +477,16 @@ TEST(TestPetriNet, TestAddRemoveOperations)
     t0 = &net.addTransition(3.14f, 2.16f);
     ASSERT_EQ(net.m_next_transition_id, 1u);
     ASSERT_EQ(t0->id, 0u);
-    ASSERT_STREQ(t0->key.c_str(), "T0");
-    ASSERT_STREQ(t0->caption.c_str(), "T0");
+    ASSERT_STREQ(t0->key().c_str(), "T0");
+    ASSERT_STREQ(t0->caption().c_str(), "T0");
     ASSERT_EQ(net.isEmpty(), false);
     ASSERT_EQ(isEventGraph(net, error, erroneous_arcs), false);
     ASSERT_STREQ(error.c_str(), "The Petri net is not an event graph. Because:\n  P0 has no output arc\n  P0 has no input arc\n");
     ASSERT_EQ(erroneous_arcs.empty(), true);
     ASSERT_EQ(net.findNode("T0"), t0);
     ASSERT_EQ(net.m_transitions.size(), 1u);
-    ASSERT_STREQ(net.m_transitions[0].key.c_str(), "T0");
-    ASSERT_STREQ(net.m_transitions[0].caption.c_str(), "T0");
+    ASSERT_STREQ(net.m_transitions[0].key().c_str(), "T0");
+    ASSERT_STREQ(net.m_transitions[0].caption().c_str(), "T0");
 
     // Add arcs back: net = P0--T0--P1
     ASSERT_EQ(net.addArc(p0, *t0), true);
@@ -507,10 +507,10 @@ TEST(TestPetriNet, TestAddRemoveOperations)
     ASSERT_EQ(net.m_next_transition_id, 1u);
     ASSERT_EQ(net.m_arcs.size(), 1u);
     ASSERT_EQ(&net.m_arcs[0], a1); // a2 has been merged into a1
-    ASSERT_STREQ(net.m_arcs[0].from.key.c_str(), "T0");
-    ASSERT_STREQ(net.m_arcs[0].to.key.c_str(), "P1");
-    ASSERT_STREQ(net.m_arcs[0].from.caption.c_str(), "T0");
-    ASSERT_STREQ(net.m_arcs[0].to.caption.c_str(), "P1");
+    ASSERT_STREQ(net.m_arcs[0].from.key().c_str(), "T0");
+    ASSERT_STREQ(net.m_arcs[0].to.key().c_str(), "P1");
+    ASSERT_STREQ(net.m_arcs[0].from.caption().c_str(), "T0");
+    ASSERT_STREQ(net.m_arcs[0].to.caption().c_str(), "P1");
 
     // Remove P1: net = P0 T0
     net.removeNode(p1);
@@ -519,10 +519,10 @@ TEST(TestPetriNet, TestAddRemoveOperations)
     ASSERT_EQ(net.m_arcs.size(), 0u);
     ASSERT_EQ(net.m_places.size(), 1u);
     ASSERT_EQ(net.m_transitions.size(), 1u);
-    ASSERT_STREQ(net.m_places[0].key.c_str(), "P0");
-    ASSERT_STREQ(net.m_transitions[0].key.c_str(), "T0");
-    ASSERT_STREQ(net.m_places[0].caption.c_str(), "P0");
-    ASSERT_STREQ(net.m_transitions[0].caption.c_str(), "T0");
+    ASSERT_STREQ(net.m_places[0].key().c_str(), "P0");
+    ASSERT_STREQ(net.m_transitions[0].key().c_str(), "T0");
+    ASSERT_STREQ(net.m_places[0].caption().c_str(), "P0");
+    ASSERT_STREQ(net.m_transitions[0].caption().c_str(), "T0");
 
     // Remove P0: net = T0
     net.removeNode(p0);
@@ -531,8 +531,8 @@ TEST(TestPetriNet, TestAddRemoveOperations)
     ASSERT_EQ(net.m_arcs.size(), 0u);
     ASSERT_EQ(net.m_places.size(), 0u);
     ASSERT_EQ(net.m_transitions.size(), 1u);
-    ASSERT_STREQ(net.m_transitions[0].key.c_str(), "T0");
-    ASSERT_STREQ(net.m_transitions[0].caption.c_str(), "T0");
+    ASSERT_STREQ(net.m_transitions[0].key().c_str(), "T0");
+    ASSERT_STREQ(net.m_transitions[0].caption().c_str(), "T0");
 
     // Remove T0: net
     net.removeNode(*t0);
@@ -602,16 +602,16 @@ TEST(TestPetriNet, TestCaptionAfterRemove)
     net.addPlace(1u, "World", 1.0f, 1.5f, 42u);
 
     ASSERT_EQ(net.m_places.size(), 2u);
-    ASSERT_STREQ(net.m_places[0].key.c_str(), "P0");
-    ASSERT_STREQ(net.m_places[0].caption.c_str(), "Hello");
-    ASSERT_STREQ(net.m_places[1].key.c_str(), "P1");
-    ASSERT_STREQ(net.m_places[1].caption.c_str(), "World");
+    ASSERT_STREQ(net.m_places[0].key().c_str(), "P0");
+    ASSERT_STREQ(net.m_places[0].caption().c_str(), "Hello");
+    ASSERT_STREQ(net.m_places[1].key().c_str(), "P1");
+    ASSERT_STREQ(net.m_places[1].caption().c_str(), "World");
 
     // Remove P0 check P1 is now P0 but with its caption
     net.removeNode(p0);
     ASSERT_EQ(net.m_places.size(), 1u);
-    ASSERT_STREQ(net.m_places[0].key.c_str(), "P0");
-    ASSERT_STREQ(net.m_places[0].caption.c_str(), "World");
+    ASSERT_STREQ(net.m_places[0].key().c_str(), "P0");
+    ASSERT_STREQ(net.m_places[0].caption().c_str(), "World");
     ASSERT_EQ(net.m_places[0].x, 1.0f); // Attributes from P1
     ASSERT_EQ(net.m_places[0].y, 1.5f);
     ASSERT_EQ(net.m_places[0].tokens, 42u);
@@ -619,16 +619,16 @@ TEST(TestPetriNet, TestCaptionAfterRemove)
     // Add P2. Check we have P0 P2
     net.addPlace(2u, "", 2.0f, 2.5f, 24u);
     ASSERT_EQ(net.m_places.size(), 2u);
-    ASSERT_STREQ(net.m_places[0].key.c_str(), "P0");
-    ASSERT_STREQ(net.m_places[0].caption.c_str(), "World");
-    ASSERT_STREQ(net.m_places[1].key.c_str(), "P2");
-    ASSERT_STREQ(net.m_places[1].caption.c_str(), "P2");
+    ASSERT_STREQ(net.m_places[0].key().c_str(), "P0");
+    ASSERT_STREQ(net.m_places[0].caption().c_str(), "World");
+    ASSERT_STREQ(net.m_places[1].key().c_str(), "P2");
+    ASSERT_STREQ(net.m_places[1].caption().c_str(), "P2");
 
     // Remove P0 check P2 is now P0 but without its caption
     net.removeNode(net.m_places[0]);
     ASSERT_EQ(net.m_places.size(), 1u);
-    ASSERT_STREQ(net.m_places[0].key.c_str(), "P0");
-    ASSERT_STREQ(net.m_places[0].caption.c_str(), "P0");
+    ASSERT_STREQ(net.m_places[0].key().c_str(), "P0");
+    ASSERT_STREQ(net.m_places[0].caption().c_str(), "P0");
     ASSERT_EQ(net.m_places[0].x, 2.0f); // Attributes from P2
     ASSERT_EQ(net.m_places[0].y, 2.5f);
     ASSERT_EQ(net.m_places[0].tokens, 24u);
@@ -646,8 +646,8 @@ TEST(TestPetriNet, TestDoubleAdd)
     /*Place& p2 =*/ net.addPlace(42u, "", 3.5f, 4.0f, 45u);
     ASSERT_EQ(net.m_next_place_id, 43u);
     ASSERT_EQ(net.m_next_transition_id, 0u);
-    ASSERT_STREQ(net.m_places[0].key.c_str(), "P42");
-    ASSERT_STREQ(net.m_places[1].key.c_str(), "P42");
+    ASSERT_STREQ(net.m_places[0].key().c_str(), "P42");
+    ASSERT_STREQ(net.m_places[1].key().c_str(), "P42");
 
     Transition& t1 = net.addTransition(43u, "", 3.5f, 4.0f, 45u);
     ASSERT_EQ(net.m_next_place_id, 43u);
@@ -657,8 +657,8 @@ TEST(TestPetriNet, TestDoubleAdd)
     ASSERT_EQ(net.isEmpty(), false);
     ASSERT_EQ(net.m_next_place_id, 43u);
     ASSERT_EQ(net.m_next_transition_id, 44u);
-    ASSERT_STREQ(net.m_transitions[0].key.c_str(), "T43");
-    ASSERT_STREQ(net.m_transitions[1].key.c_str(), "T43");
+    ASSERT_STREQ(net.m_transitions[0].key().c_str(), "T43");
+    ASSERT_STREQ(net.m_transitions[1].key().c_str(), "T43");
 
     ASSERT_EQ(net.addArc(t1, p1), true);
     ASSERT_EQ(net.m_next_place_id, 43u);
@@ -742,193 +742,193 @@ TEST(TestPetriNet, TestLoadedNetTimedPetri)
 
     // Check places
     ASSERT_EQ(net.m_places[0].id, 0u);
-    ASSERT_STREQ(net.m_places[0].key.c_str(), "P0");
-    ASSERT_STREQ(net.m_places[0].caption.c_str(), "P0");
+    ASSERT_STREQ(net.m_places[0].key().c_str(), "P0");
+    ASSERT_STREQ(net.m_places[0].caption().c_str(), "P0");
     ASSERT_EQ(net.m_places[0].type, Node::Place);
     ASSERT_EQ(net.m_places[0].tokens, 2u);
     ASSERT_EQ(net.m_places[0].arcsIn.size(), 1u);
     ASSERT_EQ(net.m_places[0].arcsOut.size(), 1u);
-    ASSERT_STREQ(net.m_places[0].arcsIn[0]->from.key.c_str(), "T0");
-    ASSERT_STREQ(net.m_places[0].arcsIn[0]->to.key.c_str(), "P0");
-    ASSERT_STREQ(net.m_places[0].arcsOut[0]->from.key.c_str(), "P0");
-    ASSERT_STREQ(net.m_places[0].arcsOut[0]->to.key.c_str(), "T2");
+    ASSERT_STREQ(net.m_places[0].arcsIn[0]->from.key().c_str(), "T0");
+    ASSERT_STREQ(net.m_places[0].arcsIn[0]->to.key().c_str(), "P0");
+    ASSERT_STREQ(net.m_places[0].arcsOut[0]->from.key().c_str(), "P0");
+    ASSERT_STREQ(net.m_places[0].arcsOut[0]->to.key().c_str(), "T2");
 
     ASSERT_EQ(net.m_places[1].id, 1u);
-    ASSERT_STREQ(net.m_places[1].key.c_str(), "P1");
-    ASSERT_STREQ(net.m_places[1].caption.c_str(), "P1");
+    ASSERT_STREQ(net.m_places[1].key().c_str(), "P1");
+    ASSERT_STREQ(net.m_places[1].caption().c_str(), "P1");
     ASSERT_EQ(net.m_places[1].type, Node::Place);
     ASSERT_EQ(net.m_places[1].tokens, 0u);
     ASSERT_EQ(net.m_places[1].arcsIn.size(), 1u);
     ASSERT_EQ(net.m_places[1].arcsOut.size(), 1u);
-    ASSERT_STREQ(net.m_places[1].arcsIn[0]->from.key.c_str(), "T1");
-    ASSERT_STREQ(net.m_places[1].arcsIn[0]->to.key.c_str(), "P1");
-    ASSERT_STREQ(net.m_places[1].arcsOut[0]->from.key.c_str(), "P1");
-    ASSERT_STREQ(net.m_places[1].arcsOut[0]->to.key.c_str(), "T0");
+    ASSERT_STREQ(net.m_places[1].arcsIn[0]->from.key().c_str(), "T1");
+    ASSERT_STREQ(net.m_places[1].arcsIn[0]->to.key().c_str(), "P1");
+    ASSERT_STREQ(net.m_places[1].arcsOut[0]->from.key().c_str(), "P1");
+    ASSERT_STREQ(net.m_places[1].arcsOut[0]->to.key().c_str(), "T0");
 
     ASSERT_EQ(net.m_places[2].id, 2u);
-    ASSERT_STREQ(net.m_places[2].key.c_str(), "P2");
-    ASSERT_STREQ(net.m_places[2].caption.c_str(), "P2");
+    ASSERT_STREQ(net.m_places[2].key().c_str(), "P2");
+    ASSERT_STREQ(net.m_places[2].caption().c_str(), "P2");
     ASSERT_EQ(net.m_places[2].type, Node::Place);
     ASSERT_EQ(net.m_places[2].tokens, 0u);
     ASSERT_EQ(net.m_places[2].arcsIn.size(), 1u);
     ASSERT_EQ(net.m_places[2].arcsOut.size(), 1u);
-    ASSERT_STREQ(net.m_places[2].arcsIn[0]->from.key.c_str(), "T2");
-    ASSERT_STREQ(net.m_places[2].arcsIn[0]->to.key.c_str(), "P2");
-    ASSERT_STREQ(net.m_places[2].arcsOut[0]->from.key.c_str(), "P2");
-    ASSERT_STREQ(net.m_places[2].arcsOut[0]->to.key.c_str(), "T1");
+    ASSERT_STREQ(net.m_places[2].arcsIn[0]->from.key().c_str(), "T2");
+    ASSERT_STREQ(net.m_places[2].arcsIn[0]->to.key().c_str(), "P2");
+    ASSERT_STREQ(net.m_places[2].arcsOut[0]->from.key().c_str(), "P2");
+    ASSERT_STREQ(net.m_places[2].arcsOut[0]->to.key().c_str(), "T1");
 
     ASSERT_EQ(net.m_places[3].id, 3u);
-    ASSERT_STREQ(net.m_places[3].key.c_str(), "P3");
-    ASSERT_STREQ(net.m_places[3].caption.c_str(), "P3");
+    ASSERT_STREQ(net.m_places[3].key().c_str(), "P3");
+    ASSERT_STREQ(net.m_places[3].caption().c_str(), "P3");
     ASSERT_EQ(net.m_places[3].type, Node::Place);
     ASSERT_EQ(net.m_places[3].tokens, 0u);
     ASSERT_EQ(net.m_places[3].arcsIn.size(), 1u);
     ASSERT_EQ(net.m_places[3].arcsOut.size(), 1u);
-    ASSERT_STREQ(net.m_places[3].arcsIn[0]->from.key.c_str(), "T3");
-    ASSERT_STREQ(net.m_places[3].arcsIn[0]->to.key.c_str(), "P3");
-    ASSERT_STREQ(net.m_places[3].arcsOut[0]->from.key.c_str(), "P3");
-    ASSERT_STREQ(net.m_places[3].arcsOut[0]->to.key.c_str(), "T0");
+    ASSERT_STREQ(net.m_places[3].arcsIn[0]->from.key().c_str(), "T3");
+    ASSERT_STREQ(net.m_places[3].arcsIn[0]->to.key().c_str(), "P3");
+    ASSERT_STREQ(net.m_places[3].arcsOut[0]->from.key().c_str(), "P3");
+    ASSERT_STREQ(net.m_places[3].arcsOut[0]->to.key().c_str(), "T0");
 
     ASSERT_EQ(net.m_places[4].id, 4u);
-    ASSERT_STREQ(net.m_places[4].key.c_str(), "P4");
-    ASSERT_STREQ(net.m_places[4].caption.c_str(), "P4");
+    ASSERT_STREQ(net.m_places[4].key().c_str(), "P4");
+    ASSERT_STREQ(net.m_places[4].caption().c_str(), "P4");
     ASSERT_EQ(net.m_places[4].type, Node::Place);
     ASSERT_EQ(net.m_places[4].tokens, 0u);
     ASSERT_EQ(net.m_places[4].arcsIn.size(), 1u);
     ASSERT_EQ(net.m_places[4].arcsOut.size(), 1u);
-    ASSERT_STREQ(net.m_places[4].arcsIn[0]->from.key.c_str(), "T2");
-    ASSERT_STREQ(net.m_places[4].arcsIn[0]->to.key.c_str(), "P4");
-    ASSERT_STREQ(net.m_places[4].arcsOut[0]->from.key.c_str(), "P4");
-    ASSERT_STREQ(net.m_places[4].arcsOut[0]->to.key.c_str(), "T3");
+    ASSERT_STREQ(net.m_places[4].arcsIn[0]->from.key().c_str(), "T2");
+    ASSERT_STREQ(net.m_places[4].arcsIn[0]->to.key().c_str(), "P4");
+    ASSERT_STREQ(net.m_places[4].arcsOut[0]->from.key().c_str(), "P4");
+    ASSERT_STREQ(net.m_places[4].arcsOut[0]->to.key().c_str(), "T3");
 
     // Check transitions
     ASSERT_EQ(net.m_transitions[0].id, 0u);
-    ASSERT_STREQ(net.m_transitions[0].key.c_str(), "T0");
-    ASSERT_STREQ(net.m_transitions[0].caption.c_str(), "T0");
+    ASSERT_STREQ(net.m_transitions[0].key().c_str(), "T0");
+    ASSERT_STREQ(net.m_transitions[0].caption().c_str(), "T0");
     ASSERT_EQ(net.m_transitions[0].type, Node::Transition);
     ASSERT_EQ(net.m_transitions[0].arcsIn.size(), 2u);
     ASSERT_EQ(net.m_transitions[0].arcsOut.size(), 1u);
-    ASSERT_STREQ(net.m_transitions[0].arcsOut[0]->from.key.c_str(), "T0");
-    ASSERT_STREQ(net.m_transitions[0].arcsOut[0]->to.key.c_str(), "P0");
-    ASSERT_STREQ(net.m_transitions[0].arcsIn[0]->from.key.c_str(), "P3");
-    ASSERT_STREQ(net.m_transitions[0].arcsIn[0]->to.key.c_str(), "T0");
-    ASSERT_STREQ(net.m_transitions[0].arcsIn[1]->from.key.c_str(), "P1");
-    ASSERT_STREQ(net.m_transitions[0].arcsIn[1]->to.key.c_str(), "T0");
+    ASSERT_STREQ(net.m_transitions[0].arcsOut[0]->from.key().c_str(), "T0");
+    ASSERT_STREQ(net.m_transitions[0].arcsOut[0]->to.key().c_str(), "P0");
+    ASSERT_STREQ(net.m_transitions[0].arcsIn[0]->from.key().c_str(), "P3");
+    ASSERT_STREQ(net.m_transitions[0].arcsIn[0]->to.key().c_str(), "T0");
+    ASSERT_STREQ(net.m_transitions[0].arcsIn[1]->from.key().c_str(), "P1");
+    ASSERT_STREQ(net.m_transitions[0].arcsIn[1]->to.key().c_str(), "T0");
 
     ASSERT_EQ(net.m_transitions[1].id, 1u);
-    ASSERT_STREQ(net.m_transitions[1].key.c_str(), "T1");
-    ASSERT_STREQ(net.m_transitions[1].caption.c_str(), "T1");
+    ASSERT_STREQ(net.m_transitions[1].key().c_str(), "T1");
+    ASSERT_STREQ(net.m_transitions[1].caption().c_str(), "T1");
     ASSERT_EQ(net.m_transitions[1].type, Node::Transition);
     ASSERT_EQ(net.m_transitions[1].arcsIn.size(), 1u);
     ASSERT_EQ(net.m_transitions[1].arcsOut.size(), 1u);
-    ASSERT_STREQ(net.m_transitions[1].arcsIn[0]->from.key.c_str(), "P2");
-    ASSERT_STREQ(net.m_transitions[1].arcsIn[0]->to.key.c_str(), "T1");
-    ASSERT_STREQ(net.m_transitions[1].arcsOut[0]->from.key.c_str(), "T1");
-    ASSERT_STREQ(net.m_transitions[1].arcsOut[0]->to.key.c_str(), "P1");
+    ASSERT_STREQ(net.m_transitions[1].arcsIn[0]->from.key().c_str(), "P2");
+    ASSERT_STREQ(net.m_transitions[1].arcsIn[0]->to.key().c_str(), "T1");
+    ASSERT_STREQ(net.m_transitions[1].arcsOut[0]->from.key().c_str(), "T1");
+    ASSERT_STREQ(net.m_transitions[1].arcsOut[0]->to.key().c_str(), "P1");
 
     ASSERT_EQ(net.m_transitions[2].id, 2u);
-    ASSERT_STREQ(net.m_transitions[2].key.c_str(), "T2");
-    ASSERT_STREQ(net.m_transitions[2].caption.c_str(), "T2");
+    ASSERT_STREQ(net.m_transitions[2].key().c_str(), "T2");
+    ASSERT_STREQ(net.m_transitions[2].caption().c_str(), "T2");
     ASSERT_EQ(net.m_transitions[2].type, Node::Transition);
     ASSERT_EQ(net.m_transitions[2].arcsIn.size(), 1u);
     ASSERT_EQ(net.m_transitions[2].arcsOut.size(), 2u);
-    ASSERT_STREQ(net.m_transitions[2].arcsOut[0]->from.key.c_str(), "T2");
-    ASSERT_STREQ(net.m_transitions[2].arcsOut[0]->to.key.c_str(), "P2");
-    ASSERT_STREQ(net.m_transitions[2].arcsOut[1]->from.key.c_str(), "T2");
-    ASSERT_STREQ(net.m_transitions[2].arcsOut[1]->to.key.c_str(), "P4");
-    ASSERT_STREQ(net.m_transitions[2].arcsIn[0]->from.key.c_str(), "P0");
-    ASSERT_STREQ(net.m_transitions[2].arcsIn[0]->to.key.c_str(), "T2");
+    ASSERT_STREQ(net.m_transitions[2].arcsOut[0]->from.key().c_str(), "T2");
+    ASSERT_STREQ(net.m_transitions[2].arcsOut[0]->to.key().c_str(), "P2");
+    ASSERT_STREQ(net.m_transitions[2].arcsOut[1]->from.key().c_str(), "T2");
+    ASSERT_STREQ(net.m_transitions[2].arcsOut[1]->to.key().c_str(), "P4");
+    ASSERT_STREQ(net.m_transitions[2].arcsIn[0]->from.key().c_str(), "P0");
+    ASSERT_STREQ(net.m_transitions[2].arcsIn[0]->to.key().c_str(), "T2");
 
     ASSERT_EQ(net.m_transitions[3].id, 3u);
-    ASSERT_STREQ(net.m_transitions[3].key.c_str(), "T3");
-    ASSERT_STREQ(net.m_transitions[3].caption.c_str(), "T3");
+    ASSERT_STREQ(net.m_transitions[3].key().c_str(), "T3");
+    ASSERT_STREQ(net.m_transitions[3].caption().c_str(), "T3");
     ASSERT_EQ(net.m_transitions[3].type, Node::Transition);
     ASSERT_EQ(net.m_transitions[3].arcsIn.size(), 1u);
     ASSERT_EQ(net.m_transitions[3].arcsOut.size(), 1u);
-    ASSERT_STREQ(net.m_transitions[3].arcsIn[0]->from.key.c_str(), "P4");
-    ASSERT_STREQ(net.m_transitions[3].arcsIn[0]->to.key.c_str(), "T3");
-    ASSERT_STREQ(net.m_transitions[3].arcsOut[0]->from.key.c_str(), "T3");
-    ASSERT_STREQ(net.m_transitions[3].arcsOut[0]->to.key.c_str(), "P3");
+    ASSERT_STREQ(net.m_transitions[3].arcsIn[0]->from.key().c_str(), "P4");
+    ASSERT_STREQ(net.m_transitions[3].arcsIn[0]->to.key().c_str(), "T3");
+    ASSERT_STREQ(net.m_transitions[3].arcsOut[0]->from.key().c_str(), "T3");
+    ASSERT_STREQ(net.m_transitions[3].arcsOut[0]->to.key().c_str(), "P3");
 
     // Check arcs
     ASSERT_EQ(net.m_arcs[0].from.id, 3u);
     ASSERT_EQ(net.m_arcs[0].from.type, Node::Place);
-    ASSERT_STREQ(net.m_arcs[0].from.key.c_str(), "P3");
+    ASSERT_STREQ(net.m_arcs[0].from.key().c_str(), "P3");
     ASSERT_EQ(net.m_arcs[0].to.id, 0u);
     ASSERT_EQ(net.m_arcs[0].to.type, Node::Transition);
-    ASSERT_STREQ(net.m_arcs[0].to.key.c_str(), "T0");
+    ASSERT_STREQ(net.m_arcs[0].to.key().c_str(), "T0");
     ASSERT_EQ(isnan(net.m_arcs[0].duration), true); // FIXME forcer json a NAN ?
 
     ASSERT_EQ(net.m_arcs[1].from.id, 1u);
     ASSERT_EQ(net.m_arcs[1].from.type, Node::Place);
-    ASSERT_STREQ(net.m_arcs[1].from.key.c_str(), "P1");
+    ASSERT_STREQ(net.m_arcs[1].from.key().c_str(), "P1");
     ASSERT_EQ(net.m_arcs[1].to.id, 0u);
     ASSERT_EQ(net.m_arcs[1].to.type, Node::Transition);
-    ASSERT_STREQ(net.m_arcs[1].to.key.c_str(), "T0");
+    ASSERT_STREQ(net.m_arcs[1].to.key().c_str(), "T0");
     ASSERT_EQ(isnan(net.m_arcs[1].duration), true);
 
     ASSERT_EQ(net.m_arcs[2].from.id, 0u);
     ASSERT_EQ(net.m_arcs[2].from.type, Node::Transition);
-    ASSERT_STREQ(net.m_arcs[2].from.key.c_str(), "T0");
+    ASSERT_STREQ(net.m_arcs[2].from.key().c_str(), "T0");
     ASSERT_EQ(net.m_arcs[2].to.id, 0u);
     ASSERT_EQ(net.m_arcs[2].to.type, Node::Place);
-    ASSERT_STREQ(net.m_arcs[2].to.key.c_str(), "P0");
+    ASSERT_STREQ(net.m_arcs[2].to.key().c_str(), "P0");
     ASSERT_EQ(net.m_arcs[2].duration, 5u);
 
     ASSERT_EQ(net.m_arcs[3].from.id, 0u);
     ASSERT_EQ(net.m_arcs[3].from.type, Node::Place);
-    ASSERT_STREQ(net.m_arcs[3].from.key.c_str(), "P0");
+    ASSERT_STREQ(net.m_arcs[3].from.key().c_str(), "P0");
     ASSERT_EQ(net.m_arcs[3].to.id, 2u);
     ASSERT_EQ(net.m_arcs[3].to.type, Node::Transition);
-    ASSERT_STREQ(net.m_arcs[3].to.key.c_str(), "T2");
+    ASSERT_STREQ(net.m_arcs[3].to.key().c_str(), "T2");
     ASSERT_EQ(isnan(net.m_arcs[3].duration), true);
 
     ASSERT_EQ(net.m_arcs[4].from.id, 2u);
     ASSERT_EQ(net.m_arcs[4].from.type, Node::Transition);
-    ASSERT_STREQ(net.m_arcs[4].from.key.c_str(), "T2");
+    ASSERT_STREQ(net.m_arcs[4].from.key().c_str(), "T2");
     ASSERT_EQ(net.m_arcs[4].to.id, 2u);
     ASSERT_EQ(net.m_arcs[4].to.type, Node::Place);
-    ASSERT_STREQ(net.m_arcs[4].to.key.c_str(), "P2");
+    ASSERT_STREQ(net.m_arcs[4].to.key().c_str(), "P2");
     ASSERT_EQ(net.m_arcs[4].duration, 3u);
 
     ASSERT_EQ(net.m_arcs[5].from.id, 2u);
     ASSERT_EQ(net.m_arcs[5].from.type, Node::Place);
-    ASSERT_STREQ(net.m_arcs[5].from.key.c_str(), "P2");
+    ASSERT_STREQ(net.m_arcs[5].from.key().c_str(), "P2");
     ASSERT_EQ(net.m_arcs[5].to.id, 1u);
     ASSERT_EQ(net.m_arcs[5].to.type, Node::Transition);
-    ASSERT_STREQ(net.m_arcs[5].to.key.c_str(), "T1");
+    ASSERT_STREQ(net.m_arcs[5].to.key().c_str(), "T1");
     ASSERT_EQ(isnan(net.m_arcs[5].duration), true);
 
     ASSERT_EQ(net.m_arcs[6].from.id, 1u);
     ASSERT_EQ(net.m_arcs[6].from.type, Node::Transition);
-    ASSERT_STREQ(net.m_arcs[6].from.key.c_str(), "T1");
+    ASSERT_STREQ(net.m_arcs[6].from.key().c_str(), "T1");
     ASSERT_EQ(net.m_arcs[6].to.id, 1u);
     ASSERT_EQ(net.m_arcs[6].to.type, Node::Place);
-    ASSERT_STREQ(net.m_arcs[6].to.key.c_str(), "P1");
+    ASSERT_STREQ(net.m_arcs[6].to.key().c_str(), "P1");
     ASSERT_EQ(net.m_arcs[6].duration, 5u);
 
     ASSERT_EQ(net.m_arcs[7].from.id, 2u);
     ASSERT_EQ(net.m_arcs[7].from.type, Node::Transition);
-    ASSERT_STREQ(net.m_arcs[7].from.key.c_str(), "T2");
+    ASSERT_STREQ(net.m_arcs[7].from.key().c_str(), "T2");
     ASSERT_EQ(net.m_arcs[7].to.id, 4u);
     ASSERT_EQ(net.m_arcs[7].to.type, Node::Place);
-    ASSERT_STREQ(net.m_arcs[7].to.key.c_str(), "P4");
+    ASSERT_STREQ(net.m_arcs[7].to.key().c_str(), "P4");
     ASSERT_EQ(net.m_arcs[7].duration, 1u);
 
     ASSERT_EQ(net.m_arcs[8].from.id, 4u);
     ASSERT_EQ(net.m_arcs[8].from.type, Node::Place);
-    ASSERT_STREQ(net.m_arcs[8].from.key.c_str(), "P4");
+    ASSERT_STREQ(net.m_arcs[8].from.key().c_str(), "P4");
     ASSERT_EQ(net.m_arcs[8].to.id, 3u);
     ASSERT_EQ(net.m_arcs[8].to.type, Node::Transition);
-    ASSERT_STREQ(net.m_arcs[8].to.key.c_str(), "T3");
+    ASSERT_STREQ(net.m_arcs[8].to.key().c_str(), "T3");
     ASSERT_EQ(isnan(net.m_arcs[8].duration), true);
 
     ASSERT_EQ(net.m_arcs[9].from.id, 3u);
     ASSERT_EQ(net.m_arcs[9].from.type, Node::Transition);
-    ASSERT_STREQ(net.m_arcs[9].from.key.c_str(), "T3");
+    ASSERT_STREQ(net.m_arcs[9].from.key().c_str(), "T3");
     ASSERT_EQ(net.m_arcs[9].to.id, 3u);
     ASSERT_EQ(net.m_arcs[9].to.type, Node::Place);
-    ASSERT_STREQ(net.m_arcs[9].to.key.c_str(), "P3");
+    ASSERT_STREQ(net.m_arcs[9].to.key().c_str(), "P3");
     ASSERT_EQ(net.m_arcs[9].duration, 1u);
 
     // Can we access to nodes ?
@@ -964,62 +964,62 @@ TEST(TestPetriNet, TestLoadedNetTimedPetri)
 
     arc = net.findArc(*net.findNode("P3"), *net.findNode("T0"));
     ASSERT_NE(arc, nullptr);
-    ASSERT_STREQ(arc->from.key.c_str(), "P3");
-    ASSERT_STREQ(arc->to.key.c_str(), "T0");
+    ASSERT_STREQ(arc->from.key().c_str(), "P3");
+    ASSERT_STREQ(arc->to.key().c_str(), "T0");
     ASSERT_EQ(isnan(arc->duration), true);
 
     arc = net.findArc(*net.findNode("P1"), *net.findNode("T0"));
     ASSERT_NE(arc, nullptr);
-    ASSERT_STREQ(arc->from.key.c_str(), "P1");
-    ASSERT_STREQ(arc->to.key.c_str(), "T0");
+    ASSERT_STREQ(arc->from.key().c_str(), "P1");
+    ASSERT_STREQ(arc->to.key().c_str(), "T0");
     ASSERT_EQ(isnan(arc->duration), true);
 
     arc = net.findArc(*net.findNode("T0"), *net.findNode("P0"));
     ASSERT_NE(arc, nullptr);
-    ASSERT_STREQ(arc->from.key.c_str(), "T0");
-    ASSERT_STREQ(arc->to.key.c_str(), "P0");
+    ASSERT_STREQ(arc->from.key().c_str(), "T0");
+    ASSERT_STREQ(arc->to.key().c_str(), "P0");
     ASSERT_EQ(arc->duration, 5u);
 
     arc = net.findArc(*net.findNode("P0"), *net.findNode("T2"));
     ASSERT_NE(arc, nullptr);
-    ASSERT_STREQ(arc->from.key.c_str(), "P0");
-    ASSERT_STREQ(arc->to.key.c_str(), "T2");
+    ASSERT_STREQ(arc->from.key().c_str(), "P0");
+    ASSERT_STREQ(arc->to.key().c_str(), "T2");
     ASSERT_EQ(isnan(arc->duration), true);
 
     arc = net.findArc(*net.findNode("T2"), *net.findNode("P2"));
     ASSERT_NE(arc, nullptr);
-    ASSERT_STREQ(arc->from.key.c_str(), "T2");
-    ASSERT_STREQ(arc->to.key.c_str(), "P2");
+    ASSERT_STREQ(arc->from.key().c_str(), "T2");
+    ASSERT_STREQ(arc->to.key().c_str(), "P2");
     ASSERT_EQ(arc->duration, 3u);
 
     arc = net.findArc(*net.findNode("P2"), *net.findNode("T1"));
     ASSERT_NE(arc, nullptr);
-    ASSERT_STREQ(arc->from.key.c_str(), "P2");
-    ASSERT_STREQ(arc->to.key.c_str(), "T1");
+    ASSERT_STREQ(arc->from.key().c_str(), "P2");
+    ASSERT_STREQ(arc->to.key().c_str(), "T1");
     ASSERT_EQ(isnan(arc->duration), true);
 
     arc = net.findArc(*net.findNode("T1"), *net.findNode("P1"));
     ASSERT_NE(arc, nullptr);
-    ASSERT_STREQ(arc->from.key.c_str(), "T1");
-    ASSERT_STREQ(arc->to.key.c_str(), "P1");
+    ASSERT_STREQ(arc->from.key().c_str(), "T1");
+    ASSERT_STREQ(arc->to.key().c_str(), "P1");
     ASSERT_EQ(arc->duration, 5u);
 
     arc = net.findArc(*net.findNode("T2"), *net.findNode("P4"));
     ASSERT_NE(arc, nullptr);
-    ASSERT_STREQ(arc->from.key.c_str(), "T2");
-    ASSERT_STREQ(arc->to.key.c_str(), "P4");
+    ASSERT_STREQ(arc->from.key().c_str(), "T2");
+    ASSERT_STREQ(arc->to.key().c_str(), "P4");
     ASSERT_EQ(arc->duration, 1u);
 
     arc = net.findArc(*net.findNode("P4"), *net.findNode("T3"));
     ASSERT_NE(arc, nullptr);
-    ASSERT_STREQ(arc->from.key.c_str(), "P4");
-    ASSERT_STREQ(arc->to.key.c_str(), "T3");
+    ASSERT_STREQ(arc->from.key().c_str(), "P4");
+    ASSERT_STREQ(arc->to.key().c_str(), "T3");
     ASSERT_EQ(isnan(arc->duration), true);
 
     arc = net.findArc(*net.findNode("T3"), *net.findNode("P3"));
     ASSERT_NE(arc, nullptr);
-    ASSERT_STREQ(arc->from.key.c_str(), "T3");
-    ASSERT_STREQ(arc->to.key.c_str(), "P3");
+    ASSERT_STREQ(arc->from.key().c_str(), "T3");
+    ASSERT_STREQ(arc->to.key().c_str(), "P3");
     ASSERT_EQ(arc->duration, 1u);
 
     // At least one token
@@ -1061,193 +1061,193 @@ TEST(TestPetriNet, TestLoadedNetGraphEvent)
 
     // Check places
     ASSERT_EQ(net.m_places[0].id, 0u);
-    ASSERT_STREQ(net.m_places[0].key.c_str(), "P0");
-    ASSERT_STREQ(net.m_places[0].caption.c_str(), "P0");
+    ASSERT_STREQ(net.m_places[0].key().c_str(), "P0");
+    ASSERT_STREQ(net.m_places[0].caption().c_str(), "P0");
     ASSERT_EQ(net.m_places[0].type, Node::Place);
     ASSERT_EQ(net.m_places[0].tokens, 2u);
     ASSERT_EQ(net.m_places[0].arcsIn.size(), 1u);
     ASSERT_EQ(net.m_places[0].arcsOut.size(), 1u);
-    ASSERT_STREQ(net.m_places[0].arcsIn[0]->from.key.c_str(), "T2");
-    ASSERT_STREQ(net.m_places[0].arcsIn[0]->to.key.c_str(), "P0");
-    ASSERT_STREQ(net.m_places[0].arcsOut[0]->from.key.c_str(), "P0");
-    ASSERT_STREQ(net.m_places[0].arcsOut[0]->to.key.c_str(), "T0");
+    ASSERT_STREQ(net.m_places[0].arcsIn[0]->from.key().c_str(), "T2");
+    ASSERT_STREQ(net.m_places[0].arcsIn[0]->to.key().c_str(), "P0");
+    ASSERT_STREQ(net.m_places[0].arcsOut[0]->from.key().c_str(), "P0");
+    ASSERT_STREQ(net.m_places[0].arcsOut[0]->to.key().c_str(), "T0");
 
     ASSERT_EQ(net.m_places[1].id, 1u);
-    ASSERT_STREQ(net.m_places[1].key.c_str(), "P1");
-    ASSERT_STREQ(net.m_places[1].caption.c_str(), "P1");
+    ASSERT_STREQ(net.m_places[1].key().c_str(), "P1");
+    ASSERT_STREQ(net.m_places[1].caption().c_str(), "P1");
     ASSERT_EQ(net.m_places[1].type, Node::Place);
     ASSERT_EQ(net.m_places[1].tokens, 0u);
     ASSERT_EQ(net.m_places[1].arcsIn.size(), 1u);
     ASSERT_EQ(net.m_places[1].arcsOut.size(), 1u);
-    ASSERT_STREQ(net.m_places[1].arcsIn[0]->from.key.c_str(), "T0");
-    ASSERT_STREQ(net.m_places[1].arcsIn[0]->to.key.c_str(), "P1");
-    ASSERT_STREQ(net.m_places[1].arcsOut[0]->from.key.c_str(), "P1");
-    ASSERT_STREQ(net.m_places[1].arcsOut[0]->to.key.c_str(), "T1");
+    ASSERT_STREQ(net.m_places[1].arcsIn[0]->from.key().c_str(), "T0");
+    ASSERT_STREQ(net.m_places[1].arcsIn[0]->to.key().c_str(), "P1");
+    ASSERT_STREQ(net.m_places[1].arcsOut[0]->from.key().c_str(), "P1");
+    ASSERT_STREQ(net.m_places[1].arcsOut[0]->to.key().c_str(), "T1");
 
     ASSERT_EQ(net.m_places[2].id, 2u);
-    ASSERT_STREQ(net.m_places[2].key.c_str(), "P2");
-    ASSERT_STREQ(net.m_places[2].caption.c_str(), "P2");
+    ASSERT_STREQ(net.m_places[2].key().c_str(), "P2");
+    ASSERT_STREQ(net.m_places[2].caption().c_str(), "P2");
     ASSERT_EQ(net.m_places[2].type, Node::Place);
     ASSERT_EQ(net.m_places[2].tokens, 0u);
     ASSERT_EQ(net.m_places[2].arcsIn.size(), 1u);
     ASSERT_EQ(net.m_places[2].arcsOut.size(), 1u);
-    ASSERT_STREQ(net.m_places[2].arcsIn[0]->from.key.c_str(), "T1");
-    ASSERT_STREQ(net.m_places[2].arcsIn[0]->to.key.c_str(), "P2");
-    ASSERT_STREQ(net.m_places[2].arcsOut[0]->from.key.c_str(), "P2");
-    ASSERT_STREQ(net.m_places[2].arcsOut[0]->to.key.c_str(), "T2");
+    ASSERT_STREQ(net.m_places[2].arcsIn[0]->from.key().c_str(), "T1");
+    ASSERT_STREQ(net.m_places[2].arcsIn[0]->to.key().c_str(), "P2");
+    ASSERT_STREQ(net.m_places[2].arcsOut[0]->from.key().c_str(), "P2");
+    ASSERT_STREQ(net.m_places[2].arcsOut[0]->to.key().c_str(), "T2");
 
     ASSERT_EQ(net.m_places[3].id, 3u);
-    ASSERT_STREQ(net.m_places[3].key.c_str(), "P3");
-    ASSERT_STREQ(net.m_places[3].caption.c_str(), "P3");
+    ASSERT_STREQ(net.m_places[3].key().c_str(), "P3");
+    ASSERT_STREQ(net.m_places[3].caption().c_str(), "P3");
     ASSERT_EQ(net.m_places[3].type, Node::Place);
     ASSERT_EQ(net.m_places[3].tokens, 0u);
     ASSERT_EQ(net.m_places[3].arcsIn.size(), 1u);
     ASSERT_EQ(net.m_places[3].arcsOut.size(), 1u);
-    ASSERT_STREQ(net.m_places[3].arcsIn[0]->from.key.c_str(), "T0");
-    ASSERT_STREQ(net.m_places[3].arcsIn[0]->to.key.c_str(), "P3");
-    ASSERT_STREQ(net.m_places[3].arcsOut[0]->from.key.c_str(), "P3");
-    ASSERT_STREQ(net.m_places[3].arcsOut[0]->to.key.c_str(), "T3");
+    ASSERT_STREQ(net.m_places[3].arcsIn[0]->from.key().c_str(), "T0");
+    ASSERT_STREQ(net.m_places[3].arcsIn[0]->to.key().c_str(), "P3");
+    ASSERT_STREQ(net.m_places[3].arcsOut[0]->from.key().c_str(), "P3");
+    ASSERT_STREQ(net.m_places[3].arcsOut[0]->to.key().c_str(), "T3");
 
     ASSERT_EQ(net.m_places[4].id, 4u);
-    ASSERT_STREQ(net.m_places[4].key.c_str(), "P4");
-    ASSERT_STREQ(net.m_places[4].caption.c_str(), "P4");
+    ASSERT_STREQ(net.m_places[4].key().c_str(), "P4");
+    ASSERT_STREQ(net.m_places[4].caption().c_str(), "P4");
     ASSERT_EQ(net.m_places[4].type, Node::Place);
     ASSERT_EQ(net.m_places[4].tokens, 0u);
     ASSERT_EQ(net.m_places[4].arcsIn.size(), 1u);
     ASSERT_EQ(net.m_places[4].arcsOut.size(), 1u);
-    ASSERT_STREQ(net.m_places[4].arcsIn[0]->from.key.c_str(), "T3");
-    ASSERT_STREQ(net.m_places[4].arcsIn[0]->to.key.c_str(), "P4");
-    ASSERT_STREQ(net.m_places[4].arcsOut[0]->from.key.c_str(), "P4");
-    ASSERT_STREQ(net.m_places[4].arcsOut[0]->to.key.c_str(), "T2");
+    ASSERT_STREQ(net.m_places[4].arcsIn[0]->from.key().c_str(), "T3");
+    ASSERT_STREQ(net.m_places[4].arcsIn[0]->to.key().c_str(), "P4");
+    ASSERT_STREQ(net.m_places[4].arcsOut[0]->from.key().c_str(), "P4");
+    ASSERT_STREQ(net.m_places[4].arcsOut[0]->to.key().c_str(), "T2");
 
     // Check transitions
     ASSERT_EQ(net.m_transitions[0].id, 0u);
-    ASSERT_STREQ(net.m_transitions[0].key.c_str(), "T0");
-    ASSERT_STREQ(net.m_transitions[0].caption.c_str(), "T0");
+    ASSERT_STREQ(net.m_transitions[0].key().c_str(), "T0");
+    ASSERT_STREQ(net.m_transitions[0].caption().c_str(), "T0");
     ASSERT_EQ(net.m_transitions[0].type, Node::Transition);
     ASSERT_EQ(net.m_transitions[0].arcsIn.size(), 1u);
     ASSERT_EQ(net.m_transitions[0].arcsOut.size(), 2u);
-    ASSERT_STREQ(net.m_transitions[0].arcsIn[0]->from.key.c_str(), "P0");
-    ASSERT_STREQ(net.m_transitions[0].arcsIn[0]->to.key.c_str(), "T0");
-    ASSERT_STREQ(net.m_transitions[0].arcsOut[0]->from.key.c_str(), "T0");
-    ASSERT_STREQ(net.m_transitions[0].arcsOut[0]->to.key.c_str(), "P1");
-    ASSERT_STREQ(net.m_transitions[0].arcsOut[1]->from.key.c_str(), "T0");
-    ASSERT_STREQ(net.m_transitions[0].arcsOut[1]->to.key.c_str(), "P3");
+    ASSERT_STREQ(net.m_transitions[0].arcsIn[0]->from.key().c_str(), "P0");
+    ASSERT_STREQ(net.m_transitions[0].arcsIn[0]->to.key().c_str(), "T0");
+    ASSERT_STREQ(net.m_transitions[0].arcsOut[0]->from.key().c_str(), "T0");
+    ASSERT_STREQ(net.m_transitions[0].arcsOut[0]->to.key().c_str(), "P1");
+    ASSERT_STREQ(net.m_transitions[0].arcsOut[1]->from.key().c_str(), "T0");
+    ASSERT_STREQ(net.m_transitions[0].arcsOut[1]->to.key().c_str(), "P3");
 
     ASSERT_EQ(net.m_transitions[1].id, 1u);
-    ASSERT_STREQ(net.m_transitions[1].key.c_str(), "T1");
-    ASSERT_STREQ(net.m_transitions[1].caption.c_str(), "T1");
+    ASSERT_STREQ(net.m_transitions[1].key().c_str(), "T1");
+    ASSERT_STREQ(net.m_transitions[1].caption().c_str(), "T1");
     ASSERT_EQ(net.m_transitions[1].type, Node::Transition);
     ASSERT_EQ(net.m_transitions[1].arcsIn.size(), 1u);
     ASSERT_EQ(net.m_transitions[1].arcsOut.size(), 1u);
-    ASSERT_STREQ(net.m_transitions[1].arcsIn[0]->from.key.c_str(), "P1");
-    ASSERT_STREQ(net.m_transitions[1].arcsIn[0]->to.key.c_str(), "T1");
-    ASSERT_STREQ(net.m_transitions[1].arcsOut[0]->from.key.c_str(), "T1");
-    ASSERT_STREQ(net.m_transitions[1].arcsOut[0]->to.key.c_str(), "P2");
+    ASSERT_STREQ(net.m_transitions[1].arcsIn[0]->from.key().c_str(), "P1");
+    ASSERT_STREQ(net.m_transitions[1].arcsIn[0]->to.key().c_str(), "T1");
+    ASSERT_STREQ(net.m_transitions[1].arcsOut[0]->from.key().c_str(), "T1");
+    ASSERT_STREQ(net.m_transitions[1].arcsOut[0]->to.key().c_str(), "P2");
 
     ASSERT_EQ(net.m_transitions[2].id, 2u);
-    ASSERT_STREQ(net.m_transitions[2].key.c_str(), "T2");
-    ASSERT_STREQ(net.m_transitions[2].caption.c_str(), "T2");
+    ASSERT_STREQ(net.m_transitions[2].key().c_str(), "T2");
+    ASSERT_STREQ(net.m_transitions[2].caption().c_str(), "T2");
     ASSERT_EQ(net.m_transitions[2].type, Node::Transition);
     ASSERT_EQ(net.m_transitions[2].arcsIn.size(), 2u);
     ASSERT_EQ(net.m_transitions[2].arcsOut.size(), 1u);
-    ASSERT_STREQ(net.m_transitions[2].arcsIn[0]->from.key.c_str(), "P2");
-    ASSERT_STREQ(net.m_transitions[2].arcsIn[0]->to.key.c_str(), "T2");
-    ASSERT_STREQ(net.m_transitions[2].arcsIn[1]->from.key.c_str(), "P4");
-    ASSERT_STREQ(net.m_transitions[2].arcsIn[1]->to.key.c_str(), "T2");
-    ASSERT_STREQ(net.m_transitions[2].arcsOut[0]->from.key.c_str(), "T2");
-    ASSERT_STREQ(net.m_transitions[2].arcsOut[0]->to.key.c_str(), "P0");
+    ASSERT_STREQ(net.m_transitions[2].arcsIn[0]->from.key().c_str(), "P2");
+    ASSERT_STREQ(net.m_transitions[2].arcsIn[0]->to.key().c_str(), "T2");
+    ASSERT_STREQ(net.m_transitions[2].arcsIn[1]->from.key().c_str(), "P4");
+    ASSERT_STREQ(net.m_transitions[2].arcsIn[1]->to.key().c_str(), "T2");
+    ASSERT_STREQ(net.m_transitions[2].arcsOut[0]->from.key().c_str(), "T2");
+    ASSERT_STREQ(net.m_transitions[2].arcsOut[0]->to.key().c_str(), "P0");
 
     ASSERT_EQ(net.m_transitions[3].id, 3u);
-    ASSERT_STREQ(net.m_transitions[3].key.c_str(), "T3");
-    ASSERT_STREQ(net.m_transitions[3].caption.c_str(), "T3");
+    ASSERT_STREQ(net.m_transitions[3].key().c_str(), "T3");
+    ASSERT_STREQ(net.m_transitions[3].caption().c_str(), "T3");
     ASSERT_EQ(net.m_transitions[3].type, Node::Transition);
     ASSERT_EQ(net.m_transitions[3].arcsIn.size(), 1u);
     ASSERT_EQ(net.m_transitions[3].arcsOut.size(), 1u);
-    ASSERT_STREQ(net.m_transitions[3].arcsIn[0]->from.key.c_str(), "P3");
-    ASSERT_STREQ(net.m_transitions[3].arcsIn[0]->to.key.c_str(), "T3");
-    ASSERT_STREQ(net.m_transitions[3].arcsOut[0]->from.key.c_str(), "T3");
-    ASSERT_STREQ(net.m_transitions[3].arcsOut[0]->to.key.c_str(), "P4");
+    ASSERT_STREQ(net.m_transitions[3].arcsIn[0]->from.key().c_str(), "P3");
+    ASSERT_STREQ(net.m_transitions[3].arcsIn[0]->to.key().c_str(), "T3");
+    ASSERT_STREQ(net.m_transitions[3].arcsOut[0]->from.key().c_str(), "T3");
+    ASSERT_STREQ(net.m_transitions[3].arcsOut[0]->to.key().c_str(), "P4");
 
     // Check arcs
     ASSERT_EQ(net.m_arcs[0].from.id, 0u);
     ASSERT_EQ(net.m_arcs[0].from.type, Node::Place);
-    ASSERT_STREQ(net.m_arcs[0].from.key.c_str(), "P0");
+    ASSERT_STREQ(net.m_arcs[0].from.key().c_str(), "P0");
     ASSERT_EQ(net.m_arcs[0].to.id, 0u);
     ASSERT_EQ(net.m_arcs[0].to.type, Node::Transition);
-    ASSERT_STREQ(net.m_arcs[0].to.key.c_str(), "T0");
+    ASSERT_STREQ(net.m_arcs[0].to.key().c_str(), "T0");
     ASSERT_EQ(isnan(net.m_arcs[0].duration), true); // FIXME forcer json a NAN ?
 
     ASSERT_EQ(net.m_arcs[1].from.id, 0u);
     ASSERT_EQ(net.m_arcs[1].from.type, Node::Transition);
-    ASSERT_STREQ(net.m_arcs[1].from.key.c_str(), "T0");
+    ASSERT_STREQ(net.m_arcs[1].from.key().c_str(), "T0");
     ASSERT_EQ(net.m_arcs[1].to.id, 1u);
     ASSERT_EQ(net.m_arcs[1].to.type, Node::Place);
-    ASSERT_STREQ(net.m_arcs[1].to.key.c_str(), "P1");
+    ASSERT_STREQ(net.m_arcs[1].to.key().c_str(), "P1");
     ASSERT_EQ(net.m_arcs[1].duration, 5u);
 
     ASSERT_EQ(net.m_arcs[2].from.id, 1u);
     ASSERT_EQ(net.m_arcs[2].from.type, Node::Place);
-    ASSERT_STREQ(net.m_arcs[2].from.key.c_str(), "P1");
+    ASSERT_STREQ(net.m_arcs[2].from.key().c_str(), "P1");
     ASSERT_EQ(net.m_arcs[2].to.id, 1u);
     ASSERT_EQ(net.m_arcs[2].to.type, Node::Transition);
-    ASSERT_STREQ(net.m_arcs[2].to.key.c_str(), "T1");
+    ASSERT_STREQ(net.m_arcs[2].to.key().c_str(), "T1");
     ASSERT_EQ(isnan(net.m_arcs[2].duration), true);
 
     ASSERT_EQ(net.m_arcs[3].from.id, 1u);
     ASSERT_EQ(net.m_arcs[3].from.type, Node::Transition);
-    ASSERT_STREQ(net.m_arcs[3].from.key.c_str(), "T1");
+    ASSERT_STREQ(net.m_arcs[3].from.key().c_str(), "T1");
     ASSERT_EQ(net.m_arcs[3].to.id, 2u);
     ASSERT_EQ(net.m_arcs[3].to.type, Node::Place);
-    ASSERT_STREQ(net.m_arcs[3].to.key.c_str(), "P2");
+    ASSERT_STREQ(net.m_arcs[3].to.key().c_str(), "P2");
     ASSERT_EQ(net.m_arcs[3].duration, 3u);
 
     ASSERT_EQ(net.m_arcs[4].from.id, 2u);
     ASSERT_EQ(net.m_arcs[4].from.type, Node::Place);
-    ASSERT_STREQ(net.m_arcs[4].from.key.c_str(), "P2");
+    ASSERT_STREQ(net.m_arcs[4].from.key().c_str(), "P2");
     ASSERT_EQ(net.m_arcs[4].to.id, 2u);
     ASSERT_EQ(net.m_arcs[4].to.type, Node::Transition);
-    ASSERT_STREQ(net.m_arcs[4].to.key.c_str(), "T2");
+    ASSERT_STREQ(net.m_arcs[4].to.key().c_str(), "T2");
     ASSERT_EQ(isnan(net.m_arcs[4].duration), true); // FIXME forcer json a NAN ?
 
     ASSERT_EQ(net.m_arcs[5].from.id, 2u);
     ASSERT_EQ(net.m_arcs[5].from.type, Node::Transition);
-    ASSERT_STREQ(net.m_arcs[5].from.key.c_str(), "T2");
+    ASSERT_STREQ(net.m_arcs[5].from.key().c_str(), "T2");
     ASSERT_EQ(net.m_arcs[5].to.id, 0u);
     ASSERT_EQ(net.m_arcs[5].to.type, Node::Place);
-    ASSERT_STREQ(net.m_arcs[5].to.key.c_str(), "P0");
+    ASSERT_STREQ(net.m_arcs[5].to.key().c_str(), "P0");
     ASSERT_EQ(net.m_arcs[5].duration, 5u);
 
     ASSERT_EQ(net.m_arcs[6].from.id, 0u);
     ASSERT_EQ(net.m_arcs[6].from.type, Node::Transition);
-    ASSERT_STREQ(net.m_arcs[6].from.key.c_str(), "T0");
+    ASSERT_STREQ(net.m_arcs[6].from.key().c_str(), "T0");
     ASSERT_EQ(net.m_arcs[6].to.id, 3u);
     ASSERT_EQ(net.m_arcs[6].to.type, Node::Place);
-    ASSERT_STREQ(net.m_arcs[6].to.key.c_str(), "P3");
+    ASSERT_STREQ(net.m_arcs[6].to.key().c_str(), "P3");
     ASSERT_EQ(net.m_arcs[6].duration, 1u);
 
     ASSERT_EQ(net.m_arcs[7].from.id, 3u);
     ASSERT_EQ(net.m_arcs[7].from.type, Node::Place);
-    ASSERT_STREQ(net.m_arcs[7].from.key.c_str(), "P3");
+    ASSERT_STREQ(net.m_arcs[7].from.key().c_str(), "P3");
     ASSERT_EQ(net.m_arcs[7].to.id, 3u);
     ASSERT_EQ(net.m_arcs[7].to.type, Node::Transition);
-    ASSERT_STREQ(net.m_arcs[7].to.key.c_str(), "T3");
+    ASSERT_STREQ(net.m_arcs[7].to.key().c_str(), "T3");
     ASSERT_EQ(isnan(net.m_arcs[7].duration), true); // FIXME forcer json a NAN ?
 
     ASSERT_EQ(net.m_arcs[8].from.id, 3u);
     ASSERT_EQ(net.m_arcs[8].from.type, Node::Transition);
-    ASSERT_STREQ(net.m_arcs[8].from.key.c_str(), "T3");
+    ASSERT_STREQ(net.m_arcs[8].from.key().c_str(), "T3");
     ASSERT_EQ(net.m_arcs[8].to.id, 4u);
     ASSERT_EQ(net.m_arcs[8].to.type, Node::Place);
-    ASSERT_STREQ(net.m_arcs[8].to.key.c_str(), "P4");
+    ASSERT_STREQ(net.m_arcs[8].to.key().c_str(), "P4");
     ASSERT_EQ(net.m_arcs[8].duration, 1u);
 
     ASSERT_EQ(net.m_arcs[9].from.id, 4u);
     ASSERT_EQ(net.m_arcs[9].from.type, Node::Place);
-    ASSERT_STREQ(net.m_arcs[9].from.key.c_str(), "P4");
+    ASSERT_STREQ(net.m_arcs[9].from.key().c_str(), "P4");
     ASSERT_EQ(net.m_arcs[9].to.id, 2u);
     ASSERT_EQ(net.m_arcs[9].to.type, Node::Transition);
-    ASSERT_STREQ(net.m_arcs[9].to.key.c_str(), "T2");
+    ASSERT_STREQ(net.m_arcs[9].to.key().c_str(), "T2");
     ASSERT_EQ(isnan(net.m_arcs[9].duration), true); // FIXME forcer json a NAN ?
 
     // Can we access to nodes ?
@@ -1281,53 +1281,53 @@ TEST(TestPetriNet, TestLoadedNetGraphEvent)
 
     arc = net.findArc(*net.findNode("T0"), *net.findNode("P1"));
     ASSERT_NE(arc, nullptr);
-    ASSERT_STREQ(arc->from.key.c_str(), "T0");
-    ASSERT_STREQ(arc->to.key.c_str(), "P1");
+    ASSERT_STREQ(arc->from.key().c_str(), "T0");
+    ASSERT_STREQ(arc->to.key().c_str(), "P1");
 
     arc = net.findArc(*net.findNode("T0"), *net.findNode("P3"));
     ASSERT_NE(arc, nullptr);
-    ASSERT_STREQ(arc->from.key.c_str(), "T0");
-    ASSERT_STREQ(arc->to.key.c_str(), "P3");
+    ASSERT_STREQ(arc->from.key().c_str(), "T0");
+    ASSERT_STREQ(arc->to.key().c_str(), "P3");
 
     arc = net.findArc(*net.findNode("T1"), *net.findNode("P2"));
     ASSERT_NE(arc, nullptr);
-    ASSERT_STREQ(arc->from.key.c_str(), "T1");
-    ASSERT_STREQ(arc->to.key.c_str(), "P2");
+    ASSERT_STREQ(arc->from.key().c_str(), "T1");
+    ASSERT_STREQ(arc->to.key().c_str(), "P2");
 
     arc = net.findArc(*net.findNode("T2"), *net.findNode("P0"));
     ASSERT_NE(arc, nullptr);
-    ASSERT_STREQ(arc->from.key.c_str(), "T2");
-    ASSERT_STREQ(arc->to.key.c_str(), "P0");
+    ASSERT_STREQ(arc->from.key().c_str(), "T2");
+    ASSERT_STREQ(arc->to.key().c_str(), "P0");
 
     arc = net.findArc(*net.findNode("T3"), *net.findNode("P4"));
     ASSERT_NE(arc, nullptr);
-    ASSERT_STREQ(arc->from.key.c_str(), "T3");
-    ASSERT_STREQ(arc->to.key.c_str(), "P4");
+    ASSERT_STREQ(arc->from.key().c_str(), "T3");
+    ASSERT_STREQ(arc->to.key().c_str(), "P4");
 
     arc = net.findArc(*net.findNode("P0"), *net.findNode("T0"));
     ASSERT_NE(arc, nullptr);
-    ASSERT_STREQ(arc->from.key.c_str(), "P0");
-    ASSERT_STREQ(arc->to.key.c_str(), "T0");
+    ASSERT_STREQ(arc->from.key().c_str(), "P0");
+    ASSERT_STREQ(arc->to.key().c_str(), "T0");
 
     arc = net.findArc(*net.findNode("P1"), *net.findNode("T1"));
     ASSERT_NE(arc, nullptr);
-    ASSERT_STREQ(arc->from.key.c_str(), "P1");
-    ASSERT_STREQ(arc->to.key.c_str(), "T1");
+    ASSERT_STREQ(arc->from.key().c_str(), "P1");
+    ASSERT_STREQ(arc->to.key().c_str(), "T1");
 
     arc = net.findArc(*net.findNode("P2"), *net.findNode("T2"));
     ASSERT_NE(arc, nullptr);
-    ASSERT_STREQ(arc->from.key.c_str(), "P2");
-    ASSERT_STREQ(arc->to.key.c_str(), "T2");
+    ASSERT_STREQ(arc->from.key().c_str(), "P2");
+    ASSERT_STREQ(arc->to.key().c_str(), "T2");
 
     arc = net.findArc(*net.findNode("P3"), *net.findNode("T3"));
     ASSERT_NE(arc, nullptr);
-    ASSERT_STREQ(arc->from.key.c_str(), "P3");
-    ASSERT_STREQ(arc->to.key.c_str(), "T3");
+    ASSERT_STREQ(arc->from.key().c_str(), "P3");
+    ASSERT_STREQ(arc->to.key().c_str(), "T3");
 
     arc = net.findArc(*net.findNode("P4"), *net.findNode("T2"));
     ASSERT_NE(arc, nullptr);
-    ASSERT_STREQ(arc->from.key.c_str(), "P4");
-    ASSERT_STREQ(arc->to.key.c_str(), "T2");
+    ASSERT_STREQ(arc->from.key().c_str(), "P4");
+    ASSERT_STREQ(arc->to.key().c_str(), "T2");
 
     // At least one token
     ASSERT_EQ(net.m_transitions[0].isValidated(), true);
@@ -1406,8 +1406,8 @@ TEST(TestPetriNet, TestRemoveNode)
         auto const& arcsOut = net.findTransition(0u)->arcsOut;
         ASSERT_EQ(arcsIn.size(), 1u);
         ASSERT_EQ(arcsOut.size(), 0u);
-        ASSERT_STREQ(arcsIn[0]->from.key.c_str(), "P1");
-        ASSERT_STREQ(arcsIn[0]->to.key.c_str(), "T0");
+        ASSERT_STREQ(arcsIn[0]->from.key().c_str(), "P1");
+        ASSERT_STREQ(arcsIn[0]->to.key().c_str(), "T0");
     }
     // T1
     {
@@ -1415,8 +1415,8 @@ TEST(TestPetriNet, TestRemoveNode)
         auto const& arcsOut = net.findTransition(1u)->arcsOut;
         ASSERT_EQ(arcsIn.size(), 1u);
         ASSERT_EQ(arcsOut.size(), 0u);
-        ASSERT_STREQ(arcsIn[0]->from.key.c_str(), "P0");
-        ASSERT_STREQ(arcsIn[0]->to.key.c_str(), "T1");
+        ASSERT_STREQ(arcsIn[0]->from.key().c_str(), "P0");
+        ASSERT_STREQ(arcsIn[0]->to.key().c_str(), "T1");
     }
     // T2
     {
@@ -1424,11 +1424,11 @@ TEST(TestPetriNet, TestRemoveNode)
         auto const& arcsOut = net.findTransition(2u)->arcsOut;
         ASSERT_EQ(arcsIn.size(), 0u);
         ASSERT_EQ(arcsOut.size(), 2u);
-        ASSERT_STREQ(arcsOut[0]->from.key.c_str(), "T2");
-        ASSERT_STREQ(arcsOut[0]->to.key.c_str(), "P1");
+        ASSERT_STREQ(arcsOut[0]->from.key().c_str(), "T2");
+        ASSERT_STREQ(arcsOut[0]->to.key().c_str(), "P1");
         ASSERT_EQ(arcsOut[0]->duration, 1.0f);
-        ASSERT_STREQ(arcsOut[1]->from.key.c_str(), "T2");
-        ASSERT_STREQ(arcsOut[1]->to.key.c_str(), "P0");
+        ASSERT_STREQ(arcsOut[1]->from.key().c_str(), "T2");
+        ASSERT_STREQ(arcsOut[1]->to.key().c_str(), "P0");
         ASSERT_EQ(arcsOut[1]->duration, 3.0f);
     }
 
@@ -1439,10 +1439,10 @@ TEST(TestPetriNet, TestRemoveNode)
         auto const& arcsOut = net.findPlace(0u)->arcsOut;
         ASSERT_EQ(arcsIn.size(), 1u);
         ASSERT_EQ(arcsOut.size(), 1u);
-        ASSERT_STREQ(arcsOut[0]->from.key.c_str(), "P0");
-        ASSERT_STREQ(arcsOut[0]->to.key.c_str(), "T1");
-        ASSERT_STREQ(arcsIn[0]->from.key.c_str(), "T2");
-        ASSERT_STREQ(arcsIn[0]->to.key.c_str(), "P0");
+        ASSERT_STREQ(arcsOut[0]->from.key().c_str(), "P0");
+        ASSERT_STREQ(arcsOut[0]->to.key().c_str(), "T1");
+        ASSERT_STREQ(arcsIn[0]->from.key().c_str(), "T2");
+        ASSERT_STREQ(arcsIn[0]->to.key().c_str(), "P0");
     }
     // P1
     {
@@ -1450,10 +1450,10 @@ TEST(TestPetriNet, TestRemoveNode)
         auto const& arcsOut = net.findPlace(1u)->arcsOut;
         ASSERT_EQ(arcsIn.size(), 1u);
         ASSERT_EQ(arcsOut.size(), 1u);
-        ASSERT_STREQ(arcsOut[0]->from.key.c_str(), "P1");
-        ASSERT_STREQ(arcsOut[0]->to.key.c_str(), "T0");
-        ASSERT_STREQ(arcsIn[0]->from.key.c_str(), "T2");
-        ASSERT_STREQ(arcsIn[0]->to.key.c_str(), "P1");
+        ASSERT_STREQ(arcsOut[0]->from.key().c_str(), "P1");
+        ASSERT_STREQ(arcsOut[0]->to.key().c_str(), "T0");
+        ASSERT_STREQ(arcsIn[0]->from.key().c_str(), "T2");
+        ASSERT_STREQ(arcsIn[0]->to.key().c_str(), "P1");
     }
 
     // *** Delete Transition 2
@@ -1480,6 +1480,36 @@ TEST(TestPetriNet, TestRemoveNode)
     }
 }
 
+//------------------------------------------------------------------------------
+TEST(TestPetriNet, TestRemoveTransitionKeepsDelays)
+{
+    Net net(TypeOfNet::PetriNet);
+    net.addTransition(0.0f, 0.0f);
+    Transition& t1 = net.addTransition(1.0f, 0.0f);
+    t1.delay.law = Distribution::Law::Erlang;
+    t1.delay.a = 2.0f;
+    t1.delay.b = 3.0f;
+    t1.receptivity = true;
+    Transition& t2 = net.addTransition(2.0f, 0.0f);
+    t2.delay.law = Distribution::Law::Weibull;
+    t2.delay.a = 1.5f;
+    t2.delay.b = 4.0f;
+
+    // Removing T0 moves the latest transition T2 to its location.
+    net.removeNode(net.transitions()[0]);
+    ASSERT_EQ(net.transitions().size(), 2u);
+    Transition const& moved = net.transitions()[0];
+    ASSERT_EQ(moved.x, 2.0f);
+    ASSERT_EQ(moved.delay.law, Distribution::Law::Weibull);
+    ASSERT_EQ(moved.delay.a, 1.5f);
+    ASSERT_EQ(moved.delay.b, 4.0f);
+    ASSERT_EQ(moved.receptivity, false);
+    ASSERT_EQ(net.transitions()[1].delay.law, Distribution::Law::Erlang);
+    ASSERT_EQ(net.transitions()[1].delay.a, 2.0f);
+    ASSERT_EQ(net.transitions()[1].delay.b, 3.0f);
+    ASSERT_EQ(net.transitions()[1].receptivity, true);
+}
+
 //------------------------------------------------------------------------------
 TEST(TestPetriNet, TestcountBurnableTokens)
 {
@@ -1505,3 +1535,443 @@ TEST(TestPetriNet, TestcountBurnableTokens)
     //ASSERT_EQ(net.m_transitions[2].countBurnableTokens(), 2u); // x2
     //ASSERT_EQ(net.m_transitions[3].countBurnableTokens(), 0u); // y
 }
+
+//------------------------------------------------------------------------------
+TEST(TestPetriNet, TestIndexedLookups)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+
+    // Malformed keys
+    ASSERT_EQ(net.findNode(""), nullptr);
+    ASSERT_EQ(net.findNode("P"), nullptr);
+    ASSERT_EQ(net.findNode("P0"), nullptr);
+    ASSERT_EQ(net.findNode("T0"), nullptr);
+
+    // Chain P0 -> T0 -> P1 -> T1 -> ... -> P99
+    for (size_t i = 0u; i < 100u; ++i)
+    {
+        net.addPlace(float(i), 0.0f, i);
+        if (i != 0u)
+        {
+            Transition& t = net.addTransition(float(i), 1.0f);
+            ASSERT_EQ(net.addArc(*net.findPlace(i - 1u), t), true);
+            ASSERT_EQ(net.addArc(t, *net.findPlace(i)), true);
+        }
+    }
+    ASSERT_EQ(net.m_places.size(), 100u);
+    ASSERT_EQ(net.m_transitions.size(), 99u);
+    ASSERT_EQ(net.m_arcs.size(), 198u);
+
+    ASSERT_EQ(net.findNode("P01"), nullptr);
+    ASSERT_EQ(net.findNode("X1"), nullptr);
+    ASSERT_EQ(net.findNode("P1a"), nullptr);
+    ASSERT_EQ(net.findNode("P100"), nullptr);
+    ASSERT_EQ(net.findNode("T99"), nullptr);
+    ASSERT_EQ(net.findNode("P99000000000000000000000"), nullptr);
+    for (auto const& p: net.places())
+    {
+        ASSERT_EQ(net.findNode(p.key()), &p);
+        ASSERT_EQ(net.findPlace(p.id), &p);
+    }
+    for (auto const& t: net.transitions())
+    {
+        ASSERT_EQ(net.findNode(t.key()), &t);
+        ASSERT_EQ(net.findTransition(t.id), &t);
+    }
+    for (auto const& a: net.arcs())
+    {
+        ASSERT_EQ(net.findArc(a.from, a.to), &a);
+        ASSERT_EQ(net.findArc(a.to, a.from), nullptr);
+    }
+
+    // Remove nodes in the middle of the containers: the latest node takes the
+    // identifier of the removed one. Indices shall follow.
+    net.removeNode(*net.findNode("P10"));
+    net.removeNode(*net.findNode("T20"));
+    ASSERT_TRUE(net.removeArc(*net.findNode("P30"), *net.findNode("T30")));
+    ASSERT_FALSE(net.removeArc(*net.findNode("P30"), *net.findNode("T30")));
+    ASSERT_EQ(net.m_places.size(), 99u);
+    ASSERT_EQ(net.m_transitions.size(), 98u);
+    ASSERT_EQ(net.findNode("P99"), nullptr);
+    ASSERT_EQ(net.findNode("T98"), nullptr);
+    ASSERT_EQ(net.findPlace(10u)->tokens, 99u);
+    for (size_t i = 0u; i < net.places().size(); ++i)
+    {
+        ASSERT_EQ(net.findPlace(net.places()[i].id), &net.places()[i]);
+    }
+    for (size_t i = 0u; i < net.transitions().size(); ++i)
+    {
+        ASSERT_EQ(net.findTransition(net.transitions()[i].id), &net.transitions()[i]);
+    }
+    for (auto const& a: net.arcs())
+    {
+        ASSERT_EQ(net.findArc(a.from, a.to), &a);
+    }
+
+    // Clear
+    net.clear();
+    ASSERT_EQ(net.findNode("P0"), nullptr);
+    ASSERT_EQ(net.findNode("T0"), nullptr);
+    ASSERT_EQ(net.findPlace(0u), nullptr);
+    ASSERT_EQ(net.findTransition(0u), nullptr);
+
+    // Copy
+    Net copy(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    ASSERT_EQ(net.addArc(p0, t0), true);
+    copy = net;
+    ASSERT_EQ(copy.findNode("P0"), &copy.places()[0]);
+    ASSERT_EQ(copy.findNode("T0"), &copy.transitions()[0]);
+    ASSERT_EQ(copy.findArc(*copy.findNode("P0"), *copy.findNode("T0")), &copy.arcs()[0]);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestPetriNet, TestIncrementalArcsInArcsOut)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+
+    // Complete bipartite net between 10 places and 10 transitions.
+    for (size_t i = 0u; i < 10u; ++i)
+    {
+        net.addPlace(float(i), 0.0f, i);
+        net.addTransition(float(i), 1.0f);
+    }
+    for (size_t i = 0u; i < 10u; ++i)
+    {
+        for (size_t j = 0u; j < 10u; ++j)
+        {
+            ASSERT_EQ(net.addArc(*net.findPlace(i), *net.findTransition(j)), true);
+            ASSERT_EQ(net.addArc(*net.findTransition(j), *net.findPlace(i), float(j)), true);
+        }
+    }
+    ASSERT_EQ(net.m_arcs.size(), 200u);
+    ASSERT_TRUE(net.sanityArcsInArcsOut());
+    for (auto const& p: net.places())
+    {
+        ASSERT_EQ(p.arcsIn.size(), 10u);
+        ASSERT_EQ(p.arcsOut.size(), 10u);
+    }
+
+    // Incremental updates shall give the same result than a full rebuild.
+    auto check = [](Net& n)
+    {
+        ASSERT_TRUE(n.sanityArcsInArcsOut());
+        std::vector<std::vector<Arc*>> adjacency;
+        for (auto const& p: n.places())
+        {
+            adjacency.push_back(p.arcsIn);
+            adjacency.push_back(p.arcsOut);
+        }
+        for (auto const& t: n.transitions())
+        {
+            adjacency.push_back(t.arcsIn);
+            adjacency.push_back(t.arcsOut);
+        }
+        n.generateArcsInArcsOut();
+        size_t k = 0u;
+        for (auto const& p: n.places())
+        {
+            ASSERT_EQ(adjacency[k++], p.arcsIn);
+            ASSERT_EQ(adjacency[k++], p.arcsOut);
+        }
+        for (auto const& t: n.transitions())
+        {
+            ASSERT_EQ(adjacency[k++], t.arcsIn);
+            ASSERT_EQ(adjacency[k++], t.arcsOut);
+        }
+    };
+
+    ASSERT_TRUE(net.removeArc(*net.findNode("P3"), *net.findNode("T7")));
+    check(net);
+    ASSERT_TRUE(net.removeArc(*net.findNode("T0"), *net.findNode("P0")));
+    check(net);
+    net.removeNode(*net.findNode("P2"));
+    check(net);
+    net.removeNode(*net.findNode("T5"));
+    check(net);
+    net.removeNode(*net.findNode("T8"));
+    check(net);
+    net.removeNode(*net.findNode("P0"));
+    check(net);
+    ASSERT_EQ(net.m_places.size(), 8u);
+    ASSERT_EQ(net.m_transitions.size(), 8u);
+    ASSERT_EQ(net.m_arcs.size(), 2u * 8u * 8u - 1u); // P3 -> T7 removed
+
+    // Arcs between nodes of same type create intermediate nodes.
+    ASSERT_EQ(net.addArc(*net.findNode("T1"), *net.findNode("T2")), true);
+    check(net);
+    ASSERT_EQ(net.addArc(*net.findNode("P1"), *net.findNode("P3")), true);
+    check(net);
+
+    // Copy
+    Net copy(net);
+    check(copy);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestPetriNet, TestHandles)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+
+    // Invalid handles
+    ASSERT_EQ(net.node(NodeHandle()), nullptr);
+    ASSERT_EQ(net.arc(ArcHandle()), nullptr);
+
+    Place& p0 = net.addPlace(0.0f, 0.0f, 0u);
+    Place& p1 = net.addPlace(1.0f, 0.0f, 1u);
+    Place& p2 = net.addPlace(2.0f, 0.0f, 2u);
+    Transition& t0 = net.addTransition(0.0f, 1.0f);
+    Transition& t1 = net.addTransition(1.0f, 1.0f);
+    ASSERT_EQ(net.addArc(p0, t0), true);
+    ASSERT_EQ(net.addArc(t0, p1), true);
+    ASSERT_EQ(net.addArc(p2, t1), true);
+
+    NodeHandle hp0 = net.handle(p0);
+    NodeHandle hp2 = net.handle(p2);
+    NodeHandle ht0 = net.handle(t0);
+    NodeHandle ht1 = net.handle(t1);
+    ArcHandle ha0 = net.handle(*net.findArc(p0, t0));
+    ArcHandle ha2 = net.handle(*net.findArc(p2, t1));
+    ASSERT_NE(hp0, hp2);
+    ASSERT_EQ(hp0, net.handle(p0));
+    ASSERT_EQ(net.node(hp0), &p0);
+    ASSERT_EQ(net.node(hp2), &p2);
+    ASSERT_EQ(net.node(ht0), &t0);
+    ASSERT_EQ(net.node(ht1), &t1);
+    ASSERT_EQ(net.arc(ha0), net.findArc(p0, t0));
+    ASSERT_EQ(net.arc(ha2), net.findArc(p2, t1));
+
+    // Nodes of another net have no handle in this net
+    Net other(TypeOfNet::TimedPetriNet);
+    Place& q0 = other.addPlace(0.0f, 0.0f, 0u);
+    ASSERT_EQ(net.node(net.handle(q0)), nullptr);
+
+    // Remove P0: P2 takes its location and its identifier but its handle
+    // still refers to it while the handle to P0 becomes stale.
+    net.removeNode(p0);
+    ASSERT_EQ(net.node(hp0), nullptr);
+    ASSERT_EQ(net.arc(ha0), nullptr);
+    Node* n = net.node(hp2);
+    ASSERT_NE(n, nullptr);
+    ASSERT_STREQ(n->key().c_str(), "P0");
+    ASSERT_EQ(n->x, 2.0f);
+    ASSERT_EQ(reinterpret_cast<Place*>(n)->tokens, 2u);
+    Arc* a = net.arc(ha2);
+    ASSERT_NE(a, nullptr);
+    ASSERT_EQ(&a->from, n);
+    ASSERT_EQ(&a->to, net.node(ht1));
+
+    // Copies keep handles valid
+    Net copy(net);
+    ASSERT_EQ(copy.node(hp0), nullptr);
+    ASSERT_EQ(copy.node(hp2), &copy.places()[0]);
+    ASSERT_EQ(copy.arc(ha2), copy.findArc(copy.places()[0], copy.transitions()[1]));
+
+    // Recycled slots do not revive stale handles
+    Place& p3 = net.addPlace(3.0f, 0.0f, 3u);
+    NodeHandle hp3 = net.handle(p3);
+    ASSERT_EQ(hp3.slot, hp0.slot);
+    ASSERT_NE(hp3, hp0);
+    ASSERT_EQ(net.node(hp0), nullptr);
+    ASSERT_EQ(net.node(hp3), &p3);
+
+    // Remove arc
+    ASSERT_EQ(net.removeArc(*net.arc(ha2)), true);
+    ASSERT_EQ(net.arc(ha2), nullptr);
+    ASSERT_NE(net.node(ht0), nullptr);
+
+    // Clear
+    net.clear();
+    ASSERT_EQ(net.node(hp2), nullptr);
+    ASSERT_EQ(net.node(ht0), nullptr);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestPetriNet, TestCaptions)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+
+    // Default captions follow the key
+    Place& p0 = net.addPlace(0.0f, 0.0f, 0u);
+    Place& p1 = net.addPlace(1u, "P1", 1.0f, 0.0f, 0u);
+    ASSERT_EQ(p0.hasDefaultCaption(), true);
+    ASSERT_EQ(p1.hasDefaultCaption(), true);
+    ASSERT_STREQ(p0.caption().c_str(), "P0");
+    ASSERT_STREQ(p1.caption().c_str(), "P1");
+
+    // Identical captions are shared
+    Place& p2 = net.addPlace(2u, "Buffer", 2.0f, 0.0f, 0u);
+    Transition& t0 = net.addTransition(0u, "Buffer", 0.0f, 1.0f, 0);
+    ASSERT_EQ(p2.hasDefaultCaption(), false);
+    ASSERT_STREQ(p2.caption().c_str(), "Buffer");
+    ASSERT_STREQ(t0.caption().c_str(), "Buffer");
+    ASSERT_EQ(p2.m_caption, t0.m_caption);
+
+    // Setter
+    p0.caption("Buffer");
+    ASSERT_EQ(p0.m_caption, p2.m_caption);
+    p0.caption("");
+    ASSERT_EQ(p0.hasDefaultCaption(), true);
+    ASSERT_STREQ(p0.caption().c_str(), "P0");
+
+    // Renumbered nodes: default captions follow the new key, custom captions
+    // are kept.
+    net.removeNode(p0);
+    ASSERT_STREQ(net.places()[0].key().c_str(), "P0");
+    ASSERT_STREQ(net.places()[0].caption().c_str(), "Buffer");
+    net.removeNode(net.places()[0]);
+    ASSERT_STREQ(net.places()[0].key().c_str(), "P0");
+    ASSERT_STREQ(net.places()[0].caption().c_str(), "P0");
+    ASSERT_EQ(net.places()[0].x, 1.0f);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestPetriNet, TestCopyAndMove)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 1u);
+    Place& p1 = net.addPlace(1.0f, 0.0f, 2u);
+    Transition& t0 = net.addTransition(0.0f, 1.0f);
+    p1.caption("Buffer");
+    ASSERT_EQ(net.addArc(p0, t0, 2.0f), true);
+    ASSERT_EQ(net.addArc(t0, p1, 3.0f), true);
+    ASSERT_EQ(net.addArc(p1, t0), true);
+    net.name = "foo";
+
+    // Copy: same content but nodes and arcs belong to the copy
+    Net copy(net);
+    ASSERT_EQ(copy.name, "foo");
+    ASSERT_EQ(copy.places().size(), 2u);
+    ASSERT_EQ(copy.transitions().size(), 1u);
+    ASSERT_EQ(copy.arcs().size(), 3u);
+    ASSERT_STREQ(copy.places()[1].caption().c_str(), "Buffer");
+    ASSERT_EQ(copy.places()[1].tokens, 2u);
+    for (size_t i = 0u; i < copy.arcs().size(); ++i)
+    {
+        Arc const& a = copy.arcs()[i];
+        Arc const& b = net.arcs()[i];
+        ASSERT_EQ(a.from.key(), b.from.key());
+        ASSERT_EQ(a.to.key(), b.to.key());
+        ASSERT_EQ(&a.from, copy.findNode(a.from.key()));
+        ASSERT_EQ(&a.to, copy.findNode(a.to.key()));
+    }
+    ASSERT_EQ(copy.transitions()[0].arcsIn.size(), 2u);
+    ASSERT_EQ(copy.transitions()[0].arcsIn[0], &copy.arcs()[0]);
+    ASSERT_EQ(copy.transitions()[0].arcsIn[1], &copy.arcs()[2]);
+    ASSERT_EQ(copy.transitions()[0].arcsOut[0], &copy.arcs()[1]);
+    ASSERT_EQ(copy.findArc(copy.places()[0], copy.transitions()[0]), &copy.arcs()[0]);
+    ASSERT_EQ(copy.sanityArcsInArcsOut(), true);
+
+    // Copy operator
+    Net other(TypeOfNet::PetriNet);
+    other.addPlace(0.0f, 0.0f, 0u);
+    other = net;
+    ASSERT_EQ(other.type(), TypeOfNet::TimedPetriNet);
+    ASSERT_EQ(other.arcs().size(), 3u);
+    ASSERT_EQ(other.sanityArcsInArcsOut(), true);
+
+    // Move: nodes and arcs are not relocated
+    Arc* a0 = &net.arcs()[0];
+    Net moved(std::move(net));
+    ASSERT_EQ(&moved.places()[0], &p0);
+    ASSERT_EQ(&moved.transitions()[0], &t0);
+    ASSERT_EQ(&moved.arcs()[0], a0);
+    ASSERT_EQ(moved.findArc(p0, t0), a0);
+    ASSERT_EQ(moved.node(moved.handle(p1)), &p1);
+    ASSERT_EQ(moved.sanityArcsInArcsOut(), true);
+    ASSERT_EQ(net.isEmpty(), true);
+
+    // Move operator
+    other = std::move(moved);
+    ASSERT_EQ(&other.places()[1], &p1);
+    ASSERT_EQ(other.arcs().size(), 3u);
+    ASSERT_EQ(moved.isEmpty(), true);
+
+    // The moved-from net is still usable
+    Place& q = moved.addPlace(0.0f, 0.0f, 0u);
+    ASSERT_STREQ(q.key().c_str(), "P0");
+}
+
+//------------------------------------------------------------------------------
+TEST(TestPetriNet, TestSettingsPerNet)
+{
+    Net grafcet(TypeOfNet::GRAFCET);
+    Net petri(TypeOfNet::PetriNet);
+    ASSERT_EQ(grafcet.settings().maxTokens, 1u);
+    ASSERT_EQ(petri.settings().maxTokens, std::numeric_limits<size_t>::max());
+
+    // Settings of a net do not impact the other net
+    Place& p0 = grafcet.addPlace(0.0f, 0.0f, 5u);
+    Place& p1 = petri.addPlace(0.0f, 0.0f, 5u);
+    ASSERT_EQ(p0.tokens, 1u);
+    ASSERT_EQ(p1.tokens, 5u);
+    p0.increment();
+    p1.increment();
+    ASSERT_EQ(p0.tokens, 1u);
+    ASSERT_EQ(p1.tokens, 6u);
+    ASSERT_EQ(&p0.settings(), &grafcet.settings());
+
+    // Creating a net of another type does not impact existing nets
+    Net other(TypeOfNet::GRAFCET);
+    p1.increment();
+    ASSERT_EQ(p1.tokens, 7u);
+
+    // Copied and moved nodes refer to the settings of their new net
+    Net copy(grafcet);
+    ASSERT_EQ(&copy.places()[0].settings(), &copy.settings());
+    Net moved(std::move(petri));
+    ASSERT_EQ(&moved.places()[0].settings(), &moved.settings());
+    moved.places()[0].increment();
+    ASSERT_EQ(moved.places()[0].tokens, 8u);
+
+    // Firing policy
+    Transition& t0 = moved.addTransition(1.0f, 0.0f);
+    ASSERT_EQ(moved.addArc(moved.places()[0], t0), true);
+    t0.receptivity = true;
+    ASSERT_EQ(t0.countBurnableTokens(), 1u);
+    Net::Settings settings = moved.settings();
+    settings.firing = Net::Settings::Fire::MaxPossible;
+    moved.settings(settings);
+    ASSERT_EQ(t0.countBurnableTokens(), 8u);
+    ASSERT_EQ(petri.isEmpty(), true);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestPetriNet, TestWeightedArcs)
+{
+    // P0 -(2)-> T0 -(3)-> P1
+    Net net(TypeOfNet::PetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 1u);
+    Place& p1 = net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    ASSERT_EQ(net.addArc(p0, t0, 0.0f, 2u), true);
+    ASSERT_EQ(net.addArc(t0, p1, 0.0f, 3u), true);
+    ASSERT_EQ(net.arcs()[0].weight, 2u);
+    ASSERT_EQ(net.arcs()[1].weight, 3u);
+    t0.receptivity = true;
+
+    // Null weights and duplicated arcs are refused
+    Transition& t1 = net.addTransition(0.0f, 0.0f);
+    ASSERT_EQ(net.addArc(p1, t1, 0.0f, 0u), false);
+    ASSERT_EQ(net.addArc(p0, t0, 0.0f, 4u), false);
+    ASSERT_EQ(net.arcs().size(), 2u);
+
+    // Not enough tokens for the weight
+    ASSERT_EQ(t0.isValidated(), false);
+    ASSERT_EQ(t0.countBurnableTokens(), 0u);
+
+    // Burnable tokens are counted in number of firings
+    p0.tokens = 5u;
+    ASSERT_EQ(t0.isValidated(), true);
+    ASSERT_EQ(t0.countBurnableTokens(), 1u);
+    Net::Settings settings = net.settings();
+    settings.firing = Net::Settings::Fire::MaxPossible;
+    net.settings(settings);
+    ASSERT_EQ(t0.countBurnableTokens(), 2u);
+
+    // Weights are kept by copies
+    Net copy(net);
+    ASSERT_EQ(copy.arcs()[0].weight, 2u);
+    ASSERT_EQ(copy.arcs()[1].weight, 3u);
+}
@@ -0,0 +1,177 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+
+#include "main.hpp"
+#include "Net/Simulation.hpp"
+#include <thread>
+
+using namespace ::tpne;
+
+//------------------------------------------------------------------------------
+TEST(TestSimulation, TestTripleBuffer)
+{
+    TripleBuffer<int> buffer;
+    ASSERT_EQ(buffer.update(), false);
+
+    buffer.back() = 1;
+    buffer.publish();
+    buffer.back() = 2;
+    buffer.publish();
+
+    // Only the latest published value is taken.
+    ASSERT_EQ(buffer.update(), true);
+    ASSERT_EQ(buffer.front(), 2);
+    ASSERT_EQ(buffer.update(), false);
+    ASSERT_EQ(buffer.front(), 2);
+
+    // The producer never writes in the front slot.
+    buffer.back() = 3;
+    ASSERT_EQ(buffer.front(), 2);
+    buffer.publish();
+    ASSERT_EQ(buffer.update(), true);
+    ASSERT_EQ(buffer.front(), 3);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestSimulation, TestWorkerThread)
+{
+    // Tokens loop between P0 and P1.
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 1u);
+    Place& p1 = net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    Transition& t1 = net.addTransition(0.0f, 0.0f);
+    net.addArc(p0, t0);
+    net.addArc(t0, p1, 0.1f);
+    net.addArc(p1, t1);
+    net.addArc(t1, p0, 0.1f);
+
+    Messages messages;
+    Simulation simulation(net, messages);
+    simulation.speed(10.0f);
+    simulation.running = true;
+
+    // The simulation advances without blocking the calling thread.
+    simulation.step(0.0f);
+    auto const start = std::chrono::steady_clock::now();
+    while ((simulation.time() < 1.0) &&
+           (std::chrono::steady_clock::now() - start < std::chrono::seconds(5)))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        simulation.step(0.0f);
+    }
+    ASSERT_GE(simulation.time(), 1.0);
+    ASSERT_EQ(p0.tokens + p1.tokens + simulation.timedTokens().size(), 1u);
+
+    // Halting restores the initial marking.
+    simulation.running = false;
+    simulation.step(0.0f);
+    simulation.step(0.0f);
+    ASSERT_EQ(p0.tokens, 1u);
+    ASSERT_EQ(p1.tokens, 0u);
+    ASSERT_EQ(simulation.timedTokens().size(), 0u);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestSimulation, TestStaleTokens)
+{
+    // P0 (1 token) -> T0 -> P1
+    Net net(TypeOfNet::PetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 1u);
+    Place& p1 = net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    net.addArc(p0, t0);
+    net.addArc(t0, p1);
+
+    Messages messages;
+    Simulation simulation(net, messages);
+    simulation.speed(10.0f);
+    simulation.running = true;
+    simulation.step(0.0f);
+
+    auto const wait = [&](std::chrono::milliseconds const duration)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start < duration)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            simulation.step(0.0f);
+        }
+    };
+
+    // The user fires T0 then adds a token in P0 before seeing the firing: the
+    // token consumed by T0 shall not come back.
+    wait(std::chrono::milliseconds(50));
+    t0.receptivity = true;
+    simulation.step(0.0f);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    p0.tokens += 1u;
+    simulation.step(0.0f);
+    wait(std::chrono::milliseconds(500));
+    ASSERT_EQ(p0.tokens + p1.tokens + simulation.timedTokens().size(), 2u);
+
+    // Two additions before the next frame are both applied.
+    p0.tokens += 1u;
+    simulation.step(0.0f);
+    p0.tokens += 1u;
+    simulation.step(0.0f);
+    wait(std::chrono::milliseconds(500));
+    ASSERT_EQ(p0.tokens + p1.tokens + simulation.timedTokens().size(), 4u);
+
+    simulation.running = false;
+    simulation.step(0.0f);
+    simulation.step(0.0f);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestSimulation, TestOverflow)
+{
+#if defined(TPNE_COMPACT_INDEX)
+    // P0 -> T0 -(2)-> P1 where P1 cannot hold the produced tokens.
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 1u);
+    Place& p1 = net.addPlace(0.0f, 0.0f, CompiledNet::maxCount() - 1u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    net.addArc(p0, t0);
+    net.addArc(t0, p1, 0.01f, 2u);
+
+    Messages messages;
+    Simulation simulation(net, messages);
+    simulation.speed(10.0f);
+    simulation.running = true;
+
+    // The simulation halts and reports the lost tokens.
+    simulation.step(0.0f);
+    auto const start = std::chrono::steady_clock::now();
+    while (simulation.running &&
+           (std::chrono::steady_clock::now() - start < std::chrono::seconds(5)))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        simulation.step(0.0f);
+    }
+    ASSERT_EQ(simulation.running, false);
+    ASSERT_EQ(messages.getMessage().level, Messages::Level::Error);
+    ASSERT_STREQ(messages.getMessage().message.c_str(),
+                 "Places cannot hold more than 4294967295 tokens: tokens have been lost");
+    simulation.step(0.0f);
+    ASSERT_EQ(p1.tokens, CompiledNet::maxCount() - 1u);
+#endif
+}
@@ -0,0 +1,246 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "main.hpp"
+#include "TimedPetriNetEditor/PetriNet.hpp"
+#include "TimedPetriNetEditor/StochasticSimulator.hpp"
+
+using namespace ::tpne;
+
+//------------------------------------------------------------------------------
+static Distribution law(Distribution::Law const type, float const a, float const b = 0.0f)
+{
+    Distribution distribution;
+    distribution.law = type;
+    distribution.a = a;
+    distribution.b = b;
+    return distribution;
+}
+
+//------------------------------------------------------------------------------
+TEST(TestStochasticSimulator, TestSamplers)
+{
+    Distribution const laws[] = {
+        law(Distribution::Law::Deterministic, 1.5f),
+        law(Distribution::Law::Exponential, 2.0f),
+        law(Distribution::Law::Uniform, 1.0f, 3.0f),
+        law(Distribution::Law::Erlang, 4.0f, 2.0f),
+        law(Distribution::Law::Weibull, 2.0f, 3.0f),
+    };
+
+    FiringPolicy::Random random;
+    random.state = 42u;
+    for (auto const& it: laws)
+    {
+        double sum = 0.0;
+        for (size_t i = 0u; i < 100000u; ++i)
+        {
+            double const delay = StochasticSimulator::sample(it, random);
+            ASSERT_GE(delay, 0.0);
+            sum += delay;
+        }
+        ASSERT_NEAR(sum / 100000.0, it.mean(), 0.02 * it.mean());
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(TestStochasticSimulator, TestQueue)
+{
+    // M/M/1 queue: T0 -> P0 -> T1 with arrivals of rate 1 and services of
+    // rate 2. The mean number of customers is rho / (1 - rho) = 1.
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    Transition& t1 = net.addTransition(0.0f, 0.0f);
+    net.addArc(t0, p0, 0.0f);
+    net.addArc(p0, t1);
+    t0.delay = law(Distribution::Law::Exponential, 1.0f);
+    t1.delay = law(Distribution::Law::Exponential, 2.0f);
+    net.resetReceptivies();
+
+    StochasticSimulator simulator(net, 42u);
+    ASSERT_STREQ(simulator.error().c_str(), "");
+    ASSERT_EQ(simulator.waiting(), true);
+    simulator.runUntil(200000.0);
+    ASSERT_EQ(simulator.time(), 200000.0);
+    ASSERT_EQ(simulator.firings(), simulator.firings(0u) + simulator.firings(1u));
+    ASSERT_NEAR(simulator.throughput(0u), 1.0, 0.02);
+    ASSERT_NEAR(simulator.throughput(1u), 1.0, 0.02);
+    ASSERT_NEAR(simulator.meanTokens(0u), 1.0, 0.1);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestStochasticSimulator, TestRace)
+{
+    // The token of P0 is raced by T0 (rate 1) and T1 (rate 3), both giving it
+    // back: T1 wins 3 times out of 4.
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 1u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    Transition& t1 = net.addTransition(0.0f, 0.0f);
+    net.addArc(p0, t0);
+    net.addArc(t0, p0, 0.0f);
+    net.addArc(p0, t1);
+    net.addArc(t1, p0, 0.0f);
+    t0.delay = law(Distribution::Law::Exponential, 1.0f);
+    t1.delay = law(Distribution::Law::Exponential, 3.0f);
+    net.resetReceptivies();
+
+    StochasticSimulator simulator(net, 7u);
+    ASSERT_EQ(simulator.runUntil(1e9, 100000u), 100000u);
+    ASSERT_NEAR(double(simulator.firings(1u)) / 100000.0, 0.75, 0.01);
+    ASSERT_NEAR(simulator.throughput(0u) + simulator.throughput(1u), 4.0, 0.1);
+    ASSERT_NEAR(simulator.meanTokens(0u), 1.0, 1e-9);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestStochasticSimulator, TestReproducible)
+{
+    // P0 (1 token) -> T0 -> P1 -> T1 -> P0 with uniform delays.
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 1u);
+    Place& p1 = net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    Transition& t1 = net.addTransition(0.0f, 0.0f);
+    net.addArc(p0, t0);
+    net.addArc(t0, p1, 0.0f);
+    net.addArc(p1, t1);
+    net.addArc(t1, p0, 0.0f);
+    t0.delay = law(Distribution::Law::Uniform, 1.0f, 2.0f);
+    net.resetReceptivies();
+
+    // Deterministic delays of T1 can be overridden.
+    StochasticSimulator s1(net, 1u);
+    StochasticSimulator s2(net, 1u);
+    StochasticSimulator s3(net, 2u);
+    s1.delay(1u, law(Distribution::Law::Deterministic, 0.5f));
+    s2.delay(1u, law(Distribution::Law::Deterministic, 0.5f));
+    s3.delay(1u, law(Distribution::Law::Deterministic, 0.5f));
+    s1.runUntil(100.0);
+    s2.runUntil(100.0);
+    s3.runUntil(100.0);
+    ASSERT_EQ(s1.firings(), s2.firings());
+    ASSERT_EQ(s1.nextTime(), s2.nextTime());
+    ASSERT_NE(s1.nextTime(), s3.nextTime());
+    ASSERT_EQ(s1.firings(0u), s1.firings(1u) + s1.compiled().tokens(1u));
+    ASSERT_NEAR(s1.throughput(0u), 1.0 / 2.0, 0.05);
+
+    // Without tokens, nothing is scheduled.
+    net.places()[0].tokens = 0u;
+    StochasticSimulator s4(net);
+    ASSERT_EQ(s4.waiting(), false);
+    ASSERT_EQ(s4.step(), false);
+    ASSERT_EQ(s4.runUntil(10.0), 0u);
+    ASSERT_EQ(s4.time(), 10.0);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestStochasticSimulator, TestInvalidDelays)
+{
+    // P0 (1 token) -> T0 -> P0
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 1u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    net.addArc(p0, t0);
+    net.addArc(t0, p0, 0.0f);
+    net.resetReceptivies();
+
+    struct Case { Distribution delay; const char* error; };
+    Case const cases[] = {
+        { law(Distribution::Law::Deterministic, -1.0f),
+          "Transition T0 has an invalid delay: a deterministic delay shall not be negative" },
+        { law(Distribution::Law::Exponential, -2.0f),
+          "Transition T0 has an invalid delay: the rate of an exponential law shall be positive" },
+        { law(Distribution::Law::Exponential, 0.0f),
+          "Transition T0 has an invalid delay: the rate of an exponential law shall be positive" },
+        { law(Distribution::Law::Uniform, 3.0f, 1.0f),
+          "Transition T0 has an invalid delay: the bounds of an uniform law shall be 0 <= a <= b" },
+        { law(Distribution::Law::Erlang, 0.0f, 2.0f),
+          "Transition T0 has an invalid delay: the rate of an Erlang law shall be positive" },
+        { law(Distribution::Law::Erlang, 1.0f, 0.0f),
+          "Transition T0 has an invalid delay: an Erlang law shall have at least one phase" },
+        { law(Distribution::Law::Weibull, 0.0f, 1.0f),
+          "Transition T0 has an invalid delay: the shape and the scale of a Weibull law shall be positive" },
+    };
+
+    StochasticSimulator simulator;
+    for (auto const& it: cases)
+    {
+        t0.delay = it.delay;
+        ASSERT_EQ(simulator.reset(net), false);
+        ASSERT_STREQ(simulator.error().c_str(), it.error);
+        ASSERT_EQ(simulator.waiting(), false);
+        ASSERT_EQ(simulator.runUntil(10.0), 0u);
+    }
+
+    t0.delay = law(Distribution::Law::Weibull, 1.0f, 1.0f);
+    ASSERT_EQ(simulator.reset(net), true);
+    ASSERT_STREQ(simulator.error().c_str(), "");
+    ASSERT_EQ(simulator.waiting(), true);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestStochasticSimulator, TestImmediateCycles)
+{
+    // P0 (1 token) -> T0 -> P0 with the default immediate delay would fire
+    // forever at the time 0.
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 1u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    net.addArc(p0, t0);
+    net.addArc(t0, p0, 0.0f);
+    net.resetReceptivies();
+
+    StochasticSimulator simulator;
+    ASSERT_EQ(simulator.reset(net), false);
+    ASSERT_STREQ(simulator.error().c_str(), "Transition T0 is in a cycle of immediate "
+                 "transitions: they would fire forever at the same time");
+    ASSERT_EQ(simulator.runUntil(10.0), 0u);
+
+    // Longer cycle: P0 -> T0 -> P1 -> T1 -> P0, T1 also feeding a timed T2.
+    Place& p1 = net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t1 = net.addTransition(0.0f, 0.0f);
+    Transition& t2 = net.addTransition(0.0f, 0.0f);
+    net.removeArc(t0, p0);
+    net.addArc(t0, p1, 0.0f);
+    net.addArc(p1, t2);
+    net.addArc(p1, t1);
+    net.addArc(t1, p0, 0.0f);
+    t2.delay = law(Distribution::Law::Exponential, 1.0f);
+    net.resetReceptivies();
+    ASSERT_EQ(simulator.reset(net), false);
+    ASSERT_STREQ(simulator.error().c_str(), "Transition T0 is in a cycle of immediate "
+                 "transitions: they would fire forever at the same time");
+
+    // A timed transition in the cycle lets the time advance.
+    t1.delay = law(Distribution::Law::Uniform, 0.0f, 1.0f);
+    ASSERT_EQ(simulator.reset(net), true);
+    simulator.runUntil(10.0);
+    ASSERT_EQ(simulator.time(), 10.0);
+
+    // Immediate transitions without upstream place fire forever too.
+    Place& p2 = net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t3 = net.addTransition(0.0f, 0.0f);
+    net.addArc(t3, p2, 0.0f);
+    net.resetReceptivies();
+    ASSERT_EQ(simulator.reset(net), false);
+    ASSERT_STREQ(simulator.error().c_str(), "Transition T3 is immediate without upstream "
+                 "place: it would fire forever at the same time");
+}
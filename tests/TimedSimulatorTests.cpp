@@ -0,0 +1,387 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "main.hpp"
+#define protected public
+#define private public
+#  include "TimedPetriNetEditor/PetriNet.hpp"
+#  include "TimedPetriNetEditor/TimedSimulator.hpp"
+#undef protected
+#undef private
+
+using namespace ::tpne;
+
+//------------------------------------------------------------------------------
+//! \brief Record events of the simulation.
+class Recorder: public TimedSimulator::Observer
+{
+public:
+
+    virtual void onFired(double const time, size_t const transition,
+                         size_t const count) override
+    {
+        fired.push_back({ time, transition, count });
+    }
+
+    virtual void onDeparted(double const /*time*/, size_t const /*arc*/,
+                            size_t const /*tokens*/, double const /*arrival*/) override
+    {
+        ++departures;
+    }
+
+    virtual void onArrived(double const time, size_t const /*arc*/,
+                           size_t const place, size_t const tokens) override
+    {
+        arrived.push_back({ time, place, tokens });
+    }
+
+    struct Record { double time; size_t id; size_t count; };
+    std::vector<Record> fired;
+    std::vector<Record> arrived;
+    size_t departures = 0u;
+};
+
+//------------------------------------------------------------------------------
+TEST(TestTimedSimulator, TestStep)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+    createCycle(net);
+
+    TimedSimulator simulator(net);
+    Recorder recorder;
+    simulator.addObserver(recorder);
+    ASSERT_STREQ(simulator.error().c_str(), "");
+    ASSERT_EQ(simulator.time(), 0.0);
+
+    // T0 fires and its token arrives in P1 after 3 units of time
+    ASSERT_EQ(simulator.step(), true);
+    ASSERT_EQ(simulator.time(), 3.0);
+    ASSERT_EQ(simulator.compiled().tokens(0u), 0u);
+    ASSERT_EQ(simulator.compiled().tokens(1u), 1u);
+    ASSERT_EQ(recorder.fired.size(), 1u);
+    ASSERT_EQ(recorder.fired[0].id, 0u);
+    ASSERT_EQ(recorder.departures, 1u);
+    ASSERT_EQ(recorder.arrived.size(), 1u);
+    ASSERT_EQ(recorder.arrived[0].time, 3.0);
+    ASSERT_EQ(recorder.arrived[0].id, 1u);
+
+    // T1 fires and its token arrives in P0 after 2 units of time
+    ASSERT_EQ(simulator.step(), true);
+    ASSERT_EQ(simulator.time(), 5.0);
+    ASSERT_EQ(simulator.compiled().tokens(0u), 1u);
+    ASSERT_EQ(simulator.compiled().tokens(1u), 0u);
+    ASSERT_EQ(simulator.firings(), 2u);
+
+    // The net is not modified until written back
+    ASSERT_EQ(net.places()[0].tokens, 1u);
+    simulator.compiled().writeMarking(net);
+    ASSERT_EQ(net.places()[0].tokens, 1u);
+    ASSERT_EQ(net.places()[1].tokens, 0u);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestTimedSimulator, TestRunUntil)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+    createCycle(net);
+
+    // T0 fires at 0, 5, ... 100 and T1 at 3, 8, ... 98
+    TimedSimulator simulator(net);
+    ASSERT_EQ(simulator.runUntil(100.0), 41u);
+    ASSERT_EQ(simulator.time(), 100.0);
+    ASSERT_EQ(simulator.pending(), 1u);
+    ASSERT_EQ(simulator.nextTime(), 103.0);
+    ASSERT_EQ(simulator.compiled().tokens(0u), 0u);
+    ASSERT_EQ(simulator.compiled().tokens(1u), 0u);
+
+    // Nothing happens between two events
+    ASSERT_EQ(simulator.runUntil(102.0), 0u);
+    ASSERT_EQ(simulator.time(), 102.0);
+
+    // Reset restarts from the marking of the net
+    ASSERT_EQ(simulator.reset(net), true);
+    ASSERT_EQ(simulator.time(), 0.0);
+    ASSERT_EQ(simulator.pending(), 0u);
+    ASSERT_EQ(simulator.firings(), 0u);
+    ASSERT_EQ(simulator.compiled().tokens(0u), 1u);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestTimedSimulator, TestRunUntilBudget)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+    createCycle(net);
+
+    // Stop once 10 firings are reached: T0 fires at 0, 5, ... 20 and T1 at
+    // 3, 8, ... 23.
+    TimedSimulator simulator(net);
+    auto const never = std::chrono::steady_clock::time_point::max();
+    ASSERT_EQ(simulator.runUntil(100.0, 10u, never), 10u);
+    ASSERT_EQ(simulator.time(), 23.0);
+    ASSERT_EQ(simulator.firings(), 10u);
+
+    // Continue until the time.
+    ASSERT_EQ(simulator.runUntil(100.0, 1000u, never), 31u);
+    ASSERT_EQ(simulator.time(), 100.0);
+
+    // Deadline already passed: the clock is read every 16 instants.
+    ASSERT_EQ(simulator.reset(net), true);
+    auto const past = std::chrono::steady_clock::now();
+    ASSERT_EQ(simulator.runUntil(100.0, 1000u, past), 16u);
+    ASSERT_EQ(simulator.time(), 38.0);
+    ASSERT_EQ(simulator.runUntil(100.0, 1000u, past), 15u);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestTimedSimulator, TestDeadlock)
+{
+    // P0 (2 tokens) -> T0 -(1)-> P1
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 2u);
+    Place& p1 = net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    net.addArc(p0, t0);
+    net.addArc(t0, p1, 1.0f);
+    net.resetReceptivies();
+
+    // Both tokens are carried together
+    TimedSimulator simulator(net);
+    Recorder recorder;
+    simulator.addObserver(recorder);
+    ASSERT_EQ(simulator.step(), true);
+    ASSERT_EQ(simulator.time(), 1.0);
+    ASSERT_EQ(simulator.compiled().tokens(1u), 2u);
+    ASSERT_EQ(recorder.arrived.size(), 1u);
+    ASSERT_EQ(recorder.arrived[0].count, 2u);
+    ASSERT_EQ(simulator.step(), false);
+    ASSERT_EQ(simulator.time(), 1.0);
+
+    // Removed observers are no longer notified
+    simulator.removeObserver(recorder);
+    simulator.reset(net);
+    simulator.step();
+    ASSERT_EQ(recorder.arrived.size(), 1u);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestTimedSimulator, TestSourceTransition)
+{
+    // T0 -(1)-> P0: the source fires again once its token has arrived
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    net.addArc(t0, p0, 1.0f);
+    net.resetReceptivies();
+
+    TimedSimulator simulator(net);
+    ASSERT_EQ(simulator.runUntil(10.0), 11u);
+    ASSERT_EQ(simulator.compiled().tokens(0u), 10u);
+
+    // In Petri nets, tokens are not timed and the user has to click again on
+    // source transitions.
+    Net petri(TypeOfNet::PetriNet);
+    petri = net;
+    petri.m_type = TypeOfNet::PetriNet;
+    petri.transitions()[0].receptivity = true;
+    simulator.reset(petri);
+    ASSERT_EQ(simulator.runUntil(10.0), 1u);
+    ASSERT_EQ(simulator.compiled().tokens(0u), 1u);
+    ASSERT_EQ(simulator.compiled().receptivity(0u), false);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestTimedSimulator, TestReproducible)
+{
+    // P0 (100 tokens) -> T0 -(1)-> P1 and P0 -> T1 -(1)-> P2: conflict
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 100u);
+    Place& p1 = net.addPlace(0.0f, 0.0f, 0u);
+    Place& p2 = net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    Transition& t1 = net.addTransition(0.0f, 0.0f);
+    net.addArc(p0, t0);
+    net.addArc(p0, t1);
+    net.addArc(t0, p1, 1.0f);
+    net.addArc(t1, p2, 1.0f);
+    net.resetReceptivies();
+
+    TimedSimulator s1(net);
+    TimedSimulator s2(net);
+    Recorder r1, r2;
+    s1.addObserver(r1);
+    s2.addObserver(r2);
+    s1.seed(42u);
+    s2.seed(42u);
+    s1.runUntil(1.0);
+    s2.runUntil(1.0);
+
+    ASSERT_EQ(s1.compiled().tokens(1u) + s1.compiled().tokens(2u), 100u);
+    ASSERT_EQ(s1.compiled().tokens(1u), s2.compiled().tokens(1u));
+    ASSERT_EQ(s1.firings(), 100u);
+    ASSERT_EQ(r1.fired.size(), r2.fired.size());
+    for (size_t i = 0u; i < r1.fired.size(); ++i)
+    {
+        ASSERT_EQ(r1.fired[i].id, r2.fired[i].id);
+        ASSERT_EQ(r1.fired[i].count, r2.fired[i].count);
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(TestTimedSimulator, TestBulkFiring)
+{
+    // P0 (10^6 + 1 tokens) -> T0, T1, T2 -(1)-> P2, P3, P4 and P1 (2 tokens)
+    // -> T2: T2 fires twice only.
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 1000001u);
+    Place& p1 = net.addPlace(0.0f, 0.0f, 2u);
+    for (size_t i = 0u; i < 3u; ++i)
+    {
+        Place& p = net.addPlace(0.0f, 0.0f, 0u);
+        Transition& t = net.addTransition(0.0f, 0.0f);
+        net.addArc(net.places()[0], t);
+        net.addArc(t, p, 1.0f);
+    }
+    net.addArc(p1, net.transitions()[2]);
+    net.resetReceptivies();
+    ASSERT_EQ(p0.tokens, 1000001u);
+
+    // Tokens are divided kindly between T0 and T1. Each transition is
+    // notified a few times only.
+    TimedSimulator simulator(net);
+    Recorder recorder;
+    simulator.addObserver(recorder);
+    ASSERT_EQ(simulator.fire(), 1000001u);
+    ASSERT_LT(recorder.fired.size(), 10u);
+    ASSERT_EQ(simulator.compiled().tokens(0u), 0u);
+    ASSERT_EQ(simulator.compiled().tokens(1u), 0u);
+
+    simulator.runUntil(1.0);
+    size_t const t0 = simulator.compiled().tokens(2u);
+    size_t const t1 = simulator.compiled().tokens(3u);
+    ASSERT_EQ(simulator.compiled().tokens(4u), 2u);
+    ASSERT_EQ(t0 + t1, 999999u);
+    ASSERT_LE(std::max(t0, t1) - std::min(t0, t1), 1u);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestTimedSimulator, TestCarriedOverflow)
+{
+#if defined(TPNE_COMPACT_INDEX)
+    // P0 (maxCount() tokens) -> T0 -(2)-> P1: the arc cannot carry the
+    // produced tokens.
+    Net net(TypeOfNet::TimedPetriNet);
+    net.addPlace(0.0f, 0.0f, CompiledNet::maxCount());
+    Place& p1 = net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    net.addArc(net.places()[0], t0);
+    net.addArc(t0, p1, 1.0f, 2u);
+    net.resetReceptivies();
+
+    TimedSimulator simulator(net);
+    ASSERT_EQ(simulator.fire(), CompiledNet::maxCount());
+    ASSERT_GT(simulator.compiled().overflows(), 0u);
+    ASSERT_EQ(simulator.compiled().overflowed(), true);
+
+    simulator.runUntil(1.0);
+    ASSERT_EQ(simulator.compiled().tokens(1u), CompiledNet::maxCount());
+#endif
+}
+
+//------------------------------------------------------------------------------
+TEST(TestTimedSimulator, TestConflictFree)
+{
+    // P0 (1000 tokens) -> T0 -(1)-> P1 -> T1 -(1)-> P2: no conflict
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 1000u);
+    Place& p1 = net.addPlace(0.0f, 0.0f, 0u);
+    Place& p2 = net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    Transition& t1 = net.addTransition(0.0f, 0.0f);
+    net.addArc(p0, t0);
+    net.addArc(t0, p1, 1.0f);
+    net.addArc(p1, t1);
+    net.addArc(t1, p2, 1.0f);
+    net.resetReceptivies();
+
+    // Transitions without conflict fire all their tokens at once
+    TimedSimulator simulator(net);
+    Recorder recorder;
+    simulator.addObserver(recorder);
+    ASSERT_EQ(simulator.runUntil(2.0), 2000u);
+    ASSERT_EQ(simulator.compiled().tokens(2u), 1000u);
+    ASSERT_EQ(recorder.fired.size(), 2u);
+    ASSERT_EQ(recorder.fired[0].count, 1000u);
+    ASSERT_EQ(recorder.fired[1].count, 1000u);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestTimedSimulator, TestHoldingTime)
+{
+    // P0 (3 tokens) -> T0 -(1)-> P1 held 2 units of time -> T1 -(1)-> P2
+    Net net(TypeOfNet::TimedPetriNet);
+    Place& p0 = net.addPlace(0.0f, 0.0f, 3u);
+    Place& p1 = net.addPlace(0.0f, 0.0f, 0u);
+    Place& p2 = net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    Transition& t1 = net.addTransition(0.0f, 0.0f);
+    net.addArc(p0, t0);
+    net.addArc(t0, p1, 1.0f);
+    net.addArc(p1, t1);
+    net.addArc(t1, p2, 1.0f);
+    net.resetReceptivies();
+
+    TimedSimulator simulator(net);
+    simulator.holding(1u, 2.0f);
+    ASSERT_EQ(simulator.holding(1u), 2.0f);
+    ASSERT_EQ(simulator.holding(0u), 0.0f);
+    Recorder recorder;
+    simulator.addObserver(recorder);
+
+    // Arrived tokens are in the place but do not enable T1.
+    simulator.runUntil(2.0);
+    ASSERT_EQ(simulator.tokens(1u), 3u);
+    ASSERT_EQ(simulator.compiled().tokens(1u), 0u);
+    ASSERT_EQ(simulator.held(1u).size(), 1u);
+    ASSERT_EQ(simulator.held(1u).front().time, 3.0);
+    ASSERT_EQ(simulator.waiting(), true);
+    ASSERT_EQ(simulator.pending(), 0u);
+    ASSERT_EQ(simulator.nextTime(), 3.0);
+    TimedSimulator::Checkpoint checkpoint;
+    simulator.save(checkpoint);
+    ASSERT_EQ(checkpoint.held.size(), 1u);
+
+    // T1 fires at the earliest time its tokens are available.
+    simulator.runUntil(10.0);
+    ASSERT_EQ(recorder.fired.size(), 2u);
+    ASSERT_EQ(recorder.fired[1].time, 3.0);
+    ASSERT_EQ(recorder.fired[1].id, 1u);
+    ASSERT_EQ(simulator.tokens(2u), 3u);
+    ASSERT_EQ(simulator.held(1u).empty(), true);
+    ASSERT_EQ(simulator.waiting(), false);
+
+    // Held tokens are restored.
+    simulator.restore(checkpoint);
+    ASSERT_EQ(simulator.tokens(1u), 3u);
+    ASSERT_EQ(simulator.tokens(2u), 0u);
+    simulator.runUntil(10.0);
+    ASSERT_EQ(recorder.fired.size(), 3u);
+    ASSERT_EQ(recorder.fired[2].time, 3.0);
+    ASSERT_EQ(simulator.tokens(2u), 3u);
+}
@@ -31,71 +31,36 @@ using namespace ::tpne;
 //------------------------------------------------------------------------------
 TEST(TestPetriNet, TestTimedTokenCreation)
 {
-    // Reminder: TimedToken not made for Place -> Transition
+    // Reminder: TimedTokens not made for Place -> Transition
     Transition t1(42u, "", 3.5f, 4.0f, 45u, true);
     Place p1(43u, "", 4.6f, 5.1f, 13u);
     Arc a1(t1, p1, 10.0f);
-    TimedToken at1(a1, 3u, TypeOfNet::TimedPetriNet);
-    float norm = sqrtf((3.5f - 4.6f) * (3.5f - 4.6f) + (4.0f - 5.1f) * (4.0f - 5.1f));
-
-    ASSERT_EQ(at1.x, 3.5f);
-    ASSERT_EQ(at1.y, 4.0f);
-    ASSERT_EQ(at1.tokens, 3u);
-    ASSERT_EQ(at1.arc->from.type, Node::Transition);
-    ASSERT_EQ(at1.arc->from.id, 42u);
-    ASSERT_STREQ(at1.arc->from.key.c_str(), "T42");
-    ASSERT_EQ(at1.arc->to.type, Node::Place);
-    ASSERT_EQ(at1.arc->to.id, 43u);
-    ASSERT_STREQ(at1.arc->to.key.c_str(), "P43");
-    ASSERT_EQ(at1.magnitude, norm);
-    ASSERT_EQ(at1.speed, norm / 10.0f);
-    ASSERT_EQ(at1.offset, 0.0f);
-    ASSERT_EQ(&at1.toPlace(), &p1);
-
-    TimedToken at2(at1);
-    ASSERT_EQ(at2.x, 3.5f);
-    ASSERT_EQ(at2.y, 4.0f);
-    ASSERT_EQ(at2.tokens, 3u);
-    ASSERT_EQ(at2.arc->from.type, Node::Transition);
-    ASSERT_EQ(at2.arc->from.id, 42u);
-    ASSERT_STREQ(at2.arc->from.key.c_str(), "T42");
-    ASSERT_EQ(at2.arc->to.type, Node::Place);
-    ASSERT_EQ(at2.arc->to.id, 43u);
-    ASSERT_STREQ(at2.arc->to.key.c_str(), "P43");
-    ASSERT_EQ(at2.magnitude, norm);
-    ASSERT_EQ(at2.speed, norm / 10.0f);
-    ASSERT_EQ(at2.offset, 0.0f);
-    ASSERT_EQ(&at2.toPlace(), &p1);
-
     Transition t2(45u, "", 13.5f, 14.0f, 145u, true);
     Place p2(46u, "", 14.6f, 15.1f, 113u);
     Arc a2(t2, p2, 110.0f);
-    TimedToken at3(a2, 13u, TypeOfNet::TimedPetriNet);
-    ASSERT_EQ(at3.x, 13.5f);
-    ASSERT_EQ(at3.y, 14.0f);
-    ASSERT_EQ(at3.tokens, 13u);
-    ASSERT_EQ(at3.arc->from.type, Node::Transition);
-    ASSERT_EQ(at3.arc->from.id, 45u);
-    ASSERT_STREQ(at3.arc->from.key.c_str(), "T45");
-    ASSERT_EQ(at3.arc->to.type, Node::Place);
-    ASSERT_EQ(at3.arc->to.id, 46u);
-    ASSERT_STREQ(at3.arc->to.key.c_str(), "P46");
-    ASSERT_EQ(&at3.toPlace(), &p2);
-
-    at3 = at1;
-    ASSERT_EQ(at3.x, 3.5f);
-    ASSERT_EQ(at3.y, 4.0f);
-    ASSERT_EQ(at3.tokens, 3u);
-    ASSERT_EQ(at3.arc->from.type, Node::Transition);
-    ASSERT_EQ(at3.arc->from.id, 42u);
-    ASSERT_STREQ(at3.arc->from.key.c_str(), "T42");
-    ASSERT_EQ(at3.arc->to.type, Node::Place);
-    ASSERT_EQ(at3.arc->to.id, 43u);
-    ASSERT_STREQ(at3.arc->to.key.c_str(), "P43");
-    ASSERT_EQ(at3.magnitude, norm);
-    ASSERT_EQ(at3.speed, norm / 10.0f);
-    ASSERT_EQ(at3.offset, 0.0f);
-    ASSERT_EQ(&at3.toPlace(), &p1);
+
+    TimedTokens pool;
+    pool.spawn(a1, 3u, TypeOfNet::TimedPetriNet);
+    pool.spawn(a2, 13u, TypeOfNet::TimedPetriNet);
+    ASSERT_EQ(pool.size(), 2u);
+
+    ASSERT_EQ(pool.x(0u), 3.5f);
+    ASSERT_EQ(pool.y(0u), 4.0f);
+    ASSERT_EQ(pool.tokens(0u), 3u);
+    ASSERT_EQ(pool.offset(0u), 0.0f);
+    ASSERT_EQ(pool.arc(0u).from.type, Node::Transition);
+    ASSERT_STREQ(pool.arc(0u).from.key().c_str(), "T42");
+    ASSERT_EQ(pool.arc(0u).to.type, Node::Place);
+    ASSERT_STREQ(pool.arc(0u).to.key().c_str(), "P43");
+    ASSERT_EQ(&pool.arc(0u).to, &p1);
+
+    ASSERT_EQ(pool.x(1u), 13.5f);
+    ASSERT_EQ(pool.y(1u), 14.0f);
+    ASSERT_EQ(pool.tokens(1u), 13u);
+    ASSERT_EQ(pool.offset(1u), 0.0f);
+    ASSERT_STREQ(pool.arc(1u).from.key().c_str(), "T45");
+    ASSERT_STREQ(pool.arc(1u).to.key().c_str(), "P46");
+    ASSERT_EQ(&pool.arc(1u).to, &p2);
 }
 
 //------------------------------------------------------------------------------
@@ -105,31 +70,112 @@ TEST(TestPetriNet, TestTimedTokenUpdate)
     Transition t1(42u, "", 0.0f, 0.0f, 45u, true);
     Place p1(43u, "", 20.0f, 0.0f, 13u);
     Arc a1(t1, p1, 10.0f); // Duration: 10 units of time
-    TimedToken at1(a1, 3u, TypeOfNet::TimedPetriNet);
-    ASSERT_EQ(at1.magnitude, 20.0f);
-    ASSERT_EQ(at1.speed, 2.0f); // 20 units of distance / 10 units of time
+    TimedTokens pool;
+    pool.spawn(a1, 3u, TypeOfNet::TimedPetriNet);
 
     // 1st unit of time
-    ASSERT_EQ(at1.update(1.0f), false);
-    ASSERT_EQ(at1.offset, 0.1f);
-    ASSERT_EQ(at1.x, 2.0f);
-    ASSERT_EQ(at1.y, 0.0f);
+    pool.updateAll(1.0f);
+    ASSERT_FLOAT_EQ(pool.offset(0u), 0.1f);
+    ASSERT_FLOAT_EQ(pool.x(0u), 2.0f);
+    ASSERT_EQ(pool.y(0u), 0.0f);
 
     // 2nd unit of time
-    ASSERT_EQ(at1.update(1.0f), false);
-    ASSERT_EQ(at1.offset, 0.2f);
-    ASSERT_EQ(at1.x, 4.0f);
-    ASSERT_EQ(at1.y, 0.0f);
+    pool.updateAll(1.0f);
+    ASSERT_FLOAT_EQ(pool.offset(0u), 0.2f);
+    ASSERT_FLOAT_EQ(pool.x(0u), 4.0f);
+    ASSERT_EQ(pool.y(0u), 0.0f);
 
     // 9th unit of time
-    ASSERT_EQ(at1.update(7.0f), false);
-    ASSERT_EQ(at1.offset, 0.9f);
-    ASSERT_EQ(at1.x, 18.0f);
-    ASSERT_EQ(at1.y, 0.0f);
-
-    // 10th unit of time
-    ASSERT_EQ(at1.update(1.0f), true);
-    ASSERT_EQ(at1.offset, 1.0f);
-    ASSERT_EQ(at1.x, 20.0f);
-    ASSERT_EQ(at1.y, 0.0f);
+    pool.updateAll(7.0f);
+    ASSERT_FLOAT_EQ(pool.offset(0u), 0.9f);
+    ASSERT_FLOAT_EQ(pool.x(0u), 18.0f);
+    ASSERT_EQ(pool.compact(), 0u);
+
+    // 10th unit of time: arrived
+    pool.updateAll(1.0f);
+    ASSERT_GE(pool.offset(0u), 1.0f);
+    ASSERT_EQ(pool.x(0u), 20.0f);
+    ASSERT_EQ(pool.y(0u), 0.0f);
+    ASSERT_EQ(pool.compact(), 1u);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestPetriNet, TestTimedTokenTypeOfNet)
+{
+    // T1 --> P1 --> T2: 20 units of distance along the X-axis then 10 along
+    // the Y-axis.
+    Transition t1(0u, "", 0.0f, 0.0f, 0u, true);
+    Place p1(0u, "", 20.0f, 0.0f, 0u);
+    Transition t2(1u, "", 20.0f, 10.0f, 0u, true);
+    Arc a1(t1, p1, 10.0f);
+    Arc a2(p1, t2, 0.0f);
+    p1.arcsOut.push_back(&a2);
+    Arc a3(t1, p1, 0.0f);
+
+    // Animation duration depends on the type of net: duration of the arc for
+    // timed nets, else fixed durations.
+    TimedTokens pool;
+    pool.spawn(a1, 1u, TypeOfNet::TimedPetriNet);
+    pool.spawn(a1, 1u, TypeOfNet::PetriNet);
+    pool.spawn(a1, 1u, TypeOfNet::GRAFCET);
+    pool.spawn(a3, 1u, TypeOfNet::TimedPetriNet);
+    pool.updateAll(0.1f);
+    ASSERT_FLOAT_EQ(pool.offset(0u), 0.1f / 10.0f);
+    ASSERT_FLOAT_EQ(pool.offset(1u), 0.1f / 0.2f);
+    ASSERT_FLOAT_EQ(pool.offset(2u), 0.1f / 1.5f);
+    // Null durations: arrived at once
+    ASSERT_GE(pool.offset(3u), 1.0f);
+    ASSERT_EQ(pool.x(3u), 20.0f);
+
+    // With event graphs, implicit places are skipped: tokens move to the
+    // transition after the place.
+    pool.clear();
+    pool.spawn(a1, 1u, TypeOfNet::TimedEventGraph);
+    pool.updateAll(5.0f);
+    ASSERT_FLOAT_EQ(pool.offset(0u), 0.5f);
+    ASSERT_FLOAT_EQ(pool.x(0u), 10.0f);
+    ASSERT_FLOAT_EQ(pool.y(0u), 5.0f);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestPetriNet, TestTimedTokensPool)
+{
+    // T1 --> P1 is 20 unit of distance along the X-axis, T1 --> P2 is 10
+    // units along the Y-axis.
+    Transition t1(42u, "", 0.0f, 0.0f, 45u, true);
+    Place p1(43u, "", 20.0f, 0.0f, 13u);
+    Place p2(44u, "", 0.0f, 10.0f, 13u);
+    Arc a1(t1, p1, 10.0f);
+    Arc a2(t1, p2, 4.0f);
+
+    TimedTokens pool;
+    ASSERT_EQ(pool.empty(), true);
+    pool.spawn(a1, 3u, TypeOfNet::TimedPetriNet);
+    pool.spawn(a2, 5u, TypeOfNet::TimedPetriNet, 0.5f);
+    ASSERT_EQ(pool.size(), 2u);
+    ASSERT_EQ(&pool.arc(0u), &a1);
+    ASSERT_EQ(pool.tokens(0u), 3u);
+    ASSERT_EQ(pool.x(0u), 0.0f);
+    ASSERT_EQ(pool.tokens(1u), 5u);
+    ASSERT_EQ(pool.y(1u), 5.0f);
+
+    pool.updateAll(1.0f);
+    ASSERT_FLOAT_EQ(pool.offset(0u), 0.1f);
+    ASSERT_FLOAT_EQ(pool.x(0u), 2.0f);
+    ASSERT_EQ(pool.y(0u), 0.0f);
+    ASSERT_EQ(pool.offset(1u), 0.75f);
+    ASSERT_EQ(pool.y(1u), 7.5f);
+    ASSERT_EQ(pool.compact(), 0u);
+
+    // Arrived tokens stay at their destination until compacted.
+    pool.updateAll(2.0f);
+    ASSERT_EQ(pool.y(1u), 10.0f);
+    ASSERT_EQ(pool.size(), 2u);
+    ASSERT_EQ(pool.compact(), 1u);
+    ASSERT_EQ(pool.size(), 1u);
+    ASSERT_EQ(&pool.arc(0u), &a1);
+    ASSERT_EQ(pool.x(0u), 6.0f);
+
+    pool.clear();
+    ASSERT_EQ(pool.empty(), true);
 }
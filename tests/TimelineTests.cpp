@@ -0,0 +1,211 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "main.hpp"
+#define protected public
+#define private public
+#  include "TimedPetriNetEditor/PetriNet.hpp"
+#  include "TimedPetriNetEditor/Timeline.hpp"
+#undef protected
+#undef private
+
+using namespace ::tpne;
+
+//------------------------------------------------------------------------------
+// Tokens of P0 are shared randomly between T0 and T1 looping back to P0, and
+// T2 moving them into P1 then back to P0.
+static void createConflicts(Net& net)
+{
+    Place& p0 = net.addPlace(0.0f, 0.0f, 5u);
+    Place& p1 = net.addPlace(0.0f, 0.0f, 0u);
+    Transition& t0 = net.addTransition(0.0f, 0.0f);
+    Transition& t1 = net.addTransition(0.0f, 0.0f);
+    Transition& t2 = net.addTransition(0.0f, 0.0f);
+    Transition& t3 = net.addTransition(0.0f, 0.0f);
+    net.addArc(p0, t0);
+    net.addArc(t0, p0, 1.0f);
+    net.addArc(p0, t1);
+    net.addArc(t1, p0, 1.5f);
+    net.addArc(p0, t2);
+    net.addArc(t2, p1, 0.5f);
+    net.addArc(p1, t3);
+    net.addArc(t3, p0, 2.0f);
+    net.resetReceptivies();
+}
+
+//------------------------------------------------------------------------------
+//! \brief Count the events of the simulation.
+class Counter: public TimedSimulator::Observer
+{
+public:
+
+    virtual void onFired(double const /*time*/, size_t const /*transition*/,
+                         size_t const count) override
+    {
+        fired += count;
+    }
+
+    virtual void onDeparted(double const /*time*/, size_t const /*arc*/,
+                            size_t const /*tokens*/, double const /*arrival*/) override
+    {
+        ++departures;
+    }
+
+    virtual void onArrived(double const /*time*/, size_t const /*arc*/,
+                           size_t const /*place*/, size_t const /*tokens*/) override
+    {
+        ++arrivals;
+    }
+
+    size_t fired = 0u;
+    size_t departures = 0u;
+    size_t arrivals = 0u;
+};
+
+//------------------------------------------------------------------------------
+static void simulate(TimedSimulator& simulator, Timeline& timeline, double const until)
+{
+    while (simulator.time() < until)
+    {
+        simulator.runUntil(simulator.time() + 0.25);
+        timeline.take(simulator);
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(TestTimeline, TestDeltas)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+    createConflicts(net);
+    TimedSimulator simulator(net);
+    simulator.seed(42u);
+
+    Timeline timeline(4u);
+    ASSERT_EQ(timeline.find(0.0), 0u);
+    timeline.take(simulator);
+    simulate(simulator, timeline, 5.0);
+    ASSERT_EQ(timeline.size(), 21u);
+    ASSERT_EQ(timeline.time(0u), 0.0);
+    ASSERT_EQ(timeline.time(20u), 5.0);
+    ASSERT_EQ(timeline.find(1.1), 4u);
+    ASSERT_EQ(timeline.find(-1.0), 21u);
+    ASSERT_EQ(timeline.find(100.0), 20u);
+
+    // Key frames hold marked places. Deltas hold modified places only.
+    ASSERT_EQ(timeline.m_snapshots[0].tokens.size(), 1u);
+    ASSERT_EQ(timeline.m_snapshots[0].receptivities.size(), 4u);
+    ASSERT_EQ(timeline.m_snapshots[1].receptivities.size(), 0u);
+    for (size_t i = 0u; i < timeline.size(); ++i)
+    {
+        ASSERT_LE(timeline.m_snapshots[i].tokens.size(), 2u);
+    }
+
+    // Restoring the latest snapshot gives the current state.
+    TimedSimulator::Checkpoint checkpoint;
+    timeline.restore(20u, checkpoint);
+    ASSERT_EQ(checkpoint.time, simulator.time());
+    ASSERT_EQ(checkpoint.firings, simulator.firings());
+    ASSERT_EQ(checkpoint.tokens, simulator.compiled().tokens());
+    ASSERT_EQ(checkpoint.events.size(), simulator.pending());
+}
+
+//------------------------------------------------------------------------------
+TEST(TestTimeline, TestRewind)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+    createConflicts(net);
+    TimedSimulator simulator(net);
+    simulator.seed(42u);
+
+    Timeline timeline(4u);
+    timeline.take(simulator);
+    simulate(simulator, timeline, 20.0);
+    size_t const firings = simulator.firings();
+    std::vector<CompiledNet::Count> const tokens = simulator.compiled().tokens();
+
+    // Branch a what-if simulation: the simulator is not modified.
+    TimedSimulator branch(simulator);
+    ASSERT_EQ(timeline.rewind(branch, 7.6), true);
+    ASSERT_EQ(branch.time(), 7.6);
+    ASSERT_LT(branch.firings(), firings);
+    ASSERT_EQ(simulator.time(), 20.0);
+    ASSERT_EQ(timeline.rewind(branch, -1.0), false);
+
+    // Rewinding then simulating again gives the same future.
+    ASSERT_EQ(timeline.rewind(simulator, 7.5), true);
+    ASSERT_EQ(simulator.time(), 7.5);
+    size_t const past = simulator.firings();
+    simulate(simulator, timeline, 20.0);
+    ASSERT_EQ(simulator.firings(), firings);
+    ASSERT_EQ(simulator.compiled().tokens(), tokens);
+    ASSERT_EQ(timeline.size(), 81u);
+
+    // The branch has forgotten the previous future.
+    ASSERT_EQ(timeline.rewind(simulator, 7.5), true);
+    ASSERT_EQ(simulator.firings(), past);
+    timeline.take(simulator);
+    ASSERT_EQ(timeline.size(), 31u);
+    ASSERT_EQ(timeline.time(30u), 7.5);
+    ASSERT_EQ(timeline.find(20.0), 30u);
+
+    // Deltas are computed from the new branch.
+    simulate(simulator, timeline, 20.0);
+    ASSERT_EQ(simulator.firings(), firings);
+    ASSERT_EQ(simulator.compiled().tokens(), tokens);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestTimeline, TestRewindObservers)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+    createConflicts(net);
+    TimedSimulator simulator(net);
+    simulator.seed(42u);
+    Counter counter;
+    simulator.addObserver(counter);
+
+    // Snapshots are sparser than events, which happen every 0.5.
+    Timeline timeline(4u);
+    timeline.take(simulator);
+    while (simulator.time() < 20.0)
+    {
+        simulator.runUntil(simulator.time() + 1.25);
+        timeline.take(simulator);
+    }
+    ASSERT_EQ(counter.fired, simulator.firings());
+    size_t const firings = counter.fired;
+    size_t const departures = counter.departures;
+    size_t const arrivals = counter.arrivals;
+
+    // Events replayed between the snapshot and the rewind time have already
+    // been notified.
+    ASSERT_EQ(timeline.rewind(simulator, 8.6), true);
+    ASSERT_EQ(simulator.time(), 8.6);
+    ASSERT_EQ(counter.fired, firings);
+    ASSERT_EQ(counter.departures, departures);
+    ASSERT_EQ(counter.arrivals, arrivals);
+    ASSERT_EQ(simulator.observers().size(), 1u);
+
+    // Observers are still notified of the new future.
+    size_t const past = simulator.firings();
+    simulator.runUntil(20.0);
+    ASSERT_GT(simulator.firings(), past);
+    ASSERT_EQ(counter.fired - firings, simulator.firings() - past);
+}
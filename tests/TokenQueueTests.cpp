@@ -0,0 +1,108 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "main.hpp"
+#include "TimedPetriNetEditor/TokenQueue.hpp"
+
+using namespace ::tpne;
+
+//------------------------------------------------------------------------------
+TEST(TestTokenQueue, TestRuns)
+{
+    TokenQueue queue;
+    ASSERT_EQ(queue.empty(), true);
+    ASSERT_EQ(queue.tokens(), 0u);
+
+    // Tokens of the same time share a run. Earlier times join the latest run.
+    queue.push(1.0, 2u);
+    queue.push(1.0, 3u);
+    queue.push(2.0, 1u);
+    queue.push(1.5, 4u);
+    queue.push(3.0, 0u);
+    ASSERT_EQ(queue.size(), 2u);
+    ASSERT_EQ(queue.tokens(), 10u);
+    ASSERT_EQ(queue.front().time, 1.0);
+    ASSERT_EQ(queue.front().tokens, 5u);
+    ASSERT_EQ(queue.back().time, 2.0);
+    ASSERT_EQ(queue.back().tokens, 5u);
+
+    queue.pop();
+    ASSERT_EQ(queue.size(), 1u);
+    ASSERT_EQ(queue.tokens(), 5u);
+    ASSERT_EQ(queue.front().time, 2.0);
+
+    queue.clear();
+    ASSERT_EQ(queue.empty(), true);
+    ASSERT_EQ(queue.tokens(), 0u);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestTokenQueue, TestLargeRuns)
+{
+#if defined(TPNE_COMPACT_INDEX)
+    // Runs cannot hold more than maxCount() tokens: no token is lost, they
+    // are spread over several runs of the same time.
+    size_t const max = CompiledNet::maxCount();
+    TokenQueue queue;
+    queue.push(1.0, max - 1u);
+    queue.push(1.0, 3u);
+    queue.push(0.5, 2u * max);
+    ASSERT_EQ(queue.tokens(), 3u * max + 2u);
+    ASSERT_EQ(queue.size(), 4u);
+    for (size_t i = 0u; i < 3u; ++i)
+    {
+        ASSERT_EQ(queue[i].time, 1.0);
+        ASSERT_EQ(queue[i].tokens, max);
+    }
+    ASSERT_EQ(queue.back().time, 1.0);
+    ASSERT_EQ(queue.back().tokens, 2u);
+#endif
+}
+
+//------------------------------------------------------------------------------
+TEST(TestTokenQueue, TestRingBuffer)
+{
+    // Push and pop around the end of the ring buffer, growing it meanwhile.
+    TokenQueue queue;
+    size_t first = 0u;
+    size_t last = 0u;
+    for (size_t round = 0u; round < 10u; ++round)
+    {
+        for (size_t i = 0u; i < round + 3u; ++i, ++last)
+        {
+            queue.push(double(last), last + 1u);
+        }
+        for (size_t i = 0u; i < 2u; ++i, ++first)
+        {
+            ASSERT_EQ(queue.front().time, double(first));
+            ASSERT_EQ(queue.front().tokens, first + 1u);
+            queue.pop();
+        }
+
+        ASSERT_EQ(queue.size(), last - first);
+        size_t tokens = 0u;
+        for (size_t i = 0u; i < queue.size(); ++i)
+        {
+            ASSERT_EQ(queue[i].time, double(first + i));
+            tokens += queue[i].tokens;
+        }
+        ASSERT_EQ(queue.tokens(), tokens);
+    }
+}
@@ -0,0 +1,133 @@
+//=============================================================================
+// TimedPetriNetEditor: A timed Petri net editor.
+// Copyright 2021 -- 2023 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of TimedPetriNetEditor.
+//
+// TimedPetriNetEditor is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GNU Emacs.  If not, see <http://www.gnu.org/licenses/>.
+//=============================================================================
+
+#include "main.hpp"
+#define protected public
+#define private public
+#  include "TimedPetriNetEditor/PetriNet.hpp"
+#  include "TimedPetriNetEditor/TraceRecorder.hpp"
+#undef protected
+#undef private
+#include <sstream>
+#include <fstream>
+
+using namespace ::tpne;
+
+//------------------------------------------------------------------------------
+TEST(TestTraceRecorder, TestCapacity)
+{
+    TraceRecorder recorder(1000u);
+    ASSERT_EQ(recorder.capacity(), 1024u);
+    ASSERT_EQ(recorder.isOpen(), false);
+
+    // Records are ignored while no file is opened.
+    recorder.onFired(0.0, 0u, 1u);
+    ASSERT_EQ(recorder.m_head.load(), 0u);
+    ASSERT_STRNE(recorder.open("/nonexistent/trace.bin").c_str(), "");
+    ASSERT_EQ(recorder.isOpen(), false);
+}
+
+//------------------------------------------------------------------------------
+TEST(TestTraceRecorder, TestRecordAndDecode)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+    createCycle(net);
+
+    TraceRecorder recorder(4u);
+    ASSERT_STREQ(recorder.open("/tmp/trace.bin").c_str(), "");
+    ASSERT_EQ(recorder.isOpen(), true);
+
+    TimedSimulator simulator(net);
+    simulator.addObserver(recorder);
+    recorder.started();
+    size_t events = 1u;
+    while (simulator.time() < 10.0)
+    {
+        // Let the writer thread drain the tiny ring buffer.
+        while (recorder.m_head.load() != recorder.m_tail.load())
+            std::this_thread::yield();
+        size_t const firings = simulator.firings();
+        ASSERT_EQ(simulator.step(), true);
+        events += 2u * (simulator.firings() - firings) + 1u;
+    }
+    recorder.close();
+    ASSERT_EQ(recorder.isOpen(), false);
+    ASSERT_EQ(recorder.dropped(), 0u);
+
+    // T0 fires at 0, T1 at 3, T0 at 5, T1 at 8, T0 at 10: each firing makes
+    // tokens depart then arrive.
+    std::vector<TraceRecord> records;
+    ASSERT_STREQ(readTrace("/tmp/trace.bin", records).c_str(), "");
+    ASSERT_EQ(records.size(), events);
+    ASSERT_EQ(records[0].type, TraceRecord::Started);
+    ASSERT_EQ(records[1].type, TraceRecord::Fired);
+    ASSERT_EQ(records[1].time, 0.0);
+    ASSERT_EQ(records[1].node, 0u);
+    ASSERT_EQ(records[1].tokens, 1u);
+    ASSERT_EQ(records[1].arc, TraceRecord::None);
+    ASSERT_EQ(records[2].type, TraceRecord::Departed);
+    ASSERT_EQ(records[2].arc, 1u);
+    ASSERT_EQ(records[3].type, TraceRecord::Arrived);
+    ASSERT_EQ(records[3].time, 3.0);
+    ASSERT_EQ(records[3].node, 1u);
+    ASSERT_EQ(records[3].arc, 1u);
+    ASSERT_EQ(records[4].type, TraceRecord::Fired);
+    ASSERT_EQ(records[4].node, 1u);
+
+    std::stringstream csv;
+    ASSERT_STREQ(decodeTrace("/tmp/trace.bin", csv, TraceFormat::CSV).c_str(), "");
+    std::string line;
+    std::getline(csv, line);
+    ASSERT_STREQ(line.c_str(), "time,type,node,arc,tokens");
+    std::getline(csv, line);
+    ASSERT_STREQ(line.c_str(), "0,started,,,0");
+    std::getline(csv, line);
+    ASSERT_STREQ(line.c_str(), "0,fired,0,,1");
+    std::getline(csv, line);
+    ASSERT_STREQ(line.c_str(), "0,departed,,1,1");
+    std::getline(csv, line);
+    ASSERT_STREQ(line.c_str(), "3,arrived,1,1,1");
+
+    std::stringstream text;
+    ASSERT_STREQ(decodeTrace("/tmp/trace.bin", text, TraceFormat::Text).c_str(), "");
+    std::getline(text, line);
+    std::getline(text, line);
+    ASSERT_STREQ(line.c_str(), "[0] Transition T0 fired 1 time");
+
+    // Not a trace file.
+    std::ofstream("/tmp/trace.bin") << "hello world, this is not a trace";
+    ASSERT_STRNE(readTrace("/tmp/trace.bin", records).c_str(), "");
+}
+
+//------------------------------------------------------------------------------
+TEST(TestTraceRecorder, TestConsole)
+{
+    Net net(TypeOfNet::TimedPetriNet);
+    createCycle(net);
+
+    std::stringstream ss;
+    ConsoleTrace console(net, ss);
+    TimedSimulator simulator(net);
+    simulator.addObserver(console);
+    ASSERT_EQ(simulator.step(), true);
+    std::string const log = ss.str();
+    ASSERT_NE(log.find("Transition T0 burnt 1 token\n"), std::string::npos);
+    ASSERT_NE(log.find("Place P1 got 1 token\n"), std::string::npos);
+}
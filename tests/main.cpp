@@ -1,4 +1,19 @@
 #include "main.hpp"
+#include "TimedPetriNetEditor/PetriNet.hpp"
+
+//------------------------------------------------------------------------------
+void createCycle(tpne::Net& net)
+{
+    tpne::Place& p0 = net.addPlace(0.0f, 0.0f, 1u);
+    tpne::Place& p1 = net.addPlace(0.0f, 0.0f, 0u);
+    tpne::Transition& t0 = net.addTransition(0.0f, 0.0f);
+    tpne::Transition& t1 = net.addTransition(0.0f, 0.0f);
+    net.addArc(p0, t0);
+    net.addArc(t0, p1, 3.0f);
+    net.addArc(p1, t1);
+    net.addArc(t1, p0, 2.0f);
+    net.resetReceptivies();
+}
 
 int main(int argc, char *argv[])
 {
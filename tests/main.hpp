@@ -26,4 +26,14 @@
 
 using namespace ::testing;
 
+namespace tpne { class Net; }
+
+//------------------------------------------------------------------------------
+//! \brief Fixture shared by tests of simulators:
+//! P0 (1 token) -> T0 -(3)-> P1 -> T1 -(2)-> P0
+//! \note Defined in main.cpp so that this header does not include PetriNet.hpp
+//! before tests redefining private and protected.
+//------------------------------------------------------------------------------
+void createCycle(tpne::Net& net);
+
 #endif // MAIN_HPP